@@ -0,0 +1,143 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : bench_ajouts.c
+ * Banc d'essai des ajouts de petits enregistrements à la fin d'un fichier (journaux) : écriture à la fin
+ * (EcrireDonneesInode à Taille()) contre AjouterDonneesInode, sur un disque en mémoire et sur un disque
+ * stocké dans un fichier image, puis EcrireSF sur un descripteur ouvert en écriture ou en ajout.
+ * Les fichiers obtenus sont comparés.
+ * Usage : ./bench_ajouts [nombre d'enregistrements] [taille des blocs]
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "disque.h"
+#include "inode.h"
+#include "sf.h"
+#include "mesure.h"
+
+// Nombre d'enregistrements et taille des blocs par défaut, taille des enregistrements
+#define NB_ENREGISTREMENTS_DEFAUT 4000000L
+#define TAILLE_BLOC_DEFAUT 4096
+#define TAILLE_ENREGISTREMENT 16
+
+// Fichier image du disque stocké dans un fichier (effacé à la fin)
+#define NOM_IMAGE "bench_ajouts.img"
+
+// fonction auxiliaire qui retourne l'enregistrement numéro i (son numéro suivi d'octets fixes)
+static const unsigned char *enregistrement(long i) {
+  static unsigned char zone[TAILLE_ENREGISTREMENT] = "........abcdefgh";
+  memcpy(zone, &i, sizeof(long));
+  return zone;
+}
+
+// fonction auxiliaire qui indique si deux inodes ont le même contenu
+static bool contenusEgaux(tInode a, tInode b) {
+  long taille = Taille(a);
+  unsigned char *contenuA = malloc(taille);
+  unsigned char *contenuB = malloc(taille);
+  bool egaux = contenuA != NULL && contenuB != NULL && Taille(b) == taille
+               && LireDonneesInode(a, contenuA, taille, 0) == taille && LireDonneesInode(b, contenuB, taille, 0) == taille
+               && memcmp(contenuA, contenuB, taille) == 0;
+  free(contenuA);
+  free(contenuB);
+  return egaux;
+}
+
+// fonction auxiliaire qui mesure les ajouts dans deux inodes d'un même disque et affiche une ligne de résultats ;
+// retourne 0 si les deux fichiers sont identiques, -1 sinon
+static int mesurerInodes(tDisque disque, const char *nom, long nbEnregistrements) {
+  if (disque == NULL) {
+    return -1;
+  }
+  tInode ecrit = CreerInode(1, ORDINAIRE);
+  tInode ajoute = CreerInode(2, ORDINAIRE);
+  AssocierDisqueInode(ecrit, disque);
+  AssocierDisqueInode(ajoute, disque);
+
+  double debut = Chronometre();
+  for (long i = 0; i < nbEnregistrements; i++) {
+    EcrireDonneesInode(ecrit, (unsigned char *)enregistrement(i), TAILLE_ENREGISTREMENT, Taille(ecrit));
+  }
+  double ecriture = Chronometre() - debut;
+  debut = Chronometre();
+  for (long i = 0; i < nbEnregistrements; i++) {
+    AjouterDonneesInode(ajoute, (unsigned char *)enregistrement(i), TAILLE_ENREGISTREMENT);
+  }
+  ViderAjoutsInode(ajoute);
+  double ajout = Chronometre() - debut;
+
+  printf("%-28s %-10s %14.1f %14.1f\n", "inode", nom, ecriture / nbEnregistrements * 1e9,
+         ajout / nbEnregistrements * 1e9);
+  int resultat = (Taille(ecrit) == nbEnregistrements * TAILLE_ENREGISTREMENT && contenusEgaux(ecrit, ajoute)) ? 0 : -1;
+  DetruireInode(&ecrit);
+  DetruireInode(&ajoute);
+  return resultat;
+}
+
+// fonction auxiliaire qui mesure EcrireSF sur un descripteur ouvert en écriture puis en ajout
+// et affiche une ligne de résultats ; retourne 0 si les deux fichiers ont la bonne taille, -1 sinon
+static int mesurerSF(long tailleBloc, long nbEnregistrements) {
+  tSF sf = CreerSFAvecTailleBloc("bench", tailleBloc);
+  if (sf == NULL) {
+    return -1;
+  }
+  unsigned char lu[TAILLE_ENREGISTREMENT];
+  double durees[2];
+  long tailles[2];
+  char *noms[] = {"ecrit.log", "ajoute.log"};
+  int modes[] = {OUVERTURE_ECRITURE | OUVERTURE_CREATION, OUVERTURE_ECRITURE | OUVERTURE_AJOUT | OUVERTURE_CREATION};
+  for (int k = 0; k < 2; k++) {
+    double debut = Chronometre();
+    int descripteur = OuvrirSF(sf, noms[k], modes[k]);
+    for (long i = 0; i < nbEnregistrements; i++) {
+      EcrireSF(sf, descripteur, (unsigned char *)enregistrement(i), TAILLE_ENREGISTREMENT);
+    }
+    FermerSF(sf, descripteur);
+    durees[k] = Chronometre() - debut;
+    descripteur = OuvrirSF(sf, noms[k], OUVERTURE_LECTURE);
+    tailles[k] = PositionnerSF(sf, descripteur, 0, SEEK_END);
+    // le dernier enregistrement est relu
+    PositionnerSF(sf, descripteur, -TAILLE_ENREGISTREMENT, SEEK_END);
+    if (LireSF(sf, descripteur, lu, TAILLE_ENREGISTREMENT) != TAILLE_ENREGISTREMENT
+        || memcmp(lu, enregistrement(nbEnregistrements - 1), TAILLE_ENREGISTREMENT) != 0) {
+      tailles[k] = -1;
+    }
+    FermerSF(sf, descripteur);
+  }
+  printf("%-28s %-10s %14.1f %14.1f\n", "EcrireSF (ecriture, ajout)", "memoire", durees[0] / nbEnregistrements * 1e9,
+         durees[1] / nbEnregistrements * 1e9);
+  DetruireSF(&sf);
+  return (tailles[0] == nbEnregistrements * TAILLE_ENREGISTREMENT && tailles[1] == tailles[0]) ? 0 : -1;
+}
+
+int main(int argc, char *argv[]) {
+  long nbEnregistrements = (argc > 1) ? atol(argv[1]) : NB_ENREGISTREMENTS_DEFAUT;
+  long tailleBloc = (argc > 2) ? atol(argv[2]) : TAILLE_BLOC_DEFAUT;
+  if (nbEnregistrements <= 0 || !TailleBlocValide(tailleBloc)
+      || nbEnregistrements * TAILLE_ENREGISTREMENT > TailleMaxFichierBlocs(tailleBloc)) {
+    fprintf(stderr, "Usage : %s [nombre d'enregistrements] [taille des blocs] (dans la taille maximale d'un fichier)\n",
+            argv[0]);
+    return 1;
+  }
+
+  printf("%ld enregistrements de %d octets, blocs de %ld octets (ns par enregistrement)\n\n", nbEnregistrements,
+         TAILLE_ENREGISTREMENT, tailleBloc);
+  printf("%-28s %-10s %14s %14s\n", "fichier", "disque", "ecrire a la fin", "ajouter");
+  tDisque disque = CreerDisque(tailleBloc);
+  int erreur = mesurerInodes(disque, "memoire", nbEnregistrements);
+  DetruireDisque(&disque);
+  disque = CreerDisqueFichier(tailleBloc, NOM_IMAGE);
+  erreur |= mesurerInodes(disque, "image", nbEnregistrements);
+  DetruireDisque(&disque);
+  remove(NOM_IMAGE);
+  erreur |= mesurerSF(tailleBloc, nbEnregistrements);
+  if (erreur != 0) {
+    fprintf(stderr, "ERREUR: fichiers differents\n");
+  }
+  return erreur != 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : bench_blocs.c
+ * Banc d'essai de l'allocation des blocs : un malloc par bloc (comme les blocs des niveaux 1 à 4)
+ * contre les blocs numérotés de la zone d'un disque (AllouerBlocDisque/LibererBlocDisque).
+ * Usage : ./bench_blocs [nombre de blocs]
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bloc.h"
+#include "disque.h"
+#include "mesure.h"
+
+// Nombre de blocs alloués par défaut
+#define NB_BLOCS_DEFAUT 2000000
+
+int main(int argc, char *argv[]) {
+  long nbBlocs = (argc > 1) ? atol(argv[1]) : NB_BLOCS_DEFAUT;
+  if (nbBlocs <= 0) {
+    fprintf(stderr, "Usage : %s [nombre de blocs]\n", argv[0]);
+    return 1;
+  }
+  printf("Allocation de %ld blocs de %d octets\n\n", nbBlocs, TAILLE_BLOC);
+
+  // === Blocs du disque : une carte de bits et une zone contiguë (le disque double sans recopie quand il est plein) ===
+  // (mesuré en premier : la zone est rendue au système à sa destruction, le tas de malloc ne l'est pas forcément)
+  long memoireAvant = MemoireResidente();
+  tDisque disque = CreerDisque(TAILLE_BLOC);
+  if (disque == NULL) {
+    return 1;
+  }
+  double debut = Chronometre();
+  for (long i = 0; i < nbBlocs; i++) {
+    tNumeroBloc numero = AllouerBlocDisque(disque, BLOC_NUL);
+    if (numero == BLOC_NUL) {
+      fprintf(stderr, "ERREUR: allocation du bloc %ld\n", i);
+      return 1;
+    }
+    // le bloc est écrit, comme un bloc de fichier (ses pages deviennent résidentes)
+    AdresseBlocDisque(disque, numero)[0] = (unsigned char)i;
+  }
+  double allocation = Chronometre() - debut;
+  long memoireDisque = MemoireResidente() - memoireAvant;
+  debut = Chronometre();
+  for (tNumeroBloc numero = 1; numero <= (tNumeroBloc)nbBlocs; numero++) {
+    LibererBlocDisque(disque, numero);
+  }
+  double liberation = Chronometre() - debut;
+  debut = Chronometre();
+  DetruireDisque(&disque);
+  double destruction = Chronometre() - debut;
+  printf("disque (zone)    : allocation %6.1f ns/bloc, liberation %6.1f ns/bloc, destruction %8.3f ms, "
+         "memoire %7ld Kio (%.1f octets/bloc)\n",
+         allocation / nbBlocs * 1e9, liberation / nbBlocs * 1e9, destruction * 1e3,
+         memoireDisque, memoireDisque * 1024.0 / nbBlocs);
+
+  // === Un malloc par bloc ===
+  unsigned char **blocs = malloc(nbBlocs * sizeof(unsigned char *));
+  if (blocs == NULL) {
+    return 1;
+  }
+  memoireAvant = MemoireResidente();
+  debut = Chronometre();
+  for (long i = 0; i < nbBlocs; i++) {
+    blocs[i] = malloc(TAILLE_BLOC);
+    if (blocs[i] == NULL) {
+      fprintf(stderr, "ERREUR: creation du bloc %ld\n", i);
+      return 1;
+    }
+    blocs[i][0] = (unsigned char)i;
+  }
+  allocation = Chronometre() - debut;
+  long memoireMalloc = MemoireResidente() - memoireAvant;
+  debut = Chronometre();
+  for (long i = 0; i < nbBlocs; i++) {
+    free(blocs[i]);
+  }
+  liberation = Chronometre() - debut;
+  free(blocs);
+  printf("malloc par bloc  : allocation %6.1f ns/bloc, liberation %6.1f ns/bloc, "
+         "memoire %7ld Kio (%.1f octets/bloc)\n",
+         allocation / nbBlocs * 1e9, liberation / nbBlocs * 1e9,
+         memoireMalloc, memoireMalloc * 1024.0 / nbBlocs);
+
+  printf("\nPic de memoire residente : %ld Kio\n", PicMemoireResidente());
+  return 0;
+}
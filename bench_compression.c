@@ -0,0 +1,137 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : bench_compression.c
+ * Banc d'essai de la compression des fichiers : taux de compression et débits d'écriture et de lecture
+ * (séquentielle, et aléatoire dans quelques trames relues, servies par le cache de trames décompressées),
+ * avec et sans compression, pour un texte compressible et pour des données aléatoires.
+ * Usage : ./bench_compression [taille du fichier en octets] [taille des blocs]
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "disque.h"
+#include "inode.h"
+#include "mesure.h"
+
+// Taille du fichier et des blocs par défaut
+#define TAILLE_FICHIER_DEFAUT (16L << 20)
+#define TAILLE_BLOC_DEFAUT 4096
+
+// Taille des écritures et lectures séquentielles, et des lectures aléatoires
+#define TAILLE_MORCEAU (64L << 10)
+#define TAILLE_LECTURE_ALEATOIRE 512
+
+// Nombre de lectures aléatoires, et taille de la zone du fichier où elles ont lieu
+#define NB_LECTURES_ALEATOIRES 200000
+#define TAILLE_ZONE_CHAUDE (16L << 10)
+
+// fonction auxiliaire qui remplit une zone d'un texte fait de mots tirés au hasard (compressible)
+static void remplirTexte(unsigned char *zone, long taille) {
+  static const char *mots[] = {"inode ", "bloc ", "disque ", "fichier ", "systeme ", "de ", "le ", "un ",
+                               "repertoire ", "sauvegarde ", "etendue ", "trame ", "cache ", "lecture ", "\n", ", "};
+  long i = 0;
+  while (i < taille) {
+    const char *mot = mots[rand() % 16];
+    for (long k = 0; mot[k] != '\0' && i < taille; k++) {
+      zone[i++] = (unsigned char)mot[k];
+    }
+  }
+}
+
+// fonction auxiliaire qui remplit une zone d'octets aléatoires (incompressibles)
+static void remplirAleatoire(unsigned char *zone, long taille) {
+  for (long i = 0; i < taille; i++) {
+    zone[i] = (unsigned char)rand();
+  }
+}
+
+// fonction auxiliaire qui mesure un fichier (compressé ou non) et affiche une ligne de résultats ;
+// retourne 0 si les données relues sont identiques, -1 sinon
+static int mesurer(const char *nom, const unsigned char *donnees, long taille, long tailleBloc, bool compression) {
+  tDisque disque = CreerDisque(tailleBloc);
+  tInode inode = CreerInode(1, ORDINAIRE);
+  unsigned char *lu = malloc(taille);
+  if (disque == NULL || inode == NULL || lu == NULL) {
+    fprintf(stderr, "ERREUR: allocation\n");
+    return -1;
+  }
+  AssocierDisqueInode(inode, disque);
+  if (compression) {
+    ActiverCompressionInode(inode);
+  }
+  long utilisesAvant = NbBlocsDisque(disque) - NbBlocsLibresDisque(disque);
+
+  // écriture séquentielle
+  double debut = Chronometre();
+  for (long decalage = 0; decalage < taille; decalage += TAILLE_MORCEAU) {
+    long morceau = (taille - decalage < TAILLE_MORCEAU) ? taille - decalage : TAILLE_MORCEAU;
+    EcrireDonneesInode(inode, (unsigned char *)donnees + decalage, morceau, decalage);
+  }
+  double ecriture = Chronometre() - debut;
+  long octetsStockes = (NbBlocsDisque(disque) - NbBlocsLibresDisque(disque) - utilisesAvant) * tailleBloc;
+
+  // lecture séquentielle
+  debut = Chronometre();
+  for (long decalage = 0; decalage < taille; decalage += TAILLE_MORCEAU) {
+    LireDonneesInode(inode, lu + decalage, TAILLE_MORCEAU, decalage);
+  }
+  double lecture = Chronometre() - debut;
+  int resultat = (memcmp(lu, donnees, taille) == 0) ? 0 : -1;
+
+  // lectures aléatoires dans une petite zone du milieu du fichier (quelques trames, relues souvent)
+  long zone = (TAILLE_ZONE_CHAUDE < taille) ? TAILLE_ZONE_CHAUDE : taille;
+  long origine = (taille - zone) / 2;
+  debut = Chronometre();
+  for (long i = 0; i < NB_LECTURES_ALEATOIRES; i++) {
+    long decalage = origine + rand() % (zone - TAILLE_LECTURE_ALEATOIRE + 1);
+    LireDonneesInode(inode, lu, TAILLE_LECTURE_ALEATOIRE, decalage);
+  }
+  double aleatoire = Chronometre() - debut;
+
+  printf("%-10s %-14s %8.2f %12.1f %12.1f %14.1f\n", nom, compression ? "compresse" : "brut",
+         (double)taille / octetsStockes, DebitMo(taille, ecriture), DebitMo(taille, lecture),
+         DebitMo((double)NB_LECTURES_ALEATOIRES * TAILLE_LECTURE_ALEATOIRE, aleatoire));
+
+  free(lu);
+  DetruireInode(&inode);
+  DetruireDisque(&disque);
+  return resultat;
+}
+
+int main(int argc, char *argv[]) {
+  long taille = (argc > 1) ? atol(argv[1]) : TAILLE_FICHIER_DEFAUT;
+  long tailleBloc = (argc > 2) ? atol(argv[2]) : TAILLE_BLOC_DEFAUT;
+  if (taille < TAILLE_LECTURE_ALEATOIRE || !TailleBlocValide(tailleBloc)
+      || taille > TailleMaxFichierBlocs(tailleBloc)) {
+    fprintf(stderr, "Usage : %s [taille du fichier en octets] [taille des blocs]\n", argv[0]);
+    return 1;
+  }
+
+  unsigned char *texte = malloc(taille);
+  unsigned char *aleatoire = malloc(taille);
+  if (texte == NULL || aleatoire == NULL) {
+    return 1;
+  }
+  srand(1);
+  remplirTexte(texte, taille);
+  remplirAleatoire(aleatoire, taille);
+
+  printf("Fichier de %ld octets, blocs de %ld octets (debits en Mo/s)\n\n", taille, tailleBloc);
+  printf("%-10s %-14s %8s %12s %12s %14s\n", "donnees", "stockage", "ratio", "ecriture", "lecture", "lecture 512 o");
+  int erreur = mesurer("texte", texte, taille, tailleBloc, false)
+             | mesurer("texte", texte, taille, tailleBloc, true)
+             | mesurer("aleatoire", aleatoire, taille, tailleBloc, false)
+             | mesurer("aleatoire", aleatoire, taille, tailleBloc, true);
+  if (erreur != 0) {
+    fprintf(stderr, "ERREUR: donnees relues differentes\n");
+  }
+
+  free(texte);
+  free(aleatoire);
+  return erreur != 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : bench_copie.c
+ * Banc d'essai des noyaux de copie (CopierBlocEntier, CopierOctets) pour des blocs de 64 o, 4 Kio et 64 Kio,
+ * comparés à la boucle octet par octet d'origine et au memcpy de la bibliothèque C.
+ * Usage : ./bench_copie [octets copiés par mesure]
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "mesure.h"
+
+// Octets copiés par mesure par défaut
+#define OCTETS_PAR_MESURE (1L << 30)
+
+// Les façons de copier un bloc mesurées
+typedef enum { BOUCLE, MEMCPY, BLOC_ENTIER, OCTETS, PARTIEL } tCopie;
+
+static const char *nomsCopies[] = {
+  "boucle octet par octet", "memcpy", "CopierBlocEntier", "CopierOctets", "CopierOctets (bloc - 1 octet)"
+};
+
+// fonction auxiliaire qui copie octet par octet, comme les copies de blocs avant les noyaux
+// (volatile : le compilateur ne la remplace pas par un memcpy, comme avec les Makefile sans optimisation)
+static void copierBoucle(unsigned char *destination, const unsigned char *source, long taille) {
+  volatile unsigned char *d = destination;
+  for (long i = 0; i < taille; i++) {
+    d[i] = source[i];
+  }
+}
+
+// fonction auxiliaire qui mesure une façon de copier des blocs d'une taille donnée : retourne le débit en Go/s
+// (les sources alternent pour que les copies ne puissent pas être fusionnées)
+static double mesurer(tCopie copie, long taille, long octets, unsigned char *sources[2], unsigned char *destination) {
+  long nbCopies = octets / taille;
+  long longueur = (copie == PARTIEL) ? taille - 1 : taille;
+  double debut = Chronometre();
+  for (long i = 0; i < nbCopies; i++) {
+    const unsigned char *source = sources[i & 1];
+    switch (copie) {
+      case BOUCLE:      copierBoucle(destination, source, longueur); break;
+      case MEMCPY:      memcpy(destination, source, longueur); break;
+      case BLOC_ENTIER: CopierBlocEntier(destination, source, longueur); break;
+      case OCTETS:
+      case PARTIEL:     CopierOctets(destination, source, longueur); break;
+    }
+  }
+  double duree = Chronometre() - debut;
+  return DebitMo((double)nbCopies * longueur, duree) / 1e3;
+}
+
+int main(int argc, char *argv[]) {
+  long octets = (argc > 1) ? atol(argv[1]) : OCTETS_PAR_MESURE;
+  if (octets <= 0) {
+    fprintf(stderr, "Usage : %s [octets copiés par mesure]\n", argv[0]);
+    return 1;
+  }
+
+  long tailles[] = {TAILLE_BLOC_MIN, 4096, TAILLE_BLOC_MAX};
+  int nbTailles = sizeof(tailles) / sizeof(tailles[0]);
+  unsigned char *sources[2] = {malloc(TAILLE_BLOC_MAX), malloc(TAILLE_BLOC_MAX)};
+  unsigned char *destination = malloc(TAILLE_BLOC_MAX);
+  if (sources[0] == NULL || sources[1] == NULL || destination == NULL) {
+    fprintf(stderr, "ERREUR: allocation\n");
+    return 1;
+  }
+  for (long i = 0; i < TAILLE_BLOC_MAX; i++) {
+    sources[0][i] = (unsigned char)i;
+    sources[1][i] = (unsigned char)(i * 7);
+  }
+
+  printf("Debit de copie en Go/s (%ld octets par mesure)\n\n", octets);
+  printf("%-32s", "");
+  for (int t = 0; t < nbTailles; t++) {
+    printf("%10ld o", tailles[t]);
+  }
+  printf("\n");
+  for (tCopie copie = BOUCLE; copie <= PARTIEL; copie++) {
+    printf("%-32s", nomsCopies[copie]);
+    for (int t = 0; t < nbTailles; t++) {
+      // la boucle octet par octet est mesurée sur moins d'octets (elle est lente)
+      long aCopier = (copie == BOUCLE) ? octets / 16 : octets;
+      printf("%12.2f", mesurer(copie, tailles[t], aCopier, sources, destination));
+    }
+    printf("\n");
+  }
+
+  // la dernière copie est vérifiée (une copie fausse serait mesurée pour rien)
+  int erreur = memcmp(destination, sources[(octets / TAILLE_BLOC_MAX - 1) & 1], TAILLE_BLOC_MAX - 1) != 0;
+  if (erreur) {
+    fprintf(stderr, "ERREUR: contenu copie incorrect\n");
+  }
+  free(sources[0]);
+  free(sources[1]);
+  free(destination);
+  return erreur;
+}
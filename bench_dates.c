@@ -0,0 +1,113 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : bench_dates.c
+ * Banc d'essai des politiques de date de dernier accès sur de petites lectures : DATES_STRICTES,
+ * DATES_RELATIVES et SANS_DATE_ACCES, avec LireDonneesInode sur un inode puis LireSF sur un descripteur
+ * (repositionné au début avant chaque lecture).
+ * Usage : ./bench_dates [nombre de lectures] [taille des lectures]
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "inode.h"
+#include "sf.h"
+#include "mesure.h"
+
+// Nombre et taille des lectures par défaut, taille du fichier lu (plusieurs blocs)
+#define NB_LECTURES_DEFAUT 10000000L
+#define TAILLE_LECTURE_DEFAUT 64
+#define TAILLE_FICHIER (16 * 1024)
+
+// Les politiques mesurées, et leur nom
+static const politiqueDates politiques[] = {DATES_STRICTES, DATES_RELATIVES, SANS_DATE_ACCES};
+static const char *nomsPolitiques[] = {"strictes", "relatives", "sans"};
+#define NB_POLITIQUES 3
+
+// fonction auxiliaire qui mesure les lectures dans un inode pour une politique : retourne la durée
+// d'une lecture en ns, -1 si une lecture échoue
+static double mesurerInode(tInode inode, politiqueDates politique, long nbLectures, long tailleLecture,
+                           unsigned char *lu) {
+  PolitiqueDatesInode(inode, politique);
+  double debut = Chronometre();
+  for (long i = 0; i < nbLectures; i++) {
+    long decalage = (i * tailleLecture) % (TAILLE_FICHIER - tailleLecture);
+    if (LireDonneesInode(inode, lu, tailleLecture, decalage) != tailleLecture) {
+      return -1;
+    }
+  }
+  return (Chronometre() - debut) / nbLectures * 1e9;
+}
+
+// fonction auxiliaire qui mesure les lectures d'un fichier du SF pour une politique : retourne la durée
+// d'une lecture en ns, -1 si une lecture échoue
+static double mesurerSF(tSF sf, int descripteur, politiqueDates politique, long nbLectures, long tailleLecture,
+                        unsigned char *lu) {
+  PolitiqueDatesSF(sf, politique);
+  double debut = Chronometre();
+  for (long i = 0; i < nbLectures; i++) {
+    if (PositionnerSF(sf, descripteur, 0, SEEK_SET) != 0
+        || LireSF(sf, descripteur, lu, tailleLecture) != tailleLecture) {
+      return -1;
+    }
+  }
+  return (Chronometre() - debut) / nbLectures * 1e9;
+}
+
+int main(int argc, char *argv[]) {
+  long nbLectures = (argc > 1) ? atol(argv[1]) : NB_LECTURES_DEFAUT;
+  long tailleLecture = (argc > 2) ? atol(argv[2]) : TAILLE_LECTURE_DEFAUT;
+  if (nbLectures <= 0 || tailleLecture <= 0 || tailleLecture >= TAILLE_FICHIER) {
+    fprintf(stderr, "Usage : %s [nombre de lectures] [taille des lectures (< %d)]\n", argv[0], TAILLE_FICHIER);
+    return 1;
+  }
+  unsigned char *contenu = malloc(TAILLE_FICHIER);
+  unsigned char *lu = malloc(tailleLecture);
+  if (contenu == NULL || lu == NULL) {
+    free(contenu);
+    free(lu);
+    return 1;
+  }
+  for (long i = 0; i < TAILLE_FICHIER; i++) {
+    contenu[i] = (unsigned char)(i * 7 + i / 251);
+  }
+
+  printf("%ld lectures de %ld octets (ns par lecture)\n\n", nbLectures, tailleLecture);
+  printf("%-20s %12s %12s %12s\n", "lecture", nomsPolitiques[0], nomsPolitiques[1], nomsPolitiques[2]);
+  bool erreur = false;
+
+  tInode inode = CreerInode(1, ORDINAIRE);
+  erreur = EcrireDonneesInode(inode, contenu, TAILLE_FICHIER, 0) != TAILLE_FICHIER;
+  printf("%-20s", "LireDonneesInode");
+  for (int k = 0; k < NB_POLITIQUES; k++) {
+    double duree = mesurerInode(inode, politiques[k], nbLectures, tailleLecture, lu);
+    erreur = erreur || duree < 0;
+    printf(" %12.1f", duree);
+  }
+  printf("\n");
+  DetruireInode(&inode);
+
+  tSF sf = CreerSF("bench");
+  int descripteur = OuvrirSF(sf, "lu.bin", OUVERTURE_ECRITURE | OUVERTURE_LECTURE | OUVERTURE_CREATION);
+  erreur = erreur || descripteur < 0 || EcrireSF(sf, descripteur, contenu, TAILLE_FICHIER) != TAILLE_FICHIER;
+  printf("%-20s", "LireSF");
+  for (int k = 0; k < NB_POLITIQUES; k++) {
+    double duree = mesurerSF(sf, descripteur, politiques[k], nbLectures, tailleLecture, lu);
+    erreur = erreur || duree < 0;
+    printf(" %12.1f", duree);
+  }
+  printf("\n");
+  FermerSF(sf, descripteur);
+  DetruireSF(&sf);
+
+  free(contenu);
+  free(lu);
+  if (erreur) {
+    fprintf(stderr, "ERREUR: lecture incomplete\n");
+  }
+  return erreur;
+}
@@ -0,0 +1,172 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : bench_import.c
+ * Banc d'essai de l'import d'un gros fichier du système dans le SF : débit et pic de mémoire résidente,
+ * pour l'import par tronçons depuis un chemin (EcrireFichierSF) ou depuis un tube (EcrireDescripteurSystemeSF),
+ * et pour la lecture du fichier entier dans une zone allouée puis écrite en une fois (ancienne méthode),
+ * sur un disque en mémoire et sur un disque stocké dans un fichier image.
+ * Chaque mesure est faite dans un processus fils, pour que les pics de mémoire ne se cumulent pas.
+ * Usage : ./bench_import [taille du fichier en Mo]
+ **/
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "sf.h"
+#include "mesure.h"
+
+// Taille du fichier par défaut (en Mo), et des blocs du SF
+#define TAILLE_FICHIER_DEFAUT 256
+#define TAILLE_BLOC_SF 4096
+
+// Taille des écritures dans le tube
+#define TAILLE_TRONCON_TUBE (64L << 10)
+
+// Fichiers utilisés par le banc d'essai (effacés à la fin)
+#define NOM_SOURCE "bench_import.src"
+#define NOM_IMAGE "bench_import.img"
+
+// Méthodes d'import mesurées
+typedef enum { ENTIER, CHEMIN, TUBE } methodeImport;
+
+// fonction auxiliaire qui importe le fichier source en le lisant en entier dans une zone allouée,
+// écrite dans le SF en une fois ; retourne le nombre d'octets écrits
+static long importerEntier(tSF sf) {
+  FILE *source = fopen(NOM_SOURCE, "rb");
+  if (source == NULL) {
+    return -1;
+  }
+  fseek(source, 0, SEEK_END);
+  long taille = ftell(source);
+  fseek(source, 0, SEEK_SET);
+  unsigned char *contenu = malloc(taille);
+  long ecrits = -1;
+  if (contenu != NULL && (long)fread(contenu, 1, taille, source) == taille) {
+    int descripteur = OuvrirSF(sf, "entier.bin", OUVERTURE_ECRITURE | OUVERTURE_CREATION);
+    ecrits = EcrireSF(sf, descripteur, contenu, taille);
+    FermerSF(sf, descripteur);
+  }
+  free(contenu);
+  fclose(source);
+  return ecrits;
+}
+
+// fonction auxiliaire qui importe le fichier source par un tube, alimenté par un processus fils
+// qui le lit par tronçons ; retourne le nombre d'octets écrits
+static long importerTube(tSF sf) {
+  int tube[2];
+  if (pipe(tube) != 0) {
+    return -1;
+  }
+  pid_t fils = fork();
+  if (fils == 0) {
+    close(tube[0]);
+    FILE *source = fopen(NOM_SOURCE, "rb");
+    unsigned char *troncon = malloc(TAILLE_TRONCON_TUBE);
+    size_t lus;
+    while (source != NULL && troncon != NULL && (lus = fread(troncon, 1, TAILLE_TRONCON_TUBE, source)) > 0) {
+      for (size_t ecrits = 0; ecrits < lus;) {
+        ssize_t n = write(tube[1], troncon + ecrits, lus - ecrits);
+        if (n <= 0) {
+          _exit(1);
+        }
+        ecrits += n;
+      }
+    }
+    _exit(0);
+  }
+  close(tube[1]);
+  long ecrits = (fils > 0) ? EcrireDescripteurSystemeSF(sf, tube[0], "tube.bin", ORDINAIRE) : -1;
+  close(tube[0]);
+  if (fils > 0) {
+    waitpid(fils, NULL, 0);
+  }
+  return ecrits;
+}
+
+// fonction auxiliaire, exécutée dans un processus fils, qui mesure un import et affiche une ligne de résultats ;
+// retourne 0 si tout le fichier est importé, 1 sinon
+static int mesurer(methodeImport methode, bool image, long taille) {
+  tSF sf = image ? CreerSFSurFichier("bench", TAILLE_BLOC_SF, NOM_IMAGE) : CreerSFAvecTailleBloc("bench", TAILLE_BLOC_SF);
+  if (sf == NULL) {
+    return 1;
+  }
+  double debut = Chronometre();
+  long ecrits;
+  switch (methode) {
+    case ENTIER:
+      ecrits = importerEntier(sf);
+      break;
+    case CHEMIN:
+      ecrits = EcrireFichierSF(sf, NOM_SOURCE, ORDINAIRE);
+      break;
+    default:
+      ecrits = importerTube(sf);
+      break;
+  }
+  double duree = Chronometre() - debut;
+  static const char *noms[] = {"fichier entier", "chemin", "tube"};
+  printf("%-16s %-10s %12.1f %14ld\n", noms[methode], image ? "image" : "memoire", DebitMo(ecrits, duree),
+         PicMemoireResidente() / 1024);
+  fflush(stdout);
+  DetruireSF(&sf);
+  return ecrits != taille;
+}
+
+int main(int argc, char *argv[]) {
+  long tailleMo = (argc > 1) ? atol(argv[1]) : TAILLE_FICHIER_DEFAUT;
+  if (tailleMo <= 0) {
+    fprintf(stderr, "Usage : %s [taille du fichier en Mo]\n", argv[0]);
+    return 1;
+  }
+  long taille = tailleMo * 1000000;
+
+  // fichier source aléatoire, écrit par tronçons
+  FILE *source = fopen(NOM_SOURCE, "wb");
+  unsigned char *troncon = malloc(TAILLE_TRONCON_TUBE);
+  if (source == NULL || troncon == NULL) {
+    fprintf(stderr, "ERREUR: creation du fichier source\n");
+    return 1;
+  }
+  srand(1);
+  for (long ecrits = 0; ecrits < taille; ecrits += TAILLE_TRONCON_TUBE) {
+    long morceau = (taille - ecrits < TAILLE_TRONCON_TUBE) ? taille - ecrits : TAILLE_TRONCON_TUBE;
+    for (long i = 0; i < morceau; i++) {
+      troncon[i] = (unsigned char)rand();
+    }
+    fwrite(troncon, 1, morceau, source);
+  }
+  fclose(source);
+  free(troncon);
+
+  printf("Import d'un fichier de %ld octets, blocs de %d octets\n\n", taille, TAILLE_BLOC_SF);
+  printf("%-16s %-10s %12s %14s\n", "methode", "disque", "debit (Mo/s)", "pic RSS (Mio)");
+  fflush(stdout);
+  int erreur = 0;
+  for (int image = 0; image < 2; image++) {
+    for (methodeImport methode = ENTIER; methode <= TUBE; methode++) {
+      pid_t fils = fork();
+      if (fils == 0) {
+        _exit(mesurer(methode, image, taille));
+      }
+      int statut;
+      if (fils < 0 || waitpid(fils, &statut, 0) != fils || !WIFEXITED(statut) || WEXITSTATUS(statut) != 0) {
+        erreur = 1;
+      }
+    }
+  }
+  if (erreur != 0) {
+    fprintf(stderr, "ERREUR: import incomplet\n");
+  }
+
+  remove(NOM_SOURCE);
+  remove(NOM_IMAGE);
+  return erreur;
+}
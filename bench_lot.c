@@ -0,0 +1,271 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : bench_lot.c
+ * Banc d'essai des entrées/sorties par lots : écriture puis relecture à froid (cache du noyau vidé)
+ * de blocs d'un fichier local, un fread/fwrite par bloc (comme les sauvegardes bloc par bloc d'avant)
+ * ou par lots exécutés par preadv/pwritev ou par io_uring, pour des blocs consécutifs
+ * (regroupés en une requête par suite) et pour des blocs dans le désordre (une requête par bloc).
+ * Puis, pour un disque stocké dans un fichier image : vidage du cache de blocs (SauvegarderDisque)
+ * et relecture séquentielle à froid, avec les deux modes des lots.
+ * Usage : ./bench_lot [nombre de blocs] [taille des blocs]
+ **/
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "bloc.h"
+#include "disque.h"
+#include "lot.h"
+#include "mesure.h"
+
+// Nombre et taille des blocs par défaut
+#define NB_BLOCS_DEFAUT 25000L
+#define TAILLE_BLOC_DEFAUT 4096
+
+// Nombre de zones en mémoire d'un lot (comme pour le cache de blocs)
+#define CAPACITE_LOT 256
+
+// Fichiers utilisés par le banc d'essai (effacés à la fin)
+#define NOM_FICHIER "bench_lot.img"
+#define NOM_SAUVEGARDE "bench_lot.sav"
+
+// fonction auxiliaire qui écrit le fichier sur le disque et retire ses pages du cache du noyau,
+// pour que la lecture suivante soit faite à froid
+static void oublierFichier(const char *nom) {
+  int fd = open(nom, O_RDONLY);
+  if (fd >= 0) {
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+}
+
+// fonction auxiliaire qui écrit puis relit les blocs un par un avec fwrite/fread ;
+// retourne 0 si les blocs relus sont identiques, -1 sinon
+static int mesurerStdio(const char *nom, const unsigned char *donnees, unsigned char *lu,
+                        const long *ordre, long nbBlocs, long tailleBloc) {
+  FILE *fichier = fopen(NOM_FICHIER, "w+b");
+  if (fichier == NULL) {
+    perror(NOM_FICHIER);
+    return -1;
+  }
+
+  double debut = Chronometre();
+  for (long i = 0; i < nbBlocs; i++) {
+    fseek(fichier, ordre[i] * tailleBloc, SEEK_SET);
+    fwrite(donnees + ordre[i] * tailleBloc, tailleBloc, 1, fichier);
+  }
+  fflush(fichier);
+  double ecriture = Chronometre() - debut;
+
+  oublierFichier(NOM_FICHIER);
+  debut = Chronometre();
+  for (long i = 0; i < nbBlocs; i++) {
+    fseek(fichier, ordre[i] * tailleBloc, SEEK_SET);
+    if (fread(lu + ordre[i] * tailleBloc, tailleBloc, 1, fichier) != 1) {
+      break;
+    }
+  }
+  double lecture = Chronometre() - debut;
+  fclose(fichier);
+
+  double octets = (double)nbBlocs * tailleBloc;
+  printf("%-12s %-10s %12.1f %12.1f\n", nom, "stdio", DebitMo(octets, ecriture), DebitMo(octets, lecture));
+  return (memcmp(lu, donnees, nbBlocs * tailleBloc) == 0) ? 0 : -1;
+}
+
+// fonction auxiliaire qui ajoute la lecture ou l'écriture d'un bloc à un lot, en prolongeant
+// la dernière requête si le bloc suit celui qui la termine ; le lot est exécuté quand il est plein
+static int ajouterBloc(tLotES lot, bool ecriture, int fd, unsigned char *zone, long numero, long *pSuivant,
+                       long tailleBloc) {
+  if (numero == *pSuivant && ProlongerLotES(lot, zone, tailleBloc) == 0) {
+    *pSuivant = numero + 1;
+    return 0;
+  }
+  int resultat = ecriture ? AjouterEcritureLotES(lot, fd, zone, tailleBloc, (off_t)numero * tailleBloc)
+                          : AjouterLectureLotES(lot, fd, zone, tailleBloc, (off_t)numero * tailleBloc);
+  if (resultat != 0) {
+    if (ExecuterLotES(lot) != 0) {
+      return -1;
+    }
+    resultat = ecriture ? AjouterEcritureLotES(lot, fd, zone, tailleBloc, (off_t)numero * tailleBloc)
+                        : AjouterLectureLotES(lot, fd, zone, tailleBloc, (off_t)numero * tailleBloc);
+  }
+  *pSuivant = numero + 1;
+  return resultat;
+}
+
+// fonction auxiliaire qui écrit puis relit les blocs par lots (io_uring ou preadv/pwritev) ;
+// retourne 0 si les blocs relus sont identiques, -1 sinon
+static int mesurerLots(const char *nom, const unsigned char *donnees, unsigned char *lu,
+                       const long *ordre, long nbBlocs, long tailleBloc, bool asynchrone) {
+  AsynchroneLotES(asynchrone);
+  tLotES lot = CreerLotES(CAPACITE_LOT);
+  int fd = open(NOM_FICHIER, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (lot == NULL || fd < 0) {
+    fprintf(stderr, "ERREUR: creation du lot ou du fichier\n");
+    DetruireLotES(&lot);
+    return -1;
+  }
+  int resultat = 0;
+
+  double debut = Chronometre();
+  long suivant = -1;
+  for (long i = 0; i < nbBlocs && resultat == 0; i++) {
+    resultat = ajouterBloc(lot, true, fd, (unsigned char *)donnees + ordre[i] * tailleBloc, ordre[i], &suivant,
+                           tailleBloc);
+  }
+  if (resultat == 0) {
+    resultat = ExecuterLotES(lot);
+  }
+  double ecriture = Chronometre() - debut;
+
+  oublierFichier(NOM_FICHIER);
+  debut = Chronometre();
+  suivant = -1;
+  for (long i = 0; i < nbBlocs && resultat == 0; i++) {
+    resultat = ajouterBloc(lot, false, fd, lu + ordre[i] * tailleBloc, ordre[i], &suivant, tailleBloc);
+  }
+  if (resultat == 0) {
+    resultat = ExecuterLotES(lot);
+  }
+  double lecture = Chronometre() - debut;
+
+  double octets = (double)nbBlocs * tailleBloc;
+  printf("%-12s %-10s %12.1f %12.1f\n", nom, EstAsynchroneLotES(lot) ? "io_uring" : "synchrone",
+         DebitMo(octets, ecriture), DebitMo(octets, lecture));
+  close(fd);
+  DetruireLotES(&lot);
+  if (resultat != 0) {
+    return -1;
+  }
+  return (memcmp(lu, donnees, nbBlocs * tailleBloc) == 0) ? 0 : -1;
+}
+
+// fonction auxiliaire qui remplit un disque stocké dans un fichier image, le sauvegarde
+// (vidage du cache de blocs) puis le recharge et relit ses blocs dans l'ordre à froid ;
+// retourne 0 si les blocs relus sont identiques, -1 sinon
+static int mesurerDisque(const unsigned char *donnees, unsigned char *lu, long nbBlocs, long tailleBloc,
+                         bool asynchrone) {
+  AsynchroneLotES(asynchrone);
+  // tous les blocs restent dans le cache jusqu'à la sauvegarde, qui les écrit tous
+  BudgetCacheDisque(nbBlocs * tailleBloc + (1L << 20));
+  tDisque disque = CreerDisqueFichier(tailleBloc, NOM_FICHIER);
+  tNumeroBloc *numeros = malloc(nbBlocs * sizeof(tNumeroBloc));
+  if (disque == NULL || numeros == NULL) {
+    DetruireDisque(&disque);
+    free(numeros);
+    return -1;
+  }
+  for (long i = 0; i < nbBlocs; i++) {
+    numeros[i] = AllouerBlocDisque(disque, (i > 0) ? numeros[i - 1] : BLOC_NUL);
+    EcrireBlocDisque(disque, numeros[i], 0, (unsigned char *)donnees + i * tailleBloc, tailleBloc);
+  }
+
+  FILE *sauvegarde = fopen(NOM_SAUVEGARDE, "wb");
+  if (sauvegarde == NULL) {
+    DetruireDisque(&disque);
+    free(numeros);
+    return -1;
+  }
+  double debut = Chronometre();
+  int resultat = SauvegarderDisque(disque, sauvegarde);
+  double vidage = Chronometre() - debut;
+  fclose(sauvegarde);
+  DetruireDisque(&disque);
+
+  oublierFichier(NOM_FICHIER);
+  sauvegarde = fopen(NOM_SAUVEGARDE, "rb");
+  if (sauvegarde == NULL || resultat != 0 || ChargerDisque(&disque, sauvegarde) != 0) {
+    if (sauvegarde != NULL) {
+      fclose(sauvegarde);
+    }
+    free(numeros);
+    return -1;
+  }
+  fclose(sauvegarde);
+  debut = Chronometre();
+  for (long i = 0; i < nbBlocs; i++) {
+    LireBlocDisque(disque, numeros[i], 0, lu + i * tailleBloc, tailleBloc);
+  }
+  double lecture = Chronometre() - debut;
+  DetruireDisque(&disque);
+  free(numeros);
+
+  double octets = (double)nbBlocs * tailleBloc;
+  printf("%-12s %-10s %12.1f %12.1f\n", "disque", asynchrone ? "io_uring" : "synchrone",
+         DebitMo(octets, vidage), DebitMo(octets, lecture));
+  return (memcmp(lu, donnees, nbBlocs * tailleBloc) == 0) ? 0 : -1;
+}
+
+int main(int argc, char *argv[]) {
+  long nbBlocs = (argc > 1) ? atol(argv[1]) : NB_BLOCS_DEFAUT;
+  long tailleBloc = (argc > 2) ? atol(argv[2]) : TAILLE_BLOC_DEFAUT;
+  if (nbBlocs <= 0 || !TailleBlocValide(tailleBloc)) {
+    fprintf(stderr, "Usage : %s [nombre de blocs] [taille des blocs]\n", argv[0]);
+    return 1;
+  }
+
+  unsigned char *donnees = malloc(nbBlocs * tailleBloc);
+  unsigned char *lu = malloc(nbBlocs * tailleBloc);
+  long *sequentiel = malloc(nbBlocs * sizeof(long));
+  long *desordre = malloc(nbBlocs * sizeof(long));
+  if (donnees == NULL || lu == NULL || sequentiel == NULL || desordre == NULL) {
+    fprintf(stderr, "ERREUR: allocation\n");
+    return 1;
+  }
+  srand(1);
+  for (long i = 0; i < nbBlocs * tailleBloc; i++) {
+    donnees[i] = (unsigned char)rand();
+  }
+  for (long i = 0; i < nbBlocs; i++) {
+    sequentiel[i] = i;
+    desordre[i] = i;
+  }
+  // ordre aléatoire (Fisher-Yates) : aucun bloc ne suit le précédent dans le fichier
+  for (long i = nbBlocs - 1; i > 0; i--) {
+    long j = ((long)rand() * RAND_MAX + rand()) % (i + 1);
+    long echange = desordre[i];
+    desordre[i] = desordre[j];
+    desordre[j] = echange;
+  }
+
+  printf("%ld blocs de %ld octets (debits en Mo/s, lecture apres vidage du cache du noyau)\n\n", nbBlocs, tailleBloc);
+  printf("%-12s %-10s %12s %12s\n", "blocs", "mode", "ecriture", "lecture");
+  int erreur = 0;
+  const long *ordres[] = {sequentiel, desordre};
+  const char *noms[] = {"consecutifs", "desordre"};
+  for (int k = 0; k < 2; k++) {
+    memset(lu, 0, nbBlocs * tailleBloc);
+    erreur |= mesurerStdio(noms[k], donnees, lu, ordres[k], nbBlocs, tailleBloc);
+    memset(lu, 0, nbBlocs * tailleBloc);
+    erreur |= mesurerLots(noms[k], donnees, lu, ordres[k], nbBlocs, tailleBloc, false);
+    memset(lu, 0, nbBlocs * tailleBloc);
+    erreur |= mesurerLots(noms[k], donnees, lu, ordres[k], nbBlocs, tailleBloc, true);
+  }
+  printf("\n%-12s %-10s %12s %12s\n", "", "mode", "vidage", "lecture");
+  memset(lu, 0, nbBlocs * tailleBloc);
+  erreur |= mesurerDisque(donnees, lu, nbBlocs, tailleBloc, false);
+  memset(lu, 0, nbBlocs * tailleBloc);
+  erreur |= mesurerDisque(donnees, lu, nbBlocs, tailleBloc, true);
+  if (erreur != 0) {
+    fprintf(stderr, "ERREUR: donnees relues differentes\n");
+  }
+
+  AsynchroneLotES(true);
+  BudgetCacheDisque(BUDGET_CACHE_DISQUE);
+  remove(NOM_FICHIER);
+  remove(NOM_SAUVEGARDE);
+  free(donnees);
+  free(lu);
+  free(sequentiel);
+  free(desordre);
+  return erreur != 0;
+}
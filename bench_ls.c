@@ -0,0 +1,120 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : bench_ls.c
+ * Banc d'essai de l'affichage du répertoire racine (Ls, détaillé ou non) pour un grand nombre de fichiers,
+ * sortie envoyée vers /dev/null. Le volume est soit construit (fichiers de 1 à 150 octets créés par OuvrirSF,
+ * dont le coût croît avec le carré du nombre de fichiers : chaque création réécrit le répertoire racine),
+ * soit chargé depuis une sauvegarde (par exemple un volume de 100 000 fichiers construit une fois par ce programme).
+ * Usage : ./bench_ls [nombre de fichiers] [sauvegarde à charger, ou à écrire si elle n'existe pas]
+ **/
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sf.h"
+#include "mesure.h"
+
+// Nombre de fichiers par défaut, et taille maximale de leur contenu
+#define NB_FICHIERS_DEFAUT 10000L
+#define TAILLE_CONTENU_MAX 150
+
+// Taille des blocs du volume construit
+#define TAILLE_BLOC_VOLUME 4096
+
+// Nombre de mesures de chaque affichage (la meilleure est retenue)
+#define NB_ESSAIS 3
+
+// fonction auxiliaire qui construit un volume de nbFichiers fichiers dans le répertoire racine
+static tSF construireVolume(long nbFichiers) {
+  tSF sf = CreerSFAvecTailleBloc("bench", TAILLE_BLOC_VOLUME);
+  unsigned char contenu[TAILLE_CONTENU_MAX];
+  char nom[32];
+  if (sf == NULL) {
+    return NULL;
+  }
+  memset(contenu, 'x', TAILLE_CONTENU_MAX);
+  for (long i = 0; i < nbFichiers; i++) {
+    snprintf(nom, sizeof(nom), "fichier%07ld", i);
+    int descripteur = OuvrirSF(sf, nom, OUVERTURE_ECRITURE | OUVERTURE_CREATION);
+    if (descripteur < 0 || EcrireSF(sf, descripteur, contenu, 1 + i % TAILLE_CONTENU_MAX) < 0) {
+      DetruireSF(&sf);
+      return NULL;
+    }
+    FermerSF(sf, descripteur);
+  }
+  return sf;
+}
+
+// fonction auxiliaire qui mesure le meilleur temps de Ls, sortie standard envoyée vers /dev/null
+static double mesurerLs(tSF sf, bool detail, int *pResultat) {
+  double meilleure = -1;
+  fflush(stdout);
+  int sortie = dup(STDOUT_FILENO);
+  if (sortie < 0 || freopen("/dev/null", "w", stdout) == NULL) {
+    *pResultat = -1;
+    return 0;
+  }
+  for (int essai = 0; essai < NB_ESSAIS; essai++) {
+    double debut = Chronometre();
+    if (Ls(sf, detail) != 0) {
+      *pResultat = -1;
+    }
+    fflush(stdout);
+    double duree = Chronometre() - debut;
+    if (meilleure < 0 || duree < meilleure) {
+      meilleure = duree;
+    }
+  }
+  dup2(sortie, STDOUT_FILENO);
+  close(sortie);
+  return meilleure;
+}
+
+int main(int argc, char *argv[]) {
+  long nbFichiers = (argc > 1) ? atol(argv[1]) : NB_FICHIERS_DEFAUT;
+  char *nomSauvegarde = (argc > 2) ? argv[2] : NULL;
+  if (nbFichiers <= 0) {
+    fprintf(stderr, "Usage : %s [nombre de fichiers] [sauvegarde à charger, ou à écrire si elle n'existe pas]\n",
+            argv[0]);
+    return 1;
+  }
+
+  tSF sf = NULL;
+  FILE *existante = (nomSauvegarde != NULL) ? fopen(nomSauvegarde, "rb") : NULL;
+  double debut = Chronometre();
+  if (existante != NULL) {
+    fclose(existante);
+    if (ChargerSF(&sf, nomSauvegarde) != 0) {
+      return 1;
+    }
+    printf("Volume charge depuis %s en %.3f s\n", nomSauvegarde, Chronometre() - debut);
+  } else {
+    sf = construireVolume(nbFichiers);
+    if (sf == NULL) {
+      fprintf(stderr, "ERREUR: construction du volume\n");
+      return 1;
+    }
+    printf("Volume de %ld fichiers construit en %.3f s\n", nbFichiers, Chronometre() - debut);
+    if (nomSauvegarde != NULL && SauvegarderSF(sf, nomSauvegarde) != 0) {
+      DetruireSF(&sf);
+      return 1;
+    }
+  }
+
+  int resultat = 0;
+  double detail = mesurerLs(sf, true, &resultat);
+  double simple = mesurerLs(sf, false, &resultat);
+  printf("Ls(detail) %.3f s, Ls %.3f s (meilleur de %d affichages)\n", detail, simple, NB_ESSAIS);
+  if (resultat != 0) {
+    fprintf(stderr, "ERREUR: Ls a echoue\n");
+  }
+
+  DetruireSF(&sf);
+  return resultat != 0;
+}
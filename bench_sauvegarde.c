@@ -0,0 +1,204 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : bench_sauvegarde.c
+ * Banc d'essai de la sauvegarde et du chargement d'un grand nombre de petits inodes (1 à 150 octets,
+ * en ligne ou dans des blocs) : inode complet (SauvegarderInode / ChargerInode), puis métadonnées
+ * seules avec le disque (SauvegarderDisque et SauvegarderMetaInode, chemin de SauvegarderSF).
+ * Les données relues sont comparées à celles écrites.
+ * Usage : ./bench_sauvegarde [nombre d'inodes]
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "disque.h"
+#include "inode.h"
+#include "mesure.h"
+
+// Nombre d'inodes par défaut, et taille maximale de leur contenu
+#define NB_INODES_DEFAUT 100000L
+#define TAILLE_CONTENU_MAX 150
+
+// Nombre de mesures de chaque sauvegarde (la meilleure est retenue)
+#define NB_ESSAIS 5
+
+// Fichier utilisé par le banc d'essai (effacé à la fin)
+#define NOM_SAUVEGARDE "bench_sauvegarde.sav"
+
+// fonction auxiliaire qui retourne la taille du contenu de l'inode i
+static long tailleContenu(long i) {
+  return 1 + i % TAILLE_CONTENU_MAX;
+}
+
+// fonction auxiliaire qui crée les inodes sur un disque, chacun rempli d'un octet qui dépend de son numéro
+static tInode *creerInodes(long nbInodes, tDisque disque) {
+  tInode *inodes = malloc(nbInodes * sizeof(tInode));
+  unsigned char contenu[TAILLE_CONTENU_MAX];
+  if (inodes == NULL) {
+    return NULL;
+  }
+  for (long i = 0; i < nbInodes; i++) {
+    inodes[i] = CreerInode((int)i, ORDINAIRE);
+    if (inodes[i] == NULL) {
+      return NULL;
+    }
+    AssocierDisqueInode(inodes[i], disque);
+    memset(contenu, (int)(i % 251), tailleContenu(i));
+    EcrireDonneesInode(inodes[i], contenu, tailleContenu(i), 0);
+  }
+  return inodes;
+}
+
+// fonction auxiliaire qui détruit les inodes
+static void detruireInodes(tInode *inodes, long nbInodes) {
+  for (long i = 0; i < nbInodes; i++) {
+    DetruireInode(&inodes[i]);
+  }
+  free(inodes);
+}
+
+// fonction auxiliaire qui vérifie le contenu des inodes rechargés (0 si identiques, -1 sinon)
+static int verifierInodes(tInode *inodes, long nbInodes) {
+  unsigned char lu[TAILLE_CONTENU_MAX + 1];
+  for (long i = 0; i < nbInodes; i++) {
+    long taille = tailleContenu(i);
+    if (inodes[i] == NULL || Taille(inodes[i]) != taille
+        || LireDonneesInode(inodes[i], lu, taille + 1, 0) != taille) {
+      return -1;
+    }
+    for (long k = 0; k < taille; k++) {
+      if (lu[k] != (unsigned char)(i % 251)) {
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+// fonction auxiliaire qui mesure la sauvegarde (fermeture du fichier comprise) puis le chargement
+// des inodes complets, blocs sur le disque par défaut ; retourne 0 si les contenus rechargés sont identiques
+static int mesurerInodes(long nbInodes) {
+  tDisque disque = DisqueParDefaut();
+  tInode *inodes = creerInodes(nbInodes, disque);
+  if (inodes == NULL) {
+    fprintf(stderr, "ERREUR: creation des inodes\n");
+    return -1;
+  }
+
+  double meilleure = -1;
+  for (int essai = 0; essai < NB_ESSAIS; essai++) {
+    double debut = Chronometre();
+    FILE *fichier = fopen(NOM_SAUVEGARDE, "wb");
+    if (fichier == NULL) {
+      detruireInodes(inodes, nbInodes);
+      return -1;
+    }
+    for (long i = 0; i < nbInodes; i++) {
+      SauvegarderInode(inodes[i], fichier);
+    }
+    fclose(fichier);
+    double duree = Chronometre() - debut;
+    if (meilleure < 0 || duree < meilleure) {
+      meilleure = duree;
+    }
+  }
+  detruireInodes(inodes, nbInodes);
+
+  inodes = calloc(nbInodes, sizeof(tInode));
+  FILE *fichier = fopen(NOM_SAUVEGARDE, "rb");
+  if (inodes == NULL || fichier == NULL) {
+    free(inodes);
+    return -1;
+  }
+  double debut = Chronometre();
+  for (long i = 0; i < nbInodes; i++) {
+    ChargerInode(&inodes[i], fichier);
+  }
+  double chargement = Chronometre() - debut;
+  fclose(fichier);
+
+  int resultat = verifierInodes(inodes, nbInodes);
+  printf("%-28s %12.1f %12.1f %12.1f\n", "SauvegarderInode", meilleure * 1000, chargement * 1000,
+         nbInodes / meilleure / 1000);
+  detruireInodes(inodes, nbInodes);
+  return resultat;
+}
+
+// fonction auxiliaire qui mesure la sauvegarde du disque suivie des métadonnées des inodes,
+// puis le chargement ; retourne 0 si les contenus rechargés sont identiques
+static int mesurerMetaInodes(long nbInodes) {
+  tDisque disque = CreerDisque(TAILLE_BLOC);
+  tInode *inodes = (disque != NULL) ? creerInodes(nbInodes, disque) : NULL;
+  if (inodes == NULL) {
+    fprintf(stderr, "ERREUR: creation des inodes\n");
+    DetruireDisque(&disque);
+    return -1;
+  }
+
+  double meilleure = -1;
+  for (int essai = 0; essai < NB_ESSAIS; essai++) {
+    double debut = Chronometre();
+    FILE *fichier = fopen(NOM_SAUVEGARDE, "wb");
+    if (fichier == NULL) {
+      detruireInodes(inodes, nbInodes);
+      DetruireDisque(&disque);
+      return -1;
+    }
+    SauvegarderDisque(disque, fichier);
+    for (long i = 0; i < nbInodes; i++) {
+      SauvegarderMetaInode(inodes[i], fichier);
+    }
+    fclose(fichier);
+    double duree = Chronometre() - debut;
+    if (meilleure < 0 || duree < meilleure) {
+      meilleure = duree;
+    }
+  }
+  detruireInodes(inodes, nbInodes);
+  DetruireDisque(&disque);
+
+  inodes = calloc(nbInodes, sizeof(tInode));
+  FILE *fichier = fopen(NOM_SAUVEGARDE, "rb");
+  if (inodes == NULL || fichier == NULL) {
+    free(inodes);
+    return -1;
+  }
+  double debut = Chronometre();
+  if (ChargerDisque(&disque, fichier) == 0) {
+    for (long i = 0; i < nbInodes; i++) {
+      ChargerMetaInode(&inodes[i], fichier, disque);
+    }
+  }
+  double chargement = Chronometre() - debut;
+  fclose(fichier);
+
+  int resultat = verifierInodes(inodes, nbInodes);
+  printf("%-28s %12.1f %12.1f %12.1f\n", "SauvegarderDisque+MetaInode", meilleure * 1000, chargement * 1000,
+         nbInodes / meilleure / 1000);
+  detruireInodes(inodes, nbInodes);
+  DetruireDisque(&disque);
+  return resultat;
+}
+
+int main(int argc, char *argv[]) {
+  long nbInodes = (argc > 1) ? atol(argv[1]) : NB_INODES_DEFAUT;
+  if (nbInodes <= 0 || nbInodes > 10000000) {
+    fprintf(stderr, "Usage : %s [nombre d'inodes]\n", argv[0]);
+    return 1;
+  }
+
+  printf("%ld inodes de 1 a %d octets, blocs de %d octets (meilleure de %d sauvegardes)\n\n", nbInodes,
+         TAILLE_CONTENU_MAX, TAILLE_BLOC, NB_ESSAIS);
+  printf("%-28s %12s %12s %12s\n", "sauvegarde", "ecrire (ms)", "charger (ms)", "kinodes/s");
+  int erreur = mesurerInodes(nbInodes) | mesurerMetaInodes(nbInodes);
+  if (erreur != 0) {
+    fprintf(stderr, "ERREUR: donnees rechargees differentes\n");
+  }
+
+  remove(NOM_SAUVEGARDE);
+  return erreur != 0;
+}
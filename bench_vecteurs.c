@@ -0,0 +1,145 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : bench_vecteurs.c
+ * Banc d'essai des lectures et écritures vectorisées : de nombreux petits enregistrements, éparpillés au hasard
+ * ou qui se suivent, lus et écrits par un appel simple par enregistrement (LireDonneesInode, EcrireDonneesInode)
+ * ou en un seul appel (LireDonneesInodeV, EcrireDonneesInodeV). Les contenus obtenus sont comparés.
+ * Usage : ./bench_vecteurs [nombre de segments] [taille des segments]
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "disque.h"
+#include "inode.h"
+#include "mesure.h"
+
+// Nombre et taille des segments par défaut
+#define NB_SEGMENTS_DEFAUT 100000L
+#define TAILLE_SEGMENT_DEFAUT 16
+
+// Taille du fichier et de ses blocs
+#define TAILLE_FICHIER (4L << 20)
+#define TAILLE_BLOC_BANC 4096
+
+// fonction auxiliaire qui crée un inode de TAILLE_FICHIER octets nuls sur son propre disque
+static tInode creerFichier(tDisque *pDisque) {
+  *pDisque = CreerDisque(TAILLE_BLOC_BANC);
+  tInode inode = CreerInode(1, ORDINAIRE);
+  unsigned char *zeros = calloc(TAILLE_FICHIER, 1);
+  if (*pDisque == NULL || inode == NULL || zeros == NULL) {
+    free(zeros);
+    return NULL;
+  }
+  AssocierDisqueInode(inode, *pDisque);
+  EcrireDonneesInode(inode, zeros, TAILLE_FICHIER, 0);
+  free(zeros);
+  return inode;
+}
+
+// fonction auxiliaire qui mesure les écritures puis les lectures des segments, appel par appel
+// et en un seul appel vectorisé, et affiche une ligne de résultats ; retourne 0 si les deux fichiers
+// obtenus et les segments relus sont identiques, -1 sinon
+static int mesurer(const char *nom, struct sSegment segments[], long nbSegments, long tailleSegment,
+                   unsigned char *enregistrements) {
+  tDisque disqueSimple, disqueVectorise;
+  tInode simple = creerFichier(&disqueSimple);
+  tInode vectorise = creerFichier(&disqueVectorise);
+  unsigned char *lu = malloc(nbSegments * tailleSegment);
+  unsigned char *fichierSimple = malloc(TAILLE_FICHIER);
+  unsigned char *fichierVectorise = malloc(TAILLE_FICHIER);
+  if (simple == NULL || vectorise == NULL || lu == NULL || fichierSimple == NULL || fichierVectorise == NULL) {
+    fprintf(stderr, "ERREUR: allocation\n");
+    return -1;
+  }
+
+  double debut = Chronometre();
+  for (long i = 0; i < nbSegments; i++) {
+    EcrireDonneesInode(simple, segments[i].contenu, tailleSegment, segments[i].decalage);
+  }
+  double ecritureSimple = Chronometre() - debut;
+  debut = Chronometre();
+  long ecrits = EcrireDonneesInodeV(vectorise, segments, nbSegments);
+  double ecritureVectorisee = Chronometre() - debut;
+
+  debut = Chronometre();
+  for (long i = 0; i < nbSegments; i++) {
+    LireDonneesInode(simple, lu + i * tailleSegment, tailleSegment, segments[i].decalage);
+  }
+  double lectureSimple = Chronometre() - debut;
+  // les segments lisent maintenant vers leurs zones d'origine, effacées
+  memset(enregistrements, 0, nbSegments * tailleSegment);
+  debut = Chronometre();
+  long lus = LireDonneesInodeV(vectorise, segments, nbSegments);
+  double lectureVectorisee = Chronometre() - debut;
+
+  int resultat = (ecrits == nbSegments * tailleSegment && lus == ecrits
+                  && memcmp(lu, enregistrements, nbSegments * tailleSegment) == 0
+                  && LireDonneesInode(simple, fichierSimple, TAILLE_FICHIER, 0) == TAILLE_FICHIER
+                  && LireDonneesInode(vectorise, fichierVectorise, TAILLE_FICHIER, 0) == TAILLE_FICHIER
+                  && memcmp(fichierSimple, fichierVectorise, TAILLE_FICHIER) == 0) ? 0 : -1;
+
+  printf("%-12s %14.1f %14.1f %14.1f %14.1f\n", nom, ecritureSimple / nbSegments * 1e9,
+         ecritureVectorisee / nbSegments * 1e9, lectureSimple / nbSegments * 1e9, lectureVectorisee / nbSegments * 1e9);
+
+  DetruireInode(&simple);
+  DetruireInode(&vectorise);
+  DetruireDisque(&disqueSimple);
+  DetruireDisque(&disqueVectorise);
+  free(lu);
+  free(fichierSimple);
+  free(fichierVectorise);
+  return resultat;
+}
+
+int main(int argc, char *argv[]) {
+  long nbSegments = (argc > 1) ? atol(argv[1]) : NB_SEGMENTS_DEFAUT;
+  long tailleSegment = (argc > 2) ? atol(argv[2]) : TAILLE_SEGMENT_DEFAUT;
+  if (nbSegments <= 0 || tailleSegment <= 0 || nbSegments * tailleSegment > TAILLE_FICHIER) {
+    fprintf(stderr, "Usage : %s [nombre de segments] [taille des segments] (au plus %ld octets en tout)\n",
+            argv[0], TAILLE_FICHIER);
+    return 1;
+  }
+
+  struct sSegment *segments = malloc(nbSegments * sizeof(struct sSegment));
+  unsigned char *enregistrements = malloc(nbSegments * tailleSegment);
+  if (segments == NULL || enregistrements == NULL) {
+    fprintf(stderr, "ERREUR: allocation\n");
+    return 1;
+  }
+  srand(1);
+  for (long i = 0; i < nbSegments * tailleSegment; i++) {
+    enregistrements[i] = (unsigned char)rand();
+  }
+
+  printf("%ld segments de %ld octets, fichier de %ld octets (ns par segment)\n\n", nbSegments, tailleSegment,
+         TAILLE_FICHIER);
+  printf("%-12s %14s %14s %14s %14s\n", "segments", "ecrire", "ecrire V", "lire", "lire V");
+  int erreur = 0;
+  for (int k = 0; k < 2; k++) {
+    // enregistrements éparpillés au hasard (certains se recouvrent), puis les uns à la suite des autres
+    long nbPlaces = TAILLE_FICHIER / tailleSegment;
+    for (long i = 0; i < nbSegments; i++) {
+      segments[i].contenu = enregistrements + i * tailleSegment;
+      segments[i].taille = tailleSegment;
+      segments[i].decalage = (k == 0) ? (((long)rand() * RAND_MAX + rand()) % nbPlaces) * tailleSegment
+                                      : i * tailleSegment;
+    }
+    erreur |= mesurer((k == 0) ? "eparpilles" : "consecutifs", segments, nbSegments, tailleSegment,
+                      enregistrements);
+    for (long i = 0; i < nbSegments * tailleSegment; i++) {
+      enregistrements[i] = (unsigned char)rand();
+    }
+  }
+  if (erreur != 0) {
+    fprintf(stderr, "ERREUR: contenus differents\n");
+  }
+
+  free(segments);
+  free(enregistrements);
+  return erreur != 0;
+}
@@ -6,167 +6,281 @@
  **/
 
 #include "bloc.h"
-#include <stdlib.h>
-#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
 
-/* V1
- * Crée et retourne un nouveau bloc de données.
- * Entrée : Aucune
- * Retour : le bloc créé ou NULL en cas de problème
+/* V5
+ * Indique si une taille de bloc est acceptable :
+ * une puissance de 2 comprise entre TAILLE_BLOC_MIN et TAILLE_BLOC_MAX.
+ * Entrée : la taille en octets
+ * Retour : true si la taille est valide, false sinon
  */
-tBloc CreerBloc (void) {
-  // alloue mémoire de taille TAILLE_BLOC octets pour un nouveau bloc de type tBloc
-  tBloc nouveauBloc = (tBloc)malloc(TAILLE_BLOC);
+bool TailleBlocValide(long tailleBloc) {
+  // dans les bornes, et un seul bit à 1
+  return tailleBloc >= TAILLE_BLOC_MIN && tailleBloc <= TAILLE_BLOC_MAX
+      && (tailleBloc & (tailleBloc - 1)) == 0;
+}
+
+/* ---------------------------------------------------------------------------
+ * Noyaux de copie : les copies de blocs sont sur le chemin de toutes les lectures
+ * et écritures des inodes. On choisit à l'exécution le meilleur noyau disponible
+ * sur le processeur (AVX2, puis SSE2), sinon une version portable (memcpy).
+ * ------------------------------------------------------------------------- */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COPIE_VECTORIELLE_X86
+#include <immintrin.h>
+// les noyaux utilisent les instructions de leur jeu, quelles que soient les options de compilation du module
+#define NOYAU_SSE2 __attribute__((target("sse2")))
+#define NOYAU_AVX2 __attribute__((target("avx2")))
+#endif
 
-  // en cas de problème d'allocation mémoire
-  if (nouveauBloc == NULL) {
-    fprintf(stderr, "CreerBloc : probleme creation\n"); // message erreur sur stderr
-    return NULL; // retourne NULL
+// Type d'un noyau de copie (les zones ne se chevauchent pas)
+typedef void (*tNoyauCopie)(unsigned char *destination, const unsigned char *source, long taille);
+
+// fonction auxiliaire qui copie moins de 16 octets (avec des accès qui peuvent se recouvrir)
+static void copierPetit(unsigned char *destination, const unsigned char *source, long taille) {
+  if (taille >= 8) {
+    uint64_t debut, fin;
+    memcpy(&debut, source, 8);
+    memcpy(&fin, source + taille - 8, 8);
+    memcpy(destination, &debut, 8);
+    memcpy(destination + taille - 8, &fin, 8);
+  } else if (taille >= 4) {
+    uint32_t debut, fin;
+    memcpy(&debut, source, 4);
+    memcpy(&fin, source + taille - 4, 4);
+    memcpy(destination, &debut, 4);
+    memcpy(destination + taille - 4, &fin, 4);
+  } else {
+    for (long i = 0; i < taille; i++) {
+      destination[i] = source[i];
+    }
   }
+}
 
-  // retourne nouveau bloc
-  return nouveauBloc;
+// noyau portable : on laisse faire la bibliothèque C
+static void copierOctetsPortable(unsigned char *destination, const unsigned char *source, long taille) {
+  memcpy(destination, source, taille);
 }
 
-/* V1
- * Détruit un bloc de données.
- * Entrée : le bloc à détruire (libération mémoire allouée)
- * Retour : aucun
- */
-void DetruireBloc(tBloc *pBloc) {
-  // vérifie que le pointeur et que le bloc pointé existe
-  if (pBloc != NULL && *pBloc != NULL) {
-    free(*pBloc); // libère la mémoire allouée
-    *pBloc = NULL; // positionne le bloc à NULL
+#ifdef COPIE_VECTORIELLE_X86
+// noyau SSE2, taille quelconque : paquets de 64 octets, puis de 16, le reste par un dernier vecteur qui recouvre le précédent
+NOYAU_SSE2
+static void copierOctetsSSE2(unsigned char *destination, const unsigned char *source, long taille) {
+  if (taille < 16) {
+    copierPetit(destination, source, taille);
+    return;
   }
-}
 
-/* V1
- * Copie dans un bloc les taille octets situés à l’adresse contenu.
- * Si taille est supérieure à la taille d’un bloc, seuls les TAILLE_BLOC premiers octets doivent être copiés.
- * Entrées : le bloc, l'adresse du contenu à copier et sa taille en octets
- * Retour : le nombre d'octets effectivement écrits dans le bloc
- */
-long EcrireContenuBloc (tBloc bloc, unsigned char *contenu, long taille) {
-  // verifie si bloc ou contenu NULL -> alors impossible d'écrire -> retourne 0 octet écrit
-  if (bloc == NULL || contenu == NULL) {
-    return 0;
+  long i = 0;
+  for (; i + 64 <= taille; i += 64) {
+    __m128i a = _mm_loadu_si128((const __m128i *)(source + i));
+    __m128i b = _mm_loadu_si128((const __m128i *)(source + i + 16));
+    __m128i c = _mm_loadu_si128((const __m128i *)(source + i + 32));
+    __m128i d = _mm_loadu_si128((const __m128i *)(source + i + 48));
+    _mm_storeu_si128((__m128i *)(destination + i), a);
+    _mm_storeu_si128((__m128i *)(destination + i + 16), b);
+    _mm_storeu_si128((__m128i *)(destination + i + 32), c);
+    _mm_storeu_si128((__m128i *)(destination + i + 48), d);
+  }
+  for (; i + 16 <= taille; i += 16) {
+    _mm_storeu_si128((__m128i *)(destination + i), _mm_loadu_si128((const __m128i *)(source + i)));
   }
+  if (i < taille) {
+    _mm_storeu_si128((__m128i *)(destination + taille - 16), _mm_loadu_si128((const __m128i *)(source + taille - 16)));
+  }
+}
 
-  // détermine le nombre d'octets à copier sans dépasser la taille du bloc (prend la plus petite des deux valeurs)
-  long octetsACopier = (taille > TAILLE_BLOC) ? TAILLE_BLOC : taille;
+// noyau SSE2, bloc entier : la taille est un multiple de 64, pas de reste à traiter
+NOYAU_SSE2
+static void copierBlocSSE2(unsigned char *destination, const unsigned char *source, long taille) {
+  for (long i = 0; i < taille; i += 64) {
+    __m128i a = _mm_loadu_si128((const __m128i *)(source + i));
+    __m128i b = _mm_loadu_si128((const __m128i *)(source + i + 16));
+    __m128i c = _mm_loadu_si128((const __m128i *)(source + i + 32));
+    __m128i d = _mm_loadu_si128((const __m128i *)(source + i + 48));
+    _mm_storeu_si128((__m128i *)(destination + i), a);
+    _mm_storeu_si128((__m128i *)(destination + i + 16), b);
+    _mm_storeu_si128((__m128i *)(destination + i + 32), c);
+    _mm_storeu_si128((__m128i *)(destination + i + 48), d);
+  }
+}
 
-  // copie octet par octet de contenu dans bloc
-  for (long i = 0; i < octetsACopier; i++) {
-    bloc[i] = contenu[i];
+// noyau AVX2, taille quelconque : paquets de 128 octets, puis de 32, le reste par un dernier vecteur qui recouvre le précédent
+NOYAU_AVX2
+static void copierOctetsAVX2(unsigned char *destination, const unsigned char *source, long taille) {
+  if (taille < 32) {
+    copierOctetsSSE2(destination, source, taille);
+    return;
   }
 
-  // retourne le nomre d'octets effectivement écrits dans le bloc
-  return octetsACopier;
+  long i = 0;
+  for (; i + 128 <= taille; i += 128) {
+    __m256i a = _mm256_loadu_si256((const __m256i *)(source + i));
+    __m256i b = _mm256_loadu_si256((const __m256i *)(source + i + 32));
+    __m256i c = _mm256_loadu_si256((const __m256i *)(source + i + 64));
+    __m256i d = _mm256_loadu_si256((const __m256i *)(source + i + 96));
+    _mm256_storeu_si256((__m256i *)(destination + i), a);
+    _mm256_storeu_si256((__m256i *)(destination + i + 32), b);
+    _mm256_storeu_si256((__m256i *)(destination + i + 64), c);
+    _mm256_storeu_si256((__m256i *)(destination + i + 96), d);
+  }
+  for (; i + 32 <= taille; i += 32) {
+    _mm256_storeu_si256((__m256i *)(destination + i), _mm256_loadu_si256((const __m256i *)(source + i)));
+  }
+  if (i < taille) {
+    _mm256_storeu_si256((__m256i *)(destination + taille - 32), _mm256_loadu_si256((const __m256i *)(source + taille - 32)));
+  }
 }
 
-/* V1
- * Copie à l'adresse contenu, les taille octets stockés dans un bloc.
- * Si taille est supérieure à la taille d’un bloc, seuls les TAILLE_BLOC premiers octets doivent être copiés.
- * Entrées : le bloc, l'adresse contenu à laquelle recopier et la taille en octets du bloc
- * Retour : le nombre d'octets effectivement lus dans le bloc
- */
-long LireContenuBloc(tBloc bloc, unsigned char *contenu, long taille) {
-  if (bloc == NULL || contenu == NULL) {
-    return 0;
+// noyau AVX2, bloc entier : la taille est un multiple de 64, pas de reste à traiter
+NOYAU_AVX2
+static void copierBlocAVX2(unsigned char *destination, const unsigned char *source, long taille) {
+  for (long i = 0; i < taille; i += 64) {
+    __m256i a = _mm256_loadu_si256((const __m256i *)(source + i));
+    __m256i b = _mm256_loadu_si256((const __m256i *)(source + i + 32));
+    _mm256_storeu_si256((__m256i *)(destination + i), a);
+    _mm256_storeu_si256((__m256i *)(destination + i + 32), b);
   }
+}
+#endif
 
-  long octetsACopier = (taille > TAILLE_BLOC) ? TAILLE_BLOC : taille;
+// Noyaux retenus pour ce processeur (choisis au premier appel)
+static tNoyauCopie noyauOctets = NULL;
+static tNoyauCopie noyauBloc = NULL;
 
-  for (long i = 0; i < octetsACopier; i++) {
-    contenu[i] = bloc[i]; // faut juste faire l'inverse car on extrait les données de bloc -> contenu au lieu de contenu -> bloc (EcrireContenuBloc)
+// fonction auxiliaire qui choisit les noyaux de copie selon le processeur
+static void choisirNoyauxCopie(void) {
+  noyauOctets = copierOctetsPortable;
+  noyauBloc = copierOctetsPortable;
+#ifdef COPIE_VECTORIELLE_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    noyauOctets = copierOctetsAVX2;
+    noyauBloc = copierBlocAVX2;
+  } else if (__builtin_cpu_supports("sse2")) {
+    noyauOctets = copierOctetsSSE2;
+    noyauBloc = copierBlocSSE2;
   }
-
-  return octetsACopier;
+#endif
 }
 
-/* V3
- * Sauvegarde les données d'un bloc en les écrivant dans un fichier (sur disque).
- * Entrées : le bloc à sauvegarder, sa taille en octets, le nom du fichier cible
- * Retour : 0 en cas de succès, -1 en cas d'erreur
+/* V5
+ * Copie des octets d'une zone vers une autre (les zones ne doivent pas se chevaucher).
+ * Entrées : la destination, la source, le nombre d'octets
+ * Retour : aucun
  */
-int SauvegarderBloc(tBloc bloc, long taille, FILE *fichier){
-  // erreur bloc
-  if (bloc == NULL) {
-    fprintf(stderr, "SauvegarderBloc : le bloc n'existe pas\n");
-    return -1;
+void CopierOctets(unsigned char *destination, const unsigned char *source, long taille) {
+  if (taille <= 0) {
+    return;
   }
-
-  // erreur fichier
-  if (fichier == NULL) {
-    fprintf(stderr, "SauvegarderBloc : le fichier n'existe pas (ou pas les permissions nécessaires)\n");
-    return -1;
+  if (noyauOctets == NULL) {
+    choisirNoyauxCopie();
   }
+  noyauOctets(destination, source, taille);
+}
 
-  // vérifier si taille pas supérieur à TAILLE_BLOC sinon on se limite au max
-  long tailleReelle = taille;
-  if (taille > TAILLE_BLOC) {
-    tailleReelle = TAILLE_BLOC;
-    printf("SauvegarderBloc : taille réduite à %ld octets (car max atteint)\n", tailleReelle);
+/* V5
+ * Copie un bloc entier (taille multiple de TAILLE_BLOC_MIN) d'une zone vers une autre.
+ * Entrées : la destination, la source, la taille du bloc
+ * Retour : aucun
+ */
+void CopierBlocEntier(unsigned char *destination, const unsigned char *source, long tailleBloc) {
+  // une taille qui n'est pas un multiple de TAILLE_BLOC_MIN passe par le noyau général
+  if (tailleBloc <= 0 || tailleBloc % TAILLE_BLOC_MIN != 0) {
+    CopierOctets(destination, source, tailleBloc);
+    return;
+  }
+  if (noyauBloc == NULL) {
+    choisirNoyauxCopie();
   }
+  noyauBloc(destination, source, tailleBloc);
+}
 
-  // écriture des données du bloc dans le fichier
-  size_t elementsEcrits = fwrite(bloc, 1, tailleReelle, fichier);
+/* ---------------------------------------------------------------------------
+ * Sommes de contrôle : CRC32C (polynôme de Castagnoli, celui de l'instruction crc32 de SSE4.2).
+ * Le noyau matériel traite 8 octets par instruction ; la version portable utilise une table
+ * de 256 entrées calculée au premier appel.
+ * ------------------------------------------------------------------------- */
 
-  // verifie que elementsEcrits = tailleReelle
-  if (elementsEcrits != (size_t)tailleReelle) {
-    fprintf(stderr, "SauvegarderBloc : erreur écriture (%lu/%ld éléments écrits)\n", elementsEcrits, tailleReelle);
-    return -1;
-  }
+// Polynôme CRC32C (forme réfléchie)
+#define POLYNOME_CRC32C 0x82F63B78u
 
-  // forcer écriture immédiate des données
-  if (fflush(fichier) != 0) {
-    fprintf(stderr, "SauvegarderBloc : erreur lors du fflush\n");
-    return -1;
-  }
+// Type d'un noyau de somme de contrôle (crc est la valeur en cours, déjà inversée)
+typedef uint32_t (*tNoyauSomme)(uint32_t crc, const unsigned char *contenu, long taille);
 
-  return 0;
-}
+// Table de la version portable (remplie au premier appel)
+static uint32_t tableCRC32C[256];
 
-/* V3
- * Charge dans un bloc les données lues dans un fichier (sur disque).
- * Entrées : le bloc dans lequel charger, la taille en octets du fichier contenant les données, son nom (sur le disque))
- * Retour : 0 en cas de succès, -1 en cas d'erreur
- */
-int ChargerBloc(tBloc bloc, long taille, FILE *fichier){
-  // erreur bloc
-  if (bloc == NULL) {
-    fprintf(stderr, "ChargerBloc : le bloc n'existe pas\n");
-    return -1;
+// fonction auxiliaire qui remplit la table de la version portable
+static void remplirTableCRC32C(void) {
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc = i;
+    for (int j = 0; j < 8; j++) {
+      crc = (crc & 1) ? (crc >> 1) ^ POLYNOME_CRC32C : crc >> 1;
+    }
+    tableCRC32C[i] = crc;
   }
+}
 
-  // erreur fichier
-  if (fichier == NULL) {
-    fprintf(stderr, "ChargerBloc : le fichier n'existe pas (ou pas les permissions nécessaires)\n");
-    return -1;
+// noyau portable : un octet à la fois avec la table
+static uint32_t sommePortable(uint32_t crc, const unsigned char *contenu, long taille) {
+  for (long i = 0; i < taille; i++) {
+    crc = tableCRC32C[(crc ^ contenu[i]) & 0xFF] ^ (crc >> 8);
   }
+  return crc;
+}
 
-  // vérifier qu'on est pas à la fin du fichier
-  if (feof(fichier)) {
-    fprintf(stderr, "ChargerBloc : fin de fichier atteinte\n");
-    return -1;
-  }
+#ifdef COPIE_VECTORIELLE_X86
+#define NOYAU_SSE42 __attribute__((target("sse4.2")))
 
-  // vérifier si taille pas supérieur à TAILLE_BLOC sinon on se limite au max
-  long tailleReelle = taille;
-  if (taille > TAILLE_BLOC) {
-    tailleReelle = TAILLE_BLOC;
-    printf("ChargerBloc : taille réduite à %ld octets (car max atteint)\n", tailleReelle);
+// noyau SSE4.2 : instruction crc32 sur 8 octets, puis octet par octet pour le reste
+NOYAU_SSE42
+static uint32_t sommeSSE42(uint32_t crc, const unsigned char *contenu, long taille) {
+  long i = 0;
+#ifdef __x86_64__
+  uint64_t crc64 = crc;
+  for (; i + 8 <= taille; i += 8) {
+    uint64_t mot;
+    memcpy(&mot, contenu + i, sizeof(mot));
+    crc64 = _mm_crc32_u64(crc64, mot);
   }
+  crc = (uint32_t)crc64;
+#endif
+  for (; i < taille; i++) {
+    crc = _mm_crc32_u8(crc, contenu[i]);
+  }
+  return crc;
+}
+#endif
 
-  // lecture des données depuis le fichier vers bloc
-  size_t elementsLus = fread(bloc, 1, tailleReelle, fichier);
+// Noyau retenu pour ce processeur (choisi au premier appel)
+static tNoyauSomme noyauSomme = NULL;
 
-  // verif que les éléments lus = taille réelle
-  if (elementsLus != (size_t)tailleReelle) {
-    fprintf(stderr, "ChargerBloc : erreur lecture (%lu/%ld éléments lus)\n", elementsLus, tailleReelle);
-    return -1;
+// fonction auxiliaire qui choisit le noyau de somme de contrôle selon le processeur
+static void choisirNoyauSomme(void) {
+  remplirTableCRC32C();
+  noyauSomme = sommePortable;
+#ifdef COPIE_VECTORIELLE_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse4.2")) {
+    noyauSomme = sommeSSE42;
   }
+#endif
+}
 
-  return 0;
+/* V5
+ * Calcule la somme de contrôle CRC32C d'une zone (instruction crc32 de SSE4.2 si le processeur l'a).
+ * Entrées : l'adresse de la zone, sa taille en octets
+ * Retour : la somme de contrôle
+ */
+uint32_t SommeControle(const unsigned char *contenu, long taille) {
+  if (noyauSomme == NULL) {
+    choisirNoyauSomme();
+  }
+  if (contenu == NULL || taille <= 0) {
+    return 0;
+  }
+  return ~noyauSomme(~UINT32_C(0), contenu, taille);
 }
@@ -3,61 +3,56 @@
  * VERSION 1
  * Fichier : bloc.h
  * Module de gestion des blocs de données.
- * Fournit des fonctions pour créer, détruire, lire et écrire des blocs de données de taille fixe.
+ * Fournit les tailles de bloc, et les noyaux de copie et de somme de contrôle des blocs de données
+ * (les blocs eux-mêmes sont dans la zone d'un disque, voir disque.h).
  **/
 #ifndef __BLOC_H__
 #define __BLOC_H__
 
 #include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
 
-// Taille d’un bloc en octets
+// Taille d’un bloc en octets (taille par défaut, un SF peut en choisir une autre à sa création)
 #define TAILLE_BLOC        64
 
-// Type public représentant un bloc de données
+// Tailles de bloc minimale et maximale autorisées (puissances de 2)
+#define TAILLE_BLOC_MIN    64
+#define TAILLE_BLOC_MAX    65536
+
+// Type public représentant l'adresse d'un bloc de données (dans la zone d'un disque, voir AdresseBlocDisque)
 typedef unsigned char *tBloc;
 
-/* V1
- * Crée et retourne un nouveau bloc de données.
- * Entrée : Aucune
- * Retour : le bloc créé ou NULL en cas de problème
+/* V5
+ * Indique si une taille de bloc est acceptable :
+ * une puissance de 2 comprise entre TAILLE_BLOC_MIN et TAILLE_BLOC_MAX.
+ * Entrée : la taille en octets
+ * Retour : true si la taille est valide, false sinon
  */
-extern tBloc CreerBloc (void);
+extern bool TailleBlocValide(long tailleBloc);
 
-/* V1
- * Détruit un bloc de données.
- * Entrée : le bloc à détruire (libération mémoire allouée)
+/* V5
+ * Copie des octets d'une zone vers une autre (les zones ne doivent pas se chevaucher).
+ * La copie utilise les instructions vectorielles du processeur (AVX2 ou SSE2, choisies à l'exécution)
+ * quand elles sont disponibles.
+ * Entrées : la destination, la source, le nombre d'octets
  * Retour : aucun
  */
-extern void DetruireBloc(tBloc *pBloc);
-
-/* V1
- * Copie dans un bloc les taille octets situés à l’adresse contenu.
- * Si taille est supérieure à la taille d’un bloc, seuls les TAILLE_BLOC premiers octets doivent être copiés.
- * Entrées : le bloc, l'adresse du contenu à copier et sa taille en octets
- * Retour : le nombre d'octets effectivement écrits dans le bloc
- */
-extern long EcrireContenuBloc (tBloc bloc, unsigned char *contenu, long taille);
+extern void CopierOctets(unsigned char *destination, const unsigned char *source, long taille);
 
-/* V1
- * Copie à l'adresse contenu, les taille octets stockés dans un bloc.
- * Si taille est supérieure à la taille d’un bloc, seuls les TAILLE_BLOC premiers octets doivent être copiés.
- * Entrées : le bloc, l'adresse contenu à laquelle recopier et la taille en octets du bloc
- * Retour : le nombre d'octets effectivement lus dans le bloc
- */
-extern long LireContenuBloc(tBloc bloc, unsigned char *contenu, long taille);
-
-/* V3
- * Sauvegarde les données d'un bloc en les écrivant dans un fichier (sur disque).
- * Entrées : le bloc à sauvegarder, sa taille en octets, le nom du fichier cible
- * Retour : 0 en cas de succès, -1 en cas d'erreur
+/* V5
+ * Copie un bloc entier d'une zone vers une autre (noyau spécialisé : pas de reste à traiter).
+ * Entrées : la destination, la source, la taille du bloc (multiple de TAILLE_BLOC_MIN)
+ * Retour : aucun
  */
-extern int SauvegarderBloc(tBloc bloc, long taille, FILE *fichier);
+extern void CopierBlocEntier(unsigned char *destination, const unsigned char *source, long tailleBloc);
 
-/* V3
- * Charge dans un bloc les données lues dans un fichier (sur disque).
- * Entrées : le bloc dans lequel charger, la taille en octets du fichier contenant les données, son nom (sur le disque))
- * Retour : 0 en cas de succès, -1 en cas d'erreur
+/* V5
+ * Calcule la somme de contrôle CRC32C d'une zone (polynôme de Castagnoli).
+ * Le calcul utilise l'instruction crc32 de SSE4.2 (choisie à l'exécution) quand elle est disponible.
+ * Entrées : l'adresse de la zone, sa taille en octets
+ * Retour : la somme de contrôle
  */
-extern int ChargerBloc(tBloc bloc, long taille, FILE *fichier);
+extern uint32_t SommeControle(const unsigned char *contenu, long taille);
 
 #endif
@@ -0,0 +1,630 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : cache.c
+ * Module de cache de blocs.
+ **/
+
+// pread, pwrite (POSIX)
+#define _POSIX_C_SOURCE 200809L
+
+#include "cache.h"
+#include "lot.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+// Alignement des données des cases (une page)
+#define ALIGNEMENT_CASES 4096
+
+// Pas de case (fin d'une chaîne de la table de hachage)
+#define CASE_NULLE (-1)
+
+// Nombre minimal de cases d'un cache
+#define NB_CASES_MIN 2
+
+// Nombre maximal de blocs d'un lot de lectures ou d'écritures (réécriture des blocs modifiés, lecture anticipée)
+#define NB_BLOCS_LOT 1024
+
+// Nombre maximal de blocs lus par anticipation après un défaut séquentiel (au plus le quart des cases)
+#define LECTURE_ANTICIPEE 32
+
+// Une case d'un lot de lectures ou d'écritures, avec son bloc
+struct sCaseLot
+{
+  tNumeroBloc numero;
+  long c;
+};
+
+// Une case du cache
+struct sCaseCache
+{
+  // Le bloc contenu (BLOC_NUL si la case est vide)
+  tNumeroBloc numero;
+  // Le bloc a-t-il été modifié depuis sa lecture ?
+  bool modifie;
+  // Le bloc a-t-il été utilisé depuis le dernier passage de l'aiguille (algorithme CLOCK) ?
+  bool reference;
+  // Le bloc, lu par anticipation, n'a pas encore été vérifié (fonction lu) ?
+  bool aVerifier;
+  // Nombre d'épinglages en cours (une case épinglée n'est jamais reprise)
+  int epingles;
+  // Case suivante dans la chaîne de la table de hachage (ou dans la liste des cases vides)
+  long suivante;
+};
+
+// Définition d'un cache de blocs
+struct sCacheBlocs
+{
+  // Le fichier image
+  int fd;
+  // La taille des blocs en octets
+  long tailleBloc;
+  // Les cases et leurs données (nbCases x tailleBloc octets)
+  long nbCases;
+  struct sCaseCache *cases;
+  unsigned char *donnees;
+  // Table de hachage numéro de bloc -> première case de la chaîne (taille puissance de 2)
+  long *table;
+  long masqueTable;
+  // Première case vide (chaînée par suivante), CASE_NULLE si toutes sont occupées
+  long premiereVide;
+  // L'aiguille de l'algorithme CLOCK : prochaine case examinée pour être reprise
+  long aiguille;
+  // La dernière case retournée (jamais reprise à la demande suivante)
+  long derniereCase;
+  // Le nombre de cases épinglées
+  long nbEpinglees;
+  // Le dernier bloc lu dans le fichier (un défaut sur le suivant déclenche la lecture anticipée)
+  tNumeroBloc dernierLu;
+  // Le lot des lectures et écritures soumises ensemble, et les cases concernées
+  tLotES lot;
+  struct sCaseLot *casesLot;
+  // Compteurs d'activité
+  tStatsCache stats;
+  // Fonctions appelées après la lecture et avant l'écriture d'un bloc
+  tBlocLuCache lu;
+  tBlocEcritCache ecrit;
+  void *contexte;
+};
+
+// fonction auxiliaire qui retourne l'entrée de la table de hachage d'un bloc
+static long *entreeTable(tCacheBlocs cache, tNumeroBloc numero) {
+  return &cache->table[(numero * UINT32_C(2654435761)) & cache->masqueTable];
+}
+
+// fonction auxiliaire qui retourne l'adresse des données d'une case
+static unsigned char *donneesCase(tCacheBlocs cache, long c) {
+  return cache->donnees + (size_t)c * cache->tailleBloc;
+}
+
+// fonction auxiliaire qui cherche la case d'un bloc, CASE_NULLE s'il n'est pas dans le cache
+static long chercherCase(tCacheBlocs cache, tNumeroBloc numero) {
+  for (long c = *entreeTable(cache, numero); c != CASE_NULLE; c = cache->cases[c].suivante) {
+    if (cache->cases[c].numero == numero) {
+      return c;
+    }
+  }
+  return CASE_NULLE;
+}
+
+// fonction auxiliaire qui retire une case de sa chaîne de la table de hachage
+static void retirerCase(tCacheBlocs cache, long c) {
+  long *lien = entreeTable(cache, cache->cases[c].numero);
+  while (*lien != c) {
+    lien = &cache->cases[*lien].suivante;
+  }
+  *lien = cache->cases[c].suivante;
+  cache->cases[c].numero = BLOC_NUL;
+  cache->cases[c].modifie = false;
+  cache->cases[c].reference = false;
+  cache->cases[c].aVerifier = false;
+}
+
+// fonction auxiliaire qui insère une case dans la table de hachage pour un bloc
+static void insererCase(tCacheBlocs cache, long c, tNumeroBloc numero) {
+  long *entree = entreeTable(cache, numero);
+  cache->cases[c].numero = numero;
+  cache->cases[c].suivante = *entree;
+  *entree = c;
+}
+
+// fonction auxiliaire qui réécrit une case modifiée dans le fichier image (0 si ok, -1 sinon)
+static int ecrireCase(tCacheBlocs cache, long c) {
+  struct sCaseCache *caseCache = &cache->cases[c];
+  if (!caseCache->modifie) {
+    return 0;
+  }
+
+  unsigned char *donnees = donneesCase(cache, c);
+  if (cache->ecrit != NULL) {
+    cache->ecrit(cache->contexte, caseCache->numero, donnees);
+  }
+
+  off_t position = (off_t)caseCache->numero * cache->tailleBloc;
+  long ecrit = 0;
+  while (ecrit < cache->tailleBloc) {
+    ssize_t n = pwrite(cache->fd, donnees + ecrit, cache->tailleBloc - ecrit, position + ecrit);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      fprintf(stderr, "cache : erreur écriture du bloc %u\n", caseCache->numero);
+      return -1;
+    }
+    ecrit += n;
+  }
+
+  caseCache->modifie = false;
+  cache->stats.ecritures++;
+  return 0;
+}
+
+// fonction auxiliaire qui lit un bloc du fichier image dans une case (0 si ok, -1 sinon) ;
+// la partie du bloc au-delà de la fin du fichier se lit à zéro (bloc jamais écrit)
+static int lireCase(tCacheBlocs cache, long c, tNumeroBloc numero) {
+  unsigned char *donnees = donneesCase(cache, c);
+  off_t position = (off_t)numero * cache->tailleBloc;
+  long lu = 0;
+  while (lu < cache->tailleBloc) {
+    ssize_t n = pread(cache->fd, donnees + lu, cache->tailleBloc - lu, position + lu);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      fprintf(stderr, "cache : erreur lecture du bloc %u\n", numero);
+      return -1;
+    }
+    if (n == 0) {
+      memset(donnees + lu, 0, cache->tailleBloc - lu);
+      break;
+    }
+    lu += n;
+  }
+  return 0;
+}
+
+// fonction auxiliaire qui choisit une case à reprendre et la libère (réécriture si elle a été modifiée) :
+// une case vide s'il y en a, sinon la première case non utilisée depuis le dernier passage de l'aiguille
+// (algorithme CLOCK, une seconde chance par utilisation) ; les cases déjà reprises pour une lecture
+// en cours (sans bloc) et les cases épinglées sont sautées ; retourne CASE_NULLE en cas d'erreur
+static long reprendreCase(tCacheBlocs cache) {
+  if (cache->premiereVide != CASE_NULLE) {
+    long c = cache->premiereVide;
+    cache->premiereVide = cache->cases[c].suivante;
+    return c;
+  }
+
+  // au plus deux tours : au second, toutes les références ont été effacées
+  long choisie;
+  for (;;) {
+    choisie = cache->aiguille;
+    cache->aiguille = (cache->aiguille + 1) % cache->nbCases;
+    if (choisie == cache->derniereCase || cache->cases[choisie].numero == BLOC_NUL
+        || cache->cases[choisie].epingles > 0) {
+      continue;
+    }
+    if (!cache->cases[choisie].reference) {
+      break;
+    }
+    cache->cases[choisie].reference = false;
+  }
+
+  if (ecrireCase(cache, choisie) != 0) {
+    return CASE_NULLE;
+  }
+  retirerCase(cache, choisie);
+  cache->stats.evictions++;
+  return choisie;
+}
+
+// fonction auxiliaire qui remet une case dans la liste des cases vides
+static void rendreCase(tCacheBlocs cache, long c) {
+  cache->cases[c].suivante = cache->premiereVide;
+  cache->premiereVide = c;
+}
+
+// fonction auxiliaire qui lit un bloc dans la case c avec, dans la même requête, les blocs suivants absents du cache
+// (jusqu'à la fin du fichier image) dans d'autres cases reprises ; seul le bloc demandé est vérifié tout de suite,
+// les autres le seront à leur première utilisation ; retourne 0 si ok, -1 sinon (la case c reste à rendre)
+static int lireAvecAnticipation(tCacheBlocs cache, long c, tNumeroBloc numero) {
+  // au plus le quart des cases qui peuvent être reprises
+  long fenetre = (cache->nbCases - cache->nbEpinglees) / 4;
+  if (fenetre > LECTURE_ANTICIPEE) {
+    fenetre = LECTURE_ANTICIPEE;
+  }
+  struct stat etat;
+  if (fstat(cache->fd, &etat) == 0) {
+    off_t finImage = (etat.st_size + cache->tailleBloc - 1) / cache->tailleBloc;
+    if ((off_t)numero + 1 + fenetre > finImage) {
+      fenetre = (finImage > (off_t)numero + 1) ? (long)(finImage - numero - 1) : 0;
+    }
+  }
+
+  long nb = 1;
+  AjouterLectureLotES(cache->lot, cache->fd, donneesCase(cache, c), cache->tailleBloc, (off_t)numero * cache->tailleBloc);
+  for (; nb <= fenetre && chercherCase(cache, numero + nb) == CASE_NULLE; nb++) {
+    long suivante = reprendreCase(cache);
+    if (suivante == CASE_NULLE) {
+      break;
+    }
+    ProlongerLotES(cache->lot, donneesCase(cache, suivante), cache->tailleBloc);
+    cache->casesLot[nb].c = suivante;
+  }
+
+  if (ExecuterLotES(cache->lot) != 0) {
+    fprintf(stderr, "cache : erreur lecture des blocs %u a %u\n", numero, numero + (tNumeroBloc)(nb - 1));
+    for (long i = 1; i < nb; i++) {
+      rendreCase(cache, cache->casesLot[i].c);
+    }
+    return -1;
+  }
+
+  // blocs anticipés : pas encore utilisés, les premiers repris si la lecture séquentielle s'arrête
+  for (long i = 1; i < nb; i++) {
+    long anticipee = cache->casesLot[i].c;
+    insererCase(cache, anticipee, numero + i);
+    cache->cases[anticipee].aVerifier = (cache->lu != NULL);
+  }
+  cache->stats.anticipes += nb - 1;
+  cache->dernierLu = numero + (tNumeroBloc)(nb - 1);
+
+  return (cache->lu == NULL || cache->lu(cache->contexte, numero, donneesCase(cache, c))) ? 0 : -1;
+}
+
+// fonction auxiliaire qui compare deux cases d'un lot par numéro de bloc (pour qsort)
+static int comparerCasesLot(const void *a, const void *b) {
+  tNumeroBloc na = ((const struct sCaseLot *)a)->numero;
+  tNumeroBloc nb = ((const struct sCaseLot *)b)->numero;
+  return (na > nb) - (na < nb);
+}
+
+// fonction auxiliaire qui réécrit les nb cases modifiées listées dans le lot, triées par numéro de bloc :
+// une seule requête par suite de blocs consécutifs ; les cases ne sont plus modifiées si tout s'est bien passé
+static int ecrireLot(tCacheBlocs cache, long nb) {
+  qsort(cache->casesLot, nb, sizeof(struct sCaseLot), comparerCasesLot);
+  for (long i = 0; i < nb; i++) {
+    tNumeroBloc numero = cache->casesLot[i].numero;
+    unsigned char *donnees = donneesCase(cache, cache->casesLot[i].c);
+    if (cache->ecrit != NULL) {
+      cache->ecrit(cache->contexte, numero, donnees);
+    }
+    if (i == 0 || numero != cache->casesLot[i - 1].numero + 1
+        || ProlongerLotES(cache->lot, donnees, cache->tailleBloc) != 0) {
+      AjouterEcritureLotES(cache->lot, cache->fd, donnees, cache->tailleBloc, (off_t)numero * cache->tailleBloc);
+    }
+  }
+
+  if (ExecuterLotES(cache->lot) != 0) {
+    fprintf(stderr, "cache : erreur écriture d'un lot de %ld blocs\n", nb);
+    return -1;
+  }
+
+  for (long i = 0; i < nb; i++) {
+    cache->cases[cache->casesLot[i].c].modifie = false;
+  }
+  cache->stats.ecritures += nb;
+  return 0;
+}
+
+/* V5
+ * Ouvre (ou crée) un fichier image et crée un cache de blocs devant lui.
+ * Entrées : le nom du fichier image, true pour le créer (vide), la taille des blocs, la mémoire des blocs en octets,
+ * les fonctions appelées après la lecture et avant l'écriture d'un bloc et leur contexte
+ * Retour : le cache créé, ou NULL en cas de problème
+ */
+tCacheBlocs OuvrirCacheBlocs(char nomFichier[], bool creer, long tailleBloc, long budget,
+                             tBlocLuCache lu, tBlocEcritCache ecrit, void *contexte) {
+  if (nomFichier == NULL || tailleBloc <= 0 || budget <= 0) {
+    fprintf(stderr, "OuvrirCacheBlocs : parametre invalide\n");
+    return NULL;
+  }
+
+  // au moins deux cases : deux blocs peuvent être utilisés ensemble
+  long nbCases = budget / tailleBloc;
+  if (nbCases < NB_CASES_MIN) {
+    nbCases = NB_CASES_MIN;
+  }
+
+  tCacheBlocs cache = (tCacheBlocs)malloc(sizeof(struct sCacheBlocs));
+  if (cache == NULL) {
+    fprintf(stderr, "OuvrirCacheBlocs : probleme creation\n");
+    return NULL;
+  }
+
+  // table de hachage : au moins deux entrées par case
+  long tailleTable = 1;
+  while (tailleTable < 2 * nbCases) {
+    tailleTable *= 2;
+  }
+
+  cache->tailleBloc = tailleBloc;
+  cache->nbCases = nbCases;
+  cache->masqueTable = tailleTable - 1;
+  cache->premiereVide = CASE_NULLE;
+  cache->aiguille = 0;
+  cache->derniereCase = CASE_NULLE;
+  cache->nbEpinglees = 0;
+  cache->stats.succes = 0;
+  cache->stats.defauts = 0;
+  cache->stats.evictions = 0;
+  cache->stats.ecritures = 0;
+  cache->stats.anticipes = 0;
+  cache->dernierLu = BLOC_NUL;
+  cache->lu = lu;
+  cache->ecrit = ecrit;
+  cache->contexte = contexte;
+  cache->cases = malloc(nbCases * sizeof(struct sCaseCache));
+  cache->table = malloc(tailleTable * sizeof(long));
+  cache->donnees = aligned_alloc(ALIGNEMENT_CASES,
+                                 (((size_t)nbCases * tailleBloc + ALIGNEMENT_CASES - 1) / ALIGNEMENT_CASES) * ALIGNEMENT_CASES);
+  cache->lot = CreerLotES(NB_BLOCS_LOT);
+  cache->casesLot = malloc(NB_BLOCS_LOT * sizeof(struct sCaseLot));
+  cache->fd = open(nomFichier, creer ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR, 0644);
+
+  if (cache->cases == NULL || cache->table == NULL || cache->donnees == NULL || cache->lot == NULL
+      || cache->casesLot == NULL || cache->fd < 0) {
+    fprintf(stderr, "OuvrirCacheBlocs : impossible d'ouvrir l'image %s\n", nomFichier);
+    if (cache->fd >= 0) {
+      close(cache->fd);
+    }
+    free(cache->cases);
+    free(cache->table);
+    free(cache->donnees);
+    DetruireLotES(&cache->lot);
+    free(cache->casesLot);
+    free(cache);
+    return NULL;
+  }
+
+  // toutes les cases sont vides, la case 0 en tête
+  for (long c = nbCases - 1; c >= 0; c--) {
+    cache->cases[c].numero = BLOC_NUL;
+    cache->cases[c].modifie = false;
+    cache->cases[c].reference = false;
+    cache->cases[c].aVerifier = false;
+    cache->cases[c].epingles = 0;
+    rendreCase(cache, c);
+  }
+  for (long i = 0; i < tailleTable; i++) {
+    cache->table[i] = CASE_NULLE;
+  }
+
+  return cache;
+}
+
+/* V5
+ * Détruit un cache : les blocs modifiés sont réécrits dans le fichier image, qui est fermé.
+ * Entrée : le cache à détruire
+ * Retour : aucun
+ */
+void DetruireCacheBlocs(tCacheBlocs *pCache) {
+  if (pCache == NULL || *pCache == NULL) {
+    return;
+  }
+
+  ViderCache(*pCache);
+  close((*pCache)->fd);
+  free((*pCache)->cases);
+  free((*pCache)->table);
+  free((*pCache)->donnees);
+  DetruireLotES(&(*pCache)->lot);
+  free((*pCache)->casesLot);
+  free(*pCache);
+  *pCache = NULL;
+}
+
+/* V5
+ * Retourne l'adresse en mémoire d'un bloc (lu dans le fichier image s'il n'est pas dans le cache).
+ * Un défaut sur le bloc qui suit le dernier bloc lu lit aussi, dans le même lot, les blocs suivants.
+ * Entrées : le cache, le numéro du bloc, le type d'accès
+ * Retour : l'adresse du bloc, NULL en cas d'erreur
+ */
+unsigned char *BlocCache(tCacheBlocs cache, tNumeroBloc numero, tAccesBloc acces) {
+  if (cache == NULL || numero == BLOC_NUL) {
+    return NULL;
+  }
+
+  long c = chercherCase(cache, numero);
+  if (c != CASE_NULLE) {
+    cache->stats.succes++;
+
+    // bloc lu par anticipation : vérifié à sa première utilisation (sauf s'il va être réécrit en entier)
+    if (cache->cases[c].aVerifier) {
+      cache->cases[c].aVerifier = false;
+      if (acces != ACCES_REMPLACEMENT && !cache->lu(cache->contexte, numero, donneesCase(cache, c))) {
+        retirerCase(cache, c);
+        rendreCase(cache, c);
+        return NULL;
+      }
+    }
+  } else {
+    cache->stats.defauts++;
+    c = reprendreCase(cache);
+    if (c == CASE_NULLE) {
+      return NULL;
+    }
+
+    // bloc lu dans l'image (sauf s'il va être réécrit en entier), avec les suivants si la lecture est séquentielle,
+    // et vérifié
+    if (acces != ACCES_REMPLACEMENT) {
+      int lecture;
+      if (numero == cache->dernierLu + 1) {
+        lecture = lireAvecAnticipation(cache, c, numero);
+      } else {
+        cache->dernierLu = numero;
+        lecture = (lireCase(cache, c, numero) != 0
+                   || (cache->lu != NULL && !cache->lu(cache->contexte, numero, donneesCase(cache, c)))) ? -1 : 0;
+      }
+      if (lecture != 0) {
+        rendreCase(cache, c);
+        return NULL;
+      }
+    }
+
+    insererCase(cache, c, numero);
+  }
+
+  cache->cases[c].reference = true;
+  cache->derniereCase = c;
+  if (acces != ACCES_LECTURE) {
+    cache->cases[c].modifie = true;
+  }
+
+  return donneesCase(cache, c);
+}
+
+/* V5
+ * Épingle un bloc dans le cache : il est lu s'il n'y est pas, et son adresse reste valable
+ * (sa case n'est pas reprise) jusqu'à DesepinglerBlocCache, quels que soient les blocs demandés entre-temps.
+ * Un bloc peut être épinglé plusieurs fois. L'épinglage est refusé s'il ne laisserait pas au moins
+ * deux cases au reste du cache.
+ * Entrées : le cache, le numéro du bloc
+ * Retour : l'adresse du bloc, NULL en cas d'erreur de lecture ou si l'épinglage est refusé
+ */
+const unsigned char *EpinglerBlocCache(tCacheBlocs cache, tNumeroBloc numero) {
+  if (cache == NULL) {
+    return NULL;
+  }
+
+  // une nouvelle case épinglée doit laisser au cache de quoi lire les autres blocs
+  long c = chercherCase(cache, numero);
+  bool nouvelle = (c == CASE_NULLE || cache->cases[c].epingles == 0);
+  if (nouvelle && cache->nbCases - cache->nbEpinglees <= NB_CASES_MIN) {
+    return NULL;
+  }
+
+  unsigned char *adresse = BlocCache(cache, numero, ACCES_LECTURE);
+  if (adresse == NULL) {
+    return NULL;
+  }
+  c = (adresse - cache->donnees) / cache->tailleBloc;
+  if (cache->cases[c].epingles++ == 0) {
+    cache->nbEpinglees++;
+  }
+
+  return adresse;
+}
+
+/* V5
+ * Relâche un épinglage d'un bloc (voir EpinglerBlocCache).
+ * Entrées : le cache, l'adresse retournée par EpinglerBlocCache
+ * Retour : aucun
+ */
+void DesepinglerBlocCache(tCacheBlocs cache, const unsigned char *adresse) {
+  if (cache == NULL || adresse < cache->donnees
+      || adresse >= cache->donnees + (size_t)cache->nbCases * cache->tailleBloc) {
+    return;
+  }
+
+  long c = (adresse - cache->donnees) / cache->tailleBloc;
+  if (cache->cases[c].epingles == 0 || --cache->cases[c].epingles > 0) {
+    return;
+  }
+  cache->nbEpinglees--;
+
+  // bloc libéré pendant qu'il était épinglé (voir OublierBlocCache) : la case redevient vide
+  if (cache->cases[c].numero == BLOC_NUL) {
+    rendreCase(cache, c);
+  }
+}
+
+/* V5
+ * Indique si un bloc est épinglé dans le cache.
+ * Entrées : le cache, le numéro du bloc
+ * Retour : true si le bloc est dans une case épinglée, false sinon
+ */
+bool BlocEpingleCache(tCacheBlocs cache, tNumeroBloc numero) {
+  if (cache == NULL) {
+    return false;
+  }
+
+  long c = chercherCase(cache, numero);
+  return c != CASE_NULLE && cache->cases[c].epingles > 0;
+}
+
+/* V5
+ * Retire un bloc du cache sans le réécrire (le bloc vient d'être libéré).
+ * Une case épinglée n'est rendue qu'au dernier DesepinglerBlocCache.
+ * Entrées : le cache, le numéro du bloc
+ * Retour : aucun
+ */
+void OublierBlocCache(tCacheBlocs cache, tNumeroBloc numero) {
+  if (cache == NULL) {
+    return;
+  }
+
+  long c = chercherCase(cache, numero);
+  if (c != CASE_NULLE) {
+    retirerCase(cache, c);
+    if (cache->cases[c].epingles == 0) {
+      rendreCase(cache, c);
+    }
+  }
+}
+
+/* V5
+ * Réécrit dans le fichier image tous les blocs modifiés du cache, par lots soumis ensemble
+ * (blocs triés, une requête par suite de blocs consécutifs).
+ * Entrée : le cache
+ * Retour : 0 en cas de succès, -1 en cas d'erreur d'écriture
+ */
+int ViderCache(tCacheBlocs cache) {
+  if (cache == NULL) {
+    return -1;
+  }
+
+  int resultat = 0;
+  long nb = 0;
+  for (long c = 0; c < cache->nbCases; c++) {
+    if (cache->cases[c].numero == BLOC_NUL || !cache->cases[c].modifie) {
+      continue;
+    }
+
+    cache->casesLot[nb].numero = cache->cases[c].numero;
+    cache->casesLot[nb].c = c;
+    nb++;
+    if (nb == NB_BLOCS_LOT) {
+      if (ecrireLot(cache, nb) != 0) {
+        resultat = -1;
+      }
+      nb = 0;
+    }
+  }
+  if (nb > 0 && ecrireLot(cache, nb) != 0) {
+    resultat = -1;
+  }
+
+  return resultat;
+}
+
+/* V5
+ * Retourne les compteurs d'activité d'un cache.
+ * Entrées : le cache, la structure où recopier les compteurs
+ * Retour : 0 en cas de succès, -1 si le cache n'existe pas
+ */
+int StatistiquesCache(tCacheBlocs cache, tStatsCache *stats) {
+  if (cache == NULL || stats == NULL) {
+    return -1;
+  }
+
+  *stats = cache->stats;
+  return 0;
+}
+
+/* V5
+ * Retourne la mémoire occupée par les blocs d'un cache.
+ * Entrée : le cache
+ * Retour : la taille en octets
+ */
+long TailleMemoireCache(tCacheBlocs cache) {
+  if (cache == NULL) {
+    return 0;
+  }
+
+  return cache->nbCases * cache->tailleBloc;
+}
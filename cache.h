@@ -0,0 +1,116 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : cache.h
+ * Module de cache de blocs.
+ * Les blocs d'un disque stocké dans un fichier image (bloc n à l'octet n x tailleBloc)
+ * sont lus (pread) et écrits (pwrite) par l'intermédiaire d'un nombre fixe de cases en mémoire (un budget en octets).
+ * Quand toutes les cases sont occupées, la case reprise est choisie par l'algorithme CLOCK
+ * (un bit de référence par case, une seconde chance pour chaque bloc utilisé).
+ * Un bloc modifié n'est réécrit dans le fichier que quand sa case est reprise, ou au vidage du cache.
+ **/
+#ifndef __CACHE_H__
+#define __CACHE_H__
+
+#include <stdbool.h>
+#include "disque.h"
+
+// Type public représentant un cache de blocs
+typedef struct sCacheBlocs *tCacheBlocs;
+
+// Les accès à un bloc du cache :
+// LECTURE : le bloc est lu, MODIFICATION : le bloc est lu puis modifié,
+// REMPLACEMENT : le bloc va être réécrit en entier (inutile de le lire dans le fichier)
+typedef enum
+{
+    ACCES_LECTURE,
+    ACCES_MODIFICATION,
+    ACCES_REMPLACEMENT
+} tAccesBloc;
+
+// Type d'une fonction appelée quand un bloc vient d'être lu dans le fichier :
+// elle retourne false si son contenu est invalide (le bloc n'est alors pas gardé dans le cache)
+typedef bool (*tBlocLuCache)(void *contexte, tNumeroBloc numero, const unsigned char *contenu);
+
+// Type d'une fonction appelée juste avant qu'un bloc modifié soit réécrit dans le fichier
+typedef void (*tBlocEcritCache)(void *contexte, tNumeroBloc numero, const unsigned char *contenu);
+
+/* V5
+ * Ouvre (ou crée) un fichier image et crée un cache de blocs devant lui.
+ * Entrées : le nom du fichier image, true pour le créer (vide), la taille des blocs,
+ * la mémoire des blocs du cache en octets (au moins deux blocs sont gardés),
+ * les fonctions appelées après la lecture et avant l'écriture d'un bloc (NULL si aucune) et leur contexte
+ * Retour : le cache créé, ou NULL en cas de problème
+ */
+extern tCacheBlocs OuvrirCacheBlocs(char nomFichier[], bool creer, long tailleBloc, long budget,
+                                    tBlocLuCache lu, tBlocEcritCache ecrit, void *contexte);
+
+/* V5
+ * Détruit un cache : les blocs modifiés sont réécrits dans le fichier image, qui est fermé.
+ * Entrée : le cache à détruire
+ * Retour : aucun
+ */
+extern void DetruireCacheBlocs(tCacheBlocs *pCache);
+
+/* V5
+ * Retourne l'adresse en mémoire d'un bloc (lu dans le fichier image s'il n'est pas dans le cache).
+ * L'adresse reste valable tant qu'au plus un autre bloc est demandé au cache.
+ * Entrées : le cache, le numéro du bloc, le type d'accès
+ * Retour : l'adresse du bloc, NULL en cas d'erreur de lecture ou de bloc invalide
+ */
+extern unsigned char *BlocCache(tCacheBlocs cache, tNumeroBloc numero, tAccesBloc acces);
+
+/* V5
+ * Épingle un bloc dans le cache : il est lu s'il n'y est pas, et son adresse reste valable
+ * (sa case n'est pas reprise) jusqu'à DesepinglerBlocCache, quels que soient les blocs demandés entre-temps.
+ * Un bloc peut être épinglé plusieurs fois. L'épinglage est refusé s'il ne laisserait pas au moins
+ * deux cases au reste du cache.
+ * Entrées : le cache, le numéro du bloc
+ * Retour : l'adresse du bloc, NULL en cas d'erreur de lecture ou si l'épinglage est refusé
+ */
+extern const unsigned char *EpinglerBlocCache(tCacheBlocs cache, tNumeroBloc numero);
+
+/* V5
+ * Relâche un épinglage d'un bloc (voir EpinglerBlocCache).
+ * Entrées : le cache, l'adresse retournée par EpinglerBlocCache
+ * Retour : aucun
+ */
+extern void DesepinglerBlocCache(tCacheBlocs cache, const unsigned char *adresse);
+
+/* V5
+ * Indique si un bloc est épinglé dans le cache.
+ * Entrées : le cache, le numéro du bloc
+ * Retour : true si le bloc est dans une case épinglée, false sinon
+ */
+extern bool BlocEpingleCache(tCacheBlocs cache, tNumeroBloc numero);
+
+/* V5
+ * Retire un bloc du cache sans le réécrire (le bloc vient d'être libéré).
+ * Une case épinglée n'est rendue qu'au dernier DesepinglerBlocCache.
+ * Entrées : le cache, le numéro du bloc
+ * Retour : aucun
+ */
+extern void OublierBlocCache(tCacheBlocs cache, tNumeroBloc numero);
+
+/* V5
+ * Réécrit dans le fichier image tous les blocs modifiés du cache (ils restent dans le cache).
+ * Entrée : le cache
+ * Retour : 0 en cas de succès, -1 en cas d'erreur d'écriture
+ */
+extern int ViderCache(tCacheBlocs cache);
+
+/* V5
+ * Retourne les compteurs d'activité d'un cache (voir tStatsCache).
+ * Entrées : le cache, la structure où recopier les compteurs
+ * Retour : 0 en cas de succès, -1 si le cache n'existe pas
+ */
+extern int StatistiquesCache(tCacheBlocs cache, tStatsCache *stats);
+
+/* V5
+ * Retourne la mémoire occupée par les blocs d'un cache.
+ * Entrée : le cache
+ * Retour : la taille en octets
+ */
+extern long TailleMemoireCache(tCacheBlocs cache);
+
+#endif
@@ -0,0 +1,218 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : compression.c
+ * Module de compression des données.
+ *
+ * Format d'une séquence :
+ *   - un octet jeton : 4 bits de poids fort = nombre de littéraux, 4 bits de poids faible = longueur de la répétition - 4
+ *     (la valeur 15 indique que la longueur continue sur les octets suivants, par tranches de 255)
+ *   - les littéraux
+ *   - la distance de la répétition sur 2 octets (poids faible d'abord), absente pour la dernière séquence
+ **/
+
+#include "compression.h"
+#include <stdint.h>
+#include <string.h>
+
+// Longueur minimale d'une répétition
+#define REPETITION_MIN 4
+
+// Distance maximale d'une répétition (sur 2 octets)
+#define DISTANCE_MAX 65535
+
+// Nombre de bits maximal et minimal de la table de hachage des chaînes de 4 octets
+// (la table est dimensionnée d'après la taille des données : pas la peine de vider 4096 cases pour 256 octets)
+#define BITS_HACHAGE_MAX 12
+#define BITS_HACHAGE_MIN 6
+
+// fonction auxiliaire qui lit 4 octets (sans contrainte d'alignement)
+static uint32_t lire32(const unsigned char *p) {
+  uint32_t mot;
+  memcpy(&mot, p, sizeof(mot));
+  return mot;
+}
+
+// fonction auxiliaire qui hache 4 octets sur un nombre de bits donné
+static uint32_t hacher(uint32_t mot, int bits) {
+  return (mot * UINT32_C(2654435761)) >> (32 - bits);
+}
+
+// fonction auxiliaire qui écrit la suite d'une longueur (tranches de 255), retourne la position après, -1 si plus de place
+static long ecrireLongueur(unsigned char *destination, long position, long capacite, long reste) {
+  while (reste >= 255) {
+    if (position >= capacite) {
+      return -1;
+    }
+    destination[position++] = 255;
+    reste -= 255;
+  }
+  if (position >= capacite) {
+    return -1;
+  }
+  destination[position++] = (unsigned char)reste;
+  return position;
+}
+
+// fonction auxiliaire qui écrit une séquence (littéraux puis répétition si longueur > 0),
+// retourne la position après, -1 si plus de place
+static long ecrireSequence(unsigned char *destination, long position, long capacite,
+                           const unsigned char *litteraux, long nbLitteraux, long distance, long longueur) {
+  if (position >= capacite) {
+    return -1;
+  }
+
+  long jeton = position++;
+  long codeLongueur = (longueur > 0) ? longueur - REPETITION_MIN : 0;
+  destination[jeton] = (unsigned char)(((nbLitteraux < 15 ? nbLitteraux : 15) << 4) | (codeLongueur < 15 ? codeLongueur : 15));
+
+  // nombre de littéraux, puis les littéraux
+  if (nbLitteraux >= 15 && (position = ecrireLongueur(destination, position, capacite, nbLitteraux - 15)) < 0) {
+    return -1;
+  }
+  if (position + nbLitteraux > capacite) {
+    return -1;
+  }
+  memcpy(destination + position, litteraux, nbLitteraux);
+  position += nbLitteraux;
+
+  // répétition : distance puis suite de la longueur
+  if (longueur > 0) {
+    if (position + 2 > capacite) {
+      return -1;
+    }
+    destination[position++] = (unsigned char)(distance & 0xFF);
+    destination[position++] = (unsigned char)(distance >> 8);
+    if (codeLongueur >= 15 && (position = ecrireLongueur(destination, position, capacite, codeLongueur - 15)) < 0) {
+      return -1;
+    }
+  }
+
+  return position;
+}
+
+/* V5
+ * Compresse une zone mémoire (recherche gloutonne des répétitions avec une table de hachage des chaînes de 4 octets).
+ * Entrées : la zone à compresser et sa taille, la zone destination et sa capacité en octets
+ * Retour : la taille des données compressées, -1 si elles ne tiennent pas dans la destination
+ */
+long CompresserLZ(const unsigned char *source, long taille, unsigned char *destination, long capacite) {
+  if (source == NULL || destination == NULL || taille < 0) {
+    return -1;
+  }
+
+  // dernière position vue de chaque chaîne de 4 octets (+1, 0 = jamais vue) : environ une case par octet
+  int bits = BITS_HACHAGE_MIN;
+  while (bits < BITS_HACHAGE_MAX && (1L << bits) < taille) {
+    bits++;
+  }
+  long table[1 << BITS_HACHAGE_MAX];
+  memset(table, 0, sizeof(long) << bits);
+
+  long position = 0; // position dans la destination
+  long debutLitteraux = 0; // début des littéraux en attente
+  long i = 0;
+
+  while (i + REPETITION_MIN <= taille) {
+    uint32_t h = hacher(lire32(source + i), bits);
+    long candidat = table[h] - 1;
+    table[h] = i + 1;
+
+    // pas de répétition à cette position
+    if (candidat < 0 || i - candidat > DISTANCE_MAX || lire32(source + candidat) != lire32(source + i)) {
+      i++;
+      continue;
+    }
+
+    // on prolonge la répétition au maximum
+    long longueur = REPETITION_MIN;
+    while (i + longueur < taille && source[candidat + longueur] == source[i + longueur]) {
+      longueur++;
+    }
+
+    position = ecrireSequence(destination, position, capacite, source + debutLitteraux, i - debutLitteraux, i - candidat, longueur);
+    if (position < 0) {
+      return -1;
+    }
+    i += longueur;
+    debutLitteraux = i;
+  }
+
+  // dernière séquence : les littéraux restants
+  return ecrireSequence(destination, position, capacite, source + debutLitteraux, taille - debutLitteraux, 0, 0);
+}
+
+// fonction auxiliaire qui lit la suite d'une longueur, retourne -1 si les données sont tronquées
+static long lireLongueur(const unsigned char *source, long taille, long *position, long longueur) {
+  unsigned char octet;
+  do {
+    if (*position >= taille) {
+      return -1;
+    }
+    octet = source[(*position)++];
+    longueur += octet;
+  } while (octet == 255);
+  return longueur;
+}
+
+/* V5
+ * Décompresse une zone compressée par CompresserLZ (toutes les longueurs et distances sont vérifiées).
+ * Entrées : les données compressées et leur taille, la zone destination et sa capacité en octets
+ * Retour : la taille des données décompressées, -1 si les données sont invalides ou trop grandes
+ */
+long DecompresserLZ(const unsigned char *source, long taille, unsigned char *destination, long capacite) {
+  if (source == NULL || destination == NULL || taille < 0) {
+    return -1;
+  }
+
+  long position = 0; // position dans la source
+  long produit = 0; // nombre d'octets décompressés
+
+  while (position < taille) {
+    unsigned char jeton = source[position++];
+
+    // littéraux
+    long nbLitteraux = jeton >> 4;
+    if (nbLitteraux == 15 && (nbLitteraux = lireLongueur(source, taille, &position, nbLitteraux)) < 0) {
+      return -1;
+    }
+    if (nbLitteraux > taille - position || nbLitteraux > capacite - produit) {
+      return -1;
+    }
+    memcpy(destination + produit, source + position, nbLitteraux);
+    position += nbLitteraux;
+    produit += nbLitteraux;
+
+    // dernière séquence : pas de répétition
+    if (position == taille) {
+      break;
+    }
+
+    // répétition
+    if (position + 2 > taille) {
+      return -1;
+    }
+    long distance = source[position] | (source[position + 1] << 8);
+    position += 2;
+    long longueur = jeton & 0x0F;
+    if (longueur == 15 && (longueur = lireLongueur(source, taille, &position, longueur)) < 0) {
+      return -1;
+    }
+    longueur += REPETITION_MIN;
+    if (distance == 0 || distance > produit || longueur > capacite - produit) {
+      return -1;
+    }
+
+    // copie d'un bloc si la répétition ne recouvre pas ce qu'elle produit, octet par octet sinon
+    if (distance >= longueur) {
+      memcpy(destination + produit, destination + produit - distance, longueur);
+    } else {
+      for (long k = 0; k < longueur; k++) {
+        destination[produit + k] = destination[produit - distance + k];
+      }
+    }
+    produit += longueur;
+  }
+
+  return produit;
+}
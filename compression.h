@@ -0,0 +1,26 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : compression.h
+ * Module de compression des données (codec de la famille LZ77, sans dépendance externe).
+ * Les données sont découpées en séquences : des littéraux (octets recopiés tels quels)
+ * suivis d'une répétition (distance et longueur d'une chaîne déjà vue).
+ **/
+#ifndef __COMPRESSION_H__
+#define __COMPRESSION_H__
+
+/* V5
+ * Compresse une zone mémoire.
+ * Entrées : la zone à compresser et sa taille, la zone destination et sa capacité en octets
+ * Retour : la taille des données compressées, -1 si elles ne tiennent pas dans la destination
+ */
+extern long CompresserLZ(const unsigned char *source, long taille, unsigned char *destination, long capacite);
+
+/* V5
+ * Décompresse une zone compressée par CompresserLZ.
+ * Entrées : les données compressées et leur taille, la zone destination et sa capacité en octets
+ * Retour : la taille des données décompressées, -1 si les données sont invalides ou trop grandes
+ */
+extern long DecompresserLZ(const unsigned char *source, long taille, unsigned char *destination, long capacite);
+
+#endif
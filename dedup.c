@@ -0,0 +1,254 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : dedup.c
+ * Module de déduplication des blocs.
+ **/
+
+#include "dedup.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Capacité initiale de la table (puissance de 2)
+#define CAPACITE_INDEX_INITIALE 256
+
+// Constantes de mélange du hachage (celles de xxHash64)
+#define PREMIER1 UINT64_C(0x9E3779B185EBCA87)
+#define PREMIER2 UINT64_C(0xC2B2AE3D27D4EB4F)
+#define PREMIER3 UINT64_C(0x165667B19E3779F9)
+#define PREMIER4 UINT64_C(0x85EBCA77C2B2AE63)
+#define PREMIER5 UINT64_C(0x27D4EB2F165667C5)
+
+// Une case de la table : numero == BLOC_NUL pour une case vide
+struct sEntreeDedup
+{
+  uint64_t empreinte;
+  tNumeroBloc numero;
+};
+
+// Définition d'un index : table à adressage ouvert (sondage linéaire)
+struct sIndexDedup
+{
+  // Les cases de la table
+  struct sEntreeDedup *table;
+  // Nombre de cases (puissance de 2)
+  long capacite;
+  // Nombre de cases occupées
+  long nbEntrees;
+};
+
+// fonction auxiliaire de rotation à gauche
+static uint64_t rotation(uint64_t x, int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+// fonction auxiliaire qui lit un mot de 8 octets (sans contrainte d'alignement)
+static uint64_t lireMot(const unsigned char *p) {
+  uint64_t mot;
+  memcpy(&mot, p, sizeof(mot));
+  return mot;
+}
+
+// fonction auxiliaire qui mélange un mot dans un accumulateur
+static uint64_t tour(uint64_t acc, uint64_t mot) {
+  acc += mot * PREMIER2;
+  acc = rotation(acc, 31);
+  return acc * PREMIER1;
+}
+
+/* V5
+ * Calcule l'empreinte (64 bits) d'un contenu : quatre accumulateurs traitent 32 octets à la fois.
+ * Entrées : l'adresse du contenu, sa taille en octets
+ * Retour : l'empreinte
+ */
+uint64_t EmpreinteContenu(const unsigned char *contenu, long taille) {
+  long i = 0;
+  uint64_t h;
+
+  if (taille >= 32) {
+    uint64_t a1 = PREMIER1 + PREMIER2, a2 = PREMIER2, a3 = 0, a4 = -PREMIER1;
+    for (; i + 32 <= taille; i += 32) {
+      a1 = tour(a1, lireMot(contenu + i));
+      a2 = tour(a2, lireMot(contenu + i + 8));
+      a3 = tour(a3, lireMot(contenu + i + 16));
+      a4 = tour(a4, lireMot(contenu + i + 24));
+    }
+    h = rotation(a1, 1) + rotation(a2, 7) + rotation(a3, 12) + rotation(a4, 18);
+  } else {
+    h = PREMIER5;
+  }
+  h += (uint64_t)taille;
+
+  // mots restants puis octets restants
+  for (; i + 8 <= taille; i += 8) {
+    h ^= tour(0, lireMot(contenu + i));
+    h = rotation(h, 27) * PREMIER1 + PREMIER4;
+  }
+  for (; i < taille; i++) {
+    h ^= contenu[i] * PREMIER5;
+    h = rotation(h, 11) * PREMIER1;
+  }
+
+  // mélange final
+  h ^= h >> 33;
+  h *= PREMIER2;
+  h ^= h >> 29;
+  h *= PREMIER3;
+  h ^= h >> 32;
+
+  return h;
+}
+
+/* V5
+ * Crée un index de déduplication vide.
+ * Entrée : aucune
+ * Retour : l'index créé, ou NULL en cas de problème
+ */
+tIndexDedup CreerIndexDedup(void) {
+  tIndexDedup index = (tIndexDedup)malloc(sizeof(struct sIndexDedup));
+  if (index == NULL) {
+    fprintf(stderr, "CreerIndexDedup : probleme creation\n");
+    return NULL;
+  }
+
+  index->capacite = CAPACITE_INDEX_INITIALE;
+  index->nbEntrees = 0;
+  index->table = calloc(index->capacite, sizeof(struct sEntreeDedup));
+  if (index->table == NULL) {
+    fprintf(stderr, "CreerIndexDedup : probleme creation\n");
+    free(index);
+    return NULL;
+  }
+
+  return index;
+}
+
+/* V5
+ * Détruit un index de déduplication.
+ * Entrée : l'index à détruire
+ * Retour : aucun
+ */
+void DetruireIndexDedup(tIndexDedup *pIndex) {
+  if (pIndex == NULL || *pIndex == NULL) {
+    return;
+  }
+
+  free((*pIndex)->table);
+  free(*pIndex);
+  *pIndex = NULL;
+}
+
+// fonction auxiliaire qui range une entrée dans une table (sans vérifier la place)
+static void rangerEntree(struct sEntreeDedup *table, long capacite, uint64_t empreinte, tNumeroBloc numero) {
+  long i = (long)(empreinte & (uint64_t)(capacite - 1));
+  while (table[i].numero != BLOC_NUL) {
+    i = (i + 1) & (capacite - 1);
+  }
+  table[i].empreinte = empreinte;
+  table[i].numero = numero;
+}
+
+/* V5
+ * Ajoute un bloc à l'index (la table double quand elle est à moitié pleine).
+ * Entrées : l'index, l'empreinte du contenu du bloc, le numéro du bloc
+ * Retour : 0 en cas de succès, -1 en cas d'erreur
+ */
+int AjouterIndexDedup(tIndexDedup index, uint64_t empreinte, tNumeroBloc numero) {
+  if (index == NULL || numero == BLOC_NUL) {
+    return -1;
+  }
+
+  // table à moitié pleine : on la double
+  if (2 * (index->nbEntrees + 1) > index->capacite) {
+    long nouvelleCapacite = index->capacite * 2;
+    struct sEntreeDedup *nouvelleTable = calloc(nouvelleCapacite, sizeof(struct sEntreeDedup));
+    if (nouvelleTable == NULL) {
+      fprintf(stderr, "AjouterIndexDedup : probleme allocation\n");
+      return -1;
+    }
+    for (long i = 0; i < index->capacite; i++) {
+      if (index->table[i].numero != BLOC_NUL) {
+        rangerEntree(nouvelleTable, nouvelleCapacite, index->table[i].empreinte, index->table[i].numero);
+      }
+    }
+    free(index->table);
+    index->table = nouvelleTable;
+    index->capacite = nouvelleCapacite;
+  }
+
+  rangerEntree(index->table, index->capacite, empreinte, numero);
+  index->nbEntrees++;
+
+  return 0;
+}
+
+/* V5
+ * Retire un bloc de l'index (les entrées suivantes sont décalées pour ne pas couper les sondages).
+ * Entrées : l'index, l'empreinte du contenu du bloc, le numéro du bloc
+ * Retour : aucun
+ */
+void RetirerIndexDedup(tIndexDedup index, uint64_t empreinte, tNumeroBloc numero) {
+  if (index == NULL) {
+    return;
+  }
+
+  long masque = index->capacite - 1;
+  long i = (long)(empreinte & (uint64_t)masque);
+
+  // on cherche l'entrée
+  while (index->table[i].numero != BLOC_NUL && index->table[i].numero != numero) {
+    i = (i + 1) & masque;
+  }
+  if (index->table[i].numero == BLOC_NUL) {
+    return; // pas dans l'index
+  }
+
+  // on vide la case puis on remonte les entrées qui seraient devenues inaccessibles
+  long trou = i;
+  index->table[trou].numero = BLOC_NUL;
+  index->nbEntrees--;
+  for (long j = (trou + 1) & masque; index->table[j].numero != BLOC_NUL; j = (j + 1) & masque) {
+    long ideale = (long)(index->table[j].empreinte & (uint64_t)masque);
+    // l'entrée j peut remplir le trou si sa case idéale n'est pas entre le trou (exclu) et j
+    if (((j - ideale) & masque) >= ((j - trou) & masque)) {
+      index->table[trou] = index->table[j];
+      index->table[j].numero = BLOC_NUL;
+      trou = j;
+    }
+  }
+}
+
+/* V5
+ * Cherche dans l'index un bloc dont le contenu est identique à un contenu donné.
+ * Entrées : l'index, l'empreinte du contenu cherché, la fonction de vérification et son contexte
+ * Retour : le numéro du bloc trouvé, BLOC_NUL si aucun
+ */
+tNumeroBloc ChercherIndexDedup(tIndexDedup index, uint64_t empreinte, tVerifBlocDedup verif, void *contexte) {
+  if (index == NULL) {
+    return BLOC_NUL;
+  }
+
+  long masque = index->capacite - 1;
+  for (long i = (long)(empreinte & (uint64_t)masque); index->table[i].numero != BLOC_NUL; i = (i + 1) & masque) {
+    // même empreinte : on vérifie le contenu (collision possible)
+    if (index->table[i].empreinte == empreinte && verif(contexte, index->table[i].numero)) {
+      return index->table[i].numero;
+    }
+  }
+
+  return BLOC_NUL;
+}
+
+/* V5
+ * Retourne la place occupée en mémoire par un index.
+ * Entrée : l'index
+ * Retour : la taille en octets
+ */
+long TailleMemoireIndexDedup(tIndexDedup index) {
+  if (index == NULL) {
+    return 0;
+  }
+
+  return (long)sizeof(struct sIndexDedup) + index->capacite * (long)sizeof(struct sEntreeDedup);
+}
@@ -0,0 +1,73 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : dedup.h
+ * Module de déduplication des blocs.
+ * Un index associe l'empreinte (hachage rapide, non cryptographique) du contenu d'un bloc
+ * aux numéros des blocs du disque qui ont cette empreinte.
+ **/
+#ifndef __DEDUP_H__
+#define __DEDUP_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "disque.h"
+
+// Type public représentant un index de déduplication
+typedef struct sIndexDedup *tIndexDedup;
+
+// Type d'une fonction qui vérifie qu'un bloc candidat a bien le contenu cherché
+// (deux contenus différents peuvent avoir la même empreinte)
+typedef bool (*tVerifBlocDedup)(void *contexte, tNumeroBloc numero);
+
+/* V5
+ * Calcule l'empreinte (64 bits) d'un contenu.
+ * Entrées : l'adresse du contenu, sa taille en octets
+ * Retour : l'empreinte
+ */
+extern uint64_t EmpreinteContenu(const unsigned char *contenu, long taille);
+
+/* V5
+ * Crée un index de déduplication vide.
+ * Entrée : aucune
+ * Retour : l'index créé, ou NULL en cas de problème
+ */
+extern tIndexDedup CreerIndexDedup(void);
+
+/* V5
+ * Détruit un index de déduplication.
+ * Entrée : l'index à détruire
+ * Retour : aucun
+ */
+extern void DetruireIndexDedup(tIndexDedup *pIndex);
+
+/* V5
+ * Ajoute un bloc à l'index.
+ * Entrées : l'index, l'empreinte du contenu du bloc, le numéro du bloc
+ * Retour : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int AjouterIndexDedup(tIndexDedup index, uint64_t empreinte, tNumeroBloc numero);
+
+/* V5
+ * Retire un bloc de l'index (rien ne se passe s'il n'y est pas).
+ * Entrées : l'index, l'empreinte du contenu du bloc, le numéro du bloc
+ * Retour : aucun
+ */
+extern void RetirerIndexDedup(tIndexDedup index, uint64_t empreinte, tNumeroBloc numero);
+
+/* V5
+ * Cherche dans l'index un bloc dont le contenu est identique à un contenu donné.
+ * Chaque bloc de même empreinte est vérifié par la fonction verif.
+ * Entrées : l'index, l'empreinte du contenu cherché, la fonction de vérification et son contexte
+ * Retour : le numéro du bloc trouvé, BLOC_NUL si aucun
+ */
+extern tNumeroBloc ChercherIndexDedup(tIndexDedup index, uint64_t empreinte, tVerifBlocDedup verif, void *contexte);
+
+/* V5
+ * Retourne la place occupée en mémoire par un index.
+ * Entrée : l'index
+ * Retour : la taille en octets
+ */
+extern long TailleMemoireIndexDedup(tIndexDedup index);
+
+#endif
@@ -0,0 +1,146 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : demo_ajouts.c
+ * Démonstration des ajouts à la fin d'un inode (AjouterDonneesInode, ViderAjoutsInode) : petits enregistrements
+ * rassemblés dans le bloc de la fin du fichier, lectures et écritures entre les ajouts, passage d'un fichier en ligne
+ * aux blocs, fichier compressé, clone et sauvegarde avec des ajouts en attente, taille maximale, et cas d'erreur.
+ * Chaque étape vérifie ses résultats (voir verification.h).
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "disque.h"
+#include "inode.h"
+#include "verification.h"
+
+// Taille des enregistrements ajoutés, et nombre d'enregistrements (40 blocs de 64 octets)
+#define TAILLE_ENREGISTREMENT 16
+#define NB_ENREGISTREMENTS 160
+#define TAILLE_DEMO (NB_ENREGISTREMENTS * TAILLE_ENREGISTREMENT)
+
+// Fichier de sauvegarde de la démonstration (effacé à la fin)
+#define NOM_SAUVEGARDE "demo_ajouts.sav"
+
+// fonction auxiliaire qui ajoute les enregistrements de premier à fin (exclu) : true si tous sont ajoutés
+static bool ajouterEnregistrements(tInode inode, unsigned char *enregistrements, long premier, long fin) {
+  bool ajoute = true;
+  for (long i = premier; i < fin; i++) {
+    ajoute = ajoute && AjouterDonneesInode(inode, enregistrements + i * TAILLE_ENREGISTREMENT,
+                                           TAILLE_ENREGISTREMENT) == TAILLE_ENREGISTREMENT;
+  }
+  return ajoute;
+}
+
+int main(void) {
+  DebuterVerifications("demo_ajouts");
+  unsigned char enregistrements[TAILLE_DEMO], attendu[TAILLE_DEMO];
+  for (long i = 0; i < TAILLE_DEMO; i++) {
+    enregistrements[i] = (unsigned char)(i * 5 + i / TAILLE_ENREGISTREMENT);
+  }
+
+  // === PHASE 1 : ajouts d'enregistrements ===
+  printf("--- PHASE 1 : 160 ajouts de 16 octets ---\n");
+  tDisque disque = CreerDisque(TAILLE_BLOC);
+  long utilisesAuDebut = NbBlocsUtilises(disque);
+  tInode inode = CreerInode(1, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  Verifier(ajouterEnregistrements(inode, enregistrements, 0, NB_ENREGISTREMENTS), "160 enregistrements ajoutes");
+  Verifier(Taille(inode) == TAILLE_DEMO, "la taille compte les ajouts en attente");
+  Verifier(ViderAjoutsInode(inode) == 0, "publication des ajouts");
+  Verifier(NbBlocsUtilises(disque) == utilisesAuDebut + 40, "40 blocs sur le disque");
+  Verifier(ContenuInodeEgal(inode, enregistrements, TAILLE_DEMO), "relecture de tous les enregistrements");
+  Verifier(ViderAjoutsInode(inode) == 0, "publication sans ajout en attente");
+  DetruireInode(&inode);
+
+  // === PHASE 2 : accès entre les ajouts ===
+  printf("\n--- PHASE 2 : lectures et ecritures entre les ajouts ---\n");
+  inode = CreerInode(2, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  memcpy(attendu, enregistrements, TAILLE_DEMO);
+  Verifier(ajouterEnregistrements(inode, enregistrements, 0, 3), "3 ajouts (fichier en ligne)");
+  Verifier(ContenuInodeEgal(inode, attendu, 3 * TAILLE_ENREGISTREMENT), "relecture du fichier en ligne");
+  Verifier(ajouterEnregistrements(inode, enregistrements, 3, 50), "47 ajouts (le fichier passe dans des blocs)");
+  unsigned char lu[TAILLE_ENREGISTREMENT];
+  Verifier(LireDonneesInode(inode, lu, TAILLE_ENREGISTREMENT, 49 * TAILLE_ENREGISTREMENT) == TAILLE_ENREGISTREMENT
+           && memcmp(lu, enregistrements + 49 * TAILLE_ENREGISTREMENT, TAILLE_ENREGISTREMENT) == 0,
+           "lecture du dernier ajout (encore en memoire)");
+  memset(attendu + 40 * TAILLE_ENREGISTREMENT, 'X', 3 * TAILLE_ENREGISTREMENT);
+  Verifier(EcrireDonneesInode(inode, attendu + 40 * TAILLE_ENREGISTREMENT, 3 * TAILLE_ENREGISTREMENT,
+                              40 * TAILLE_ENREGISTREMENT) == 3 * TAILLE_ENREGISTREMENT,
+           "ecriture par-dessus 3 enregistrements deja ajoutes");
+  Verifier(ajouterEnregistrements(inode, enregistrements, 50, NB_ENREGISTREMENTS), "110 ajouts de plus");
+  Verifier(ContenuInodeEgal(inode, attendu, TAILLE_DEMO), "relecture : ajouts et ecriture a leur place");
+  DetruireInode(&inode);
+
+  // === PHASE 3 : fichier compressé, clone et sauvegarde ===
+  printf("\n--- PHASE 3 : fichier compresse, clone et sauvegarde avec des ajouts en attente ---\n");
+  inode = CreerInode(3, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  Verifier(ActiverCompressionInode(inode) == 0, "compression activee");
+  Verifier(ajouterEnregistrements(inode, enregistrements, 0, NB_ENREGISTREMENTS), "160 ajouts dans le fichier compresse");
+  Verifier(ContenuInodeEgal(inode, enregistrements, TAILLE_DEMO), "relecture du fichier compresse");
+  DetruireInode(&inode);
+
+  inode = CreerInode(4, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  ajouterEnregistrements(inode, enregistrements, 0, 101);
+  tInode clone = CloneInode(inode, 5);
+  Verifier(clone != NULL && ContenuInodeEgal(clone, enregistrements, 101 * TAILLE_ENREGISTREMENT),
+           "le clone a tous les ajouts en attente");
+  Verifier(ajouterEnregistrements(inode, enregistrements, 101, NB_ENREGISTREMENTS)
+               && ContenuInodeEgal(clone, enregistrements, 101 * TAILLE_ENREGISTREMENT),
+           "les ajouts suivants ne touchent pas le clone");
+  DetruireInode(&clone);
+  DetruireInode(&inode);
+
+  inode = CreerInode(6, ORDINAIRE);
+  ajouterEnregistrements(inode, enregistrements, 0, 77);
+  FILE *fichier = fopen(NOM_SAUVEGARDE, "wb");
+  Verifier(fichier != NULL && SauvegarderInode(inode, fichier) == 0, "sauvegarde avec des ajouts en attente");
+  if (fichier != NULL) {
+    fclose(fichier);
+  }
+  DetruireInode(&inode);
+  fichier = fopen(NOM_SAUVEGARDE, "rb");
+  Verifier(fichier != NULL && ChargerInode(&inode, fichier) == 0
+           && ContenuInodeEgal(inode, enregistrements, 77 * TAILLE_ENREGISTREMENT), "les 77 ajouts sont sauvegardes");
+  if (fichier != NULL) {
+    fclose(fichier);
+  }
+  DetruireInode(&inode);
+  remove(NOM_SAUVEGARDE);
+
+  // === PHASE 4 : taille maximale ===
+  printf("\n--- PHASE 4 : taille maximale d'un fichier ---\n");
+  inode = CreerInode(7, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  long tailleMax = TailleMaxFichierInode(inode);
+  unsigned char *grand = calloc(tailleMax, 1);
+  Verifier(grand != NULL && AjouterDonneesInode(inode, grand, tailleMax - 10) == tailleMax - 10,
+           "ajout jusqu'a 10 octets de la taille maximale");
+  Verifier(AjouterDonneesInode(inode, enregistrements, TAILLE_ENREGISTREMENT) == 10, "l'ajout suivant est tronque");
+  Verifier(AjouterDonneesInode(inode, enregistrements, TAILLE_ENREGISTREMENT) == 0, "plus rien ne s'ajoute");
+  Verifier(ViderAjoutsInode(inode) == 0 && Taille(inode) == tailleMax, "le fichier a sa taille maximale");
+  free(grand);
+  DetruireInode(&inode);
+  Verifier(NbBlocsUtilises(disque) == utilisesAuDebut, "tous les blocs sont rendus au disque");
+
+  // === PHASE 5 : cas d'erreur ===
+  printf("\n--- PHASE 5 : cas d'erreur ---\n");
+  inode = CreerInode(8, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  Verifier(AjouterDonneesInode(NULL, enregistrements, 10) == -1, "ajout dans un inode inexistant refuse");
+  Verifier(AjouterDonneesInode(inode, NULL, 10) == -1, "ajout sans donnees refuse");
+  Verifier(AjouterDonneesInode(inode, enregistrements, -1) == -1, "taille negative refusee");
+  Verifier(AjouterDonneesInode(inode, enregistrements, 0) == 0 && Taille(inode) == 0, "ajout de 0 octet sans effet");
+  Verifier(ViderAjoutsInode(NULL) == -1, "publication pour un inode inexistant refusee");
+  DetruireInode(&inode);
+  DetruireDisque(&disque);
+
+  return TerminerVerifications("AJOUTS");
+}
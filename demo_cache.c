@@ -0,0 +1,121 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : demo_cache.c
+ * Démonstration du cache de blocs d'un disque stocké dans un fichier : volume plus grand que le budget
+ * du cache (évictions, blocs modifiés réécrits dans l'image), relecture depuis l'image, blocs épinglés
+ * par des vues qui ne sont pas évincés, et budget minimal.
+ * Chaque étape vérifie ses résultats (voir verification.h).
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "disque.h"
+#include "inode.h"
+#include "verification.h"
+
+// Taille des blocs, nombre de blocs que le cache peut garder, taille du fichier écrit
+#define TAILLE_BLOC_DEMO 4096
+#define NB_CASES_DEMO 8
+#define TAILLE_FICHIER_DEMO (64 * TAILLE_BLOC_DEMO)
+
+// fonction auxiliaire qui affiche les compteurs du cache d'un disque
+static void afficherStats(tDisque disque) {
+  tStatsCache stats;
+  if (StatistiquesCacheDisque(disque, &stats) == 0) {
+    printf("  cache : %ld succes, %ld defauts, %ld evictions, %ld ecritures, %ld anticipes\n",
+           stats.succes, stats.defauts, stats.evictions, stats.ecritures, stats.anticipes);
+  }
+}
+
+int main(void) {
+  DebuterVerifications("demo_cache");
+  unsigned char *donnees = malloc(TAILLE_FICHIER_DEMO);
+  unsigned char *lu = malloc(TAILLE_FICHIER_DEMO);
+  if (donnees == NULL || lu == NULL) {
+    return 1;
+  }
+  for (long i = 0; i < TAILLE_FICHIER_DEMO; i++) {
+    donnees[i] = (unsigned char)(i / TAILLE_BLOC_DEMO * 7 + i);
+  }
+
+  // === PHASE 1 : volume plus grand que le cache ===
+  printf("--- PHASE 1 : fichier de 64 blocs, cache de 8 blocs ---\n");
+  BudgetCacheDisque(NB_CASES_DEMO * TAILLE_BLOC_DEMO);
+  tDisque disque = CreerDisqueFichier(TAILLE_BLOC_DEMO, "demo_cache.img");
+  Verifier(disque != NULL, "creation du disque sur fichier");
+  Verifier(TailleMemoireCacheDisque(disque) <= NB_CASES_DEMO * TAILLE_BLOC_DEMO, "cache dans son budget");
+  tInode inode = CreerInode(1, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  Verifier(EcrireDonneesInode(inode, donnees, TAILLE_FICHIER_DEMO, 0) == TAILLE_FICHIER_DEMO, "ecriture du fichier");
+  tStatsCache stats;
+  Verifier(StatistiquesCacheDisque(disque, &stats) == 0 && stats.evictions > 0 && stats.ecritures > 0,
+           "des blocs modifies sont evinces et reecrits dans l'image");
+  afficherStats(disque);
+
+  // === PHASE 2 : relecture depuis l'image ===
+  printf("\n--- PHASE 2 : relecture du fichier ---\n");
+  long defautsAvant = stats.defauts;
+  Verifier(LireDonneesInode(inode, lu, TAILLE_FICHIER_DEMO, 0) == TAILLE_FICHIER_DEMO
+           && memcmp(lu, donnees, TAILLE_FICHIER_DEMO) == 0, "relecture identique");
+  Verifier(StatistiquesCacheDisque(disque, &stats) == 0 && stats.defauts > defautsAvant,
+           "les blocs evinces sont relus dans l'image");
+  Verifier(TailleMemoireCacheDisque(disque) <= NB_CASES_DEMO * TAILLE_BLOC_DEMO, "cache toujours dans son budget");
+  afficherStats(disque);
+
+  // réécriture au milieu, puis relecture après avoir parcouru tout le fichier (le bloc a quitté le cache)
+  memset(donnees + 10 * TAILLE_BLOC_DEMO + 100, 'M', 1000);
+  Verifier(EcrireDonneesInode(inode, donnees + 10 * TAILLE_BLOC_DEMO + 100, 1000, 10 * TAILLE_BLOC_DEMO + 100) == 1000,
+           "reecriture de 1000 octets dans le bloc 10");
+  Verifier(LireDonneesInode(inode, lu, TAILLE_FICHIER_DEMO, 0) == TAILLE_FICHIER_DEMO
+           && memcmp(lu, donnees, TAILLE_FICHIER_DEMO) == 0, "relecture avec la reecriture");
+
+  // === PHASE 3 : blocs épinglés par des vues ===
+  printf("\n--- PHASE 3 : vues sur des blocs du fichier image ---\n");
+  tVuesInode vues = LireVuesInode(inode, 2 * TAILLE_BLOC_DEMO, 5 * TAILLE_BLOC_DEMO);
+  Verifier(vues != NULL && VuesEgales(vues, donnees + 5 * TAILLE_BLOC_DEMO, 2 * TAILLE_BLOC_DEMO),
+           "vues sur les blocs 5 et 6");
+  Verifier(LireDonneesInode(inode, lu, TAILLE_FICHIER_DEMO, 0) == TAILLE_FICHIER_DEMO,
+           "lecture de tout le fichier pendant les vues");
+  Verifier(VuesEgales(vues, donnees + 5 * TAILLE_BLOC_DEMO, 2 * TAILLE_BLOC_DEMO),
+           "les blocs epingles n'ont pas ete evinces");
+  memset(lu, 'V', TAILLE_BLOC_DEMO);
+  Verifier(EcrireDonneesInode(inode, lu, TAILLE_BLOC_DEMO, 5 * TAILLE_BLOC_DEMO) == TAILLE_BLOC_DEMO,
+           "reecriture du bloc 5 pendant les vues");
+  Verifier(VuesEgales(vues, donnees + 5 * TAILLE_BLOC_DEMO, 2 * TAILLE_BLOC_DEMO), "les vues gardent le contenu lu");
+  LibererVuesInode(&vues);
+  memset(donnees + 5 * TAILLE_BLOC_DEMO, 'V', TAILLE_BLOC_DEMO);
+
+  // plus de vues que de cases : les blocs que le cache refuse d'épingler sont recopiés
+  vues = LireVuesInode(inode, TAILLE_FICHIER_DEMO, 0);
+  Verifier(vues != NULL && VuesEgales(vues, donnees, TAILLE_FICHIER_DEMO), "vues sur les 64 blocs (8 cases)");
+  LibererVuesInode(&vues);
+  DetruireInode(&inode);
+  DetruireDisque(&disque);
+
+  // === PHASE 4 : budget minimal et cas d'erreur ===
+  printf("\n--- PHASE 4 : budget minimal et cas d'erreur ---\n");
+  BudgetCacheDisque(1);
+  disque = CreerDisqueFichier(TAILLE_BLOC_DEMO, "demo_cache.img");
+  Verifier(disque != NULL && TailleMemoireCacheDisque(disque) == 2 * TAILLE_BLOC_DEMO,
+           "un budget trop petit garde deux blocs");
+  inode = CreerInode(2, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  Verifier(EcrireDonneesInode(inode, donnees, TAILLE_FICHIER_DEMO, 0) == TAILLE_FICHIER_DEMO
+           && LireDonneesInode(inode, lu, TAILLE_FICHIER_DEMO, 0) == TAILLE_FICHIER_DEMO
+           && memcmp(lu, donnees, TAILLE_FICHIER_DEMO) == 0, "ecriture et relecture avec deux blocs de cache");
+  DetruireInode(&inode);
+  DetruireDisque(&disque);
+  BudgetCacheDisque(BUDGET_CACHE_DISQUE);
+  Verifier(StatistiquesCacheDisque(NULL, &stats) == -1, "pas de statistiques sans disque");
+  Verifier(TailleMemoireCacheDisque(NULL) == 0, "pas de cache sans disque");
+
+  remove("demo_cache.img");
+  free(donnees);
+  free(lu);
+  return TerminerVerifications("CACHE");
+}
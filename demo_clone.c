@@ -0,0 +1,104 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : demo_clone.c
+ * Démonstration du clonage de fichiers (copie sur écriture) : clone d'un inode qui partage ses blocs,
+ * écritures de part et d'autre, destruction de la source, clone d'un fichier du SF conservé par
+ * SauvegarderSF/ChargerSF, et cas d'erreur.
+ * Chaque étape vérifie ses résultats (voir verification.h).
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "disque.h"
+#include "inode.h"
+#include "sf.h"
+#include "verification.h"
+
+// Taille des fichiers de la démonstration (40 blocs de 64 octets)
+#define TAILLE_DEMO (40 * TAILLE_BLOC)
+
+int main(void) {
+  DebuterVerifications("demo_clone");
+  unsigned char source[TAILLE_DEMO], copie[TAILLE_DEMO];
+  for (long i = 0; i < TAILLE_DEMO; i++) {
+    source[i] = (unsigned char)(i * 13 + i / 64);
+  }
+  memcpy(copie, source, TAILLE_DEMO);
+
+  // === PHASE 1 : clone d'un inode ===
+  printf("--- PHASE 1 : clone d'un inode ---\n");
+  tDisque disque = CreerDisque(TAILLE_BLOC);
+  long utilisesAuDebut = NbBlocsUtilises(disque);
+  tInode original = CreerInode(1, ORDINAIRE);
+  AssocierDisqueInode(original, disque);
+  Verifier(EcrireDonneesInode(original, source, TAILLE_DEMO, 0) == TAILLE_DEMO, "ecriture de 40 blocs");
+  long utilisesOriginal = NbBlocsUtilises(disque);
+  tInode clone = CloneInode(original, 2);
+  Verifier(clone != NULL && Numero(clone) == 2 && Taille(clone) == TAILLE_DEMO, "clone cree avec sa taille");
+  Verifier(NbBlocsUtilises(disque) == utilisesOriginal, "aucun bloc alloue par le clonage");
+  Verifier(NbReferencesPartageesDisque(disque) == 40, "40 blocs partages");
+  Verifier(ContenuInodeEgal(clone, source, TAILLE_DEMO), "relecture du clone");
+
+  // === PHASE 2 : copie sur écriture, de part et d'autre ===
+  printf("\n--- PHASE 2 : ecritures dans le clone et dans l'original ---\n");
+  memset(copie + 100, 'C', 50);
+  Verifier(EcrireDonneesInode(clone, copie + 100, 50, 100) == 50, "ecriture de 50 octets dans le clone (blocs 1 et 2)");
+  Verifier(NbBlocsUtilises(disque) == utilisesOriginal + 2, "deux blocs recopies");
+  Verifier(NbReferencesPartageesDisque(disque) == 38, "38 blocs encore partages");
+  Verifier(ContenuInodeEgal(clone, copie, TAILLE_DEMO), "le clone voit son ecriture");
+  Verifier(ContenuInodeEgal(original, source, TAILLE_DEMO), "l'original est inchange");
+  unsigned char fin[TAILLE_BLOC];
+  memset(fin, 'O', TAILLE_BLOC);
+  memcpy(source + TAILLE_DEMO - TAILLE_BLOC, fin, TAILLE_BLOC);
+  Verifier(EcrireDonneesInode(original, fin, TAILLE_BLOC, TAILLE_DEMO - TAILLE_BLOC) == TAILLE_BLOC,
+           "ecriture du dernier bloc de l'original");
+  Verifier(NbReferencesPartageesDisque(disque) == 37, "37 blocs encore partages");
+  Verifier(ContenuInodeEgal(original, source, TAILLE_DEMO), "l'original voit son ecriture");
+  Verifier(ContenuInodeEgal(clone, copie, TAILLE_DEMO), "le clone est inchange");
+
+  // === PHASE 3 : destruction de l'original ===
+  printf("\n--- PHASE 3 : destruction de l'original ---\n");
+  DetruireInode(&original);
+  Verifier(NbReferencesPartageesDisque(disque) == 0, "plus aucun bloc partage");
+  Verifier(NbBlocsUtilises(disque) == utilisesAuDebut + 40, "seuls les 40 blocs du clone restent");
+  Verifier(ContenuInodeEgal(clone, copie, TAILLE_DEMO), "le clone reste lisible");
+  DetruireInode(&clone);
+  Verifier(NbBlocsUtilises(disque) == utilisesAuDebut, "tous les blocs sont rendus au disque");
+  DetruireDisque(&disque);
+
+  // === PHASE 4 : clone d'un fichier du SF ===
+  printf("\n--- PHASE 4 : clone d'un fichier du SF, sauvegarde et chargement ---\n");
+  tSF sf = CreerSF("demo_clone");
+  Verifier(CreerFichierContenu(sf, "source.bin", source, TAILLE_DEMO), "creation de source.bin");
+  Verifier(CloneFichierSF(sf, "source.bin", "clone.bin") == TAILLE_DEMO, "clone de source.bin en clone.bin");
+  int descripteur = OuvrirSF(sf, "clone.bin", OUVERTURE_ECRITURE);
+  Verifier(descripteur >= 0 && PositionnerSF(sf, descripteur, 100, SEEK_SET) == 100
+           && EcrireSF(sf, descripteur, copie + 100, 50) == 50 && FermerSF(sf, descripteur) == 0,
+           "ecriture dans clone.bin");
+  Verifier(SauvegarderSF(sf, "demo_clone.sf") == 0, "sauvegarde du SF");
+  DetruireSF(&sf);
+  Verifier(ChargerSF(&sf, "demo_clone.sf") == 0, "chargement du SF");
+  memcpy(copie, source, TAILLE_DEMO);
+  memset(copie + 100, 'C', 50);
+  Verifier(ContenuFichierEgal(sf, "source.bin", source, TAILLE_DEMO), "relecture de source.bin");
+  Verifier(ContenuFichierEgal(sf, "clone.bin", copie, TAILLE_DEMO), "relecture de clone.bin");
+  Verifier(SupprimerFichierSF(sf, "source.bin") == 0, "suppression de source.bin");
+  Verifier(ContenuFichierEgal(sf, "clone.bin", copie, TAILLE_DEMO), "clone.bin reste lisible");
+  Df(sf);
+
+  // === PHASE 5 : cas d'erreur ===
+  printf("\n--- PHASE 5 : cas d'erreur ---\n");
+  Verifier(CloneFichierSF(sf, "source.bin", "autre.bin") == -1, "clone d'un fichier inexistant refuse");
+  Verifier(CloneFichierSF(sf, "clone.bin", "clone.bin") == -1, "clone vers un nom existant refuse");
+  Verifier(CloneFichierSF(NULL, "clone.bin", "autre.bin") == -1, "clone dans un SF inexistant refuse");
+  Verifier(CloneInode(NULL, 3) == NULL, "clone d'un inode inexistant refuse");
+  DetruireSF(&sf);
+  remove("demo_clone.sf");
+
+  return TerminerVerifications("CLONE");
+}
@@ -0,0 +1,131 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : demo_compression.c
+ * Démonstration de la compression des fichiers : codec LZ, inode compressé (écriture, réécriture partielle,
+ * relecture), passage en mode compressé d'un fichier existant, SF compressé sauvegardé puis rechargé, et cas d'erreur.
+ * Chaque étape vérifie ses résultats (voir verification.h).
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "disque.h"
+#include "compression.h"
+#include "inode.h"
+#include "sf.h"
+#include "verification.h"
+
+// Taille du texte de la démonstration (au plus la taille maximale d'un fichier à blocs de 64 octets)
+#define TAILLE_TEXTE 20000
+
+// fonction auxiliaire qui remplit une zone d'un texte fait de mots répétés (très compressible)
+static void remplirTexte(unsigned char *zone, long taille) {
+  static const char *mots[] = {"inode ", "bloc ", "disque ", "fichier ", "systeme ", "de ", "le ", "un "};
+  long i = 0;
+  for (unsigned int n = 1; i < taille; n = n * 1103515245u + 12345u) {
+    const char *mot = mots[(n >> 16) % 8];
+    for (long k = 0; mot[k] != '\0' && i < taille; k++) {
+      zone[i++] = (unsigned char)mot[k];
+    }
+  }
+}
+
+int main(void) {
+  DebuterVerifications("demo_compression");
+  unsigned char *texte = malloc(TAILLE_TEXTE);
+  unsigned char *zone = malloc(2 * TAILLE_TEXTE);
+  unsigned char *lu = malloc(TAILLE_TEXTE);
+  if (texte == NULL || zone == NULL || lu == NULL) {
+    return 1;
+  }
+  remplirTexte(texte, TAILLE_TEXTE);
+
+  // === PHASE 1 : codec LZ ===
+  printf("--- PHASE 1 : codec LZ ---\n");
+  long compresse = CompresserLZ(texte, TAILLE_TEXTE, zone, 2 * TAILLE_TEXTE);
+  printf("  %d octets de texte compresses en %ld octets\n", TAILLE_TEXTE, compresse);
+  Verifier(compresse > 0 && compresse < TAILLE_TEXTE / 2, "le texte est compresse de plus de moitie");
+  Verifier(DecompresserLZ(zone, compresse, lu, TAILLE_TEXTE) == TAILLE_TEXTE && memcmp(lu, texte, TAILLE_TEXTE) == 0,
+           "decompression identique au texte");
+  Verifier(CompresserLZ(texte, TAILLE_TEXTE, zone, 16) == -1, "destination trop petite pour la compression");
+  Verifier(DecompresserLZ(zone, compresse, lu, TAILLE_TEXTE - 1) == -1, "destination trop petite pour la decompression");
+  Verifier(DecompresserLZ(zone, compresse / 2, lu, TAILLE_TEXTE) != TAILLE_TEXTE, "donnees tronquees non decompressees");
+
+  // === PHASE 2 : inode compressé ===
+  printf("\n--- PHASE 2 : inode compresse ---\n");
+  tDisque disque = CreerDisque(TAILLE_BLOC);
+  long utilisesAuDebut = NbBlocsUtilises(disque);
+  tInode inode = CreerInode(1, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  Verifier(ActiverCompressionInode(inode) == 0 && CompressionInode(inode), "passage en mode compresse");
+  Verifier(EcrireDonneesInode(inode, texte, TAILLE_TEXTE, 0) == TAILLE_TEXTE, "ecriture du texte");
+  long blocsFichier = NbBlocsUtilises(disque) - utilisesAuDebut;
+  printf("  %d octets stockes dans %ld blocs de %d octets\n", TAILLE_TEXTE, blocsFichier, TAILLE_BLOC);
+  // (les trames de 8 blocs sont compressées séparément : le gain est moindre que sur le texte entier)
+  Verifier(blocsFichier * TAILLE_BLOC < TAILLE_TEXTE * 2 / 3, "un tiers de blocs de moins qu'un fichier brut");
+  Verifier(ContenuInodeEgal(inode, texte, TAILLE_TEXTE), "relecture du texte");
+  Verifier(LireDonneesInode(inode, lu, 100, 12345) == 100 && memcmp(lu, texte + 12345, 100) == 0,
+           "lecture de 100 octets au milieu du fichier");
+
+  // réécriture partielle : seule la trame concernée est recompressée
+  memset(texte + 7000, 'Z', 300);
+  Verifier(EcrireDonneesInode(inode, texte + 7000, 300, 7000) == 300, "reecriture de 300 octets au milieu");
+  Verifier(ContenuInodeEgal(inode, texte, TAILLE_TEXTE), "relecture apres reecriture");
+
+  // écriture au-delà de la fin : le trou se relit à zéro
+  unsigned char fin[10] = "0123456789";
+  Verifier(EcrireDonneesInode(inode, fin, 10, TAILLE_TEXTE + 1000) == 10, "ecriture apres un trou de 1000 octets");
+  Verifier(Taille(inode) == TAILLE_TEXTE + 1010, "taille du fichier");
+  bool trouNul = LireDonneesInode(inode, lu, 1010, TAILLE_TEXTE) == 1010;
+  for (int i = 0; trouNul && i < 1000; i++) {
+    trouNul = (lu[i] == 0);
+  }
+  Verifier(trouNul && memcmp(lu + 1000, fin, 10) == 0, "le trou se relit a zero, suivi des donnees");
+  DetruireInode(&inode);
+  Verifier(NbBlocsUtilises(disque) == utilisesAuDebut, "tous les blocs sont rendus au disque");
+
+  // === PHASE 3 : fichier existant passé en mode compressé ===
+  printf("\n--- PHASE 3 : fichier existant passe en mode compresse ---\n");
+  inode = CreerInode(2, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  Verifier(EcrireDonneesInode(inode, texte, TAILLE_TEXTE, 0) == TAILLE_TEXTE && !CompressionInode(inode),
+           "ecriture du texte sans compression");
+  long blocsBruts = NbBlocsUtilises(disque) - utilisesAuDebut;
+  Verifier(ActiverCompressionInode(inode) == 0, "passage en mode compresse");
+  Verifier(NbBlocsUtilises(disque) - utilisesAuDebut < blocsBruts * 2 / 3, "une partie des blocs bruts est rendue");
+  Verifier(ContenuInodeEgal(inode, texte, TAILLE_TEXTE), "relecture du texte");
+  DetruireInode(&inode);
+  DetruireDisque(&disque);
+
+  // === PHASE 4 : SF compressé sauvegardé puis rechargé ===
+  printf("\n--- PHASE 4 : SF compresse sauvegarde puis recharge ---\n");
+  FILE *source = fopen("demo_compression.txt", "wb");
+  Verifier(source != NULL && fwrite(texte, 1, TAILLE_TEXTE, source) == TAILLE_TEXTE && fclose(source) == 0,
+           "creation du fichier source");
+  tSF sf = CreerSF("demo_compression");
+  Verifier(sf != NULL && ActiverCompressionSF(sf, true) == 0, "creation du SF compresse");
+  Verifier(EcrireFichierSF(sf, "demo_compression.txt", ORDINAIRE) == TAILLE_TEXTE, "import du fichier source");
+  Verifier(SauvegarderSF(sf, "demo_compression.sf") == 0, "sauvegarde du SF");
+  DetruireSF(&sf);
+  Verifier(ChargerSF(&sf, "demo_compression.sf") == 0, "chargement du SF");
+  Verifier(ContenuFichierEgal(sf, "demo_compression.txt", texte, TAILLE_TEXTE), "relecture du fichier");
+  Df(sf);
+  DetruireSF(&sf);
+  remove("demo_compression.txt");
+  remove("demo_compression.sf");
+
+  // === PHASE 5 : cas d'erreur ===
+  printf("\n--- PHASE 5 : cas d'erreur ---\n");
+  Verifier(ActiverCompressionInode(NULL) == -1, "compression d'un inode inexistant refusee");
+  Verifier(!CompressionInode(NULL), "un inode inexistant n'est pas compresse");
+  Verifier(ActiverCompressionSF(NULL, true) == -1, "compression d'un SF inexistant refusee");
+
+  free(texte);
+  free(zone);
+  free(lu);
+  return TerminerVerifications("COMPRESSION");
+}
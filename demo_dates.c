@@ -0,0 +1,187 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : demo_dates.c
+ * Démonstration des politiques de date de dernier accès (PolitiqueDatesInode, PolitiqueDatesSF) :
+ * DATES_STRICTES, règle de DATES_RELATIVES (accès antérieur à la dernière modification ou de plus d'un jour),
+ * SANS_DATE_ACCES, AfficherInode qui ne touche pas la date d'accès, et conservation de la politique
+ * et des dates par SauvegarderSF/ChargerSF.
+ * Chaque étape vérifie ses résultats (voir verification.h).
+ **/
+
+// nanosleep (POSIX)
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "bloc.h"
+#include "inode.h"
+#include "sf.h"
+#include "verification.h"
+
+// Taille du fichier de la démonstration (en ligne dans l'inode), et des lectures
+#define TAILLE_DEMO 100
+#define TAILLE_LECTURE 16
+
+// Une heure et un jour, en secondes
+#define UNE_HEURE (60 * 60)
+#define UN_JOUR (24 * UNE_HEURE)
+
+// Fichiers de sauvegarde de la démonstration (effacés à la fin)
+#define NOM_SAUVEGARDE_1 "demo_dates_1.sav"
+#define NOM_SAUVEGARDE_2 "demo_dates_2.sav"
+#define NOM_SAUVEGARDE_3 "demo_dates_3.sav"
+
+// fonction auxiliaire qui lit le début d'un inode : retourne true si la lecture aboutit
+static bool lireDebut(tInode inode) {
+  unsigned char lu[TAILLE_LECTURE];
+  return LireDonneesInode(inode, lu, TAILLE_LECTURE, 0) == TAILLE_LECTURE;
+}
+
+// fonction auxiliaire qui remplace un inode par une copie aux dates forgées : l'inode est sauvegardé,
+// ses trois dates (rangées après le numéro, le type et la taille, voir SauvegarderInode) sont réécrites,
+// puis il est rechargé (avec la politique par défaut) ; retourne true si c'est fait
+static bool forgerDates(tInode *pInode, time_t acces, time_t modif) {
+  FILE *fichier = tmpfile();
+  if (fichier == NULL) {
+    return false;
+  }
+  time_t dates[3] = {acces, modif, modif};
+  tInode charge = NULL;
+  bool forge = SauvegarderInode(*pInode, fichier) == 0
+               && fseek(fichier, sizeof(unsigned int) + sizeof(natureFichier) + sizeof(long), SEEK_SET) == 0
+               && fwrite(dates, sizeof(time_t), 3, fichier) == 3 && fseek(fichier, 0, SEEK_SET) == 0
+               && ChargerInode(&charge, fichier) == 0;
+  fclose(fichier);
+  if (forge) {
+    DetruireInode(pInode);
+    *pInode = charge;
+  }
+  return forge;
+}
+
+// fonction auxiliaire qui attend le début de la seconde suivante (time() est à la seconde)
+static void attendreSecondeSuivante(void) {
+  time_t depart = time(NULL);
+  struct timespec pause = {0, 20 * 1000 * 1000};
+  while (time(NULL) == depart) {
+    nanosleep(&pause, NULL);
+  }
+}
+
+// fonction auxiliaire qui lit le début d'un fichier du SF : retourne true si la lecture aboutit
+static bool lireDebutFichier(tSF sf, char nom[]) {
+  unsigned char lu[TAILLE_LECTURE];
+  int descripteur = OuvrirSF(sf, nom, OUVERTURE_LECTURE);
+  if (descripteur < 0) {
+    return false;
+  }
+  bool lecture = LireSF(sf, descripteur, lu, TAILLE_LECTURE) == TAILLE_LECTURE;
+  return FermerSF(sf, descripteur) == 0 && lecture;
+}
+
+// fonction auxiliaire qui indique si deux fichiers (sur disque) ont le même contenu
+static bool fichiersIdentiques(const char *nomA, const char *nomB) {
+  FILE *a = fopen(nomA, "rb");
+  FILE *b = fopen(nomB, "rb");
+  bool identiques = a != NULL && b != NULL;
+  while (identiques) {
+    int octetA = fgetc(a);
+    identiques = octetA == fgetc(b);
+    if (octetA == EOF) {
+      break;
+    }
+  }
+  if (a != NULL) {
+    fclose(a);
+  }
+  if (b != NULL) {
+    fclose(b);
+  }
+  return identiques;
+}
+
+int main(void) {
+  DebuterVerifications("demo_dates");
+  unsigned char contenu[TAILLE_DEMO];
+  for (long i = 0; i < TAILLE_DEMO; i++) {
+    contenu[i] = (unsigned char)('a' + i % 26);
+  }
+  time_t maintenant = time(NULL);
+
+  // === PHASE 1 : DATES_STRICTES (par défaut) ===
+  printf("--- PHASE 1 : DATES_STRICTES ---\n");
+  tInode inode = CreerInode(1, ORDINAIRE);
+  Verifier(EcrireDonneesInode(inode, contenu, TAILLE_DEMO, 0) == TAILLE_DEMO, "ecriture de 100 octets");
+  Verifier(forgerDates(&inode, maintenant - 2 * UNE_HEURE, maintenant - 3 * UNE_HEURE),
+           "acces il y a 2 h, modification il y a 3 h");
+  Verifier(DateDerAcces(inode) == maintenant - 2 * UNE_HEURE && DateDerModif(inode) == maintenant - 3 * UNE_HEURE
+           && ContenuInodeEgal(inode, contenu, TAILLE_DEMO), "dates et contenu recharges");
+  // ContenuInodeEgal a lu l'inode : les dates sont forgées à nouveau
+  forgerDates(&inode, maintenant - 2 * UNE_HEURE, maintenant - 3 * UNE_HEURE);
+  AfficherInode(inode);
+  Verifier(DateDerAcces(inode) == maintenant - 2 * UNE_HEURE, "AfficherInode ne change pas la date d'acces");
+  Verifier(lireDebut(inode) && DateDerAcces(inode) >= maintenant, "la lecture met a jour la date d'acces");
+  Verifier(DateDerModif(inode) == maintenant - 3 * UNE_HEURE, "la lecture ne change pas la date de modification");
+
+  // === PHASE 2 : DATES_RELATIVES (relatime) ===
+  printf("\n--- PHASE 2 : DATES_RELATIVES ---\n");
+  forgerDates(&inode, maintenant - 2 * UNE_HEURE, maintenant - 3 * UNE_HEURE);
+  Verifier(PolitiqueDatesInode(inode, DATES_RELATIVES) == 0, "politique DATES_RELATIVES");
+  Verifier(lireDebut(inode) && DateDerAcces(inode) == maintenant - 2 * UNE_HEURE,
+           "acces recent apres la modification : date inchangee");
+  forgerDates(&inode, maintenant - 3 * UNE_HEURE, maintenant - 2 * UNE_HEURE);
+  PolitiqueDatesInode(inode, DATES_RELATIVES);
+  Verifier(lireDebut(inode) && DateDerAcces(inode) >= maintenant, "acces avant la modification : date mise a jour");
+  time_t acces = DateDerAcces(inode);
+  Verifier(lireDebut(inode) && DateDerAcces(inode) == acces, "lecture suivante : date inchangee");
+  forgerDates(&inode, maintenant - 2 * UN_JOUR, maintenant - 3 * UN_JOUR);
+  PolitiqueDatesInode(inode, DATES_RELATIVES);
+  Verifier(lireDebut(inode) && DateDerAcces(inode) >= maintenant, "acces de plus d'un jour : date mise a jour");
+  Verifier(EcrireDonneesInode(inode, contenu, 10, 0) == 10 && DateDerModif(inode) >= maintenant,
+           "l'ecriture met a jour la date de modification");
+
+  // === PHASE 3 : SANS_DATE_ACCES (noatime) ===
+  printf("\n--- PHASE 3 : SANS_DATE_ACCES ---\n");
+  forgerDates(&inode, maintenant - 2 * UN_JOUR, maintenant - 3 * UN_JOUR);
+  Verifier(PolitiqueDatesInode(inode, SANS_DATE_ACCES) == 0, "politique SANS_DATE_ACCES");
+  Verifier(lireDebut(inode) && DateDerAcces(inode) == maintenant - 2 * UN_JOUR,
+           "la lecture ne change pas la date d'acces");
+  Verifier(EcrireDonneesInode(inode, contenu, 10, 0) == 10 && DateDerModif(inode) >= maintenant
+           && DateDerAcces(inode) == maintenant - 2 * UN_JOUR, "l'ecriture met a jour la date de modification seule");
+  Verifier(PolitiqueDatesInode(NULL, SANS_DATE_ACCES) == -1, "politique d'un inode inexistant refusee");
+  DetruireInode(&inode);
+
+  // === PHASE 4 : conservation par SauvegarderSF/ChargerSF ===
+  // les dates sont dans la sauvegarde : deux sauvegardes séparées par une lecture plus tard
+  // sont identiques si et seulement si la lecture n'a pas changé de date
+  printf("\n--- PHASE 4 : SauvegarderSF/ChargerSF ---\n");
+  tSF sf = CreerSF("demo_dates");
+  Verifier(sf != NULL && CreerFichierContenu(sf, "a.txt", contenu, TAILLE_DEMO), "creation de a.txt");
+  Verifier(PolitiqueDatesSF(sf, SANS_DATE_ACCES) == 0, "politique SANS_DATE_ACCES du SF");
+  Verifier(SauvegarderSF(sf, NOM_SAUVEGARDE_1) == 0, "sauvegarde du SF");
+  DetruireSF(&sf);
+  Verifier(ChargerSF(&sf, NOM_SAUVEGARDE_1) == 0, "chargement du SF");
+  attendreSecondeSuivante();
+  Verifier(lireDebutFichier(sf, "a.txt") && SauvegarderSF(sf, NOM_SAUVEGARDE_2) == 0,
+           "lecture de a.txt une seconde plus tard, nouvelle sauvegarde");
+  Verifier(fichiersIdentiques(NOM_SAUVEGARDE_1, NOM_SAUVEGARDE_2), "politique conservee : aucune date changee");
+  Verifier(PolitiqueDatesSF(sf, DATES_STRICTES) == 0, "politique DATES_STRICTES du SF");
+  Verifier(lireDebutFichier(sf, "a.txt") && SauvegarderSF(sf, NOM_SAUVEGARDE_3) == 0,
+           "nouvelle lecture de a.txt, nouvelle sauvegarde");
+  Verifier(!fichiersIdentiques(NOM_SAUVEGARDE_2, NOM_SAUVEGARDE_3), "la date d'acces a change");
+  DetruireSF(&sf);
+  Verifier(ChargerSF(&sf, NOM_SAUVEGARDE_3) == 0 && ContenuFichierEgal(sf, "a.txt", contenu, TAILLE_DEMO),
+           "chargement de la derniere sauvegarde");
+  DetruireSF(&sf);
+  Verifier(PolitiqueDatesSF(NULL, DATES_RELATIVES) == -1, "politique d'un SF inexistant refusee");
+
+  remove(NOM_SAUVEGARDE_1);
+  remove(NOM_SAUVEGARDE_2);
+  remove(NOM_SAUVEGARDE_3);
+  return TerminerVerifications("DATES");
+}
@@ -0,0 +1,122 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : demo_dedup.c
+ * Démonstration de la déduplication des blocs : blocs identiques partagés, copie sur écriture,
+ * libération à la dernière référence, conservation par SauvegarderSF/ChargerSF, et cas d'erreur.
+ * Chaque étape vérifie ses résultats (voir verification.h).
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "disque.h"
+#include "inode.h"
+#include "sf.h"
+#include "verification.h"
+
+// Nombre de blocs des fichiers de la démonstration, et nombre de contenus de blocs différents
+#define NB_BLOCS_DEMO 32
+#define NB_MOTIFS 4
+
+// fonction auxiliaire qui remplit une zone de blocs répétant NB_MOTIFS contenus différents
+static void remplirMotifs(unsigned char *zone, long nbBlocs, long tailleBloc) {
+  for (long i = 0; i < nbBlocs * tailleBloc; i++) {
+    long motif = (i / tailleBloc) % NB_MOTIFS;
+    zone[i] = (unsigned char)(motif * 37 + (i % tailleBloc));
+  }
+}
+
+int main(void) {
+  DebuterVerifications("demo_dedup");
+  long tailleBloc = TAILLE_BLOC;
+  long taille = NB_BLOCS_DEMO * tailleBloc;
+  unsigned char *donnees = malloc(taille);
+  if (donnees == NULL) {
+    return 1;
+  }
+  remplirMotifs(donnees, NB_BLOCS_DEMO, tailleBloc);
+
+  // === PHASE 1 : blocs identiques d'un même fichier ===
+  printf("--- PHASE 1 : blocs identiques d'un meme fichier ---\n");
+  tDisque disque = CreerDisque(tailleBloc);
+  Verifier(disque != NULL && ActiverDeduplicationDisque(disque) == 0, "creation du disque avec deduplication");
+  Verifier(DeduplicationActiveDisque(disque), "deduplication active");
+  long libresAuDebut = NbBlocsLibresDisque(disque);
+  tInode a = CreerInode(1, ORDINAIRE);
+  AssocierDisqueInode(a, disque);
+  Verifier(EcrireDonneesInode(a, donnees, taille, 0) == taille, "ecriture de 32 blocs (4 contenus differents)");
+  Verifier(NbBlocsLibresDisque(disque) == libresAuDebut - NB_MOTIFS, "4 blocs occupes sur le disque");
+  Verifier(NbReferencesPartageesDisque(disque) == NB_BLOCS_DEMO - NB_MOTIFS, "28 references partagees");
+  Verifier(ContenuInodeEgal(a, donnees, taille), "relecture du fichier");
+
+  // === PHASE 2 : un second fichier de même contenu ===
+  printf("\n--- PHASE 2 : second fichier de meme contenu ---\n");
+  tInode b = CreerInode(2, ORDINAIRE);
+  AssocierDisqueInode(b, disque);
+  Verifier(EcrireDonneesInode(b, donnees, taille, 0) == taille, "ecriture du second fichier");
+  Verifier(NbBlocsLibresDisque(disque) == libresAuDebut - NB_MOTIFS, "aucun nouveau bloc occupe");
+  Verifier(NbReferencesPartageesDisque(disque) == 2 * NB_BLOCS_DEMO - NB_MOTIFS, "60 references partagees");
+  Verifier(ContenuInodeEgal(b, donnees, taille), "relecture du second fichier");
+
+  // === PHASE 3 : copie sur écriture ===
+  printf("\n--- PHASE 3 : modification d'un bloc partage (copie sur ecriture) ---\n");
+  unsigned char *modifie = malloc(taille);
+  if (modifie == NULL) {
+    return 1;
+  }
+  memcpy(modifie, donnees, taille);
+  memset(modifie + 5 * tailleBloc + 10, 0xEE, 20);
+  Verifier(EcrireDonneesInode(a, modifie + 5 * tailleBloc + 10, 20, 5 * tailleBloc + 10) == 20,
+           "ecriture de 20 octets dans le bloc 5 du premier fichier");
+  Verifier(NbBlocsLibresDisque(disque) == libresAuDebut - NB_MOTIFS - 1, "un bloc recopie");
+  Verifier(ContenuInodeEgal(a, modifie, taille), "le premier fichier voit sa modification");
+  Verifier(ContenuInodeEgal(b, donnees, taille), "le second fichier est inchange");
+
+  // === PHASE 4 : libération à la dernière référence ===
+  printf("\n--- PHASE 4 : destruction des fichiers ---\n");
+  DetruireInode(&a);
+  Verifier(NbBlocsLibresDisque(disque) == libresAuDebut - NB_MOTIFS, "le bloc recopie est libere");
+  Verifier(ContenuInodeEgal(b, donnees, taille), "le second fichier reste lisible");
+  DetruireInode(&b);
+  Verifier(NbBlocsLibresDisque(disque) == libresAuDebut, "tous les blocs sont rendus au disque");
+  Verifier(NbReferencesPartageesDisque(disque) == 0, "plus aucune reference partagee");
+  DetruireDisque(&disque);
+
+  // === PHASE 5 : système de fichiers sauvegardé et rechargé ===
+  printf("\n--- PHASE 5 : sauvegarde et chargement d'un SF deduplique ---\n");
+  FILE *source = fopen("demo_dedup_source.bin", "wb");
+  Verifier(source != NULL && fwrite(donnees, 1, taille, source) == (size_t)taille && fclose(source) == 0,
+           "creation du fichier source");
+  tSF sf = CreerSF("demo_dedup");
+  Verifier(sf != NULL && ActiverDeduplicationSF(sf) == 0, "creation du SF avec deduplication");
+  Verifier(EcrireFichierSF(sf, "demo_dedup_source.bin", ORDINAIRE) == taille, "import du fichier source");
+  Verifier(CloneFichierSF(sf, "demo_dedup_source.bin", "copie.bin") == taille, "clone du fichier");
+  Verifier(SauvegarderSF(sf, "demo_dedup.sf") == 0, "sauvegarde du SF");
+  DetruireSF(&sf);
+  Verifier(ChargerSF(&sf, "demo_dedup.sf") == 0, "chargement du SF");
+  Verifier(ContenuFichierEgal(sf, "demo_dedup_source.bin", donnees, taille), "relecture du fichier importe");
+  Verifier(ContenuFichierEgal(sf, "copie.bin", donnees, taille), "relecture du clone");
+  Df(sf);
+  DetruireSF(&sf);
+  remove("demo_dedup_source.bin");
+  remove("demo_dedup.sf");
+
+  // === PHASE 6 : cas d'erreur ===
+  printf("\n--- PHASE 6 : cas d'erreur ---\n");
+  disque = CreerDisque(tailleBloc);
+  Verifier(ActiverDeduplicationDisque(NULL) == -1, "activation sur un disque inexistant refusee");
+  Verifier(!DeduplicationActiveDisque(disque), "deduplication inactive par defaut");
+  Verifier(PartagerBlocDisque(disque, 1) == -1, "partage d'un bloc libre refuse");
+  Verifier(PartagerBlocDisque(disque, (tNumeroBloc)NbBlocsDisque(disque)) == -1, "partage d'un bloc hors du disque refuse");
+  Verifier(NbReferencesBlocDisque(disque, 1) == 0, "un bloc libre n'a pas de reference");
+  Verifier(ActiverDeduplicationSF(NULL) == -1, "activation sur un SF inexistant refusee");
+  DetruireDisque(&disque);
+
+  free(donnees);
+  free(modifie);
+  return TerminerVerifications("DEDUPLICATION");
+}
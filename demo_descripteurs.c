@@ -0,0 +1,151 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : demo_descripteurs.c
+ * Démonstration de la table des fichiers ouverts du SF (OuvrirSF, LireSF, EcrireSF, PositionnerSF, FermerSF) :
+ * écritures et lectures séquentielles, déplacements et trous, ajouts à la fin du fichier, réutilisation
+ * des descripteurs, conservation par SauvegarderSF/ChargerSF, et cas d'erreur.
+ * Chaque étape vérifie ses résultats (voir verification.h).
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "sf.h"
+#include "verification.h"
+
+// Taille du fichier de la démonstration (40 blocs de 64 octets), et des morceaux lus ou écrits
+#define TAILLE_DEMO (40 * TAILLE_BLOC)
+#define TAILLE_MORCEAU 100
+
+// Fichier de sauvegarde de la démonstration (effacé à la fin)
+#define NOM_SAUVEGARDE "demo_descripteurs.sav"
+
+// fonction auxiliaire qui indique si un fichier du SF contient exactement les taille octets attendus,
+// lus par morceaux jusqu'à la fin du fichier
+static bool contenuFichierEgal(tSF sf, char nom[], const unsigned char *attendu, long taille) {
+  int descripteur = OuvrirSF(sf, nom, OUVERTURE_LECTURE);
+  if (descripteur < 0) {
+    return false;
+  }
+  unsigned char *lu = malloc(taille + TAILLE_MORCEAU);
+  long total = 0, octetsLus;
+  while (lu != NULL && (octetsLus = LireSF(sf, descripteur, lu + total, TAILLE_MORCEAU)) > 0) {
+    total += octetsLus;
+    if (total > taille) {
+      break;
+    }
+  }
+  bool egal = lu != NULL && total == taille && memcmp(lu, attendu, taille) == 0;
+  free(lu);
+  FermerSF(sf, descripteur);
+  return egal;
+}
+
+int main(void) {
+  DebuterVerifications("demo_descripteurs");
+  unsigned char contenu[TAILLE_DEMO], attendu[TAILLE_DEMO + 200];
+  for (long i = 0; i < TAILLE_DEMO; i++) {
+    contenu[i] = (unsigned char)(i * 11 + i / 64);
+  }
+
+  // === PHASE 1 : écritures et lectures séquentielles ===
+  printf("--- PHASE 1 : ecritures et lectures sequentielles ---\n");
+  tSF sf = CreerSF("demo");
+  int descripteur = OuvrirSF(sf, "seq.bin", OUVERTURE_ECRITURE | OUVERTURE_CREATION);
+  Verifier(descripteur == 0, "creation de seq.bin : descripteur 0");
+  bool ecrit = true;
+  for (long decalage = 0; decalage < TAILLE_DEMO; decalage += TAILLE_MORCEAU) {
+    long morceau = (TAILLE_DEMO - decalage < TAILLE_MORCEAU) ? TAILLE_DEMO - decalage : TAILLE_MORCEAU;
+    ecrit = ecrit && EcrireSF(sf, descripteur, contenu + decalage, morceau) == morceau;
+  }
+  Verifier(ecrit && PositionnerSF(sf, descripteur, 0, SEEK_CUR) == TAILLE_DEMO,
+           "26 ecritures a la suite, la position avance");
+  Verifier(FermerSF(sf, descripteur) == 0, "fermeture");
+  Verifier(contenuFichierEgal(sf, "seq.bin", contenu, TAILLE_DEMO), "relecture par morceaux jusqu'a la fin");
+
+  // === PHASE 2 : déplacements ===
+  printf("\n--- PHASE 2 : deplacements et trou ---\n");
+  descripteur = OuvrirSF(sf, "seq.bin", OUVERTURE_LECTURE | OUVERTURE_ECRITURE);
+  unsigned char lu[TAILLE_MORCEAU];
+  Verifier(PositionnerSF(sf, descripteur, 1000, SEEK_SET) == 1000 && LireSF(sf, descripteur, lu, 50) == 50
+           && memcmp(lu, contenu + 1000, 50) == 0, "lecture a la position 1000 (SEEK_SET)");
+  Verifier(PositionnerSF(sf, descripteur, -20, SEEK_CUR) == 1030 && LireSF(sf, descripteur, lu, 10) == 10
+           && memcmp(lu, contenu + 1030, 10) == 0, "recul de 20 octets (SEEK_CUR)");
+  Verifier(PositionnerSF(sf, descripteur, -30, SEEK_END) == TAILLE_DEMO - 30
+           && LireSF(sf, descripteur, lu, TAILLE_MORCEAU) == 30 && memcmp(lu, contenu + TAILLE_DEMO - 30, 30) == 0,
+           "lecture arretee a la fin du fichier (SEEK_END)");
+  Verifier(LireSF(sf, descripteur, lu, TAILLE_MORCEAU) == 0, "0 octet lu a la fin du fichier");
+  memcpy(attendu, contenu, TAILLE_DEMO);
+  memset(attendu + TAILLE_DEMO, 0, 150);
+  memset(attendu + TAILLE_DEMO + 150, 'Z', 50);
+  memset(lu, 'Z', 50);
+  Verifier(PositionnerSF(sf, descripteur, 150, SEEK_END) == TAILLE_DEMO + 150
+           && EcrireSF(sf, descripteur, lu, 50) == 50, "ecriture 150 octets apres la fin");
+  FermerSF(sf, descripteur);
+  Verifier(contenuFichierEgal(sf, "seq.bin", attendu, TAILLE_DEMO + 200), "le trou se lit a zero");
+
+  // === PHASE 3 : ajouts et descripteurs ===
+  printf("\n--- PHASE 3 : ajouts a la fin et reutilisation des descripteurs ---\n");
+  int ajout = OuvrirSF(sf, "journal.txt", OUVERTURE_ECRITURE | OUVERTURE_AJOUT | OUVERTURE_CREATION);
+  int lecteur = OuvrirSF(sf, "journal.txt", OUVERTURE_LECTURE);
+  int autre = OuvrirSF(sf, "seq.bin", OUVERTURE_LECTURE);
+  Verifier(ajout == 0 && lecteur == 1 && autre == 2, "trois descripteurs : 0, 1 et 2");
+  bool ajoute = true;
+  for (int i = 0; i < 10; i++) {
+    ajoute = ajoute && EcrireSF(sf, ajout, (unsigned char *)"ligne ", 6) == 6;
+    PositionnerSF(sf, ajout, 0, SEEK_SET);
+  }
+  Verifier(ajoute, "10 ajouts, la position ne compte pas");
+  Verifier(LireSF(sf, lecteur, lu, TAILLE_MORCEAU) == 60 && memcmp(lu, "ligne ligne ", 12) == 0,
+           "un autre descripteur lit les ajouts");
+  Verifier(FermerSF(sf, lecteur) == 0 && OuvrirSF(sf, "seq.bin", OUVERTURE_LECTURE) == 1,
+           "le descripteur 1 libere est redonne");
+  FermerSF(sf, 1);
+  FermerSF(sf, autre);
+  FermerSF(sf, ajout);
+  for (int i = 0; i < 10; i++) {
+    memcpy(attendu + 6 * i, "ligne ", 6);
+  }
+  Verifier(contenuFichierEgal(sf, "journal.txt", attendu, 60), "journal.txt relu apres fermeture");
+
+  // === PHASE 4 : sauvegarde ===
+  printf("\n--- PHASE 4 : sauvegarde et chargement ---\n");
+  descripteur = OuvrirSF(sf, "journal.txt", OUVERTURE_ECRITURE | OUVERTURE_AJOUT);
+  EcrireSF(sf, descripteur, (unsigned char *)"fin", 3);
+  Verifier(SauvegarderSF(sf, NOM_SAUVEGARDE) == 0, "sauvegarde avec un fichier ouvert en ajout");
+  memcpy(attendu + 60, "fin", 3);
+  tSF charge = NULL;
+  Verifier(ChargerSF(&charge, NOM_SAUVEGARDE) == 0, "chargement");
+  Verifier(contenuFichierEgal(charge, "journal.txt", attendu, 63), "les ajouts en attente sont sauvegardes");
+  Verifier(LireSF(charge, descripteur, lu, 10) == -1, "les descripteurs ne sont pas conserves");
+  DetruireSF(&charge);
+  FermerSF(sf, descripteur);
+  remove(NOM_SAUVEGARDE);
+
+  // === PHASE 5 : cas d'erreur ===
+  printf("\n--- PHASE 5 : cas d'erreur ---\n");
+  Verifier(OuvrirSF(sf, "absent.txt", OUVERTURE_LECTURE) == -1, "fichier inexistant sans OUVERTURE_CREATION");
+  Verifier(OuvrirSF(sf, "seq.bin", 0) == -1, "ouverture sans lecture ni ecriture refusee");
+  Verifier(OuvrirSF(NULL, "seq.bin", OUVERTURE_LECTURE) == -1, "ouverture dans un SF inexistant refusee");
+  Verifier(LireSF(sf, 5, lu, 10) == -1 && LireSF(sf, -1, lu, 10) == -1, "descripteurs non ouverts refuses");
+  Verifier(FermerSF(sf, 5) == -1, "fermeture d'un descripteur non ouvert refusee");
+  descripteur = OuvrirSF(sf, "seq.bin", OUVERTURE_LECTURE);
+  Verifier(EcrireSF(sf, descripteur, lu, 10) == -1, "ecriture par un descripteur en lecture seule");
+  Verifier(PositionnerSF(sf, descripteur, -1, SEEK_SET) == -1
+           && PositionnerSF(sf, descripteur, -TAILLE_DEMO - 500, SEEK_END) == -1, "position negative refusee");
+  Verifier(PositionnerSF(sf, descripteur, 0, 42) == -1, "origine invalide refusee");
+  Verifier(SupprimerFichierSF(sf, "seq.bin") == -1, "suppression d'un fichier ouvert refusee");
+  FermerSF(sf, descripteur);
+  Verifier(SupprimerFichierSF(sf, "seq.bin") == 0, "suppression apres fermeture");
+  descripteur = OuvrirSF(sf, "journal.txt", OUVERTURE_ECRITURE);
+  Verifier(LireSF(sf, descripteur, lu, 10) == -1, "lecture par un descripteur en ecriture seule");
+  FermerSF(sf, descripteur);
+  Verifier(LireSF(sf, descripteur, lu, 10) == -1, "lecture par un descripteur ferme");
+  DetruireSF(&sf);
+
+  return TerminerVerifications("DESCRIPTEURS");
+}
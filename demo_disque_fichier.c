@@ -0,0 +1,152 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : demo_disque_fichier.c
+ * Démonstration des disques stockés dans un fichier image : blocs écrits puis relus à travers le cache,
+ * image rouverte après SauvegarderDisque/ChargerDisque, SF sur fichier sauvegardé puis rechargé,
+ * et cas d'erreur (image impossible à créer, image disparue au chargement).
+ * Chaque étape vérifie ses résultats (voir verification.h).
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "bloc.h"
+#include "disque.h"
+#include "inode.h"
+#include "sf.h"
+#include "verification.h"
+
+// Taille des blocs et nombre de blocs écrits
+#define TAILLE_BLOC_DEMO 512
+#define NB_BLOCS_DEMO 100
+
+// fonction auxiliaire qui remplit un bloc d'un contenu propre à son rang
+static void remplirBloc(unsigned char *bloc, long rang) {
+  for (long i = 0; i < TAILLE_BLOC_DEMO; i++) {
+    bloc[i] = (unsigned char)(rang * 31 + i);
+  }
+}
+
+// fonction auxiliaire qui indique si les blocs numeros[0..nb-1] d'un disque ont le contenu de leur rang
+static bool blocsIntacts(tDisque disque, tNumeroBloc numeros[], long nb) {
+  unsigned char attendu[TAILLE_BLOC_DEMO], lu[TAILLE_BLOC_DEMO];
+  for (long rang = 0; rang < nb; rang++) {
+    remplirBloc(attendu, rang);
+    if (LireBlocDisque(disque, numeros[rang], 0, lu, TAILLE_BLOC_DEMO) != TAILLE_BLOC_DEMO
+        || memcmp(lu, attendu, TAILLE_BLOC_DEMO) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// fonction auxiliaire qui retourne la taille d'un fichier (sur disque), -1 s'il n'existe pas
+static long tailleFichier(const char *nom) {
+  struct stat infos;
+  return (stat(nom, &infos) == 0) ? (long)infos.st_size : -1;
+}
+
+int main(void) {
+  DebuterVerifications("demo_disque_fichier");
+  unsigned char bloc[TAILLE_BLOC_DEMO];
+  tNumeroBloc numeros[NB_BLOCS_DEMO];
+
+  // === PHASE 1 : blocs écrits puis relus ===
+  printf("--- PHASE 1 : disque dans un fichier image ---\n");
+  tDisque disque = CreerDisqueFichier(TAILLE_BLOC_DEMO, "demo_disque.img");
+  Verifier(disque != NULL && TailleBlocDisque(disque) == TAILLE_BLOC_DEMO, "creation du disque et de son image");
+  bool alloues = true;
+  for (long rang = 0; rang < NB_BLOCS_DEMO && alloues; rang++) {
+    numeros[rang] = AllouerBlocDisque(disque, BLOC_NUL);
+    remplirBloc(bloc, rang);
+    alloues = numeros[rang] != BLOC_NUL
+              && EcrireBlocDisque(disque, numeros[rang], 0, bloc, TAILLE_BLOC_DEMO) == TAILLE_BLOC_DEMO;
+  }
+  Verifier(alloues, "allocation et ecriture de 100 blocs");
+  Verifier(blocsIntacts(disque, numeros, NB_BLOCS_DEMO), "relecture des 100 blocs");
+  Verifier(TailleMemoireCacheDisque(disque) > 0, "les blocs passent par le cache");
+
+  // un bloc libéré puis réalloué est réécrit en entier
+  LibererBlocDisque(disque, numeros[10]);
+  Verifier(AllouerBlocDisque(disque, numeros[10]) == numeros[10], "bloc libere puis realloue");
+  remplirBloc(bloc, 10);
+  Verifier(EcrireBlocDisque(disque, numeros[10], 0, bloc, TAILLE_BLOC_DEMO) == TAILLE_BLOC_DEMO, "bloc reecrit");
+
+  // === PHASE 2 : sauvegarde et chargement du disque ===
+  printf("\n--- PHASE 2 : sauvegarde et chargement du disque ---\n");
+  FILE *fichier = fopen("demo_disque.sauve", "wb");
+  Verifier(fichier != NULL && SauvegarderDisque(disque, fichier) == 0 && fclose(fichier) == 0,
+           "sauvegarde du disque (metadonnees et nom de l'image)");
+  Verifier(tailleFichier("demo_disque.img") >= (NB_BLOCS_DEMO + 1) * TAILLE_BLOC_DEMO,
+           "les blocs sont dans l'image");
+  Verifier(tailleFichier("demo_disque.sauve") < NB_BLOCS_DEMO * TAILLE_BLOC_DEMO,
+           "la sauvegarde ne contient pas les blocs");
+  long libres = NbBlocsLibresDisque(disque);
+  DetruireDisque(&disque);
+  fichier = fopen("demo_disque.sauve", "rb");
+  Verifier(fichier != NULL && ChargerDisque(&disque, fichier) == 0, "chargement du disque (image rouverte)");
+  if (fichier != NULL) {
+    fclose(fichier);
+  }
+  Verifier(disque != NULL && NbBlocsLibresDisque(disque) == libres, "meme nombre de blocs libres");
+  Verifier(disque != NULL && blocsIntacts(disque, numeros, NB_BLOCS_DEMO), "relecture des 100 blocs depuis l'image");
+  DetruireDisque(&disque);
+
+  // === PHASE 3 : SF sur fichier ===
+  printf("\n--- PHASE 3 : SF sur fichier, sauvegarde et chargement ---\n");
+  tSF sf = CreerSFSurFichier("demo_disque_fichier", TAILLE_BLOC_DEMO, "demo_sf.img");
+  Verifier(sf != NULL, "creation du SF sur fichier");
+  int descripteur = OuvrirSF(sf, "donnees.bin", OUVERTURE_ECRITURE | OUVERTURE_CREATION);
+  bool ecrit = descripteur >= 0;
+  for (long rang = 0; rang < NB_BLOCS_DEMO && ecrit; rang++) {
+    remplirBloc(bloc, rang);
+    ecrit = EcrireSF(sf, descripteur, bloc, TAILLE_BLOC_DEMO) == TAILLE_BLOC_DEMO;
+  }
+  Verifier(ecrit && FermerSF(sf, descripteur) == 0, "ecriture d'un fichier de 100 blocs");
+  Verifier(SauvegarderSF(sf, "demo_sf.sauve") == 0, "sauvegarde du SF");
+  DetruireSF(&sf);
+  Verifier(ChargerSF(&sf, "demo_sf.sauve") == 0, "chargement du SF");
+  descripteur = OuvrirSF(sf, "donnees.bin", OUVERTURE_LECTURE);
+  bool relu = descripteur >= 0;
+  unsigned char attendu[TAILLE_BLOC_DEMO];
+  for (long rang = 0; rang < NB_BLOCS_DEMO && relu; rang++) {
+    remplirBloc(attendu, rang);
+    relu = LireSF(sf, descripteur, bloc, TAILLE_BLOC_DEMO) == TAILLE_BLOC_DEMO
+           && memcmp(bloc, attendu, TAILLE_BLOC_DEMO) == 0;
+  }
+  Verifier(relu && LireSF(sf, descripteur, bloc, 1) == 0, "relecture du fichier jusqu'a sa fin");
+  FermerSF(sf, descripteur);
+  Df(sf);
+  DetruireSF(&sf);
+
+  // === PHASE 4 : cas d'erreur ===
+  printf("\n--- PHASE 4 : cas d'erreur ---\n");
+  Verifier(CreerDisqueFichier(TAILLE_BLOC_DEMO, "repertoire_inexistant/demo.img") == NULL,
+           "image impossible a creer");
+  Verifier(CreerDisqueFichier(100, "demo_invalide.img") == NULL, "taille de bloc invalide refusee");
+  Verifier(CreerSFSurFichier("demo", TAILLE_BLOC_DEMO, NULL) == NULL, "SF sans nom d'image refuse");
+  remove("demo_disque.img");
+  fichier = fopen("demo_disque.sauve", "rb");
+  disque = NULL;
+  Verifier(fichier != NULL && ChargerDisque(&disque, fichier) == -1 && disque == NULL,
+           "chargement refuse quand l'image a disparu");
+  if (fichier != NULL) {
+    fclose(fichier);
+  }
+  remove("demo_sf.img");
+  Verifier(ChargerSF(&sf, "demo_sf.sauve") == -1, "chargement du SF refuse quand l'image a disparu");
+  tStatsCache stats;
+  disque = CreerDisque(TAILLE_BLOC_DEMO);
+  Verifier(StatistiquesCacheDisque(disque, &stats) == -1 && TailleMemoireCacheDisque(disque) == 0,
+           "un disque en memoire n'a pas de cache");
+  DetruireDisque(&disque);
+
+  remove("demo_disque.sauve");
+  remove("demo_sf.sauve");
+  remove("demo_invalide.img");
+  return TerminerVerifications("DISQUE SUR FICHIER");
+}
@@ -0,0 +1,159 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : demo_import.c
+ * Démonstration de l'import d'un fichier du système par tronçons : depuis un chemin (EcrireFichierSF),
+ * un flux alimenté par un tube (EcrireFluxSF) ou un descripteur de tube (EcrireDescripteurSystemeSF),
+ * source vide, source tronquée à la taille maximale d'un fichier, SF compressé, et cas d'erreur.
+ * Chaque étape vérifie ses résultats (voir verification.h).
+ **/
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "bloc.h"
+#include "inode.h"
+#include "sf.h"
+#include "verification.h"
+
+// Taille de la source (plusieurs tronçons de 64 Kio), et taille de la source tronquée
+#define TAILLE_SOURCE 200000L
+#define TAILLE_TROP_GRANDE 300000L
+
+// Fichier source sur le disque de la machine (effacé à la fin)
+#define NOM_SOURCE "demo_import.src"
+
+// fonction auxiliaire qui écrit un fichier source sur le disque de la machine
+static bool ecrireSource(const unsigned char *contenu, long taille) {
+  FILE *fichier = fopen(NOM_SOURCE, "wb");
+  if (fichier == NULL) {
+    return false;
+  }
+  bool ecrit = (long)fwrite(contenu, 1, taille, fichier) == taille;
+  return fclose(fichier) == 0 && ecrit;
+}
+
+// fonction auxiliaire qui crée un tube dont un processus fils écrit les taille octets puis ferme l'entrée :
+// retourne le descripteur de la sortie du tube (-1 en cas d'erreur) et le numéro du fils
+static int ouvrirTube(const unsigned char *contenu, long taille, pid_t *pFils) {
+  int tube[2];
+  if (pipe(tube) != 0) {
+    return -1;
+  }
+  *pFils = fork();
+  if (*pFils < 0) {
+    close(tube[0]);
+    close(tube[1]);
+    return -1;
+  }
+  if (*pFils == 0) {
+    close(tube[0]);
+    for (long ecrits = 0, n; ecrits < taille; ecrits += n) {
+      n = write(tube[1], contenu + ecrits, taille - ecrits);
+      if (n <= 0) {
+        _exit(1);
+      }
+    }
+    close(tube[1]);
+    _exit(0);
+  }
+  close(tube[1]);
+  return tube[0];
+}
+
+// fonction auxiliaire qui attend la fin du fils qui alimente un tube : true s'il a tout écrit
+static bool fermerTube(pid_t fils) {
+  int statut;
+  return waitpid(fils, &statut, 0) == fils && WIFEXITED(statut) && WEXITSTATUS(statut) == 0;
+}
+
+int main(void) {
+  DebuterVerifications("demo_import");
+  unsigned char *contenu = malloc(TAILLE_TROP_GRANDE);
+  if (contenu == NULL) {
+    return 1;
+  }
+  for (long i = 0; i < TAILLE_TROP_GRANDE; i++) {
+    contenu[i] = (unsigned char)(i * 17 + i / 4096);
+  }
+  long tailleMax = TailleMaxFichierBlocs(TAILLE_BLOC);
+
+  // === PHASE 1 : import depuis un chemin ===
+  printf("--- PHASE 1 : import depuis un chemin (EcrireFichierSF) ---\n");
+  tSF sf = CreerSF("demo");
+  Verifier(ecrireSource(contenu, TAILLE_SOURCE), "fichier source de 200000 octets");
+  Verifier(EcrireFichierSF(sf, NOM_SOURCE, ORDINAIRE) == TAILLE_SOURCE, "import de 200000 octets (4 troncons)");
+  Verifier(ContenuFichierEgal(sf, NOM_SOURCE, contenu, TAILLE_SOURCE), "relecture du fichier importe");
+
+  // === PHASE 2 : import depuis des tubes ===
+  printf("\n--- PHASE 2 : import depuis un tube (EcrireFluxSF, EcrireDescripteurSystemeSF) ---\n");
+  pid_t fils;
+  int sortie = ouvrirTube(contenu, TAILLE_SOURCE, &fils);
+  FILE *flux = (sortie >= 0) ? fdopen(sortie, "rb") : NULL;
+  Verifier(flux != NULL, "tube ouvert en flux");
+  if (flux != NULL) {
+    Verifier(EcrireFluxSF(sf, flux, "flux.bin", ORDINAIRE) == TAILLE_SOURCE, "import du flux (taille inconnue)");
+    fclose(flux);
+    Verifier(fermerTube(fils), "le fils a ecrit toute la source");
+    Verifier(ContenuFichierEgal(sf, "flux.bin", contenu, TAILLE_SOURCE), "relecture du flux importe");
+  }
+  sortie = ouvrirTube(contenu + 1000, TAILLE_SOURCE, &fils);
+  Verifier(sortie >= 0, "tube ouvert");
+  if (sortie >= 0) {
+    Verifier(EcrireDescripteurSystemeSF(sf, sortie, "fd.bin", ORDINAIRE) == TAILLE_SOURCE,
+             "import du descripteur (read)");
+    close(sortie);
+    Verifier(fermerTube(fils), "le fils a ecrit toute la source");
+    Verifier(ContenuFichierEgal(sf, "fd.bin", contenu + 1000, TAILLE_SOURCE), "relecture du descripteur importe");
+  }
+  sortie = ouvrirTube(contenu, 0, &fils);
+  if (sortie >= 0) {
+    Verifier(EcrireDescripteurSystemeSF(sf, sortie, "vide.bin", ORDINAIRE) == 0, "import d'un tube vide : 0 octet");
+    close(sortie);
+    fermerTube(fils);
+    Verifier(ContenuFichierEgal(sf, "vide.bin", contenu, 0), "le fichier vide existe");
+  }
+
+  // === PHASE 3 : source tronquée ===
+  printf("\n--- PHASE 3 : source plus grande que la taille maximale d'un fichier ---\n");
+  Verifier(ecrireSource(contenu, TAILLE_TROP_GRANDE), "fichier source de 300000 octets");
+  SupprimerFichierSF(sf, NOM_SOURCE);
+  Verifier(EcrireFichierSF(sf, NOM_SOURCE, ORDINAIRE) == tailleMax, "import tronque a 280192 octets");
+  Verifier(ContenuFichierEgal(sf, NOM_SOURCE, contenu, tailleMax), "les premiers octets sont importes");
+  sortie = ouvrirTube(contenu, TAILLE_TROP_GRANDE, &fils);
+  if (sortie >= 0) {
+    Verifier(EcrireDescripteurSystemeSF(sf, sortie, "tronque.bin", ORDINAIRE) == tailleMax,
+             "import d'un tube tronque a 280192 octets");
+    close(sortie);
+    fermerTube(fils);
+    Verifier(ContenuFichierEgal(sf, "tronque.bin", contenu, tailleMax), "les premiers octets du tube sont importes");
+  }
+  DetruireSF(&sf);
+
+  // === PHASE 4 : SF compressé ===
+  printf("\n--- PHASE 4 : import dans un SF compresse ---\n");
+  sf = CreerSF("demo");
+  Verifier(ActiverCompressionSF(sf, true) == 0, "compression activee");
+  Verifier(ecrireSource(contenu, TAILLE_SOURCE), "fichier source de 200000 octets");
+  Verifier(EcrireFichierSF(sf, NOM_SOURCE, ORDINAIRE) == TAILLE_SOURCE, "import de 200000 octets");
+  Verifier(ContenuFichierEgal(sf, NOM_SOURCE, contenu, TAILLE_SOURCE), "relecture du fichier compresse");
+
+  // === PHASE 5 : cas d'erreur ===
+  printf("\n--- PHASE 5 : cas d'erreur ---\n");
+  Verifier(EcrireFichierSF(sf, "inexistant.bin", ORDINAIRE) == -1, "source inexistante refusee");
+  Verifier(EcrireFluxSF(sf, NULL, "nul.bin", ORDINAIRE) == -1, "flux inexistant refuse");
+  Verifier(EcrireDescripteurSystemeSF(sf, -1, "nul.bin", ORDINAIRE) == -1, "descripteur invalide refuse");
+  Verifier(EcrireFichierSF(NULL, NOM_SOURCE, ORDINAIRE) == -1, "import dans un SF inexistant refuse");
+  Verifier(OuvrirSF(sf, "nul.bin", OUVERTURE_LECTURE) == -1, "aucun fichier cree par les imports refuses");
+  DetruireSF(&sf);
+  remove(NOM_SOURCE);
+  free(contenu);
+
+  return TerminerVerifications("IMPORT");
+}
@@ -0,0 +1,102 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : demo_projection.c
+ * Démonstration du chargement d'un SF par projection de sa sauvegarde (mmap) : relecture des fichiers,
+ * modifications gardées en mémoire puis sauvegardées à la place de la sauvegarde projetée,
+ * bloc corrompu détecté à sa première lecture, et cas d'erreur.
+ * Chaque étape vérifie ses résultats (voir verification.h).
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "sf.h"
+#include "verification.h"
+
+// Taille des blocs, et du fichier de la démonstration
+#define TAILLE_BLOC_DEMO 1024
+#define TAILLE_DEMO (20 * TAILLE_BLOC_DEMO)
+
+// Alignement de l'image des blocs dans une sauvegarde (voir SauvegarderDisque)
+#define ALIGNEMENT_IMAGE 65536
+
+// fonction auxiliaire qui inverse un octet d'un fichier (sur disque) : retourne true si c'est fait
+static bool corrompreOctet(const char *nom, long position) {
+  FILE *fichier = fopen(nom, "r+b");
+  if (fichier == NULL) {
+    return false;
+  }
+  int octet;
+  bool fait = fseek(fichier, position, SEEK_SET) == 0 && (octet = fgetc(fichier)) != EOF
+              && fseek(fichier, position, SEEK_SET) == 0 && fputc(~octet & 0xFF, fichier) != EOF;
+  return fclose(fichier) == 0 && fait;
+}
+
+int main(void) {
+  DebuterVerifications("demo_projection");
+  unsigned char donnees[TAILLE_DEMO], autres[TAILLE_DEMO];
+  for (long i = 0; i < TAILLE_DEMO; i++) {
+    donnees[i] = (unsigned char)(i * 3 + i / 256);
+    autres[i] = (unsigned char)(255 - i % 251);
+  }
+
+  // === PHASE 1 : sauvegarde puis chargement projeté ===
+  printf("--- PHASE 1 : sauvegarde puis chargement par projection ---\n");
+  tSF sf = CreerSFAvecTailleBloc("demo_projection", TAILLE_BLOC_DEMO);
+  Verifier(sf != NULL && CreerFichierContenu(sf, "a.bin", donnees, TAILLE_DEMO), "creation de a.bin");
+  Verifier(CreerFichierContenu(sf, "b.bin", autres, TAILLE_DEMO), "creation de b.bin");
+  Verifier(SauvegarderSF(sf, "demo_projection.sf") == 0, "sauvegarde du SF");
+  DetruireSF(&sf);
+  Verifier(ChargerSF(&sf, "demo_projection.sf") == 0, "chargement du SF (blocs projetes)");
+  Verifier(ContenuFichierEgal(sf, "a.bin", donnees, TAILLE_DEMO), "relecture de a.bin");
+  Verifier(ContenuFichierEgal(sf, "b.bin", autres, TAILLE_DEMO), "relecture de b.bin");
+
+  // === PHASE 2 : modifications après chargement ===
+  printf("\n--- PHASE 2 : modifications du SF charge ---\n");
+  memset(donnees + 3000, 'P', 2000);
+  int descripteur = OuvrirSF(sf, "a.bin", OUVERTURE_ECRITURE);
+  Verifier(descripteur >= 0 && PositionnerSF(sf, descripteur, 3000, SEEK_SET) == 3000
+           && EcrireSF(sf, descripteur, donnees + 3000, 2000) == 2000 && FermerSF(sf, descripteur) == 0,
+           "reecriture de 2000 octets de a.bin");
+  Verifier(SupprimerFichierSF(sf, "b.bin") == 0, "suppression de b.bin");
+  Verifier(ContenuFichierEgal(sf, "a.bin", donnees, TAILLE_DEMO), "a.bin voit sa modification");
+
+  // la sauvegarde remplace celle qui est projetée (fichier temporaire renommé à la fin)
+  Verifier(SauvegarderSF(sf, "demo_projection.sf") == 0, "sauvegarde a la place de la sauvegarde projetee");
+  Verifier(ContenuFichierEgal(sf, "a.bin", donnees, TAILLE_DEMO), "le SF charge reste lisible");
+  DetruireSF(&sf);
+  Verifier(ChargerSF(&sf, "demo_projection.sf") == 0, "nouveau chargement");
+  Verifier(ContenuFichierEgal(sf, "a.bin", donnees, TAILLE_DEMO), "a.bin a sa modification");
+  Verifier(OuvrirSF(sf, "b.bin", OUVERTURE_LECTURE) == -1, "b.bin n'existe plus");
+  DetruireSF(&sf);
+
+  // === PHASE 3 : bloc corrompu dans la sauvegarde ===
+  printf("\n--- PHASE 3 : bloc corrompu dans la sauvegarde ---\n");
+  // l'image des blocs commence au premier multiple de 64 Kio après l'en-tête du disque (ici, à 64 Kio),
+  // le bloc n à n x TAILLE_BLOC_DEMO : on corrompt tous les blocs qui peuvent être ceux de a.bin
+  bool corrompu = true;
+  for (long bloc = 1; bloc <= 21 && corrompu; bloc++) {
+    corrompu = corrompreOctet("demo_projection.sf", ALIGNEMENT_IMAGE + bloc * TAILLE_BLOC_DEMO + 7);
+  }
+  Verifier(corrompu, "corruption d'un octet par bloc dans la sauvegarde");
+  Verifier(ChargerSF(&sf, "demo_projection.sf") == 0, "le chargement projete ne lit pas les blocs");
+  Verifier(!ContenuFichierEgal(sf, "a.bin", donnees, TAILLE_DEMO), "la corruption est detectee a la lecture");
+  DetruireSF(&sf);
+
+  // === PHASE 4 : cas d'erreur ===
+  printf("\n--- PHASE 4 : cas d'erreur ---\n");
+  Verifier(ChargerSF(&sf, "demo_inexistant.sf") == -1 && sf == NULL, "sauvegarde inexistante");
+  FILE *tronque = fopen("demo_tronque.sf", "wb");
+  Verifier(tronque != NULL && fwrite(donnees, 1, 100, tronque) == 100 && fclose(tronque) == 0,
+           "creation d'une sauvegarde invalide");
+  Verifier(ChargerSF(&sf, "demo_tronque.sf") == -1 && sf == NULL, "sauvegarde invalide refusee");
+  Verifier(SauvegarderSF(NULL, "demo_projection.sf") == -1, "sauvegarde d'un SF inexistant refusee");
+
+  remove("demo_projection.sf");
+  remove("demo_tronque.sf");
+  return TerminerVerifications("PROJECTION");
+}
@@ -0,0 +1,137 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : demo_vecteurs.c
+ * Démonstration des lectures et écritures vectorisées d'un inode (LireDonneesInodeV, EcrireDonneesInodeV) :
+ * segments éparpillés, qui se suivent ou se recouvrent, lectures arrêtées à la fin du fichier, fichier compressé,
+ * écriture arrêtée à la taille maximale d'un fichier, et cas d'erreur.
+ * Chaque étape vérifie ses résultats (voir verification.h).
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "disque.h"
+#include "inode.h"
+#include "verification.h"
+
+// Taille du fichier de la démonstration (40 blocs de 64 octets)
+#define TAILLE_DEMO (40 * TAILLE_BLOC)
+
+// fonction auxiliaire qui prépare un segment
+static void preparerSegment(struct sSegment *segment, unsigned char *contenu, long taille, long decalage) {
+  segment->contenu = contenu;
+  segment->taille = taille;
+  segment->decalage = decalage;
+  segment->traites = -1;
+}
+
+// fonction auxiliaire qui écrit puis relit des segments éparpillés dans un inode, et vérifie le contenu
+// obtenu par rapport à une copie en mémoire tenue à jour par des memcpy
+static void allerRetour(tInode inode, const char *nom) {
+  unsigned char attendu[TAILLE_DEMO];
+  unsigned char a[100], b[30], c[50], d[200];
+  memset(attendu, 0, TAILLE_DEMO);
+  memset(a, 'A', sizeof(a));
+  memset(b, 'B', sizeof(b));
+  memset(c, 'C', sizeof(c));
+  for (long i = 0; i < (long)sizeof(d); i++) {
+    d[i] = (unsigned char)(i * 3);
+  }
+  char description[80];
+
+  // a et b se suivent dans le fichier, c recouvre la fin de a (le dernier l'emporte), d est loin
+  struct sSegment ecritures[4];
+  preparerSegment(&ecritures[0], a, sizeof(a), 10);
+  preparerSegment(&ecritures[1], b, sizeof(b), 110);
+  preparerSegment(&ecritures[2], c, sizeof(c), 80);
+  preparerSegment(&ecritures[3], d, sizeof(d), TAILLE_DEMO - sizeof(d));
+  for (int i = 0; i < 4; i++) {
+    memcpy(attendu + ecritures[i].decalage, ecritures[i].contenu, ecritures[i].taille);
+  }
+  long ecrits = EcrireDonneesInodeV(inode, ecritures, 4);
+  snprintf(description, sizeof(description), "%s : 4 segments ecrits (380 octets)", nom);
+  Verifier(ecrits == 380 && ecritures[0].traites == 100 && ecritures[1].traites == 30
+           && ecritures[2].traites == 50 && ecritures[3].traites == 200, description);
+  snprintf(description, sizeof(description), "%s : relecture entiere (le dernier segment l'emporte)", nom);
+  Verifier(ContenuInodeEgal(inode, attendu, TAILLE_DEMO), description);
+
+  // lecture éparpillée : dans le désordre, un segment à cheval sur la fin, un au-delà
+  unsigned char lu1[50], lu2[64], lu3[100], lu4[10];
+  struct sSegment lectures[4];
+  preparerSegment(&lectures[0], lu1, sizeof(lu1), 2000);
+  preparerSegment(&lectures[1], lu2, sizeof(lu2), 70);
+  preparerSegment(&lectures[2], lu3, sizeof(lu3), TAILLE_DEMO - 40);
+  preparerSegment(&lectures[3], lu4, sizeof(lu4), TAILLE_DEMO + 10);
+  long lus = LireDonneesInodeV(inode, lectures, 4);
+  snprintf(description, sizeof(description), "%s : lecture de 4 segments (154 octets)", nom);
+  Verifier(lus == 154 && lectures[0].traites == 50 && lectures[1].traites == 64
+           && lectures[2].traites == 40 && lectures[3].traites == 0, description);
+  snprintf(description, sizeof(description), "%s : chaque zone recoit ses octets", nom);
+  Verifier(memcmp(lu1, attendu + 2000, 50) == 0 && memcmp(lu2, attendu + 70, 64) == 0
+           && memcmp(lu3, attendu + TAILLE_DEMO - 40, 40) == 0, description);
+}
+
+int main(void) {
+  DebuterVerifications("demo_vecteurs");
+  // === PHASE 1 : aller-retour de segments ===
+  printf("--- PHASE 1 : segments eparpilles, qui se suivent ou se recouvrent ---\n");
+  tDisque disque = CreerDisque(TAILLE_BLOC);
+  tInode inode = CreerInode(1, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  allerRetour(inode, "brut");
+  DetruireInode(&inode);
+
+  // === PHASE 2 : fichier compressé ===
+  printf("\n--- PHASE 2 : fichier compresse ---\n");
+  inode = CreerInode(2, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  Verifier(ActiverCompressionInode(inode) == 0, "compression activee");
+  allerRetour(inode, "compresse");
+  DetruireInode(&inode);
+
+  // === PHASE 3 : taille maximale d'un fichier ===
+  printf("\n--- PHASE 3 : ecriture arretee a la taille maximale d'un fichier ---\n");
+  inode = CreerInode(3, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  long tailleMax = TailleMaxFichierInode(inode);
+  unsigned char zone[100];
+  memset(zone, 'M', sizeof(zone));
+  struct sSegment segments[3];
+  preparerSegment(&segments[0], zone, 10, 0);
+  preparerSegment(&segments[1], zone, 100, tailleMax - 40);
+  preparerSegment(&segments[2], zone, 10, 20);
+  long ecrits = EcrireDonneesInodeV(inode, segments, 3);
+  Verifier(ecrits == 50 && segments[0].traites == 10 && segments[1].traites == 40, "40 octets ecrits au bout du fichier");
+  Verifier(segments[2].traites == 0, "le segment suivant n'est pas ecrit");
+  Verifier(Taille(inode) == tailleMax, "le fichier atteint sa taille maximale");
+  preparerSegment(&segments[0], zone, 10, tailleMax);
+  Verifier(EcrireDonneesInodeV(inode, segments, 1) == -1 && segments[0].traites == 0,
+           "ecriture au-dela de la taille maximale refusee");
+  DetruireInode(&inode);
+
+  // === PHASE 4 : cas d'erreur ===
+  printf("\n--- PHASE 4 : cas d'erreur ---\n");
+  inode = CreerInode(4, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  Verifier(EcrireDonneesInodeV(inode, segments, 0) == 0 && LireDonneesInodeV(inode, NULL, 0) == 0,
+           "aucun segment : rien a faire");
+  Verifier(EcrireDonneesInodeV(NULL, segments, 1) == -1, "ecriture dans un inode inexistant refusee");
+  Verifier(LireDonneesInodeV(inode, NULL, 2) == -1, "tableau de segments inexistant refuse");
+  Verifier(LireDonneesInodeV(inode, segments, -1) == -1, "nombre de segments negatif refuse");
+  preparerSegment(&segments[0], zone, 10, 0);
+  preparerSegment(&segments[1], NULL, 10, 10);
+  Verifier(EcrireDonneesInodeV(inode, segments, 2) == -1 && Taille(inode) == 0,
+           "segment sans zone refuse, rien n'est ecrit");
+  preparerSegment(&segments[1], zone, -5, 10);
+  Verifier(EcrireDonneesInodeV(inode, segments, 2) == -1, "taille negative refusee");
+  preparerSegment(&segments[1], zone, 10, -1);
+  Verifier(LireDonneesInodeV(inode, segments, 2) == -1, "decalage negatif refuse");
+  DetruireInode(&inode);
+  DetruireDisque(&disque);
+
+  return TerminerVerifications("VECTEURS");
+}
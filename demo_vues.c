@@ -0,0 +1,169 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : demo_vues.c
+ * Démonstration de la lecture sans copie (vues sur les blocs) : vues d'un fichier entier ou d'une partie,
+ * fichier en ligne, trous et fichier compressé (recopiés), vues qui gardent leur contenu pendant
+ * une réécriture, une suppression ou l'agrandissement du disque, sauvegarde du disque pendant une vue,
+ * disque stocké dans un fichier, et cas d'erreur.
+ * Chaque étape vérifie ses résultats (voir verification.h).
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bloc.h"
+#include "disque.h"
+#include "inode.h"
+#include "verification.h"
+
+// Taille des fichiers de la démonstration (40 blocs de 64 octets)
+#define TAILLE_DEMO (40 * TAILLE_BLOC)
+
+// Fichier image du disque stocké dans un fichier (effacé à la fin)
+#define NOM_IMAGE "demo_vues.img"
+
+// Fichier de sauvegarde du disque (effacé à la fin)
+#define NOM_SAUVEGARDE "demo_vues.sav"
+
+int main(void) {
+  DebuterVerifications("demo_vues");
+  unsigned char contenu[TAILLE_DEMO], autre[TAILLE_DEMO];
+  for (long i = 0; i < TAILLE_DEMO; i++) {
+    contenu[i] = (unsigned char)(i * 7 + i / 64);
+    autre[i] = (unsigned char)(255 - i % 200);
+  }
+
+  // === PHASE 1 : vues d'un fichier ===
+  printf("--- PHASE 1 : vues d'un fichier de 40 blocs ---\n");
+  tDisque disque = CreerDisque(TAILLE_BLOC);
+  long utilisesAuDebut = NbBlocsUtilises(disque);
+  tInode inode = CreerInode(1, ORDINAIRE);
+  AssocierDisqueInode(inode, disque);
+  Verifier(EcrireDonneesInode(inode, contenu, TAILLE_DEMO, 0) == TAILLE_DEMO, "ecriture de 40 blocs");
+  tVuesInode vues = LireVuesInode(inode, TAILLE_DEMO, 0);
+  long nbVues;
+  VuesInode(vues, &nbVues);
+  Verifier(vues != NULL && nbVues >= 1 && nbVues <= 40, "vues du fichier entier (au plus une par bloc)");
+  Verifier(VuesEgales(vues, contenu, TAILLE_DEMO), "les vues couvrent tout le contenu");
+  LibererVuesInode(&vues);
+  Verifier(vues == NULL, "vues liberees");
+  vues = LireVuesInode(inode, 300, 100);
+  Verifier(VuesEgales(vues, contenu + 100, 300), "vues de 300 octets a partir de 100 (a cheval sur 6 blocs)");
+  LibererVuesInode(&vues);
+  vues = LireVuesInode(inode, 1000, TAILLE_DEMO - 10);
+  Verifier(VuesEgales(vues, contenu + TAILLE_DEMO - 10, 10), "vues arretees a la fin du fichier");
+  LibererVuesInode(&vues);
+  vues = LireVuesInode(inode, 10, TAILLE_DEMO + 5);
+  VuesInode(vues, &nbVues);
+  Verifier(vues != NULL && nbVues == 0, "aucune vue au-dela de la fin du fichier");
+  LibererVuesInode(&vues);
+
+  // === PHASE 2 : fichier en ligne, trous, fichier compressé ===
+  printf("\n--- PHASE 2 : fichier en ligne, trous et fichier compresse ---\n");
+  tInode petit = CreerInode(2, ORDINAIRE);
+  AssocierDisqueInode(petit, disque);
+  EcrireDonneesInode(petit, contenu, 50, 0);
+  vues = LireVuesInode(petit, 50, 0);
+  VuesInode(vues, &nbVues);
+  Verifier(nbVues == 1 && VuesEgales(vues, contenu, 50), "une seule vue pour un fichier en ligne de 50 octets");
+  LibererVuesInode(&vues);
+  DetruireInode(&petit);
+
+  tInode creux = CreerInode(3, ORDINAIRE);
+  AssocierDisqueInode(creux, disque);
+  unsigned char attenduCreux[12 * TAILLE_BLOC];
+  memset(attenduCreux, 0, sizeof(attenduCreux));
+  memcpy(attenduCreux + 10 * TAILLE_BLOC, contenu, 2 * TAILLE_BLOC);
+  EcrireDonneesInode(creux, contenu, 2 * TAILLE_BLOC, 10 * TAILLE_BLOC);
+  vues = LireVuesInode(creux, sizeof(attenduCreux), 0);
+  Verifier(VuesEgales(vues, attenduCreux, sizeof(attenduCreux)), "les 10 blocs du trou se lisent a zero");
+  LibererVuesInode(&vues);
+  DetruireInode(&creux);
+
+  tInode compresse = CreerInode(4, ORDINAIRE);
+  AssocierDisqueInode(compresse, disque);
+  Verifier(ActiverCompressionInode(compresse) == 0, "compression activee");
+  EcrireDonneesInode(compresse, contenu, TAILLE_DEMO, 0);
+  vues = LireVuesInode(compresse, 500, 1000);
+  Verifier(VuesEgales(vues, contenu + 1000, 500), "vues d'un fichier compresse (decompresse dans une copie)");
+  LibererVuesInode(&vues);
+  DetruireInode(&compresse);
+
+  // === PHASE 3 : les vues gardent le contenu lu ===
+  printf("\n--- PHASE 3 : reecriture, agrandissement du disque et suppression sous des vues ---\n");
+  long utilisesFichier = NbBlocsUtilises(disque);
+  vues = LireVuesInode(inode, TAILLE_DEMO, 0);
+  Verifier(EcrireDonneesInode(inode, autre, TAILLE_DEMO, 0) == TAILLE_DEMO, "reecriture de tout le fichier");
+  Verifier(ContenuInodeEgal(inode, autre, TAILLE_DEMO), "le fichier voit son nouveau contenu");
+  Verifier(VuesEgales(vues, contenu, TAILLE_DEMO), "les vues gardent l'ancien contenu");
+  Verifier(NbBlocsUtilises(disque) == utilisesFichier, "40 blocs recopies, les anciens epingles sont comptes libres");
+  FILE *fichier = fopen(NOM_SAUVEGARDE, "wb");
+  Verifier(fichier != NULL && SauvegarderDisque(disque, fichier) == 0, "sauvegarde du disque pendant les vues");
+  if (fichier != NULL) {
+    fclose(fichier);
+  }
+  tDisque charge = NULL;
+  fichier = fopen(NOM_SAUVEGARDE, "rb");
+  Verifier(fichier != NULL && ChargerDisque(&charge, fichier) == 0, "chargement du disque");
+  if (fichier != NULL) {
+    fclose(fichier);
+  }
+  Verifier(NbBlocsUtilises(charge) == utilisesFichier, "les anciens blocs epingles sont libres sur le disque charge");
+  DetruireDisque(&charge);
+  remove(NOM_SAUVEGARDE);
+  long nbBlocsAvant = NbBlocsDisque(disque);
+  tInode grand = CreerInode(5, ORDINAIRE);
+  AssocierDisqueInode(grand, disque);
+  for (long i = 0; i < 20; i++) {
+    EcrireDonneesInode(grand, contenu, TAILLE_DEMO, i * TAILLE_DEMO);
+  }
+  Verifier(NbBlocsDisque(disque) > nbBlocsAvant, "le disque s'est agrandi");
+  Verifier(VuesEgales(vues, contenu, TAILLE_DEMO), "les vues restent valables apres l'agrandissement");
+  DetruireInode(&grand);
+  LibererVuesInode(&vues);
+  Verifier(NbBlocsUtilises(disque) == utilisesFichier, "les anciens blocs sont rendus au desepinglage");
+
+  vues = LireVuesInode(inode, TAILLE_DEMO, 0);
+  DetruireInode(&inode);
+  Verifier(VuesEgales(vues, autre, TAILLE_DEMO), "les vues survivent a la destruction du fichier");
+  Verifier(NbBlocsUtilises(disque) == utilisesAuDebut, "les blocs vus sont comptes libres");
+  LibererVuesInode(&vues);
+  Verifier(NbBlocsUtilises(disque) == utilisesAuDebut, "tous les blocs sont rendus au disque");
+  DetruireDisque(&disque);
+
+  // === PHASE 4 : disque stocké dans un fichier ===
+  printf("\n--- PHASE 4 : vues sur un disque stocke dans un fichier ---\n");
+  disque = CreerDisqueFichier(TAILLE_BLOC, NOM_IMAGE);
+  Verifier(disque != NULL, "disque stocke dans " NOM_IMAGE);
+  if (disque != NULL) {
+    inode = CreerInode(1, ORDINAIRE);
+    AssocierDisqueInode(inode, disque);
+    EcrireDonneesInode(inode, contenu, TAILLE_DEMO, 0);
+    vues = LireVuesInode(inode, TAILLE_DEMO, 0);
+    Verifier(VuesEgales(vues, contenu, TAILLE_DEMO), "vues dans le cache de blocs");
+    EcrireDonneesInode(inode, autre, TAILLE_DEMO, 0);
+    Verifier(VuesEgales(vues, contenu, TAILLE_DEMO), "les vues gardent l'ancien contenu apres reecriture");
+    Verifier(ContenuInodeEgal(inode, autre, TAILLE_DEMO), "le fichier voit son nouveau contenu");
+    LibererVuesInode(&vues);
+    DetruireInode(&inode);
+    DetruireDisque(&disque);
+  }
+  remove(NOM_IMAGE);
+
+  // === PHASE 5 : cas d'erreur ===
+  printf("\n--- PHASE 5 : cas d'erreur ---\n");
+  Verifier(LireVuesInode(NULL, 10, 0) == NULL, "vues d'un inode inexistant refusees");
+  inode = CreerInode(1, ORDINAIRE);
+  Verifier(LireVuesInode(inode, -1, 0) == NULL, "taille negative refusee");
+  Verifier(LireVuesInode(inode, 10, -1) == NULL, "decalage negatif refuse");
+  DetruireInode(&inode);
+  Verifier(VuesInode(NULL, &nbVues) == NULL && nbVues == 0, "aucune vue pour des vues inexistantes");
+  LibererVuesInode(NULL);
+  LibererVuesInode(&vues);
+  Verifier(vues == NULL, "liberation de vues inexistantes sans effet");
+
+  return TerminerVerifications("VUES");
+}
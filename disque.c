@@ -0,0 +1,1697 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : disque.c
+ * Module de gestion d'un disque (simulé).
+ **/
+
+// fileno, fseeko, ftello, mmap (POSIX), mremap (Linux)
+#define _GNU_SOURCE
+
+#include "disque.h"
+#include "dedup.h"
+#include "cache.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Alignement de la zone de blocs en mémoire (une page)
+#define ALIGNEMENT_ZONE 4096
+
+// Alignement de l'image des blocs dans une sauvegarde (multiple de la taille de page des systèmes courants),
+// pour qu'elle puisse être projetée en mémoire au chargement
+#define ALIGNEMENT_IMAGE 65536
+
+// Nombre de blocs décrits par un mot de la carte des blocs libres
+#define BLOCS_PAR_MOT 64
+
+// Options enregistrées dans la sauvegarde d'un disque
+#define OPTION_DEDUP       1
+#define OPTION_REFERENCES  2
+
+// Stockage des blocs, enregistré dans la sauvegarde d'un disque
+#define STOCKAGE_MEMOIRE   0
+#define STOCKAGE_FICHIER   1
+
+// Une ancienne zone de blocs, gardée tant que des blocs du disque sont épinglés (voir EpinglerBlocsDisque)
+struct sZoneRetiree
+{
+  unsigned char *zone;
+  size_t taille;
+  struct sZoneRetiree *suivante;
+};
+
+// Définition d'un disque
+struct sDisque
+{
+  // La zone contiguë contenant les blocs (nbBlocs x tailleBloc octets, projection anonyme),
+  // NULL si les blocs sont dans un fichier
+  unsigned char *zone;
+  // Taille de la projection de la sauvegarde quand la zone en est une (mmap privé), 0 sinon
+  size_t tailleProjection;
+  // Disque stocké dans un fichier : le cache devant le fichier image et son nom (NULL pour un disque en mémoire)
+  tCacheBlocs cache;
+  char *nomImage;
+  // La taille des blocs en octets
+  long tailleBloc;
+  // Le nombre de blocs de la zone (toujours un multiple de BLOCS_PAR_MOT)
+  tNumeroBloc nbBlocs;
+  // Le nombre de blocs libres
+  tNumeroBloc nbLibres;
+  // La carte des blocs libres : bit à 1 = bloc utilisé
+  uint64_t *carte;
+  // Indice du premier mot de la carte pouvant contenir un bloc libre
+  long premierMotLibre;
+  // Le nombre de références de chaque bloc (NULL tant qu'aucun bloc n'est partagé : 1 par bloc utilisé)
+  uint32_t *references;
+  // Le nombre de références en plus d'une (= nombre de blocs économisés par le partage)
+  long nbReferencesPartagees;
+  // L'index de déduplication (NULL si la déduplication n'est pas activée)
+  tIndexDedup index;
+  // La carte des blocs présents dans l'index (bit à 1 = bloc indexé)
+  uint64_t *indexes;
+  // Vérification paresseuse : la carte des blocs chargés pas encore vérifiés (bit à 1 = à vérifier)
+  // et leur somme de contrôle attendue (NULL si aucun bloc n'attend de vérification) ;
+  // pour un disque stocké dans un fichier, les blocs sont vérifiés à chaque lecture dans le fichier
+  uint64_t *aVerifier;
+  uint32_t *sommes;
+  // Disque en mémoire : le nombre d'épinglages de blocs en cours, et les zones remplacées depuis le premier
+  // (libérées au dernier désépinglage)
+  long nbEpingles;
+  struct sZoneRetiree *zonesRetirees;
+  // Le nombre d'épinglages de chaque bloc en mémoire (NULL pour un fichier image, où le cache les compte)
+  // et la carte des blocs libérés pendant leur épinglage (bit à 1 = rendu au dernier désépinglage) ;
+  // NULL tant qu'aucun bloc n'a été épinglé ; ces blocs sont déjà comptés libres et ne sont pas sauvegardés
+  uint32_t *epinglages;
+  uint64_t *liberationsDifferees;
+  tNumeroBloc nbLiberationsDifferees;
+};
+
+// Les sommes de contrôle des blocs chargés sont-elles vérifiées à la première lecture (au lieu du chargement) ?
+static bool verificationParesseuse = false;
+
+// Mémoire du cache de blocs des disques stockés dans un fichier créés ou chargés ensuite
+static long budgetCache = BUDGET_CACHE_DISQUE;
+
+// Disque utilisé par les inodes qui n'appartiennent à aucun SF
+static tDisque disqueParDefaut = NULL;
+
+// fonction auxiliaire qui alloue une zone de nbBlocs blocs alignée sur une page
+static unsigned char *allouerZone(tNumeroBloc nbBlocs, long tailleBloc) {
+  // projection anonyme alignée sur une page (ALIGNEMENT_ZONE), qui peut grandir sans recopie (voir agrandirDisque)
+  void *zone = mmap(NULL, (size_t)nbBlocs * tailleBloc, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return (zone == MAP_FAILED) ? NULL : (unsigned char *)zone;
+}
+
+// fonction auxiliaire qui libère la zone de blocs d'un disque (allouée, ou projetée depuis une sauvegarde)
+static void libererZone(tDisque disque) {
+  if (disque->zone != NULL) {
+    munmap(disque->zone, (size_t)disque->nbBlocs * disque->tailleBloc);
+  }
+  disque->zone = NULL;
+  disque->tailleProjection = 0;
+}
+
+// fonction auxiliaire qui met de côté la zone de blocs d'un disque dont des blocs sont épinglés
+// (elle sera libérée au dernier désépinglage) ; retourne 0 si ok, -1 sinon
+static int retirerZone(tDisque disque) {
+  struct sZoneRetiree *retiree = malloc(sizeof(struct sZoneRetiree));
+  if (retiree == NULL) {
+    return -1;
+  }
+  retiree->zone = disque->zone;
+  retiree->taille = (size_t)disque->nbBlocs * disque->tailleBloc;
+  retiree->suivante = disque->zonesRetirees;
+  disque->zonesRetirees = retiree;
+  disque->zone = NULL;
+  disque->tailleProjection = 0;
+  return 0;
+}
+
+// fonction auxiliaire qui libère les zones mises de côté pendant un épinglage
+static void libererZonesRetirees(tDisque disque) {
+  while (disque->zonesRetirees != NULL) {
+    struct sZoneRetiree *retiree = disque->zonesRetirees;
+    disque->zonesRetirees = retiree->suivante;
+    munmap(retiree->zone, retiree->taille);
+    free(retiree);
+  }
+}
+
+// fonction auxiliaire qui compte les blocs libres d'après la carte
+static tNumeroBloc compterBlocsLibres(tDisque disque) {
+  tNumeroBloc nbUtilises = 0;
+  for (tNumeroBloc i = 0; i < disque->nbBlocs / BLOCS_PAR_MOT; i++) {
+    nbUtilises += __builtin_popcountll(disque->carte[i]);
+  }
+  return disque->nbBlocs - nbUtilises;
+}
+
+// fonction auxiliaire qui double le nombre de blocs d'un disque (0 si ok, -1 sinon)
+static int agrandirDisque(tDisque disque) {
+  // le numéro de bloc est sur 32 bits
+  if (disque->nbBlocs > UINT32_MAX / 2) {
+    return -1;
+  }
+  tNumeroBloc nouveauNbBlocs = disque->nbBlocs * 2;
+
+  // nouvelle carte : les nouveaux blocs sont libres
+  uint64_t *nouvelleCarte = realloc(disque->carte, (nouveauNbBlocs / BLOCS_PAR_MOT) * sizeof(uint64_t));
+  if (nouvelleCarte == NULL) {
+    return -1;
+  }
+  for (tNumeroBloc i = disque->nbBlocs / BLOCS_PAR_MOT; i < nouveauNbBlocs / BLOCS_PAR_MOT; i++) {
+    nouvelleCarte[i] = 0;
+  }
+  disque->carte = nouvelleCarte;
+
+  // carte des blocs indexés
+  if (disque->indexes != NULL) {
+    uint64_t *nouveauxIndexes = realloc(disque->indexes, (nouveauNbBlocs / BLOCS_PAR_MOT) * sizeof(uint64_t));
+    if (nouveauxIndexes == NULL) {
+      return -1;
+    }
+    for (tNumeroBloc i = disque->nbBlocs / BLOCS_PAR_MOT; i < nouveauNbBlocs / BLOCS_PAR_MOT; i++) {
+      nouveauxIndexes[i] = 0;
+    }
+    disque->indexes = nouveauxIndexes;
+  }
+
+  // nombres de références : les nouveaux blocs n'en ont pas
+  if (disque->references != NULL) {
+    uint32_t *nouvellesReferences = realloc(disque->references, nouveauNbBlocs * sizeof(uint32_t));
+    if (nouvellesReferences == NULL) {
+      return -1;
+    }
+    memset(nouvellesReferences + disque->nbBlocs, 0, (size_t)(nouveauNbBlocs - disque->nbBlocs) * sizeof(uint32_t));
+    disque->references = nouvellesReferences;
+  }
+
+  // vérification paresseuse : les nouveaux blocs n'ont rien à vérifier
+  if (disque->aVerifier != NULL) {
+    uint64_t *nouveauxAVerifier = realloc(disque->aVerifier, (nouveauNbBlocs / BLOCS_PAR_MOT) * sizeof(uint64_t));
+    if (nouveauxAVerifier == NULL) {
+      return -1;
+    }
+    for (tNumeroBloc i = disque->nbBlocs / BLOCS_PAR_MOT; i < nouveauNbBlocs / BLOCS_PAR_MOT; i++) {
+      nouveauxAVerifier[i] = 0;
+    }
+    disque->aVerifier = nouveauxAVerifier;
+    uint32_t *nouvellesSommes = realloc(disque->sommes, nouveauNbBlocs * sizeof(uint32_t));
+    if (nouvellesSommes == NULL) {
+      return -1;
+    }
+    disque->sommes = nouvellesSommes;
+  }
+
+  // épinglages : les nouveaux blocs ne sont pas épinglés
+  if (disque->liberationsDifferees != NULL) {
+    uint64_t *nouvellesLiberations = realloc(disque->liberationsDifferees,
+                                             (nouveauNbBlocs / BLOCS_PAR_MOT) * sizeof(uint64_t));
+    if (nouvellesLiberations == NULL) {
+      return -1;
+    }
+    for (tNumeroBloc i = disque->nbBlocs / BLOCS_PAR_MOT; i < nouveauNbBlocs / BLOCS_PAR_MOT; i++) {
+      nouvellesLiberations[i] = 0;
+    }
+    disque->liberationsDifferees = nouvellesLiberations;
+  }
+  if (disque->epinglages != NULL) {
+    uint32_t *nouveauxEpinglages = realloc(disque->epinglages, nouveauNbBlocs * sizeof(uint32_t));
+    if (nouveauxEpinglages == NULL) {
+      return -1;
+    }
+    memset(nouveauxEpinglages + disque->nbBlocs, 0, (size_t)(nouveauNbBlocs - disque->nbBlocs) * sizeof(uint32_t));
+    disque->epinglages = nouveauxEpinglages;
+  }
+
+  // zone allouée sans bloc épinglé : elle grandit sans recopie (les pages sont déplacées)
+  size_t ancienneTaille = (size_t)disque->nbBlocs * disque->tailleBloc;
+  bool agrandie = false;
+#ifdef MREMAP_MAYMOVE
+  if (disque->cache == NULL && disque->nbEpingles == 0 && disque->tailleProjection == 0) {
+    void *zone = mremap(disque->zone, ancienneTaille, (size_t)nouveauNbBlocs * disque->tailleBloc, MREMAP_MAYMOVE);
+    if (zone != MAP_FAILED) {
+      disque->zone = (unsigned char *)zone;
+      agrandie = true;
+    }
+  }
+#endif
+
+  // sinon nouvelle zone : on y recopie les blocs existants (un fichier image grandit tout seul)
+  if (disque->cache == NULL && !agrandie) {
+    unsigned char *nouvelleZone = allouerZone(nouveauNbBlocs, disque->tailleBloc);
+    if (nouvelleZone == NULL) {
+      return -1;
+    }
+    memcpy(nouvelleZone, disque->zone, ancienneTaille);
+
+    // des blocs épinglés restent lisibles dans l'ancienne zone
+    if (disque->nbEpingles > 0) {
+      if (retirerZone(disque) != 0) {
+        munmap(nouvelleZone, (size_t)nouveauNbBlocs * disque->tailleBloc);
+        return -1;
+      }
+    } else {
+      libererZone(disque);
+    }
+    disque->zone = nouvelleZone;
+  }
+
+  // le premier bloc libre est le premier bloc ajouté
+  disque->premierMotLibre = disque->nbBlocs / BLOCS_PAR_MOT;
+  disque->nbLibres += nouveauNbBlocs - disque->nbBlocs;
+  disque->nbBlocs = nouveauNbBlocs;
+
+  return 0;
+}
+
+// fonction auxiliaire qui cherche le premier bloc libre à partir d'un bloc donné,
+// un mot (64 blocs) à la fois, en reprenant au début de la carte si besoin
+static tNumeroBloc chercherBlocLibre(tDisque disque, tNumeroBloc aPartirDe) {
+  long nbMots = disque->nbBlocs / BLOCS_PAR_MOT;
+  long mot = aPartirDe / BLOCS_PAR_MOT;
+
+  // dans le premier mot, les blocs avant aPartirDe sont vus comme occupés
+  uint64_t occupes = disque->carte[mot] | ((UINT64_C(1) << (aPartirDe % BLOCS_PAR_MOT)) - 1);
+
+  // nbMots + 1 tours : le premier mot est revu en entier à la fin
+  for (long k = 0; k <= nbMots; k++) {
+    if (occupes != UINT64_MAX) {
+      // premier bit à 0 du mot
+      return (tNumeroBloc)(mot * BLOCS_PAR_MOT + __builtin_ctzll(~occupes));
+    }
+    mot = (mot + 1) % nbMots;
+    occupes = disque->carte[mot];
+  }
+
+  return BLOC_NUL;
+}
+
+// fonction auxiliaire qui crée le tableau des nombres de références (1 par bloc utilisé)
+static int creerReferences(tDisque disque) {
+  disque->references = malloc((size_t)disque->nbBlocs * sizeof(uint32_t));
+  if (disque->references == NULL) {
+    return -1;
+  }
+  for (tNumeroBloc i = 0; i < disque->nbBlocs; i++) {
+    disque->references[i] = (disque->carte[i / BLOCS_PAR_MOT] >> (i % BLOCS_PAR_MOT)) & 1;
+    // un bloc libéré pendant son épinglage n'a plus de référence
+    if (disque->liberationsDifferees != NULL
+        && (disque->liberationsDifferees[i / BLOCS_PAR_MOT] >> (i % BLOCS_PAR_MOT)) & 1) {
+      disque->references[i] = 0;
+    }
+  }
+  return 0;
+}
+
+// fonction auxiliaire qui indique si un bloc est utilisé d'après la carte
+static bool estUtilise(uint64_t *carte, tNumeroBloc numero) {
+  return (carte[numero / BLOCS_PAR_MOT] >> (numero % BLOCS_PAR_MOT)) & 1;
+}
+
+// fonction auxiliaire qui indique si un bloc est épinglé (il est lu en place et ne doit pas changer)
+static bool estEpingle(tDisque disque, tNumeroBloc numero) {
+  if (disque->cache != NULL) {
+    return BlocEpingleCache(disque->cache, numero);
+  }
+  return disque->epinglages != NULL && disque->epinglages[numero] > 0;
+}
+
+// fonction auxiliaire qui indique si un bloc a été libéré pendant son épinglage (il est encore marqué utilisé)
+static bool estLiberationDifferee(tDisque disque, tNumeroBloc numero) {
+  return disque->liberationsDifferees != NULL && estUtilise(disque->liberationsDifferees, numero);
+}
+
+// fonction auxiliaire qui indique si un bloc attend la vérification de sa somme de contrôle
+static bool estAVerifier(tDisque disque, tNumeroBloc numero) {
+  return disque->aVerifier != NULL && estUtilise(disque->aVerifier, numero);
+}
+
+// fonction auxiliaire qui indique qu'un bloc n'a plus à être vérifié (contenu vérifié ou remplacé)
+static void oublierVerification(tDisque disque, tNumeroBloc numero) {
+  if (disque->aVerifier != NULL) {
+    disque->aVerifier[numero / BLOCS_PAR_MOT] &= ~(UINT64_C(1) << (numero % BLOCS_PAR_MOT));
+  }
+}
+
+// fonction auxiliaire qui vérifie, s'il le faut encore, la somme de contrôle d'un bloc chargé :
+// retourne true si le bloc est intègre, false s'il est corrompu (il le reste pour les lectures suivantes)
+static bool blocIntegre(tDisque disque, tNumeroBloc numero) {
+  if (!estAVerifier(disque, numero)) {
+    return true;
+  }
+
+  if (SommeControle(disque->zone + (size_t)numero * disque->tailleBloc, disque->tailleBloc) != disque->sommes[numero]) {
+    fprintf(stderr, "disque : bloc %u corrompu (somme de contrôle invalide)\n", numero);
+    return false;
+  }
+  oublierVerification(disque, numero);
+  return true;
+}
+
+// fonction auxiliaire qui indique si un numéro désigne un bloc du disque
+static bool blocValide(tDisque disque, tNumeroBloc numero) {
+  return disque != NULL && numero != BLOC_NUL && numero < disque->nbBlocs;
+}
+
+// fonction auxiliaire qui retourne l'adresse en mémoire d'un bloc valide pour un type d'accès :
+// dans la zone (après vérification du bloc s'il vient d'être chargé) ou dans le cache du fichier image ;
+// retourne NULL si le bloc est illisible ou corrompu
+static unsigned char *adresseBloc(tDisque disque, tNumeroBloc numero, tAccesBloc acces) {
+  if (disque->cache != NULL) {
+    return BlocCache(disque->cache, numero, acces);
+  }
+
+  // un bloc réécrit en entier n'a plus à être vérifié, sinon son contenu doit être intègre
+  if (acces == ACCES_REMPLACEMENT) {
+    oublierVerification(disque, numero);
+  } else if (!blocIntegre(disque, numero)) {
+    return NULL;
+  }
+  return disque->zone + (size_t)numero * disque->tailleBloc;
+}
+
+// fonction auxiliaire appelée par le cache quand un bloc vient d'être lu dans le fichier image :
+// vérifie sa somme de contrôle, connue depuis sa dernière écriture dans le fichier
+static bool blocLuImage(void *contexte, tNumeroBloc numero, const unsigned char *contenu) {
+  tDisque disque = (tDisque)contexte;
+  if (estAVerifier(disque, numero) && SommeControle(contenu, disque->tailleBloc) != disque->sommes[numero]) {
+    fprintf(stderr, "disque : bloc %u corrompu (somme de contrôle invalide)\n", numero);
+    return false;
+  }
+  return true;
+}
+
+// fonction auxiliaire appelée par le cache juste avant l'écriture d'un bloc dans le fichier image :
+// retient sa somme de contrôle, vérifiée à sa prochaine lecture dans le fichier
+static void blocEcritImage(void *contexte, tNumeroBloc numero, const unsigned char *contenu) {
+  tDisque disque = (tDisque)contexte;
+  disque->sommes[numero] = SommeControle(contenu, disque->tailleBloc);
+  disque->aVerifier[numero / BLOCS_PAR_MOT] |= UINT64_C(1) << (numero % BLOCS_PAR_MOT);
+}
+
+// fonction auxiliaire qui indique si un bloc est dans l'index de déduplication
+static bool estIndexe(tDisque disque, tNumeroBloc numero) {
+  return disque->indexes != NULL
+      && (disque->indexes[numero / BLOCS_PAR_MOT] & (UINT64_C(1) << (numero % BLOCS_PAR_MOT))) != 0;
+}
+
+// fonction auxiliaire qui ajoute un bloc (utilisé) à l'index de déduplication
+static void ajouterALIndex(tDisque disque, tNumeroBloc numero) {
+  const unsigned char *contenu = adresseBloc(disque, numero, ACCES_LECTURE);
+
+  // en cas d'échec (ou de bloc illisible) le bloc n'est simplement pas partageable
+  if (contenu != NULL && AjouterIndexDedup(disque->index, EmpreinteContenu(contenu, disque->tailleBloc), numero) == 0) {
+    disque->indexes[numero / BLOCS_PAR_MOT] |= UINT64_C(1) << (numero % BLOCS_PAR_MOT);
+  }
+}
+
+// fonction auxiliaire qui retire un bloc de l'index de déduplication (avant que son contenu change)
+static void retirerDeLIndex(tDisque disque, tNumeroBloc numero) {
+  if (!estIndexe(disque, numero)) {
+    return;
+  }
+
+  // un bloc illisible reste dans l'index, sans danger : les candidats sont comparés octet à octet
+  const unsigned char *contenu = adresseBloc(disque, numero, ACCES_LECTURE);
+  if (contenu != NULL) {
+    RetirerIndexDedup(disque->index, EmpreinteContenu(contenu, disque->tailleBloc), numero);
+  }
+  disque->indexes[numero / BLOCS_PAR_MOT] &= ~(UINT64_C(1) << (numero % BLOCS_PAR_MOT));
+}
+
+// fonction auxiliaire qui parcourt les suites de blocs utilisés d'une zone, d'après la carte,
+// et les écrit (ecrire à true) ou les lit dans l'image des blocs d'un fichier (bloc n à debutImage + n x tailleBloc) :
+// une opération par suite de blocs contigus, les suites de blocs libres d'au moins ALIGNEMENT_IMAGE octets
+// restent des trous du fichier (les plus courtes sont transférées avec leurs voisines, sans déplacement) ;
+// le fichier est laissé à la fin de l'image ; retourne 0 si ok, -1 sinon
+static int transfererBlocsUtilises(tDisque disque, FILE *fichier, off_t debutImage, bool ecrire) {
+  tNumeroBloc ecartMax = (disque->tailleBloc < ALIGNEMENT_IMAGE) ? ALIGNEMENT_IMAGE / disque->tailleBloc : 1;
+  off_t position = -1;
+  tNumeroBloc debut = 0;
+  while (debut < disque->nbBlocs) {
+    // début de la prochaine suite (un mot vide est sauté d'un coup)
+    if (disque->carte[debut / BLOCS_PAR_MOT] == 0) {
+      debut = (debut / BLOCS_PAR_MOT + 1) * BLOCS_PAR_MOT;
+      continue;
+    }
+    if (!estUtilise(disque->carte, debut)) {
+      debut++;
+      continue;
+    }
+
+    // la suite continue tant que le prochain bloc utilisé est à moins de ecartMax blocs
+    tNumeroBloc dernierUtilise = debut;
+    for (tNumeroBloc i = debut + 1; i < disque->nbBlocs && i - dernierUtilise <= ecartMax; i++) {
+      if (estUtilise(disque->carte, i)) {
+        dernierUtilise = i;
+      }
+    }
+    tNumeroBloc fin = dernierUtilise + 1;
+
+    // déplacement seulement après un trou (un déplacement vide le tampon du fichier)
+    unsigned char *adresse = disque->zone + (size_t)debut * disque->tailleBloc;
+    size_t taille = (size_t)(fin - debut) * disque->tailleBloc;
+    off_t positionSuite = debutImage + (off_t)debut * disque->tailleBloc;
+    if (position != positionSuite && fseeko(fichier, positionSuite, SEEK_SET) != 0) {
+      return -1;
+    }
+    size_t transfere = ecrire ? fwrite(adresse, 1, taille, fichier) : fread(adresse, 1, taille, fichier);
+    if (transfere != taille) {
+      return -1;
+    }
+    position = positionSuite + (off_t)taille;
+    debut = fin;
+  }
+
+  return fseeko(fichier, debutImage + (off_t)disque->nbBlocs * disque->tailleBloc, SEEK_SET);
+}
+
+// fonction auxiliaire qui retourne la position de l'image des blocs dans un fichier de sauvegarde :
+// la position courante arrondie à ALIGNEMENT_IMAGE, -1 si le fichier n'a pas de position (tube)
+static off_t debutImageBlocs(FILE *fichier) {
+  off_t position = ftello(fichier);
+  if (position < 0) {
+    return -1;
+  }
+  return (position + ALIGNEMENT_IMAGE - 1) / ALIGNEMENT_IMAGE * ALIGNEMENT_IMAGE;
+}
+
+// fonction auxiliaire qui projette en mémoire (mmap privé, copie sur écriture) l'image des blocs
+// d'une sauvegarde comme zone du disque : les blocs ne sont lus qu'au premier accès à leur page,
+// et leurs modifications restent en mémoire ; retourne 0 si ok, -1 si la projection est impossible
+static int projeterZone(tDisque disque, FILE *fichier, off_t debutImage) {
+  size_t taille = (size_t)disque->nbBlocs * disque->tailleBloc;
+  struct stat infos;
+
+  // le fichier doit contenir toute l'image (une page au-delà de la fin provoquerait une erreur d'accès)
+  if (fstat(fileno(fichier), &infos) != 0 || infos.st_size < debutImage + (off_t)taille) {
+    return -1;
+  }
+
+  void *projection = mmap(NULL, taille, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(fichier), debutImage);
+  if (projection == MAP_FAILED) {
+    return -1;
+  }
+  disque->zone = (unsigned char *)projection;
+  disque->tailleProjection = taille;
+
+  return fseeko(fichier, debutImage + (off_t)taille, SEEK_SET);
+}
+
+// Contenu cherché dans l'index de déduplication
+struct sContenuCherche
+{
+  tDisque disque;
+  const unsigned char *contenu;
+};
+
+// fonction auxiliaire de vérification d'un bloc candidat de l'index (comparaison octet à octet)
+static bool blocIdentique(void *contexte, tNumeroBloc numero) {
+  struct sContenuCherche *cherche = (struct sContenuCherche *)contexte;
+  const unsigned char *bloc = adresseBloc(cherche->disque, numero, ACCES_LECTURE);
+  return bloc != NULL && memcmp(bloc, cherche->contenu, cherche->disque->tailleBloc) == 0;
+}
+
+/* V5
+ * Crée un disque vide (seul le bloc réservé 0 est utilisé).
+ * Entrée : la taille des blocs en octets (voir TailleBlocValide)
+ * Retour : le disque créé, ou NULL en cas de problème
+ */
+tDisque CreerDisque(long tailleBloc) {
+  // erreur taille de bloc
+  if (!TailleBlocValide(tailleBloc)) {
+    fprintf(stderr, "CreerDisque : taille de bloc invalide (%ld)\n", tailleBloc);
+    return NULL;
+  }
+
+  tDisque disque = (tDisque)malloc(sizeof(struct sDisque));
+
+  // erreur allocation mémoire
+  if (disque == NULL) {
+    fprintf(stderr, "CreerDisque : probleme creation\n");
+    return NULL;
+  }
+
+  disque->tailleBloc = tailleBloc;
+  disque->tailleProjection = 0;
+  disque->cache = NULL;
+  disque->nomImage = NULL;
+  disque->references = NULL;
+  disque->nbReferencesPartagees = 0;
+  disque->index = NULL;
+  disque->indexes = NULL;
+  disque->aVerifier = NULL;
+  disque->sommes = NULL;
+  disque->nbEpingles = 0;
+  disque->zonesRetirees = NULL;
+  disque->epinglages = NULL;
+  disque->liberationsDifferees = NULL;
+  disque->nbLiberationsDifferees = 0;
+  disque->nbBlocs = NB_BLOCS_DISQUE_INITIAL;
+  disque->zone = allouerZone(disque->nbBlocs, tailleBloc);
+  disque->carte = calloc(disque->nbBlocs / BLOCS_PAR_MOT, sizeof(uint64_t));
+
+  // erreur allocation zone ou carte
+  if (disque->zone == NULL || disque->carte == NULL) {
+    fprintf(stderr, "CreerDisque : probleme creation\n");
+    libererZone(disque);
+    free(disque->carte);
+    free(disque);
+    return NULL;
+  }
+
+  // le bloc 0 est réservé
+  disque->carte[0] = 1;
+  disque->nbLibres = disque->nbBlocs - 1;
+  disque->premierMotLibre = 0;
+
+  return disque;
+}
+
+/* V5
+ * Crée un disque vide dont les blocs sont stockés dans un fichier image (bloc n à l'octet n x tailleBloc),
+ * lus et écrits par l'intermédiaire d'un cache de blocs (voir BudgetCacheDisque).
+ * Entrées : la taille des blocs en octets (voir TailleBlocValide), le nom du fichier image (créé ou vidé)
+ * Retour : le disque créé, ou NULL en cas de problème
+ */
+tDisque CreerDisqueFichier(long tailleBloc, char nomImage[]) {
+  if (nomImage == NULL) {
+    fprintf(stderr, "CreerDisqueFichier : pas de fichier image\n");
+    return NULL;
+  }
+
+  // mêmes métadonnées qu'un disque en mémoire, sans la zone de blocs
+  tDisque disque = CreerDisque(tailleBloc);
+  if (disque == NULL) {
+    return NULL;
+  }
+  libererZone(disque);
+
+  // les sommes de contrôle des blocs écrits dans le fichier sont toujours connues
+  disque->aVerifier = calloc(disque->nbBlocs / BLOCS_PAR_MOT, sizeof(uint64_t));
+  disque->sommes = malloc((size_t)disque->nbBlocs * sizeof(uint32_t));
+  disque->nomImage = malloc(strlen(nomImage) + 1);
+  if (disque->aVerifier == NULL || disque->sommes == NULL || disque->nomImage == NULL) {
+    fprintf(stderr, "CreerDisqueFichier : probleme creation\n");
+    DetruireDisque(&disque);
+    return NULL;
+  }
+  strcpy(disque->nomImage, nomImage);
+
+  disque->cache = OuvrirCacheBlocs(nomImage, true, tailleBloc, budgetCache, blocLuImage, blocEcritImage, disque);
+  if (disque->cache == NULL) {
+    DetruireDisque(&disque);
+    return NULL;
+  }
+
+  return disque;
+}
+
+/* V5
+ * Choisit la mémoire du cache de blocs des disques stockés dans un fichier créés ou chargés ensuite.
+ * Entrée : le budget en octets
+ * Sortie : aucune
+ */
+void BudgetCacheDisque(long budget) {
+  if (budget <= 0) {
+    fprintf(stderr, "BudgetCacheDisque : budget invalide (%ld)\n", budget);
+    return;
+  }
+
+  budgetCache = budget;
+}
+
+/* V5
+ * Retourne les compteurs d'activité du cache de blocs d'un disque stocké dans un fichier.
+ * Entrées : le disque, la structure où recopier les compteurs
+ * Sortie : 0 en cas de succès, -1 si le disque n'a pas de cache
+ */
+int StatistiquesCacheDisque(tDisque disque, tStatsCache *stats) {
+  if (disque == NULL) {
+    return -1;
+  }
+
+  return StatistiquesCache(disque->cache, stats);
+}
+
+/* V5
+ * Retourne la mémoire occupée par les blocs du cache d'un disque stocké dans un fichier.
+ * Entrée : le disque
+ * Retour : la taille en octets (0 pour un disque en mémoire)
+ */
+long TailleMemoireCacheDisque(tDisque disque) {
+  if (disque == NULL) {
+    return 0;
+  }
+
+  return TailleMemoireCache(disque->cache);
+}
+
+/* V5
+ * Détruit un disque : sa zone de blocs et sa carte des blocs libres sont libérées d'un coup.
+ * Entrée : le disque à détruire
+ * Retour : aucun
+ */
+void DetruireDisque(tDisque *pDisque) {
+  if (pDisque == NULL || *pDisque == NULL) {
+    return;
+  }
+
+  // le disque par défaut peut être recréé plus tard
+  if (*pDisque == disqueParDefaut) {
+    disqueParDefaut = NULL;
+  }
+
+  // les blocs modifiés encore dans le cache sont réécrits dans le fichier image
+  DetruireCacheBlocs(&(*pDisque)->cache);
+  free((*pDisque)->nomImage);
+  libererZone(*pDisque);
+  libererZonesRetirees(*pDisque);
+  free((*pDisque)->carte);
+  free((*pDisque)->references);
+  free((*pDisque)->indexes);
+  free((*pDisque)->aVerifier);
+  free((*pDisque)->sommes);
+  free((*pDisque)->epinglages);
+  free((*pDisque)->liberationsDifferees);
+  DetruireIndexDedup(&(*pDisque)->index);
+  free(*pDisque);
+  *pDisque = NULL;
+}
+
+/* V5
+ * Retourne le disque utilisé par les inodes qui n'appartiennent à aucun SF.
+ * Entrée : aucune
+ * Retour : le disque par défaut, ou NULL en cas de problème
+ */
+tDisque DisqueParDefaut(void) {
+  if (disqueParDefaut == NULL) {
+    disqueParDefaut = CreerDisque(TAILLE_BLOC);
+  }
+  return disqueParDefaut;
+}
+
+/* V5
+ * Retourne la taille des blocs d'un disque.
+ * Entrée : le disque
+ * Retour : la taille en octets des blocs
+ */
+long TailleBlocDisque(tDisque disque) {
+  if (disque == NULL) {
+    return 0;
+  }
+
+  return disque->tailleBloc;
+}
+
+// fonction auxiliaire qui marque libre un bloc utilisé sans référence
+// (il quitte le cache sans être réécrit)
+static void rendreBloc(tDisque disque, tNumeroBloc numero) {
+  long mot = numero / BLOCS_PAR_MOT;
+
+  oublierVerification(disque, numero);
+  OublierBlocCache(disque->cache, numero);
+
+  disque->carte[mot] &= ~(UINT64_C(1) << (numero % BLOCS_PAR_MOT));
+  disque->nbLibres++;
+
+  if (mot < disque->premierMotLibre) {
+    disque->premierMotLibre = mot;
+  }
+}
+
+// fonction auxiliaire qui crée les tableaux d'épinglage d'un disque : 0 si ok, -1 sinon
+static int creerEpinglages(tDisque disque) {
+  if (disque->liberationsDifferees == NULL) {
+    disque->liberationsDifferees = calloc(disque->nbBlocs / BLOCS_PAR_MOT, sizeof(uint64_t));
+    if (disque->liberationsDifferees == NULL) {
+      return -1;
+    }
+  }
+  if (disque->cache == NULL && disque->epinglages == NULL) {
+    disque->epinglages = calloc(disque->nbBlocs, sizeof(uint32_t));
+    if (disque->epinglages == NULL) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/* V5
+ * Alloue un bloc libre du disque (premier bloc libre à partir du bloc indiqué).
+ * Entrées : le disque, le numéro du bloc à partir duquel chercher (BLOC_NUL pour le début)
+ * Retour : le numéro du bloc alloué, BLOC_NUL en cas de problème
+ */
+tNumeroBloc AllouerBlocDisque(tDisque disque, tNumeroBloc aPartirDe) {
+  if (disque == NULL) {
+    return BLOC_NUL;
+  }
+
+  // disque plein : on l'agrandit
+  if (disque->nbLibres == 0 && agrandirDisque(disque) != 0) {
+    fprintf(stderr, "AllouerBlocDisque : disque plein\n");
+    return BLOC_NUL;
+  }
+
+  // sans indication (ou indication hors du disque), on part du premier mot pouvant être libre
+  if (aPartirDe == BLOC_NUL || aPartirDe >= disque->nbBlocs) {
+    aPartirDe = (tNumeroBloc)(disque->premierMotLibre * BLOCS_PAR_MOT);
+  }
+
+  tNumeroBloc numero = chercherBlocLibre(disque, aPartirDe);
+  if (numero == BLOC_NUL) {
+    return BLOC_NUL;
+  }
+
+  // on marque le bloc utilisé
+  disque->carte[numero / BLOCS_PAR_MOT] |= UINT64_C(1) << (numero % BLOCS_PAR_MOT);
+  disque->nbLibres--;
+  if (disque->references != NULL) {
+    disque->references[numero] = 1;
+  }
+  oublierVerification(disque, numero);
+
+  // les mots pleins au début de la carte n'ont plus à être parcourus
+  while (disque->premierMotLibre < (long)(disque->nbBlocs / BLOCS_PAR_MOT)
+         && disque->carte[disque->premierMotLibre] == UINT64_MAX) {
+    disque->premierMotLibre++;
+  }
+
+  return numero;
+}
+
+/* V5
+ * Rend un bloc au disque (pour un bloc partagé, retire seulement une référence).
+ * Entrées : le disque, le numéro du bloc à libérer
+ * Retour : aucun
+ */
+void LibererBlocDisque(tDisque disque, tNumeroBloc numero) {
+  if (disque == NULL || numero == BLOC_NUL || numero >= disque->nbBlocs) {
+    return;
+  }
+
+  uint64_t masque = UINT64_C(1) << (numero % BLOCS_PAR_MOT);
+  long mot = numero / BLOCS_PAR_MOT;
+
+  // bloc déjà libre (ou libéré pendant son épinglage)
+  if ((disque->carte[mot] & masque) == 0 || estLiberationDifferee(disque, numero)) {
+    return;
+  }
+
+  // bloc partagé : on retire seulement une référence
+  if (disque->references != NULL && disque->references[numero] > 1) {
+    disque->references[numero]--;
+    disque->nbReferencesPartagees--;
+    return;
+  }
+  if (disque->references != NULL) {
+    disque->references[numero] = 0;
+  }
+
+  // le bloc quitte l'index de déduplication
+  retirerDeLIndex(disque, numero);
+
+  // bloc épinglé : il reste lisible en place, il n'est rendu qu'au dernier désépinglage
+  if (estEpingle(disque, numero)) {
+    disque->liberationsDifferees[mot] |= masque;
+    disque->nbLiberationsDifferees++;
+    return;
+  }
+
+  rendreBloc(disque, numero);
+}
+
+/* V5
+ * Retourne l'adresse des données d'un bloc du disque.
+ * Entrées : le disque, le numéro du bloc
+ * Retour : l'adresse du bloc, NULL si le numéro est invalide
+ */
+tBloc AdresseBlocDisque(tDisque disque, tNumeroBloc numero) {
+  if (!blocValide(disque, numero)) {
+    return NULL;
+  }
+
+  // l'appelant peut modifier le bloc : dans un fichier image, il sera réécrit
+  if (disque->cache != NULL) {
+    return BlocCache(disque->cache, numero, ACCES_MODIFICATION);
+  }
+  return disque->zone + (size_t)numero * disque->tailleBloc;
+}
+
+// fonction auxiliaire qui donne accès aux blocs consécutifs couverts par taille octets à partir d'un décalage
+// dans le premier (le premier et le dernier bloc partiellement couverts sont lus pour une écriture) :
+// retourne le nombre d'octets accessibles, jusqu'au premier bloc illisible ; disque en mémoire seulement
+static long accederSuiteBlocs(tDisque disque, tNumeroBloc premier, long decalage, long taille, bool ecriture) {
+  long nbBlocs = (decalage + taille + disque->tailleBloc - 1) / disque->tailleBloc;
+  long accessibles = 0;
+  for (long i = 0; i < nbBlocs; i++) {
+    long debut = (i == 0) ? decalage : 0;
+    long fin = (i == nbBlocs - 1) ? decalage + taille - i * disque->tailleBloc : disque->tailleBloc;
+    tAccesBloc acces = !ecriture ? ACCES_LECTURE
+                     : (debut == 0 && fin == disque->tailleBloc) ? ACCES_REMPLACEMENT : ACCES_MODIFICATION;
+    if (adresseBloc(disque, premier + (tNumeroBloc)i, acces) == NULL) {
+      break;
+    }
+    accessibles += fin - debut;
+  }
+  return accessibles;
+}
+
+/* V5
+ * Épingle des blocs consécutifs du disque pour les lire en place, sans copie.
+ * Entrées : le disque, le numéro du premier bloc, l'adresse du nombre de blocs voulus (remplacé par le nombre épinglés)
+ * Retour : l'adresse du premier bloc, NULL si le numéro est invalide, si le bloc est illisible ou ne peut pas être épinglé
+ */
+const unsigned char *EpinglerBlocsDisque(tDisque disque, tNumeroBloc premier, long *pNbBlocs) {
+  if (!blocValide(disque, premier) || pNbBlocs == NULL || *pNbBlocs <= 0) {
+    return NULL;
+  }
+
+  if (creerEpinglages(disque) != 0) {
+    return NULL;
+  }
+
+  // dans un fichier image, le bloc reste dans le cache
+  if (disque->cache != NULL) {
+    *pNbBlocs = 1;
+    return EpinglerBlocCache(disque->cache, premier);
+  }
+
+  // en mémoire, la suite s'arrête au premier bloc illisible ;
+  // la zone n'est plus libérée quand le disque s'agrandit (voir agrandirDisque)
+  long nbBlocs = (*pNbBlocs < (long)(disque->nbBlocs - premier)) ? *pNbBlocs : (long)(disque->nbBlocs - premier);
+  long lisibles = accederSuiteBlocs(disque, premier, 0, nbBlocs * disque->tailleBloc, false) / disque->tailleBloc;
+  if (lisibles == 0) {
+    return NULL;
+  }
+  for (long i = 0; i < lisibles; i++) {
+    disque->epinglages[premier + i]++;
+  }
+  disque->nbEpingles++;
+  *pNbBlocs = lisibles;
+  return disque->zone + (size_t)premier * disque->tailleBloc;
+}
+
+/* V5
+ * Relâche l'épinglage de blocs du disque ; ceux qui ont été libérés entre-temps sont rendus au dernier.
+ * Entrées : le disque, l'adresse retournée par EpinglerBlocsDisque, le numéro du premier bloc
+ *           et le nombre de blocs épinglés
+ * Retour : aucun
+ */
+void DesepinglerBlocsDisque(tDisque disque, const unsigned char *adresse, tNumeroBloc premier, long nbBlocs) {
+  if (!blocValide(disque, premier) || adresse == NULL || nbBlocs <= 0 || disque->liberationsDifferees == NULL
+      || nbBlocs > (long)(disque->nbBlocs - premier)) {
+    return;
+  }
+
+  if (disque->cache != NULL) {
+    DesepinglerBlocCache(disque->cache, adresse);
+  } else {
+    for (long i = 0; i < nbBlocs; i++) {
+      if (disque->epinglages[premier + i] > 0) {
+        disque->epinglages[premier + i]--;
+      }
+    }
+    if (disque->nbEpingles > 0 && --disque->nbEpingles == 0) {
+      libererZonesRetirees(disque);
+    }
+  }
+
+  // blocs libérés pendant l'épinglage
+  for (long i = 0; i < nbBlocs; i++) {
+    tNumeroBloc numero = premier + (tNumeroBloc)i;
+    if (estLiberationDifferee(disque, numero) && !estEpingle(disque, numero)) {
+      disque->liberationsDifferees[numero / BLOCS_PAR_MOT] &= ~(UINT64_C(1) << (numero % BLOCS_PAR_MOT));
+      disque->nbLiberationsDifferees--;
+      rendreBloc(disque, numero);
+    }
+  }
+}
+
+/* V5
+ * Copie à l'adresse contenu des octets d'un bloc du disque, à partir d'un décalage dans le bloc.
+ * Entrées : le disque, le numéro du bloc, le décalage dans le bloc, la zone où recopier et la taille en octets
+ * Retour : le nombre d'octets effectivement lus
+ */
+long LireBlocDisque(tDisque disque, tNumeroBloc numero, long decalage, unsigned char *contenu, long taille) {
+  // bloc invalide ou décalage hors du bloc
+  if (!blocValide(disque, numero) || contenu == NULL || decalage < 0 || decalage >= disque->tailleBloc) {
+    return 0;
+  }
+
+  // bloc illisible, ou chargé et corrompu (vérification à la première lecture)
+  tBloc bloc = adresseBloc(disque, numero, ACCES_LECTURE);
+  if (bloc == NULL) {
+    return 0;
+  }
+
+  // on ne dépasse pas la fin du bloc
+  long octetsACopier = disque->tailleBloc - decalage;
+  if (taille < octetsACopier) {
+    octetsACopier = taille;
+  }
+
+  if (octetsACopier == disque->tailleBloc) {
+    CopierBlocEntier(contenu, bloc, octetsACopier); // bloc lu en entier
+  } else {
+    CopierOctets(contenu, bloc + decalage, octetsACopier);
+  }
+
+  return octetsACopier;
+}
+
+/* V5
+ * Copie dans un bloc du disque, à partir d'un décalage dans le bloc, les octets situés à l'adresse contenu.
+ * Entrées : le disque, le numéro du bloc, le décalage dans le bloc, la zone à recopier et sa taille en octets
+ * Retour : le nombre d'octets effectivement écrits
+ */
+long EcrireBlocDisque(tDisque disque, tNumeroBloc numero, long decalage, unsigned char *contenu, long taille) {
+  // bloc invalide ou décalage hors du bloc
+  if (!blocValide(disque, numero) || contenu == NULL || decalage < 0 || decalage >= disque->tailleBloc) {
+    return 0;
+  }
+
+  // on ne dépasse pas la fin du bloc
+  long octetsACopier = disque->tailleBloc - decalage;
+  if (taille < octetsACopier) {
+    octetsACopier = taille;
+  }
+
+  // un bloc réécrit en entier n'a pas à être lu, sinon la partie gardée doit être intègre
+  tBloc bloc = adresseBloc(disque, numero, (octetsACopier == disque->tailleBloc) ? ACCES_REMPLACEMENT : ACCES_MODIFICATION);
+  if (bloc == NULL) {
+    return 0;
+  }
+
+  if (octetsACopier == disque->tailleBloc) {
+    CopierBlocEntier(bloc, contenu, octetsACopier); // bloc écrit en entier
+  } else {
+    CopierOctets(bloc + decalage, contenu, octetsACopier);
+  }
+
+  return octetsACopier;
+}
+
+/* V5
+ * Copie à l'adresse contenu taille octets de blocs consécutifs du disque, à partir d'un décalage dans le premier :
+ * une seule copie pour toute la suite quand les blocs sont en mémoire.
+ * Entrées : le disque, le numéro du premier bloc, le décalage dans ce bloc, la zone où recopier et sa taille en octets
+ * Retour : le nombre d'octets effectivement lus (la lecture s'arrête au premier bloc illisible)
+ */
+long LireSuiteBlocsDisque(tDisque disque, tNumeroBloc premier, long decalage, unsigned char *contenu, long taille) {
+  if (!blocValide(disque, premier) || contenu == NULL || decalage < 0 || decalage >= disque->tailleBloc || taille <= 0
+      || (long)premier + (decalage + taille - 1) / disque->tailleBloc >= (long)disque->nbBlocs) {
+    return 0;
+  }
+
+  // blocs du fichier image : un par un à travers le cache
+  if (disque->cache != NULL) {
+    long lus = 0;
+    for (tNumeroBloc numero = premier; lus < taille; numero++) {
+      long morceau = LireBlocDisque(disque, numero, (lus == 0) ? decalage : 0, contenu + lus, taille - lus);
+      if (morceau == 0) {
+        break;
+      }
+      lus += morceau;
+    }
+    return lus;
+  }
+
+  long lus = accederSuiteBlocs(disque, premier, decalage, taille, false);
+  CopierOctets(contenu, disque->zone + (size_t)premier * disque->tailleBloc + decalage, lus);
+  return lus;
+}
+
+/* V5
+ * Copie dans des blocs consécutifs du disque, à partir d'un décalage dans le premier, les taille octets situés
+ * à l'adresse contenu : une seule copie pour toute la suite quand les blocs sont en mémoire.
+ * Entrées : le disque, le numéro du premier bloc, le décalage dans ce bloc, la zone à recopier et sa taille en octets
+ * Retour : le nombre d'octets effectivement écrits
+ */
+long EcrireSuiteBlocsDisque(tDisque disque, tNumeroBloc premier, long decalage, unsigned char *contenu, long taille) {
+  if (!blocValide(disque, premier) || contenu == NULL || decalage < 0 || decalage >= disque->tailleBloc || taille <= 0
+      || (long)premier + (decalage + taille - 1) / disque->tailleBloc >= (long)disque->nbBlocs) {
+    return 0;
+  }
+
+  if (disque->cache != NULL) {
+    long ecrits = 0;
+    for (tNumeroBloc numero = premier; ecrits < taille; numero++) {
+      long morceau = EcrireBlocDisque(disque, numero, (ecrits == 0) ? decalage : 0, contenu + ecrits, taille - ecrits);
+      if (morceau == 0) {
+        break;
+      }
+      ecrits += morceau;
+    }
+    return ecrits;
+  }
+
+  long ecrits = accederSuiteBlocs(disque, premier, decalage, taille, true);
+  CopierOctets(disque->zone + (size_t)premier * disque->tailleBloc + decalage, contenu, ecrits);
+  return ecrits;
+}
+
+/* V5
+ * Met à zéro un bloc du disque.
+ * Entrées : le disque, le numéro du bloc
+ * Retour : aucun
+ */
+void EffacerBlocDisque(tDisque disque, tNumeroBloc numero) {
+  tBloc bloc = blocValide(disque, numero) ? adresseBloc(disque, numero, ACCES_REMPLACEMENT) : NULL;
+
+  if (bloc != NULL) {
+    memset(bloc, 0, disque->tailleBloc);
+  }
+}
+
+/* V5
+ * Recopie un bloc entier du disque dans un autre.
+ * Entrées : le disque, le numéro du bloc destination, le numéro du bloc source
+ * Sortie : 0 en cas de succès, -1 si un numéro est invalide ou si la source est illisible
+ */
+int CopierBlocDisque(tDisque disque, tNumeroBloc destination, tNumeroBloc source) {
+  if (!blocValide(disque, destination) || !blocValide(disque, source)) {
+    return -1;
+  }
+
+  // la source est demandée la première : le cache garde les deux blocs le temps de la copie
+  const unsigned char *contenu = adresseBloc(disque, source, ACCES_LECTURE);
+  unsigned char *copie = (contenu != NULL) ? adresseBloc(disque, destination, ACCES_REMPLACEMENT) : NULL;
+  if (copie == NULL) {
+    return -1;
+  }
+  CopierBlocEntier(copie, contenu, disque->tailleBloc);
+
+  return 0;
+}
+
+/* V5
+ * Retourne le nombre total de blocs du disque (bloc réservé compris).
+ * Entrée : le disque
+ * Retour : le nombre de blocs
+ */
+long NbBlocsDisque(tDisque disque) {
+  if (disque == NULL) {
+    return 0;
+  }
+
+  return disque->nbBlocs;
+}
+
+/* V5
+ * Retourne le nombre de blocs libres du disque (un bloc libéré pendant son épinglage est compté libre).
+ * Entrée : le disque
+ * Retour : le nombre de blocs libres
+ */
+long NbBlocsLibresDisque(tDisque disque) {
+  if (disque == NULL) {
+    return 0;
+  }
+
+  return disque->nbLibres + disque->nbLiberationsDifferees;
+}
+
+/* V5
+ * Active la déduplication des blocs d'un disque.
+ * Entrée : le disque
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+int ActiverDeduplicationDisque(tDisque disque) {
+  if (disque == NULL) {
+    fprintf(stderr, "ActiverDeduplicationDisque : le disque n'existe pas\n");
+    return -1;
+  }
+
+  // déjà activée
+  if (disque->index != NULL) {
+    return 0;
+  }
+
+  disque->index = CreerIndexDedup();
+  disque->indexes = calloc(disque->nbBlocs / BLOCS_PAR_MOT, sizeof(uint64_t));
+  if (disque->index == NULL || disque->indexes == NULL || (disque->references == NULL && creerReferences(disque) != 0)) {
+    fprintf(stderr, "ActiverDeduplicationDisque : probleme allocation\n");
+    DetruireIndexDedup(&disque->index);
+    free(disque->indexes);
+    disque->indexes = NULL;
+    return -1;
+  }
+
+  return 0;
+}
+
+/* V5
+ * Indique si la déduplication est activée sur un disque.
+ * Entrée : le disque
+ * Retour : true si elle est activée, false sinon
+ */
+bool DeduplicationActiveDisque(tDisque disque) {
+  return disque != NULL && disque->index != NULL;
+}
+
+/* V5
+ * Ajoute une référence à un bloc utilisé (le bloc est alors partagé).
+ * Entrées : le disque, le numéro du bloc
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+int PartagerBlocDisque(tDisque disque, tNumeroBloc numero) {
+  if (!blocValide(disque, numero)) {
+    return -1;
+  }
+  if (disque->references == NULL && creerReferences(disque) != 0) {
+    fprintf(stderr, "PartagerBlocDisque : probleme allocation\n");
+    return -1;
+  }
+
+  // bloc libéré pendant son épinglage (voir PreparerEcritureBlocDisque) : il reprend sa référence
+  if (estLiberationDifferee(disque, numero)) {
+    disque->liberationsDifferees[numero / BLOCS_PAR_MOT] &= ~(UINT64_C(1) << (numero % BLOCS_PAR_MOT));
+    disque->nbLiberationsDifferees--;
+    disque->references[numero] = 1;
+    return 0;
+  }
+
+  // bloc libre ou compteur saturé
+  if (disque->references[numero] == 0 || disque->references[numero] == UINT32_MAX) {
+    return -1;
+  }
+
+  disque->references[numero]++;
+  disque->nbReferencesPartagees++;
+
+  return 0;
+}
+
+/* V5
+ * Retourne le nombre de références d'un bloc.
+ * Entrées : le disque, le numéro du bloc
+ * Retour : le nombre de références (0 pour un bloc libre)
+ */
+long NbReferencesBlocDisque(tDisque disque, tNumeroBloc numero) {
+  if (!blocValide(disque, numero)) {
+    return 0;
+  }
+  if (disque->references != NULL) {
+    return disque->references[numero];
+  }
+  if (estLiberationDifferee(disque, numero)) {
+    return 0;
+  }
+
+  return (disque->carte[numero / BLOCS_PAR_MOT] >> (numero % BLOCS_PAR_MOT)) & 1;
+}
+
+/* V5
+ * Alloue un bloc ayant un contenu donné (un bloc entier).
+ * Avec la déduplication, un bloc existant de même contenu est partagé au lieu d'être recopié.
+ * Entrées : le disque, le numéro du bloc à partir duquel chercher (BLOC_NUL pour le début), le contenu
+ * Retour : le numéro du bloc, BLOC_NUL en cas de problème
+ */
+tNumeroBloc AllouerBlocContenuDisque(tDisque disque, tNumeroBloc aPartirDe, const unsigned char *contenu) {
+  if (disque == NULL || contenu == NULL) {
+    return BLOC_NUL;
+  }
+
+  // recherche d'un bloc identique, vérifié octet à octet
+  uint64_t empreinte = 0;
+  if (disque->index != NULL) {
+    empreinte = EmpreinteContenu(contenu, disque->tailleBloc);
+    struct sContenuCherche cherche = {disque, contenu};
+    tNumeroBloc identique = ChercherIndexDedup(disque->index, empreinte, blocIdentique, &cherche);
+    if (identique != BLOC_NUL && PartagerBlocDisque(disque, identique) == 0) {
+      return identique;
+    }
+  }
+
+  // sinon nouveau bloc
+  tNumeroBloc numero = AllouerBlocDisque(disque, aPartirDe);
+  if (numero == BLOC_NUL) {
+    return BLOC_NUL;
+  }
+  tBloc bloc = adresseBloc(disque, numero, ACCES_REMPLACEMENT);
+  if (bloc == NULL) {
+    LibererBlocDisque(disque, numero);
+    return BLOC_NUL;
+  }
+  CopierBlocEntier(bloc, contenu, disque->tailleBloc);
+
+  // le nouveau bloc pourra être partagé
+  if (disque->index != NULL && AjouterIndexDedup(disque->index, empreinte, numero) == 0) {
+    disque->indexes[numero / BLOCS_PAR_MOT] |= UINT64_C(1) << (numero % BLOCS_PAR_MOT);
+  }
+
+  return numero;
+}
+
+/* V5
+ * Prépare la modification d'un bloc (copie sur écriture) : un bloc partagé ou épinglé est d'abord recopié
+ * dans un nouveau bloc (un bloc épinglé est alors libéré), et un bloc indexé quitte l'index de déduplication.
+ * Entrées : le disque, le numéro du bloc à modifier
+ * Retour : le numéro du bloc à modifier à la place (le même s'il n'était ni partagé ni épinglé), BLOC_NUL en cas de problème
+ */
+tNumeroBloc PreparerEcritureBlocDisque(tDisque disque, tNumeroBloc numero) {
+  // la copie ou la modification doit partir d'un bloc intègre
+  if (!blocValide(disque, numero) || adresseBloc(disque, numero, ACCES_LECTURE) == NULL) {
+    return BLOC_NUL;
+  }
+
+  // bloc partagé, ou épinglé (ses lecteurs en place ne le voient pas changer) : on en fait une copie privée
+  bool partage = disque->references != NULL && disque->references[numero] > 1;
+  if (partage || estEpingle(disque, numero)) {
+    tNumeroBloc copie = AllouerBlocDisque(disque, numero + 1);
+    if (copie == BLOC_NUL) {
+      return BLOC_NUL;
+    }
+    // adresses prises après l'allocation (la zone a pu être déplacée)
+    if (CopierBlocDisque(disque, copie, numero) != 0) {
+      LibererBlocDisque(disque, copie);
+      return BLOC_NUL;
+    }
+    // le fichier quitte le bloc d'origine (un bloc épinglé n'est rendu qu'au dernier désépinglage)
+    if (partage) {
+      disque->references[numero]--;
+      disque->nbReferencesPartagees--;
+    } else {
+      LibererBlocDisque(disque, numero);
+    }
+    return copie;
+  }
+
+  // son contenu va changer : il ne doit plus être trouvé dans l'index
+  retirerDeLIndex(disque, numero);
+
+  return numero;
+}
+
+/* V5
+ * Retourne le nombre de références en plus d'une, sur tous les blocs du disque
+ * (c'est le nombre de blocs économisés par le partage).
+ * Entrée : le disque
+ * Retour : le nombre de références partagées
+ */
+long NbReferencesPartageesDisque(tDisque disque) {
+  if (disque == NULL) {
+    return 0;
+  }
+
+  return disque->nbReferencesPartagees;
+}
+
+/* V5
+ * Retourne la mémoire utilisée pour la déduplication (index, carte des blocs indexés, nombres de références).
+ * Entrée : le disque
+ * Retour : la taille en octets
+ */
+long TailleMemoireDedupDisque(tDisque disque) {
+  if (disque == NULL) {
+    return 0;
+  }
+
+  long taille = TailleMemoireIndexDedup(disque->index);
+  if (disque->indexes != NULL) {
+    taille += (disque->nbBlocs / BLOCS_PAR_MOT) * (long)sizeof(uint64_t);
+  }
+  if (disque->references != NULL) {
+    taille += disque->nbBlocs * (long)sizeof(uint32_t);
+  }
+
+  return taille;
+}
+
+/* V5
+ * Sauvegarde un disque dans un fichier (préalablement ouvert en écriture et en mode binaire).
+ * Entrées : le disque, l'identificateur du fichier
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+int SauvegarderDisque(tDisque disque, FILE *fichier) {
+  // erreur disque
+  if (disque == NULL) {
+    fprintf(stderr, "SauvegarderDisque : le disque n'existe pas\n");
+    return -1;
+  }
+
+  // erreur fichier
+  if (fichier == NULL) {
+    fprintf(stderr, "SauvegarderDisque : le fichier n'existe pas\n");
+    return -1;
+  }
+
+  size_t nbMots = disque->nbBlocs / BLOCS_PAR_MOT;
+
+  // disque stocké dans un fichier : les blocs modifiés y sont d'abord réécrits
+  if (disque->cache != NULL && ViderCache(disque->cache) != 0) {
+    fprintf(stderr, "SauvegarderDisque : erreur écriture de l'image\n");
+    return -1;
+  }
+
+  // carte sauvegardée : les blocs libérés pendant leur épinglage y sont libres
+  uint64_t *carte = disque->carte;
+  if (disque->nbLiberationsDifferees > 0) {
+    carte = malloc(nbMots * sizeof(uint64_t));
+    if (carte == NULL) {
+      fprintf(stderr, "SauvegarderDisque : erreur allocation\n");
+      return -1;
+    }
+    for (size_t i = 0; i < nbMots; i++) {
+      carte[i] = disque->carte[i] & ~disque->liberationsDifferees[i];
+    }
+  }
+
+  // en-tête (avec le fichier image s'il y en a un) et carte
+  uint32_t stockage = (disque->cache != NULL) ? STOCKAGE_FICHIER : STOCKAGE_MEMOIRE;
+  uint32_t longueurNom = (disque->nomImage != NULL) ? (uint32_t)strlen(disque->nomImage) : 0;
+  if (fwrite(&disque->tailleBloc, sizeof(long), 1, fichier) != 1
+      || fwrite(&disque->nbBlocs, sizeof(tNumeroBloc), 1, fichier) != 1
+      || fwrite(&stockage, sizeof(uint32_t), 1, fichier) != 1
+      || (stockage == STOCKAGE_FICHIER
+          && (fwrite(&longueurNom, sizeof(uint32_t), 1, fichier) != 1
+              || fwrite(disque->nomImage, sizeof(char), longueurNom, fichier) != longueurNom))
+      || fwrite(carte, sizeof(uint64_t), nbMots, fichier) != nbMots) {
+    fprintf(stderr, "SauvegarderDisque : erreur écriture\n");
+    if (carte != disque->carte) {
+      free(carte);
+    }
+    return -1;
+  }
+  if (carte != disque->carte) {
+    free(carte);
+  }
+
+  // disque en mémoire : l'image des blocs, alignée pour être projetée au chargement,
+  // où seuls les blocs utilisés sont écrits (une écriture par suite de blocs contigus)
+  if (stockage == STOCKAGE_MEMOIRE && transfererBlocsUtilises(disque, fichier, debutImageBlocs(fichier), true) != 0) {
+    fprintf(stderr, "SauvegarderDisque : erreur écriture\n");
+    return -1;
+  }
+
+  // sommes de contrôle des blocs utilisés, dans l'ordre des blocs, en une écriture
+  // (un bloc chargé pas encore vérifié garde sa somme d'origine : une corruption n'est pas masquée ;
+  // dans un fichier image, seul un bloc alloué jamais écrit doit être relu, le bloc réservé 0 n'y est pas)
+  size_t nbUtilises = disque->nbBlocs - disque->nbLibres - disque->nbLiberationsDifferees;
+  uint32_t *sommes = malloc(nbUtilises * sizeof(uint32_t));
+  if (sommes == NULL) {
+    fprintf(stderr, "SauvegarderDisque : erreur allocation\n");
+    return -1;
+  }
+  size_t k = 0;
+  for (tNumeroBloc i = 0; i < disque->nbBlocs && k < nbUtilises; i++) {
+    if (!estUtilise(disque->carte, i) || estLiberationDifferee(disque, i)) {
+      continue;
+    }
+    const unsigned char *bloc = NULL;
+    if (estAVerifier(disque, i)) {
+      sommes[k++] = disque->sommes[i];
+    } else if (i == BLOC_NUL && stockage == STOCKAGE_FICHIER) {
+      sommes[k++] = 0;
+    } else if ((bloc = adresseBloc(disque, i, ACCES_LECTURE)) != NULL) {
+      sommes[k++] = SommeControle(bloc, disque->tailleBloc);
+    } else {
+      break;
+    }
+  }
+  if (k != nbUtilises || fwrite(sommes, sizeof(uint32_t), nbUtilises, fichier) != nbUtilises) {
+    fprintf(stderr, "SauvegarderDisque : erreur écriture\n");
+    free(sommes);
+    return -1;
+  }
+  free(sommes);
+
+  // options, puis nombres de références et carte des blocs indexés s'il y en a
+  uint32_t options = (disque->index != NULL ? OPTION_DEDUP : 0) | (disque->references != NULL ? OPTION_REFERENCES : 0);
+  if (fwrite(&options, sizeof(uint32_t), 1, fichier) != 1
+      || (disque->references != NULL
+          && fwrite(disque->references, sizeof(uint32_t), disque->nbBlocs, fichier) != disque->nbBlocs)
+      || (disque->index != NULL
+          && fwrite(disque->indexes, sizeof(uint64_t), nbMots, fichier) != nbMots)) {
+    fprintf(stderr, "SauvegarderDisque : erreur écriture\n");
+    return -1;
+  }
+
+  return 0;
+}
+
+// fonction auxiliaire qui lit les sommes de contrôle des blocs utilisés d'un disque en cours de chargement,
+// et les vérifie tout de suite ou les garde pour la première lecture de chaque bloc (vérification paresseuse) ;
+// retourne 0 si ok, -1 en cas d'erreur de lecture ou de bloc corrompu
+static int chargerSommes(tDisque disque, FILE *fichier) {
+  size_t nbUtilises = disque->nbBlocs - disque->nbLibres;
+  if (nbUtilises == 0) {
+    return 0;
+  }
+  uint32_t *sommes = malloc(nbUtilises * sizeof(uint32_t));
+  if (sommes == NULL || fread(sommes, sizeof(uint32_t), nbUtilises, fichier) != nbUtilises) {
+    fprintf(stderr, "ChargerDisque : erreur lecture des sommes de contrôle\n");
+    free(sommes);
+    return -1;
+  }
+
+  // les blocs d'un fichier image sont vérifiés à leur lecture dans le fichier, ceux d'une zone projetée
+  // à leur première lecture (une vérification au chargement lirait toute la projection)
+  bool paresseuse = verificationParesseuse || disque->cache != NULL || disque->tailleProjection > 0;
+  if (paresseuse && disque->aVerifier == NULL) {
+    disque->aVerifier = calloc(disque->nbBlocs / BLOCS_PAR_MOT, sizeof(uint64_t));
+    disque->sommes = malloc((size_t)disque->nbBlocs * sizeof(uint32_t));
+    if (disque->aVerifier == NULL || disque->sommes == NULL) {
+      fprintf(stderr, "ChargerDisque : probleme allocation\n");
+      free(sommes);
+      return -1;
+    }
+  }
+
+  int resultat = 0;
+  size_t k = 0;
+  for (tNumeroBloc i = 0; i < disque->nbBlocs && k < nbUtilises; i++) {
+    if (!estUtilise(disque->carte, i)) {
+      continue;
+    }
+    if (paresseuse) {
+      disque->sommes[i] = sommes[k];
+      disque->aVerifier[i / BLOCS_PAR_MOT] |= UINT64_C(1) << (i % BLOCS_PAR_MOT);
+    } else if (SommeControle(disque->zone + (size_t)i * disque->tailleBloc, disque->tailleBloc) != sommes[k]) {
+      fprintf(stderr, "ChargerDisque : bloc %u corrompu (somme de contrôle invalide)\n", i);
+      resultat = -1;
+      break;
+    }
+    k++;
+  }
+  free(sommes);
+
+  return resultat;
+}
+
+/* V5
+ * Choisit quand les sommes de contrôle des blocs chargés (ChargerDisque) sont vérifiées :
+ * au chargement (par défaut) ou à la première lecture de chaque bloc.
+ * Entrée : true pour vérifier à la première lecture
+ * Sortie : aucune
+ */
+void VerificationParesseuseDisque(bool paresseuse) {
+  verificationParesseuse = paresseuse;
+}
+
+/* V5
+ * Enregistre la somme de contrôle attendue d'un bloc qui vient d'être chargé dans le disque :
+ * elle est vérifiée tout de suite, ou à la première lecture du bloc (voir VerificationParesseuseDisque).
+ * Entrées : le disque, le numéro du bloc, sa somme de contrôle attendue
+ * Sortie : 0 si le bloc est intègre (ou sera vérifié plus tard), -1 s'il est corrompu ou en cas d'erreur
+ */
+int VerifierBlocChargeDisque(tDisque disque, tNumeroBloc numero, uint32_t somme) {
+  tBloc bloc = AdresseBlocDisque(disque, numero);
+  if (bloc == NULL) {
+    return -1;
+  }
+
+  // le bloc est en mémoire (dans le cache pour un fichier image) : autant le vérifier tout de suite
+  if (!verificationParesseuse || disque->cache != NULL) {
+    return (SommeControle(bloc, disque->tailleBloc) == somme) ? 0 : -1;
+  }
+
+  if (disque->aVerifier == NULL) {
+    disque->aVerifier = calloc(disque->nbBlocs / BLOCS_PAR_MOT, sizeof(uint64_t));
+    disque->sommes = malloc((size_t)disque->nbBlocs * sizeof(uint32_t));
+    if (disque->aVerifier == NULL || disque->sommes == NULL) {
+      free(disque->aVerifier);
+      free(disque->sommes);
+      disque->aVerifier = NULL;
+      disque->sommes = NULL;
+      return -1;
+    }
+  }
+  disque->sommes[numero] = somme;
+  disque->aVerifier[numero / BLOCS_PAR_MOT] |= UINT64_C(1) << (numero % BLOCS_PAR_MOT);
+
+  return 0;
+}
+
+/* V5
+ * Charge un disque sauvegardé par SauvegarderDisque.
+ * Entrées : le disque chargé, l'identificateur du fichier (préalablement ouvert en lecture et en mode binaire)
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+int ChargerDisque(tDisque *pDisque, FILE *fichier) {
+  // erreur pointeur disque
+  if (pDisque == NULL) {
+    fprintf(stderr, "ChargerDisque : le pointeur de disque n'existe pas\n");
+    return -1;
+  }
+
+  // erreur fichier
+  if (fichier == NULL) {
+    fprintf(stderr, "ChargerDisque : le fichier n'existe pas\n");
+    return -1;
+  }
+
+  long tailleBloc;
+  tNumeroBloc nbBlocs;
+  uint32_t stockage;
+
+  // lecture de l'en-tête
+  if (fread(&tailleBloc, sizeof(long), 1, fichier) != 1
+      || fread(&nbBlocs, sizeof(tNumeroBloc), 1, fichier) != 1
+      || fread(&stockage, sizeof(uint32_t), 1, fichier) != 1) {
+    fprintf(stderr, "ChargerDisque : erreur lecture en-tête\n");
+    return -1;
+  }
+
+  // verif en-tête
+  if (!TailleBlocValide(tailleBloc) || nbBlocs == 0 || nbBlocs % BLOCS_PAR_MOT != 0
+      || (stockage != STOCKAGE_MEMOIRE && stockage != STOCKAGE_FICHIER)) {
+    fprintf(stderr, "ChargerDisque : en-tête invalide\n");
+    return -1;
+  }
+
+  tDisque disque = (tDisque)malloc(sizeof(struct sDisque));
+  if (disque == NULL) {
+    fprintf(stderr, "ChargerDisque : probleme creation\n");
+    return -1;
+  }
+
+  size_t nbMots = nbBlocs / BLOCS_PAR_MOT;
+  disque->tailleBloc = tailleBloc;
+  disque->cache = NULL;
+  disque->nomImage = NULL;
+  disque->references = NULL;
+  disque->nbReferencesPartagees = 0;
+  disque->index = NULL;
+  disque->indexes = NULL;
+  disque->aVerifier = NULL;
+  disque->sommes = NULL;
+  disque->nbEpingles = 0;
+  disque->zonesRetirees = NULL;
+  disque->epinglages = NULL;
+  disque->liberationsDifferees = NULL;
+  disque->nbLiberationsDifferees = 0;
+  disque->nbBlocs = nbBlocs;
+  disque->zone = NULL;
+  disque->tailleProjection = 0;
+  disque->carte = NULL;
+
+  // disque stocké dans un fichier : seul le fichier image est ouvert, ses blocs seront lus à la demande
+  if (stockage == STOCKAGE_FICHIER) {
+    uint32_t longueurNom;
+    if (fread(&longueurNom, sizeof(uint32_t), 1, fichier) != 1
+        || (disque->nomImage = malloc((size_t)longueurNom + 1)) == NULL
+        || fread(disque->nomImage, sizeof(char), longueurNom, fichier) != longueurNom) {
+      fprintf(stderr, "ChargerDisque : erreur lecture du fichier image\n");
+      DetruireDisque(&disque);
+      return -1;
+    }
+    disque->nomImage[longueurNom] = '\0';
+    disque->aVerifier = calloc(nbMots, sizeof(uint64_t));
+    disque->sommes = malloc((size_t)nbBlocs * sizeof(uint32_t));
+    if (disque->aVerifier == NULL || disque->sommes == NULL
+        || (disque->cache = OuvrirCacheBlocs(disque->nomImage, false, tailleBloc, budgetCache,
+                                             blocLuImage, blocEcritImage, disque)) == NULL) {
+      DetruireDisque(&disque);
+      return -1;
+    }
+  }
+  disque->carte = malloc(nbMots * sizeof(uint64_t));
+
+  // erreur allocation ou lecture de la carte
+  if (disque->carte == NULL || fread(disque->carte, sizeof(uint64_t), nbMots, fichier) != nbMots) {
+    fprintf(stderr, "ChargerDisque : erreur lecture de la carte\n");
+    DetruireDisque(&disque);
+    return -1;
+  }
+
+  // disque en mémoire : l'image des blocs est projetée, ou sinon lue (une lecture par suite de blocs utilisés)
+  if (stockage == STOCKAGE_MEMOIRE) {
+    off_t debutImage = debutImageBlocs(fichier);
+    if (debutImage < 0 || projeterZone(disque, fichier, debutImage) != 0) {
+      disque->zone = allouerZone(nbBlocs, tailleBloc);
+      if (disque->zone == NULL || debutImage < 0 || transfererBlocsUtilises(disque, fichier, debutImage, false) != 0) {
+        fprintf(stderr, "ChargerDisque : erreur lecture des blocs\n");
+        DetruireDisque(&disque);
+        return -1;
+      }
+    }
+  }
+
+  // sommes de contrôle des blocs utilisés (le bloc 0 en fait partie)
+  disque->nbLibres = compterBlocsLibres(disque);
+  if (chargerSommes(disque, fichier) != 0) {
+    DetruireDisque(&disque);
+    return -1;
+  }
+
+  // le bloc 0 reste réservé
+  if ((disque->carte[0] & 1) == 0) {
+    disque->carte[0] |= 1;
+    disque->nbLibres--;
+  }
+  disque->premierMotLibre = 0;
+
+  // options de la sauvegarde
+  uint32_t options;
+  if (fread(&options, sizeof(uint32_t), 1, fichier) != 1) {
+    fprintf(stderr, "ChargerDisque : erreur lecture des options\n");
+    DetruireDisque(&disque);
+    return -1;
+  }
+
+  // nombres de références : un bloc libre n'en a aucune
+  if (options & OPTION_REFERENCES) {
+    disque->references = malloc((size_t)nbBlocs * sizeof(uint32_t));
+    if (disque->references == NULL
+        || fread(disque->references, sizeof(uint32_t), nbBlocs, fichier) != nbBlocs) {
+      fprintf(stderr, "ChargerDisque : erreur lecture des références\n");
+      DetruireDisque(&disque);
+      return -1;
+    }
+    for (tNumeroBloc i = 0; i < nbBlocs; i++) {
+      if (!estUtilise(disque->carte, i)) {
+        disque->references[i] = 0;
+      } else if (disque->references[i] == 0) {
+        disque->references[i] = 1;
+      }
+      disque->nbReferencesPartagees += (disque->references[i] > 1) ? disque->references[i] - 1 : 0;
+    }
+  }
+
+  // déduplication : l'index est reconstruit à partir de la carte des blocs indexés
+  if (options & OPTION_DEDUP) {
+    uint64_t *indexes = malloc(nbMots * sizeof(uint64_t));
+    if (indexes == NULL || fread(indexes, sizeof(uint64_t), nbMots, fichier) != nbMots
+        || ActiverDeduplicationDisque(disque) != 0) {
+      fprintf(stderr, "ChargerDisque : erreur lecture de l'index\n");
+      free(indexes);
+      DetruireDisque(&disque);
+      return -1;
+    }
+    for (tNumeroBloc i = 1; i < nbBlocs; i++) {
+      uint64_t bit = UINT64_C(1) << (i % BLOCS_PAR_MOT);
+      if ((indexes[i / BLOCS_PAR_MOT] & bit) && (disque->carte[i / BLOCS_PAR_MOT] & bit)) {
+        ajouterALIndex(disque, i);
+      }
+    }
+    free(indexes);
+  }
+
+  *pDisque = disque;
+
+  return 0;
+}
@@ -0,0 +1,323 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : disque.h
+ * Module de gestion d'un disque (simulé).
+ * Un disque est une zone mémoire contiguë découpée en blocs numérotés,
+ * accompagnée d'une carte des blocs libres (un bit par bloc).
+ * Les blocs peuvent aussi être stockés dans un fichier image, lus et écrits à la demande (voir CreerDisqueFichier).
+ **/
+#ifndef __DISQUE_H__
+#define __DISQUE_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include "bloc.h"
+
+// Type représentant le numéro d'un bloc sur un disque
+// (le bloc 0 est réservé : le numéro 0 signifie "pas de bloc")
+typedef uint32_t tNumeroBloc;
+
+// Numéro signifiant "pas de bloc"
+#define BLOC_NUL           0
+
+// Nombre de blocs d'un disque à sa création (le disque s'agrandit ensuite si besoin)
+#define NB_BLOCS_DISQUE_INITIAL 64
+
+// Mémoire par défaut du cache de blocs d'un disque stocké dans un fichier (4 Mio)
+#define BUDGET_CACHE_DISQUE (4L * 1024 * 1024)
+
+// Type public représentant un disque
+typedef struct sDisque *tDisque;
+
+// Compteurs d'activité du cache de blocs d'un disque stocké dans un fichier
+typedef struct
+{
+  // Blocs trouvés dans le cache
+  long succes;
+  // Blocs absents du cache (lus dans le fichier, sauf s'ils étaient réécrits en entier)
+  long defauts;
+  // Blocs retirés du cache pour faire de la place
+  long evictions;
+  // Blocs modifiés réécrits dans le fichier
+  long ecritures;
+  // Blocs lus par anticipation (lecture séquentielle)
+  long anticipes;
+} tStatsCache;
+
+/* V5
+ * Crée un disque vide (seul le bloc réservé 0 est utilisé).
+ * Entrée : la taille des blocs en octets (voir TailleBlocValide)
+ * Retour : le disque créé, ou NULL en cas de problème
+ */
+extern tDisque CreerDisque(long tailleBloc);
+
+/* V5
+ * Crée un disque vide dont les blocs sont stockés dans un fichier image (bloc n à l'octet n x tailleBloc),
+ * lus (pread) et écrits (pwrite) par l'intermédiaire d'un cache de blocs : seuls les blocs utilisés
+ * récemment sont en mémoire (voir BudgetCacheDisque). Le disque s'utilise ensuite comme un disque en mémoire.
+ * Entrées : la taille des blocs en octets (voir TailleBlocValide), le nom du fichier image (créé ou vidé)
+ * Retour : le disque créé, ou NULL en cas de problème
+ */
+extern tDisque CreerDisqueFichier(long tailleBloc, char nomImage[]);
+
+/* V5
+ * Choisit la mémoire du cache de blocs des disques stockés dans un fichier créés ou chargés ensuite
+ * (BUDGET_CACHE_DISQUE par défaut) : un volume plus grand que ce budget ne garde en mémoire que ses blocs
+ * utilisés récemment, les blocs modifiés sont réécrits dans le fichier image quand ils quittent le cache.
+ * Entrée : le budget en octets (au moins deux blocs sont toujours gardés)
+ * Sortie : aucune
+ */
+extern void BudgetCacheDisque(long budget);
+
+/* V5
+ * Retourne les compteurs d'activité du cache de blocs d'un disque stocké dans un fichier.
+ * Entrées : le disque, la structure où recopier les compteurs
+ * Sortie : 0 en cas de succès, -1 si le disque n'a pas de cache (disque en mémoire)
+ */
+extern int StatistiquesCacheDisque(tDisque disque, tStatsCache *stats);
+
+/* V5
+ * Retourne la mémoire occupée par les blocs du cache d'un disque stocké dans un fichier.
+ * Entrée : le disque
+ * Retour : la taille en octets (0 pour un disque en mémoire)
+ */
+extern long TailleMemoireCacheDisque(tDisque disque);
+
+/* V5
+ * Détruit un disque : sa zone de blocs et sa carte des blocs libres sont libérées d'un coup
+ * (pour un fichier image, les blocs modifiés encore dans le cache y sont réécrits et le fichier est fermé).
+ * Entrée : le disque à détruire
+ * Retour : aucun
+ */
+extern void DetruireDisque(tDisque *pDisque);
+
+/* V5
+ * Retourne le disque utilisé par les inodes qui n'appartiennent à aucun SF
+ * (créé à la première demande, avec des blocs de TAILLE_BLOC octets).
+ * Entrée : aucune
+ * Retour : le disque par défaut, ou NULL en cas de problème
+ */
+extern tDisque DisqueParDefaut(void);
+
+/* V5
+ * Retourne la taille des blocs d'un disque.
+ * Entrée : le disque
+ * Retour : la taille en octets des blocs
+ */
+extern long TailleBlocDisque(tDisque disque);
+
+/* V5
+ * Alloue un bloc libre du disque (premier bloc libre à partir du bloc indiqué,
+ * pour que les blocs successifs d'un fichier soient contigus).
+ * Le disque est agrandi s'il n'a plus de bloc libre.
+ * Entrées : le disque, le numéro du bloc à partir duquel chercher (BLOC_NUL pour le début)
+ * Retour : le numéro du bloc alloué, BLOC_NUL en cas de problème
+ */
+extern tNumeroBloc AllouerBlocDisque(tDisque disque, tNumeroBloc aPartirDe);
+
+/* V5
+ * Rend un bloc au disque (pour un bloc partagé, retire seulement une référence).
+ * Entrées : le disque, le numéro du bloc à libérer
+ * Retour : aucun
+ */
+extern void LibererBlocDisque(tDisque disque, tNumeroBloc numero);
+
+/* V5
+ * Retourne l'adresse des données d'un bloc du disque (le bloc peut y être modifié).
+ * L'adresse n'est valable que jusqu'à la prochaine allocation (le disque peut être déplacé en s'agrandissant),
+ * et pour un fichier image tant qu'au plus un autre bloc est lu ou écrit (le bloc est dans le cache).
+ * Entrées : le disque, le numéro du bloc
+ * Retour : l'adresse du bloc, NULL si le numéro est invalide
+ */
+extern tBloc AdresseBlocDisque(tDisque disque, tNumeroBloc numero);
+
+/* V5
+ * Épingle des blocs consécutifs du disque pour les lire en place, sans copie : leur adresse reste valable
+ * jusqu'à DesepinglerBlocsDisque, même si le disque s'agrandit ou si d'autres blocs sont lus entre-temps.
+ * Leur contenu ne change pas non plus : PreparerEcritureBlocDisque recopie un bloc épinglé avant sa modification,
+ * et un bloc épinglé libéré n'est rendu (compté libre, réutilisable) qu'au dernier désépinglage ; seules les
+ * écritures sans PreparerEcritureBlocDisque sont vues en place. Un bloc peut être épinglé plusieurs fois.
+ * En mémoire, toute la suite est épinglée d'un coup (elle est contiguë) ; pour un fichier image, seul le premier
+ * bloc l'est, et il reste dans le cache, qui peut refuser s'il n'a plus assez de cases libres.
+ * Entrées : le disque, le numéro du premier bloc, l'adresse du nombre de blocs voulus,
+ *           où est rangé le nombre de blocs épinglés (contigus en mémoire à partir de l'adresse retournée)
+ * Retour : l'adresse du premier bloc, NULL si le numéro est invalide, si le bloc est illisible ou ne peut pas être épinglé
+ */
+extern const unsigned char *EpinglerBlocsDisque(tDisque disque, tNumeroBloc premier, long *pNbBlocs);
+
+/* V5
+ * Relâche l'épinglage de blocs du disque ; ceux qui ont été libérés entre-temps sont rendus au dernier.
+ * Entrées : le disque, l'adresse retournée par EpinglerBlocsDisque, le numéro du premier bloc
+ *           et le nombre de blocs épinglés
+ * Retour : aucun
+ */
+extern void DesepinglerBlocsDisque(tDisque disque, const unsigned char *adresse, tNumeroBloc premier, long nbBlocs);
+
+/* V5
+ * Copie à l'adresse contenu des octets d'un bloc du disque, à partir d'un décalage dans le bloc.
+ * On ne lit pas au-delà de la fin du bloc.
+ * Entrées : le disque, le numéro du bloc, le décalage dans le bloc, la zone où recopier et la taille en octets
+ * Retour : le nombre d'octets effectivement lus
+ */
+extern long LireBlocDisque(tDisque disque, tNumeroBloc numero, long decalage, unsigned char *contenu, long taille);
+
+/* V5
+ * Copie dans un bloc du disque, à partir d'un décalage dans le bloc, les octets situés à l'adresse contenu.
+ * On n'écrit pas au-delà de la fin du bloc.
+ * Entrées : le disque, le numéro du bloc, le décalage dans le bloc, la zone à recopier et sa taille en octets
+ * Retour : le nombre d'octets effectivement écrits
+ */
+extern long EcrireBlocDisque(tDisque disque, tNumeroBloc numero, long decalage, unsigned char *contenu, long taille);
+
+/* V5
+ * Copie à l'adresse contenu taille octets de blocs consécutifs du disque, à partir d'un décalage dans le premier
+ * (une seule copie pour toute la suite quand les blocs sont en mémoire).
+ * Entrées : le disque, le numéro du premier bloc, le décalage dans ce bloc, la zone où recopier et sa taille en octets
+ * Retour : le nombre d'octets effectivement lus (la lecture s'arrête au premier bloc illisible)
+ */
+extern long LireSuiteBlocsDisque(tDisque disque, tNumeroBloc premier, long decalage, unsigned char *contenu, long taille);
+
+/* V5
+ * Copie dans des blocs consécutifs du disque, à partir d'un décalage dans le premier, les taille octets
+ * situés à l'adresse contenu (une seule copie pour toute la suite quand les blocs sont en mémoire).
+ * Entrées : le disque, le numéro du premier bloc, le décalage dans ce bloc, la zone à recopier et sa taille en octets
+ * Retour : le nombre d'octets effectivement écrits
+ */
+extern long EcrireSuiteBlocsDisque(tDisque disque, tNumeroBloc premier, long decalage, unsigned char *contenu, long taille);
+
+/* V5
+ * Met à zéro un bloc du disque.
+ * Entrées : le disque, le numéro du bloc
+ * Retour : aucun
+ */
+extern void EffacerBlocDisque(tDisque disque, tNumeroBloc numero);
+
+/* V5
+ * Recopie un bloc entier du disque dans un autre.
+ * Entrées : le disque, le numéro du bloc destination, le numéro du bloc source
+ * Sortie : 0 en cas de succès, -1 si un numéro est invalide ou si la source est illisible
+ */
+extern int CopierBlocDisque(tDisque disque, tNumeroBloc destination, tNumeroBloc source);
+
+/* V5
+ * Retourne le nombre total de blocs du disque (bloc réservé compris).
+ * Entrée : le disque
+ * Retour : le nombre de blocs
+ */
+extern long NbBlocsDisque(tDisque disque);
+
+/* V5
+ * Retourne le nombre de blocs libres du disque.
+ * Entrée : le disque
+ * Retour : le nombre de blocs libres
+ */
+extern long NbBlocsLibresDisque(tDisque disque);
+
+/* V5
+ * Active la déduplication des blocs d'un disque : les blocs entiers alloués ensuite par
+ * AllouerBlocContenuDisque sont indexés par leur empreinte, et un bloc de même contenu
+ * est partagé (avec un nombre de références) au lieu d'être stocké de nouveau.
+ * Entrée : le disque
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int ActiverDeduplicationDisque(tDisque disque);
+
+/* V5
+ * Indique si la déduplication est activée sur un disque.
+ * Entrée : le disque
+ * Retour : true si elle est activée, false sinon
+ */
+extern bool DeduplicationActiveDisque(tDisque disque);
+
+/* V5
+ * Ajoute une référence à un bloc utilisé (le bloc est alors partagé).
+ * LibererBlocDisque retire une référence, le bloc n'est libéré qu'à la dernière.
+ * Entrées : le disque, le numéro du bloc
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int PartagerBlocDisque(tDisque disque, tNumeroBloc numero);
+
+/* V5
+ * Retourne le nombre de références d'un bloc.
+ * Entrées : le disque, le numéro du bloc
+ * Retour : le nombre de références (0 pour un bloc libre)
+ */
+extern long NbReferencesBlocDisque(tDisque disque, tNumeroBloc numero);
+
+/* V5
+ * Alloue un bloc ayant un contenu donné (un bloc entier).
+ * Avec la déduplication, un bloc existant de même contenu est partagé au lieu d'être recopié.
+ * Entrées : le disque, le numéro du bloc à partir duquel chercher (BLOC_NUL pour le début), le contenu
+ * Retour : le numéro du bloc, BLOC_NUL en cas de problème
+ */
+extern tNumeroBloc AllouerBlocContenuDisque(tDisque disque, tNumeroBloc aPartirDe, const unsigned char *contenu);
+
+/* V5
+ * Prépare la modification d'un bloc (copie sur écriture) : à appeler avant d'écrire dans un bloc existant.
+ * Un bloc partagé ou épinglé est d'abord recopié dans un nouveau bloc (le bloc épinglé est alors libéré,
+ * voir EpinglerBlocsDisque), et un bloc indexé quitte l'index de déduplication.
+ * Entrées : le disque, le numéro du bloc à modifier
+ * Retour : le numéro du bloc à modifier à la place (le même s'il n'était ni partagé ni épinglé), BLOC_NUL en cas de problème
+ */
+extern tNumeroBloc PreparerEcritureBlocDisque(tDisque disque, tNumeroBloc numero);
+
+/* V5
+ * Retourne le nombre de références en plus d'une, sur tous les blocs du disque
+ * (c'est le nombre de blocs économisés par le partage).
+ * Entrée : le disque
+ * Retour : le nombre de références partagées
+ */
+extern long NbReferencesPartageesDisque(tDisque disque);
+
+/* V5
+ * Retourne la mémoire utilisée pour la déduplication (index, carte des blocs indexés, nombres de références).
+ * Entrée : le disque
+ * Retour : la taille en octets
+ */
+extern long TailleMemoireDedupDisque(tDisque disque);
+
+/* V5
+ * Choisit quand les sommes de contrôle des blocs chargés (ChargerDisque, ChargerInode) sont vérifiées :
+ * au chargement (par défaut), ou à la première lecture ou modification de chaque bloc (vérification paresseuse,
+ * un bloc corrompu se lit alors comme une erreur de lecture).
+ * Entrée : true pour vérifier à la première lecture
+ * Sortie : aucune
+ */
+extern void VerificationParesseuseDisque(bool paresseuse);
+
+/* V5
+ * Enregistre la somme de contrôle attendue d'un bloc qui vient d'être chargé dans le disque :
+ * elle est vérifiée tout de suite, ou à la première lecture du bloc (voir VerificationParesseuseDisque).
+ * Entrées : le disque, le numéro du bloc, sa somme de contrôle attendue (voir SommeControle)
+ * Sortie : 0 si le bloc est intègre (ou sera vérifié plus tard), -1 s'il est corrompu ou en cas d'erreur
+ */
+extern int VerifierBlocChargeDisque(tDisque disque, tNumeroBloc numero, uint32_t somme);
+
+/* V5
+ * Sauvegarde un disque dans un fichier (préalablement ouvert en écriture et en mode binaire) :
+ * taille des blocs, nombre de blocs, nom du fichier image s'il y en a un, et carte des blocs libres,
+ * puis l'image des blocs, alignée sur 64 Kio (bloc n à n x tailleBloc du début de l'image),
+ * où seuls les blocs utilisés sont écrits (une écriture par suite de blocs contigus, les blocs libres
+ * restent des trous du fichier ; rien pour un fichier image qui garde ses blocs : les blocs modifiés
+ * y sont seulement réécrits), leurs sommes de contrôle (CRC32C),
+ * suivis des nombres de références et de la carte des blocs dédupliqués s'il y en a.
+ * Entrées : le disque, l'identificateur du fichier
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int SauvegarderDisque(tDisque disque, FILE *fichier);
+
+/* V5
+ * Charge un disque sauvegardé par SauvegarderDisque.
+ * L'image des blocs est projetée en mémoire (mmap privé, copie sur écriture) quand le fichier le permet :
+ * ses pages ne sont lues qu'au premier accès et les sommes de contrôle sont vérifiées à la première lecture
+ * de chaque bloc. Sinon les blocs sont lus, et vérifiés au chargement (un bloc corrompu est une erreur)
+ * ou à leur première lecture (voir VerificationParesseuseDisque).
+ * Un disque stocké dans un fichier image rouvre ce fichier sans lire ses blocs : ils sont lus
+ * et vérifiés à la demande (avec la déduplication, les blocs indexés sont relus pour reconstruire l'index).
+ * Entrées : le disque chargé, l'identificateur du fichier (préalablement ouvert en lecture et en mode binaire)
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int ChargerDisque(tDisque *pDisque, FILE *fichier);
+
+#endif
@@ -46,7 +46,7 @@ int main(void) {
     printf("Fichier moyen.txt : %ld octets ecrits\n", res2);
     
     long res3 = EcrireFichierSF(sf, "gros.txt", ORDINAIRE);
-    printf("Fichier gros.txt : %ld octets ecrits (tronque si > 640 octets)\n", res3);
+    printf("Fichier gros.txt : %ld octets ecrits (tronque si > 280192 octets)\n", res3);
 
     printf("\n** 4. SF avec fichiers multi-blocs\n");
     AfficherSF(sf);
@@ -7,10 +7,51 @@
 
 #include "inode.h"
 #include "bloc.h"
+#include "disque.h"
+#include "compression.h"
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 
-// Nombre maximal de blocs dans un inode
-#define NB_BLOCS_DIRECTS 10
+// Limite de la taille maximale d'un fichier. Les blocs sont décrits par des étendues, sans aucun bloc d'indirection :
+// ces deux nombres ne servent qu'à calculer la limite, celle qu'aurait un inode classique à LIMITE_BLOCS_DIRECTS
+// blocs directs puis LIMITE_NIVEAUX_INDIRECTS niveaux d'indirection (simple, double, triple) remplis de numéros
+// de 32 bits ; elle grandit ainsi avec la taille des blocs (voir TailleMaxFichierBlocs)
+#define LIMITE_BLOCS_DIRECTS 10
+#define LIMITE_NIVEAUX_INDIRECTS 3
+
+// Nombre maximal de blocs d'un fichier, quelle que soit la taille des blocs (rangs sur 32 bits dans les étendues)
+#define NB_BLOCS_FICHIER_MAX ((long)UINT32_MAX)
+
+// Nombre d'étendues rangées dans l'inode lui-même (au-delà, elles passent dans un tableau alloué)
+#define NB_ETENDUES_INODE 8
+
+// Nombre de blocs d'une trame compressée d'un seul tenant (mode compressé)
+#define NB_BLOCS_TRAME 8
+
+// Nombre de trames décompressées gardées en cache
+#define NB_TRAMES_CACHE 8
+
+// Âge (en secondes) au-delà duquel une lecture met à jour la date de dernier accès avec DATES_RELATIVES
+#define DELAI_DATES_RELATIVES (24 * 60 * 60)
+
+// Taille de la zone où les petits segments voisins dans le fichier d'une lecture ou d'une écriture vectorisée
+// sont regroupés, pour ne parcourir leurs blocs qu'une fois
+#define TAILLE_REGROUPEMENT 4096
+
+// Une étendue : une suite de blocs consécutifs du fichier stockés dans des blocs consécutifs du disque
+struct sEtendue
+{
+  // Le rang dans le fichier du premier bloc de la suite
+  uint32_t premierBloc;
+  // Le numéro sur le disque de ce premier bloc
+  tNumeroBloc numero;
+  // Le nombre de blocs de la suite
+  uint32_t nbBlocs;
+};
+
+// Taille maximale d'un fichier en ligne (données rangées dans l'inode, à la place des étendues)
+#define TAILLE_DONNEES_INODE ((long)(NB_ETENDUES_INODE * sizeof(struct sEtendue)))
 
 // Définition d'un inode
 struct sInode
@@ -21,37 +62,782 @@ struct sInode
   natureFichier type;
   // La taille en octets du fichier
   long taille;
-  // Les adresses directes vers les blocs (NB_BLOCS_DIRECTS au maximum)
-  tBloc blocDonnees[NB_BLOCS_DIRECTS];
+  // La carte des blocs du fichier : étendues triées par premier bloc, sans chevauchement (un bloc hors
+  // de toute étendue est un trou) ; rangées dans etenduesInode, ou dans un tableau alloué quand elles n'y tiennent plus
+  struct sEtendue *etendues;
+  long nbEtendues;
+  long capaciteEtendues;
+  // Fichier en ligne : ses données sont rangées dans l'inode, à la place des étendues, sans aucun bloc
+  bool enLigne;
+  union {
+    struct sEtendue etenduesInode[NB_ETENDUES_INODE];
+    unsigned char donneesInode[NB_ETENDUES_INODE * sizeof(struct sEtendue)];
+  };
+  // L'étendue du dernier bloc cherché (un accès séquentiel la retrouve sans recherche)
+  long etendueCourante;
+  // Le disque sur lequel sont stockés les blocs
+  tDisque disque;
+  // Mode compressé : les blocs sont regroupés en trames compressées
+  bool compresse;
+  // La taille compressée de chaque trame (0 si la trame est stockée telle quelle, ou au-delà de nbTrames)
+  long *tailleTrame;
+  long nbTrames;
   // Les dates : dernier accès à l'inode, dernière modification du fichier
   // et de l'inode
   time_t dateDerAcces, dateDerModif, dateDerModifInode;
+  // Quand une lecture met-elle à jour la date de dernier accès ?
+  politiqueDates politiqueDates;
+  // Ajouts en fin de fichier (voir AjouterDonneesInode) : le bloc de la fin du fichier gardé en mémoire (NULL si aucun),
+  // sa position dans le fichier, le nombre d'octets du fichier qu'il contient, et s'il reste à écrire sur le disque
+  unsigned char *queue;
+  long debutQueue;
+  long remplissageQueue;
+  bool queueModifiee;
+  // Des ajouts n'ont pas encore mis à jour les dates
+  bool datesAPublier;
 };
 
+// Les ajouts en attente d'un inode sont publiés (écrits sur le disque, taille et dates à jour) avant tout autre accès
+// à ses données ; le bloc de la fin du fichier n'est gardé en mémoire que si garderQueue (définie avec AjouterDonneesInode)
+static int publierAjouts(tInode inode, bool garderQueue);
 
-// fonction auxiliaire pour mettre à jour les dates selon l'accès
-static void mettreAJourDateAccess(tInode inode) {
-  if (inode != NULL) {
-    inode->dateDerAcces = time(NULL);
+
+// Une suite de blocs épinglée pour une lecture sans copie : son adresse, son premier bloc et son nombre de blocs
+struct sEpingle
+{
+  const unsigned char *adresse;
+  tNumeroBloc premier;
+  long nbBlocs;
+};
+
+// Définition des vues d'une lecture sans copie
+struct sVuesInode
+{
+  // Le disque des blocs épinglés
+  tDisque disque;
+  // Les vues, dans l'ordre du fichier
+  struct sVue *vues;
+  long nbVues;
+  long capaciteVues;
+  // Les suites de blocs épinglées
+  struct sEpingle *epingles;
+  long nbEpingles;
+  long capaciteEpingles;
+  // Les octets qui n'ont pas pu être vus en place, recopiés à leur rang dans la lecture (NULL si aucun)
+  unsigned char *copie;
+};
+
+// Nombre initial de vues (et de blocs épinglés) d'une lecture sans copie
+#define NB_VUES_INITIAL 8
+
+// fonction auxiliaire qui retourne la taille des blocs de l'inode (celle de son disque)
+static long tailleBlocInode(tInode inode) {
+  return TailleBlocDisque(inode->disque);
+}
+
+// fonction auxiliaire qui retourne le nombre maximal de blocs d'un fichier pour une taille de bloc
+// (la limite d'un inode classique, voir LIMITE_BLOCS_DIRECTS, dans celle des rangs des étendues)
+static long nbBlocsMaxFichier(long tailleBloc) {
+  long numerosParBloc = tailleBloc / (long)sizeof(tNumeroBloc);
+  long nbBlocs = LIMITE_BLOCS_DIRECTS;
+  long niveau = 1;
+  for (int i = 0; i < LIMITE_NIVEAUX_INDIRECTS && nbBlocs < NB_BLOCS_FICHIER_MAX; i++) {
+    niveau *= numerosParBloc;
+    nbBlocs += niveau;
   }
+  return (nbBlocs < NB_BLOCS_FICHIER_MAX) ? nbBlocs : NB_BLOCS_FICHIER_MAX;
 }
 
-// fonction auxiliaire pour mettre à jour les dates selon modification métadonnées de l'inode
-static void mettreAJourDateModifInode(tInode inode) {
-  if (inode != NULL) {
-    inode->dateDerModifInode = time(NULL);
+/* ---------------------------------------------------------------------------
+ * Carte des blocs : le fichier est décrit par des étendues (premier bloc du fichier, premier bloc
+ * sur le disque, nombre de blocs). Un fichier écrit en séquence n'a que quelques étendues, quelle que
+ * soit sa taille. Un bloc du fichier est retrouvé par recherche dichotomique, et une suite de blocs
+ * consécutifs sur le disque est lue ou écrite d'un seul tenant.
+ * ------------------------------------------------------------------------- */
+
+// fonction auxiliaire qui vide la carte des blocs d'un inode (sans libérer de tableau)
+static void viderCarte(tInode inode) {
+  inode->etendues = inode->etenduesInode;
+  inode->nbEtendues = 0;
+  inode->capaciteEtendues = NB_ETENDUES_INODE;
+  inode->etendueCourante = 0;
+}
+
+// fonction auxiliaire qui libère le tableau alloué des étendues d'un inode ; la carte est ensuite vide
+static void libererCarte(tInode inode) {
+  if (inode->etendues != inode->etenduesInode) {
+    free(inode->etendues);
+  }
+  viderCarte(inode);
+}
+
+// fonction auxiliaire qui retourne le rang dans le fichier du bloc qui suit une étendue
+static long finEtendue(const struct sEtendue *etendue) {
+  return (long)etendue->premierBloc + etendue->nbBlocs;
+}
+
+// fonction auxiliaire qui indique si k est la première étendue qui finit après un bloc du fichier
+static bool etendueDuBloc(tInode inode, long k, long bloc) {
+  return k >= 0 && k <= inode->nbEtendues
+         && (k == 0 || finEtendue(&inode->etendues[k - 1]) <= bloc)
+         && (k == inode->nbEtendues || finEtendue(&inode->etendues[k]) > bloc);
+}
+
+// fonction auxiliaire qui cherche la première étendue qui finit après un bloc du fichier :
+// celle qui le contient, ou la suivante s'il est dans un trou (nbEtendues s'il n'y en a pas)
+// l'étendue du bloc précédemment cherché et sa suivante sont essayées d'abord, puis la recherche est dichotomique
+static long chercherEtendue(tInode inode, long bloc) {
+  long k = inode->etendueCourante;
+  if (!etendueDuBloc(inode, k, bloc) && !etendueDuBloc(inode, ++k, bloc)) {
+    long debut = 0;
+    long fin = inode->nbEtendues;
+    while (debut < fin) {
+      long milieu = (debut + fin) / 2;
+      if (finEtendue(&inode->etendues[milieu]) <= bloc) {
+        debut = milieu + 1;
+      } else {
+        fin = milieu;
+      }
+    }
+    k = debut;
+  }
+  inode->etendueCourante = k;
+  return k;
+}
+
+// fonction auxiliaire qui retourne le numéro sur le disque d'un bloc du fichier (BLOC_NUL pour un trou) ;
+// si suite n'est pas NULL, y range le nombre de blocs à partir de celui-ci dans la même situation :
+// blocs consécutifs sur le disque, ou longueur du trou (LONG_MAX après la dernière étendue)
+static tNumeroBloc blocFichier(tInode inode, long bloc, long *suite) {
+  long k = chercherEtendue(inode, bloc);
+  if (k == inode->nbEtendues || inode->etendues[k].premierBloc > bloc) {
+    if (suite != NULL) {
+      *suite = (k == inode->nbEtendues) ? LONG_MAX : inode->etendues[k].premierBloc - bloc;
+    }
+    return BLOC_NUL;
+  }
+
+  struct sEtendue *etendue = &inode->etendues[k];
+  if (suite != NULL) {
+    *suite = (long)etendue->premierBloc + etendue->nbBlocs - bloc;
+  }
+  return etendue->numero + (tNumeroBloc)(bloc - etendue->premierBloc);
+}
+
+// fonction auxiliaire qui agrandit la carte pour qu'elle puisse recevoir au moins nbEtendues étendues
+// (0 si ok, -1 si problème d'allocation)
+static int reserverEtendues(tInode inode, long nbEtendues) {
+  if (nbEtendues > inode->capaciteEtendues) {
+    long capacite = (2 * inode->capaciteEtendues > nbEtendues) ? 2 * inode->capaciteEtendues : nbEtendues;
+    struct sEtendue *etendues;
+    if (inode->etendues == inode->etenduesInode) {
+      etendues = malloc(capacite * sizeof(struct sEtendue));
+      if (etendues != NULL) {
+        memcpy(etendues, inode->etenduesInode, sizeof(inode->etenduesInode));
+      }
+    } else {
+      etendues = realloc(inode->etendues, capacite * sizeof(struct sEtendue));
+    }
+    if (etendues == NULL) {
+      return -1;
+    }
+    inode->etendues = etendues;
+    inode->capaciteEtendues = capacite;
+  }
+  return 0;
+}
+
+// fonction auxiliaire qui insère une étendue à la position k de la carte (0 si ok, -1 si problème d'allocation)
+static int insererEtendue(tInode inode, long k, struct sEtendue etendue) {
+  if (reserverEtendues(inode, inode->nbEtendues + 1) != 0) {
+    return -1;
+  }
+
+  memmove(&inode->etendues[k + 1], &inode->etendues[k], (inode->nbEtendues - k) * sizeof(struct sEtendue));
+  inode->etendues[k] = etendue;
+  inode->nbEtendues++;
+  return 0;
+}
+
+// fonction auxiliaire qui retire l'étendue k de la carte
+static void retirerEtendue(tInode inode, long k) {
+  memmove(&inode->etendues[k], &inode->etendues[k + 1], (inode->nbEtendues - k - 1) * sizeof(struct sEtendue));
+  inode->nbEtendues--;
+}
+
+// fonction auxiliaire qui retire un bloc de la carte (il devient un trou, le bloc du disque n'est pas libéré) ;
+// retourne 0 si ok, -1 si problème d'allocation (étendue coupée en deux)
+static int retirerBlocCarte(tInode inode, long bloc) {
+  long k = chercherEtendue(inode, bloc);
+  if (k == inode->nbEtendues || inode->etendues[k].premierBloc > bloc) {
+    return 0; // déjà un trou
+  }
+
+  struct sEtendue *etendue = &inode->etendues[k];
+  long avant = bloc - etendue->premierBloc;
+  long apres = etendue->nbBlocs - avant - 1;
+  if (avant == 0 && apres == 0) {
+    retirerEtendue(inode, k);
+  } else if (avant == 0) {
+    etendue->premierBloc++;
+    etendue->numero++;
+    etendue->nbBlocs--;
+  } else if (apres == 0) {
+    etendue->nbBlocs--;
+  } else {
+    struct sEtendue fin = { (uint32_t)(bloc + 1), etendue->numero + (tNumeroBloc)(avant + 1), (uint32_t)apres };
+    if (insererEtendue(inode, k + 1, fin) != 0) {
+      return -1;
+    }
+    inode->etendues[k].nbBlocs = avant;
+  }
+  return 0;
+}
+
+// fonction auxiliaire qui place un bloc du disque à un rang du fichier, à la place de son bloc actuel
+// (qui n'est pas libéré), ou le retire (numero BLOC_NUL) ; l'étendue est fusionnée avec ses voisines
+// quand les blocs se suivent aussi sur le disque ; retourne 0 si ok, -1 si problème d'allocation
+static int changerBlocFichier(tInode inode, long bloc, tNumeroBloc numero) {
+  if (blocFichier(inode, bloc, NULL) == numero) {
+    return 0;
+  }
+  if (retirerBlocCarte(inode, bloc) != 0) {
+    return -1;
+  }
+  if (numero == BLOC_NUL) {
+    return 0;
+  }
+
+  // le bloc est maintenant dans un trou, entre les étendues k - 1 et k
+  long k = chercherEtendue(inode, bloc);
+  struct sEtendue *precedente = (k > 0) ? &inode->etendues[k - 1] : NULL;
+  struct sEtendue *suivante = (k < inode->nbEtendues) ? &inode->etendues[k] : NULL;
+  bool avecPrecedente = precedente != NULL && (long)precedente->premierBloc + precedente->nbBlocs == bloc
+                        && precedente->numero + precedente->nbBlocs == numero;
+  bool avecSuivante = suivante != NULL && (long)suivante->premierBloc == bloc + 1 && suivante->numero == numero + 1;
+
+  if (avecPrecedente && avecSuivante) {
+    precedente->nbBlocs += 1 + suivante->nbBlocs;
+    retirerEtendue(inode, k);
+  } else if (avecPrecedente) {
+    precedente->nbBlocs++;
+  } else if (avecSuivante) {
+    suivante->premierBloc--;
+    suivante->numero--;
+    suivante->nbBlocs++;
+  } else {
+    struct sEtendue etendue = { (uint32_t)bloc, numero, 1 };
+    return insererEtendue(inode, k, etendue);
+  }
+  return 0;
+}
+
+// fonction auxiliaire qui rend au disque les blocs de chaque étendue (un bloc partagé n'est libéré
+// qu'à sa dernière référence) ; la carte est ensuite vide
+static void libererBlocs(tInode inode) {
+  for (long k = 0; k < inode->nbEtendues; k++) {
+    struct sEtendue *etendue = &inode->etendues[k];
+    for (uint32_t i = 0; i < etendue->nbBlocs; i++) {
+      LibererBlocDisque(inode->disque, etendue->numero + i);
+    }
+  }
+  libererCarte(inode);
+}
+
+/* ---------------------------------------------------------------------------
+ * Mode compressé : les blocs d'un inode sont regroupés en trames de NB_BLOCS_TRAME blocs.
+ * Une trame est compressée d'un seul tenant, et les données compressées occupent les premiers
+ * emplacements de blocs de la trame (les autres restent à BLOC_NUL). Une trame qui ne gagne
+ * pas au moins un bloc est stockée telle quelle (tailleTrame à 0).
+ * Les dernières trames décompressées sont gardées dans un petit cache.
+ * ------------------------------------------------------------------------- */
+
+// Une trame décompressée du cache (inode à NULL pour une case vide)
+struct sTrameCache
+{
+  tInode inode;
+  long trame;
+  // Les données décompressées (NB_BLOCS_TRAME blocs) et la taille allouée
+  unsigned char *donnees;
+  long capacite;
+  // Date de dernière utilisation (pour choisir la case à remplacer)
+  unsigned long dernierUsage;
+};
+
+// Le cache des trames décompressées (partagé par tous les inodes)
+static struct sTrameCache cacheTrames[NB_TRAMES_CACHE];
+static unsigned long horlogeCache = 0;
+
+// fonction auxiliaire qui retourne la taille des données d'une trame (d'après la taille du fichier)
+static long tailleUtileTrame(tInode inode, long trame) {
+  long tailleTrameMax = NB_BLOCS_TRAME * tailleBlocInode(inode);
+  long utile = inode->taille - trame * tailleTrameMax;
+  if (utile < 0) {
+    return 0;
+  }
+  return (utile > tailleTrameMax) ? tailleTrameMax : utile;
+}
+
+// fonction auxiliaire qui retourne la taille compressée d'une trame (0 si elle est stockée telle quelle)
+static long tailleCompresseeTrame(tInode inode, long trame) {
+  return (trame < inode->nbTrames) ? inode->tailleTrame[trame] : 0;
+}
+
+// fonction auxiliaire qui agrandit le tableau des tailles compressées pour qu'il couvre au moins nbTrames trames
+// (les trames ajoutées sont stockées telles quelles) ; retourne 0 si ok, -1 si problème d'allocation
+static int reserverTrames(tInode inode, long nbTrames) {
+  if (nbTrames <= inode->nbTrames) {
+    return 0;
+  }
+  long capacite = (2 * inode->nbTrames > nbTrames) ? 2 * inode->nbTrames : nbTrames;
+  long *tailles = realloc(inode->tailleTrame, capacite * sizeof(long));
+  if (tailles == NULL) {
+    return -1;
+  }
+  memset(tailles + inode->nbTrames, 0, (capacite - inode->nbTrames) * sizeof(long));
+  inode->tailleTrame = tailles;
+  inode->nbTrames = capacite;
+  return 0;
+}
+
+// fonction auxiliaire qui retire du cache toutes les trames d'un inode
+static void oublierTramesCache(tInode inode) {
+  for (int i = 0; i < NB_TRAMES_CACHE; i++) {
+    if (cacheTrames[i].inode == inode) {
+      cacheTrames[i].inode = NULL;
+    }
+  }
+}
+
+// fonction auxiliaire qui retourne la case du cache d'une trame, NULL si elle n'y est pas
+static struct sTrameCache *chercherTrameCache(tInode inode, long trame) {
+  for (int i = 0; i < NB_TRAMES_CACHE; i++) {
+    if (cacheTrames[i].inode == inode && cacheTrames[i].trame == trame) {
+      cacheTrames[i].dernierUsage = ++horlogeCache;
+      return &cacheTrames[i];
+    }
+  }
+  return NULL;
+}
+
+// fonction auxiliaire qui réserve une case du cache pour une trame (la moins récemment utilisée),
+// retourne NULL en cas de problème d'allocation
+static struct sTrameCache *reserverTrameCache(tInode inode, long trame) {
+  struct sTrameCache *caseCache = &cacheTrames[0];
+  for (int i = 1; i < NB_TRAMES_CACHE; i++) {
+    if (cacheTrames[i].dernierUsage < caseCache->dernierUsage) {
+      caseCache = &cacheTrames[i];
+    }
+  }
+
+  // la zone de la case doit contenir une trame de cet inode
+  long tailleTrameMax = NB_BLOCS_TRAME * tailleBlocInode(inode);
+  if (caseCache->capacite < tailleTrameMax) {
+    unsigned char *donnees = realloc(caseCache->donnees, tailleTrameMax);
+    if (donnees == NULL) {
+      return NULL;
+    }
+    caseCache->donnees = donnees;
+    caseCache->capacite = tailleTrameMax;
+  }
+
+  caseCache->inode = inode;
+  caseCache->trame = trame;
+  caseCache->dernierUsage = ++horlogeCache;
+  return caseCache;
+}
+
+// fonction auxiliaire qui retourne les données décompressées d'une trame (NB_BLOCS_TRAME blocs,
+// à zéro après la fin du fichier), NULL en cas d'erreur
+// la zone retournée est celle du cache : valable jusqu'au prochain accès à une autre trame
+static unsigned char *trameDecompressee(tInode inode, long trame) {
+  struct sTrameCache *caseCache = chercherTrameCache(inode, trame);
+  if (caseCache != NULL) {
+    return caseCache->donnees;
+  }
+
+  caseCache = reserverTrameCache(inode, trame);
+  if (caseCache == NULL) {
+    return NULL;
+  }
+
+  long tailleBloc = tailleBlocInode(inode);
+  long tailleTrameMax = NB_BLOCS_TRAME * tailleBloc;
+  long premierBloc = trame * NB_BLOCS_TRAME;
+  memset(caseCache->donnees, 0, tailleTrameMax);
+
+  if (tailleCompresseeTrame(inode, trame) == 0) {
+    // trame stockée telle quelle (les blocs absents se lisent à zéro)
+    for (int j = 0; j < NB_BLOCS_TRAME; j++) {
+      tNumeroBloc numero = blocFichier(inode, premierBloc + j, NULL);
+      if (numero != BLOC_NUL
+          && LireBlocDisque(inode->disque, numero, 0, caseCache->donnees + j * tailleBloc, tailleBloc) == 0) {
+        caseCache->inode = NULL; // bloc illisible (corrompu)
+        return NULL;
+      }
+    }
+    return caseCache->donnees;
+  }
+
+  // trame compressée : on rassemble les données compressées puis on les décompresse
+  long tailleCompressee = tailleCompresseeTrame(inode, trame);
+  unsigned char *compresse = malloc(tailleCompressee);
+  if (compresse == NULL) {
+    caseCache->inode = NULL;
+    return NULL;
+  }
+  long tailleDecompressee = -1;
+  long lu = 0;
+  for (long j = 0; lu < tailleCompressee; j++) {
+    long morceau = LireBlocDisque(inode->disque, blocFichier(inode, premierBloc + j, NULL), 0, compresse + lu, tailleCompressee - lu);
+    if (morceau == 0) {
+      break; // bloc illisible (corrompu)
+    }
+    lu += morceau;
   }
+  if (lu == tailleCompressee) {
+    tailleDecompressee = DecompresserLZ(compresse, tailleCompressee, caseCache->donnees, tailleTrameMax);
+  }
+  free(compresse);
+
+  if (tailleDecompressee < 0) {
+    fprintf(stderr, "trameDecompressee : trame %ld corrompue\n", trame);
+    caseCache->inode = NULL;
+    return NULL;
+  }
+
+  return caseCache->donnees;
+}
+
+// fonction auxiliaire qui stocke une trame (NB_BLOCS_TRAME blocs de données) :
+// compressée si elle gagne au moins un bloc, telle quelle sinon ; retourne 0 si ok, -1 sinon
+static int stockerTrame(tInode inode, long trame, unsigned char *donnees) {
+  long tailleBloc = tailleBlocInode(inode);
+  long utile = tailleUtileTrame(inode, trame);
+  long premierBloc = trame * NB_BLOCS_TRAME;
+
+  // on essaie de compresser (il faut gagner au moins un bloc)
+  unsigned char *compresse = NULL;
+  long tailleCompressee = -1;
+  if (utile > tailleBloc && reserverTrames(inode, trame + 1) == 0) {
+    compresse = malloc(utile - tailleBloc);
+    if (compresse != NULL) {
+      tailleCompressee = CompresserLZ(donnees, utile, compresse, utile - tailleBloc);
+    }
+  }
+  const unsigned char *aStocker = (tailleCompressee > 0) ? compresse : donnees;
+  long tailleAStocker = (tailleCompressee > 0) ? tailleCompressee : utile;
+
+  // les nouveaux blocs sont d'abord alloués et écrits, contigus si possible, à côté des anciens :
+  // en cas d'échec, la trame garde son ancien contenu
+  tNumeroBloc anciens[NB_BLOCS_TRAME];
+  tNumeroBloc nouveaux[NB_BLOCS_TRAME];
+  for (int j = 0; j < NB_BLOCS_TRAME; j++) {
+    anciens[j] = blocFichier(inode, premierBloc + j, NULL);
+    nouveaux[j] = BLOC_NUL;
+  }
+  tNumeroBloc precedent = (premierBloc > 0) ? blocFichier(inode, premierBloc - 1, NULL) : BLOC_NUL;
+  tNumeroBloc aPartirDe = (precedent != BLOC_NUL) ? precedent + 1 : BLOC_NUL;
+  int resultat = 0;
+  for (long ecrit = 0, j = 0; ecrit < tailleAStocker; ecrit += tailleBloc, j++) {
+    long morceau = (tailleAStocker - ecrit < tailleBloc) ? tailleAStocker - ecrit : tailleBloc;
+    tNumeroBloc numero;
+    if (morceau == tailleBloc) {
+      numero = AllouerBlocContenuDisque(inode->disque, aPartirDe, aStocker + ecrit);
+    } else {
+      numero = AllouerBlocDisque(inode->disque, aPartirDe);
+      if (numero != BLOC_NUL) {
+        EffacerBlocDisque(inode->disque, numero);
+        EcrireBlocDisque(inode->disque, numero, 0, (unsigned char *)aStocker + ecrit, morceau);
+      }
+    }
+    if (numero == BLOC_NUL) {
+      fprintf(stderr, "stockerTrame : impossible de créer un bloc de la trame %ld\n", trame);
+      resultat = -1;
+      break;
+    }
+    nouveaux[j] = numero;
+    aPartirDe = numero + 1;
+  }
+  free(compresse);
+
+  // puis ils prennent la place des anciens dans la carte : chaque changement ajoute au plus deux étendues,
+  // la place est réservée avant pour qu'aucun ne puisse échouer à moitié
+  if (resultat == 0 && reserverEtendues(inode, inode->nbEtendues + 2 * NB_BLOCS_TRAME) != 0) {
+    fprintf(stderr, "stockerTrame : erreur allocation\n");
+    resultat = -1;
+  }
+  int nbChanges = 0;
+  while (resultat == 0 && nbChanges < NB_BLOCS_TRAME) {
+    if (changerBlocFichier(inode, premierBloc + nbChanges, nouveaux[nbChanges]) != 0) {
+      fprintf(stderr, "stockerTrame : erreur allocation\n");
+      resultat = -1;
+      break;
+    }
+    nbChanges++;
+  }
+
+  // échec : les anciens blocs reprennent leur place et les nouveaux sont rendus
+  if (resultat != 0) {
+    for (int j = 0; j < nbChanges; j++) {
+      changerBlocFichier(inode, premierBloc + j, anciens[j]);
+    }
+    for (int j = 0; j < NB_BLOCS_TRAME; j++) {
+      if (nouveaux[j] != BLOC_NUL) {
+        LibererBlocDisque(inode->disque, nouveaux[j]);
+      }
+    }
+  } else {
+    // succès : les anciens blocs sont rendus (un bloc partagé n'est libéré qu'à sa dernière référence)
+    if (trame < inode->nbTrames) {
+      inode->tailleTrame[trame] = (tailleCompressee > 0) ? tailleCompressee : 0;
+    }
+    for (int j = 0; j < NB_BLOCS_TRAME; j++) {
+      if (anciens[j] != BLOC_NUL) {
+        LibererBlocDisque(inode->disque, anciens[j]);
+      }
+    }
+  }
+
+  // la trame en cache est la nouvelle version
+  struct sTrameCache *caseCache = chercherTrameCache(inode, trame);
+  if (caseCache == NULL && resultat == 0) {
+    caseCache = reserverTrameCache(inode, trame);
+  }
+  if (caseCache != NULL) {
+    if (resultat == 0) {
+      memcpy(caseCache->donnees, donnees, NB_BLOCS_TRAME * tailleBloc);
+    } else {
+      caseCache->inode = NULL;
+    }
+  }
+
+  return resultat;
+}
+
+// fonction auxiliaire qui copie le contenu d'un bloc du fichier (quel que soit le mode de stockage),
+// retourne false si le bloc n'existe pas ou est illisible (le contenu est alors à zéro)
+static bool lireBlocFichier(tInode inode, long numeroBloc, unsigned char *contenu) {
+  long tailleBloc = tailleBlocInode(inode);
+
+  // fichier en ligne : la partie de ses données qui correspond au bloc
+  if (inode->enLigne) {
+    long debut = numeroBloc * tailleBloc;
+    memset(contenu, 0, tailleBloc);
+    if (debut >= inode->taille) {
+      return false;
+    }
+    long morceau = (inode->taille - debut < tailleBloc) ? inode->taille - debut : tailleBloc;
+    memcpy(contenu, inode->donneesInode + debut, morceau);
+    return true;
+  }
+
+  if (inode->compresse) {
+    unsigned char *trame = trameDecompressee(inode, numeroBloc / NB_BLOCS_TRAME);
+    if (trame == NULL) {
+      memset(contenu, 0, tailleBloc);
+      return false;
+    }
+    memcpy(contenu, trame + (numeroBloc % NB_BLOCS_TRAME) * tailleBloc, tailleBloc);
+    return true;
+  }
+
+  // bloc absent ou illisible (corrompu)
+  tNumeroBloc numero = blocFichier(inode, numeroBloc, NULL);
+  if (numero == BLOC_NUL || LireBlocDisque(inode->disque, numero, 0, contenu, tailleBloc) == 0) {
+    memset(contenu, 0, tailleBloc);
+    return false;
+  }
+  return true;
+}
+
+// fonction auxiliaire qui indique si un bloc du fichier a des données stockées (false pour un trou) ;
+// dans une trame compressée, tous les blocs utiles de la trame sont stockés ensemble, et dans un fichier
+// en ligne, tous ses blocs
+static bool blocFichierAlloue(tInode inode, long numeroBloc) {
+  if (inode->enLigne) {
+    return numeroBloc * tailleBlocInode(inode) < inode->taille;
+  }
+  if (inode->compresse) {
+    if (tailleCompresseeTrame(inode, numeroBloc / NB_BLOCS_TRAME) > 0) {
+      return true;
+    }
+  }
+  return blocFichier(inode, numeroBloc, NULL) != BLOC_NUL;
+}
+
+// fonction auxiliaire : lecture dans un inode compressé (taille et décalage déjà vérifiés)
+static long lireDonneesCompressees(tInode inode, unsigned char *contenu, long taille, long decalage) {
+  long tailleTrameMax = NB_BLOCS_TRAME * tailleBlocInode(inode);
+  long totalOctetsLus = 0;
+
+  while (totalOctetsLus < taille) {
+    long position = decalage + totalOctetsLus;
+    long trame = position / tailleTrameMax;
+    long decalageDansTrame = position % tailleTrameMax;
+
+    unsigned char *donnees = trameDecompressee(inode, trame);
+    if (donnees == NULL) {
+      break;
+    }
+
+    long morceau = tailleTrameMax - decalageDansTrame;
+    if (morceau > taille - totalOctetsLus) {
+      morceau = taille - totalOctetsLus;
+    }
+    CopierOctets(contenu + totalOctetsLus, donnees + decalageDansTrame, morceau);
+    totalOctetsLus += morceau;
+  }
+
+  return totalOctetsLus;
+}
+
+// fonction auxiliaire : écriture dans un inode compressé (taille et décalage déjà vérifiés),
+// chaque trame touchée est décompressée, modifiée puis recompressée
+static long ecrireDonneesCompressees(tInode inode, unsigned char *contenu, long taille, long decalage) {
+  long tailleTrameMax = NB_BLOCS_TRAME * tailleBlocInode(inode);
+  unsigned char *tampon = malloc(tailleTrameMax);
+  if (tampon == NULL) {
+    fprintf(stderr, "EcrireDonneesInode : erreur allocation\n");
+    return -1;
+  }
+
+  long totalOctetsEcrits = 0;
+  while (totalOctetsEcrits < taille) {
+    long position = decalage + totalOctetsEcrits;
+    long trame = position / tailleTrameMax;
+    long decalageDansTrame = position % tailleTrameMax;
+
+    long morceau = tailleTrameMax - decalageDansTrame;
+    if (morceau > taille - totalOctetsEcrits) {
+      morceau = taille - totalOctetsEcrits;
+    }
+
+    // contenu actuel de la trame (inutile si elle est entièrement réécrite)
+    if (morceau < tailleTrameMax) {
+      unsigned char *donnees = trameDecompressee(inode, trame);
+      if (donnees == NULL) {
+        break;
+      }
+      memcpy(tampon, donnees, tailleTrameMax);
+    }
+    CopierOctets(tampon + decalageDansTrame, contenu + totalOctetsEcrits, morceau);
+
+    // la taille du fichier doit être à jour avant de stocker la trame (elle est rétablie si la trame n'est pas stockée)
+    long tailleAvant = inode->taille;
+    if (position + morceau > inode->taille) {
+      inode->taille = position + morceau;
+    }
+    if (stockerTrame(inode, trame, tampon) != 0) {
+      inode->taille = tailleAvant;
+      break;
+    }
+    totalOctetsEcrits += morceau;
+  }
+  free(tampon);
+
+  return totalOctetsEcrits;
+}
+
+/* ---------------------------------------------------------------------------
+ * Fichiers en ligne : un fichier d'au plus TAILLE_DONNEES_INODE octets est rangé dans l'inode lui-même,
+ * à la place de ses étendues, sans aucun bloc sur le disque. Il passe en blocs dès qu'une écriture
+ * le fait dépasser cette taille.
+ * ------------------------------------------------------------------------- */
+
+// fonction auxiliaire : écriture dans un inode en ligne (decalage + taille <= TAILLE_DONNEES_INODE),
+// l'écart éventuel entre la fin du fichier et le décalage se lit à zéro
+static long ecrireEnLigne(tInode inode, const unsigned char *contenu, long taille, long decalage) {
+  if (decalage > inode->taille) {
+    memset(inode->donneesInode + inode->taille, 0, decalage - inode->taille);
+  }
+  memcpy(inode->donneesInode + decalage, contenu, taille);
+  if (decalage + taille > inode->taille) {
+    inode->taille = decalage + taille;
+  }
+  return taille;
+}
+
+// fonction auxiliaire qui range dans des blocs les données d'un inode en ligne ;
+// retourne 0 si ok, -1 en cas de problème (l'inode reste alors en ligne, inchangé)
+static int sortirDonneesEnLigne(tInode inode) {
+  unsigned char donnees[TAILLE_DONNEES_INODE];
+  long taille = inode->taille;
+  memcpy(donnees, inode->donneesInode, taille);
+
+  // la zone des données redevient celle des étendues
+  inode->enLigne = false;
+  viderCarte(inode);
+  inode->taille = 0;
+
+  // les données sont écrites dans la première trame, ou dans des blocs consécutifs
+  // (sans passer par EcrireDonneesInode, qui publierait les ajouts en cours d'écriture, voir AjouterDonneesInode)
+  long octetsEcrits = 0;
+  if (inode->compresse && taille > 0) {
+    octetsEcrits = ecrireDonneesCompressees(inode, donnees, taille, 0);
+  }
+  long tailleBloc = tailleBlocInode(inode);
+  tNumeroBloc precedent = BLOC_NUL;
+  for (long bloc = 0; !inode->compresse && octetsEcrits < taille; bloc++) {
+    long morceau = (taille - octetsEcrits < tailleBloc) ? taille - octetsEcrits : tailleBloc;
+    tNumeroBloc numero = AllouerBlocDisque(inode->disque, (precedent != BLOC_NUL) ? precedent + 1 : BLOC_NUL);
+    if (numero != BLOC_NUL && changerBlocFichier(inode, bloc, numero) != 0) {
+      LibererBlocDisque(inode->disque, numero);
+      numero = BLOC_NUL;
+    }
+    if (numero == BLOC_NUL) {
+      break;
+    }
+    EffacerBlocDisque(inode->disque, numero);
+    if (EcrireBlocDisque(inode->disque, numero, 0, donnees + octetsEcrits, morceau) != morceau) {
+      break;
+    }
+    octetsEcrits += morceau;
+    precedent = numero;
+  }
+  if (octetsEcrits == taille) {
+    inode->taille = taille;
+    return 0;
+  }
+
+  // échec : les blocs déjà écrits sont rendus et les données reviennent dans l'inode
+  libererBlocs(inode);
+  if (inode->nbTrames > 0) {
+    memset(inode->tailleTrame, 0, inode->nbTrames * sizeof(long));
+  }
+  oublierTramesCache(inode);
+  inode->enLigne = true;
+  memcpy(inode->donneesInode, donnees, taille);
+  inode->taille = taille;
+  return -1;
+}
+
+// fonction auxiliaire pour mettre à jour les dates selon l'accès, suivant la politique de l'inode
+static void mettreAJourDateAccess(tInode inode) {
+  if (inode == NULL || inode->politiqueDates == SANS_DATE_ACCES) {
+    return;
+  }
+  time_t maintenant = time(NULL);
+
+  // relatime : seulement si l'accès précède la dernière modification ou date de plus d'un jour
+  if (inode->politiqueDates == DATES_RELATIVES
+      && inode->dateDerAcces > inode->dateDerModif && inode->dateDerAcces > inode->dateDerModifInode
+      && maintenant - inode->dateDerAcces < DELAI_DATES_RELATIVES) {
+    return;
+  }
+  inode->dateDerAcces = maintenant;
 }
 
 // fonction auxiliaire pour mettre à jour les dates selon modification du contenu du fichier
+// (et donc de l'inode), avec une seule lecture de l'horloge (time() : à la seconde, sans appel système sous Linux)
 static void mettreAJourDateModifContenu(tInode inode) {
   if (inode != NULL) {
-    inode->dateDerModif = time(NULL);
-    inode->dateDerModifInode = time(NULL);
+    time_t maintenant = time(NULL);
+    inode->dateDerModif = maintenant;
+    inode->dateDerModifInode = maintenant;
   }
 }
 
-
 /* V1
  * Crée et retourne un inode.
  * Entrées : numéro de l'inode et le type de fichier qui y est associé
@@ -72,16 +858,35 @@ tInode CreerInode(int numInode, natureFichier type) {
   nouveau->type = type;
   nouveau->taille = 0;
 
-  // initialisation des adresses directes vers les blocs à NULL
-  for (int i = 0; i < NB_BLOCS_DIRECTS; i++) {
-    nouveau->blocDonnees[i] = NULL;
+  // tant qu'il n'est pas associé à un SF, l'inode utilise le disque par défaut
+  nouveau->disque = DisqueParDefaut();
+  if (nouveau->disque == NULL) {
+    fprintf(stderr, "CreerInode : probleme creation");
+    free(nouveau);
+    return NULL;
   }
 
+  // pas encore de bloc : la carte des blocs est vide, et le fichier (vide) est en ligne
+  viderCarte(nouveau);
+  nouveau->enLigne = true;
+
+  // pas de compression par défaut
+  nouveau->compresse = false;
+  nouveau->tailleTrame = NULL;
+  nouveau->nbTrames = 0;
+
   // initialisation des dates
   time_t maintenant = time(NULL); // obetnir heure actuelle
   nouveau->dateDerAcces = maintenant;
   nouveau->dateDerModif = maintenant;
   nouveau->dateDerModifInode = maintenant;
+  nouveau->politiqueDates = DATES_STRICTES;
+
+  // pas d'ajout en attente
+  nouveau->queue = NULL;
+  nouveau->remplissageQueue = 0;
+  nouveau->queueModifiee = false;
+  nouveau->datesAPublier = false;
 
   return nouveau; // retourne le nouveau inode
 }
@@ -93,12 +898,13 @@ tInode CreerInode(int numInode, natureFichier type) {
  */
 void DetruireInode(tInode *pInode) {
   if (pInode != NULL && *pInode != NULL) {
-    // libère les adresses directes vers les blocs
-    for (int i = 0; i < NB_BLOCS_DIRECTS; i++) {
-      if ((*pInode)->blocDonnees[i] != NULL) {
-        DetruireBloc(&(*pInode)->blocDonnees[i]);
-      }
-    }
+    // rend ses blocs au disque (aucun pour un fichier en ligne)
+    libererBlocs(*pInode);
+    free((*pInode)->tailleTrame);
+    free((*pInode)->queue); // les ajouts en attente disparaissent avec le fichier
+
+    // ses trames décompressées ne doivent plus être trouvées dans le cache
+    oublierTramesCache(*pInode);
 
     free(*pInode); // libère la mémoire allouée
     *pInode = NULL; // positionne inode à NULL
@@ -168,6 +974,10 @@ long Taille(tInode inode) {
     return 0;
   }
 
+  // avec les ajouts en attente (voir AjouterDonneesInode)
+  if (inode->queueModifiee && inode->debutQueue + inode->remplissageQueue > inode->taille) {
+    return inode->debutQueue + inode->remplissageQueue;
+  }
   return inode->taille;
 }
 
@@ -196,10 +1006,10 @@ void AfficherInode(tInode inode) {
     return;
   }
 
-  //mettre a jour date d'accès
-  mettreAJourDateAccess(inode);
+  // les ajouts en attente sont d'abord écrits (voir AjouterDonneesInode)
+  publierAjouts(inode, true);
 
-  // affichage du contenu de l'inode
+  // affichage du contenu de l'inode (comme stat, il ne change pas la date d'accès)
   printf("--------Inode----[%u]:\n", inode->numero);
   printf("type : ");
   switch (inode->type) { //selon le type de fichier associé à l'inode
@@ -232,23 +1042,32 @@ void AfficherInode(tInode inode) {
     printf("  Données :\n");
 
     // calculer le nombre de blocs utilisés par le fichier
-    int nbBlocsUtilises = (inode->taille + TAILLE_BLOC -1) / TAILLE_BLOC;
-
-    // verif de pas dépasser le nb max de blocs autorisés
-    if (nbBlocsUtilises > NB_BLOCS_DIRECTS) {
-      nbBlocsUtilises = NB_BLOCS_DIRECTS;
+    long tailleBloc = tailleBlocInode(inode);
+    long nbBlocsUtilises = (inode->taille + tailleBloc -1) / tailleBloc;
+
+    // zone où recopier chaque bloc (décompressé si besoin)
+    unsigned char *bloc = malloc(tailleBloc);
+    if (bloc == NULL) {
+      fprintf(stderr, "AfficherInode : erreur allocation\n");
+      return;
     }
 
     // parcours chaque bloc utilisé
-    for (int i = 0; i < nbBlocsUtilises; i++) {
+    for (long i = 0; i < nbBlocsUtilises; i++) {
       // verif que le bloc existe dans l'inode
-      if (inode->blocDonnees[i] != NULL) {
-        printf("  Bloc %d : ", i);
+      if (lireBlocFichier(inode, i, bloc)) {
+        printf("  Bloc %ld : ", i);
+
+        // nombre d'octets du fichier dans ce bloc (le reste du bloc n'est pas initialisé)
+        long octetsDansBloc = inode->taille - i * tailleBloc;
+        if (octetsDansBloc > tailleBloc) {
+          octetsDansBloc = tailleBloc;
+        }
 
         // parcours chaque octet du bloc
-        for (int j = 0; j < TAILLE_BLOC; j++) {
+        for (int j = 0; j < octetsDansBloc; j++) {
           // récupère l'octet à la position j dans bloc i
-          unsigned char caractereActuel = inode->blocDonnees[i][j];
+          unsigned char caractereActuel = bloc[j];
 
           // si le caractère est affichable (code ASCII entre 32 et 126)
           if (caractereActuel >= 32 && caractereActuel <= 126) {
@@ -267,6 +1086,7 @@ void AfficherInode(tInode inode) {
         printf("\n");
       }
     }
+    free(bloc);
 
     /* ANCIEN CODE V1
     // creer un espace temporaire en mémoire pour stocker les données (+1 octet pour le caractère de fin de chaîne '\0)
@@ -289,7 +1109,7 @@ void AfficherInode(tInode inode) {
 
 /* V1
  * Copie à l'adresse contenu les taille octets stockés dans un inode.
- * Si taille est supérieure à la taille d’un bloc, seuls les TAILLE_BLOC premiers octets doivent être copiés.
+ * Si taille est supérieure à la taille d’un bloc, seuls les premiers octets tenant dans un bloc doivent être copiés.
  * Entrées : l'inode, l'adresse de la zone où recopier et la taille en octets de l'inode
  * Retour : le nombre d'octets effectivement lus dans l'inode ou -1 en cas d'erreur
  */
@@ -299,31 +1119,46 @@ long LireDonneesInode1bloc(tInode inode, unsigned char *contenu, long taille) {
     return -1; // return -1 en cas d'erreur
   }
 
+  // les ajouts en attente sont d'abord écrits (voir AjouterDonneesInode)
+  publierAjouts(inode, true);
+
   // verifie que l'inode contient des données
   if (Taille(inode) == 0) {
     return 0; // si aucune donnée alors return 0
   }
 
-  // on prend le plus petit entre taille demandé par l'utilisation et TAILLE_BLOC (64)
-  if (taille > TAILLE_BLOC) {
-    taille = TAILLE_BLOC;
+  // on prend le plus petit entre taille demandé par l'utilisation et la taille d'un bloc
+  if (taille > tailleBlocInode(inode)) {
+    taille = tailleBlocInode(inode);
   }
   // vérifie que ça dépasse pas la taille max des données qui existent
   if (taille > inode->taille) {
     taille = inode->taille;
   }
 
-  // on cherche le premier bloc de l'inode qui contient des données
-  tBloc blocSource = NULL;
-  for (int i = 0; i < 10; i++) {
-    if (inode->blocDonnees[i] != NULL) {
-      blocSource = inode->blocDonnees[i];
-      break;
-    }
+  // fichier en ligne : les données sont dans l'inode
+  if (inode->enLigne) {
+    memcpy(contenu, inode->donneesInode, taille);
+    mettreAJourDateAccess(inode);
+    return taille;
+  }
+
+  // inode compressé : le premier bloc est dans la première trame
+  if (inode->compresse) {
+    long octetsLus = lireDonneesCompressees(inode, contenu, taille, 0);
+    mettreAJourDateAccess(inode);
+    return octetsLus;
   }
 
-  // on utilise la fonction LireContenuBloc pour faire la copie
-  long octetsLus = LireContenuBloc(blocSource, contenu, taille);
+  // le bloc 0 du fichier : un trou se lit à zéro (la première étendue peut commencer plus loin)
+  tNumeroBloc blocSource = blocFichier(inode, 0, NULL);
+  long octetsLus = taille;
+  if (blocSource == BLOC_NUL) {
+    memset(contenu, 0, taille);
+  } else {
+    // on lit le bloc sur le disque
+    octetsLus = LireBlocDisque(inode->disque, blocSource, 0, contenu, taille);
+  }
 
   // on met à jour la date d'accès
   mettreAJourDateAccess(inode);
@@ -333,7 +1168,7 @@ long LireDonneesInode1bloc(tInode inode, unsigned char *contenu, long taille) {
 
 /* V1
  * Copie dans un inode les taille octets situés à l’adresse contenu.
- * Si taille est supérieure à la taille d’un bloc, seuls les TAILLE_BLOC premiers octets doivent être copiés.
+ * Si taille est supérieure à la taille d’un bloc, seuls les premiers octets tenant dans un bloc doivent être copiés.
  * Entrées : l'inode, l'adresse de la zone à recopier et sa taille en octets
  * Retour : le nombre d'octets effectivement écrits dans l'inode ou -1 en cas d'erreur
  */
@@ -343,73 +1178,75 @@ long EcrireDonneesInode1bloc(tInode inode, unsigned char *contenu, long taille)
     return -1; // return -1 en cas d'erreur
   }
 
-  // on prend le plus petit entre taille demandé par l'utilisation et TAILLE_BLOC (64)
-  if (taille > TAILLE_BLOC) {
-    taille = TAILLE_BLOC;
+  // les ajouts en attente sont d'abord écrits, le bloc de la fin du fichier ne reste pas en mémoire
+  if (publierAjouts(inode, false) != 0) {
+    return -1;
   }
 
-  // on cherche un bloc déjà existant dans l'inode
-  int indexBloc = -1;
-  for (int i = 0; i < NB_BLOCS_DIRECTS; i++) {
-    if (inode->blocDonnees[i] != NULL) {
-      indexBloc = i; // on trouve un bloc dans l'inode déjà alloué
-      break;
-    }
+  // on prend le plus petit entre taille demandé par l'utilisation et la taille d'un bloc
+  if (taille > tailleBlocInode(inode)) {
+    taille = tailleBlocInode(inode);
   }
 
-  // on crée un nouveau bloc s'il n'en existe pas
-  if (indexBloc == -1) {
-    for (int i = 0; i < NB_BLOCS_DIRECTS; i++) {
-      if (inode->blocDonnees[i] == NULL) {
-        indexBloc = i;
-        break;
-      }
+  // fichier en ligne : il y reste si les données tiennent dans l'inode, sinon elles passent dans des blocs
+  if (inode->enLigne) {
+    if (taille <= TAILLE_DONNEES_INODE) {
+      memcpy(inode->donneesInode, contenu, taille);
+      inode->taille = taille;
+      mettreAJourDateModifContenu(inode);
+      return taille;
     }
-
-    // vérifie que l'emplacement trouvé est bien libre (si indexBloc reste à -1 alors tous les blocs sont déjà occupés
-    if (indexBloc == -1) {
+    if (sortirDonneesEnLigne(inode) != 0) {
       return -1;
     }
+  }
 
-    // cree un nouveau bloc
-    inode->blocDonnees[indexBloc] = CreerBloc();
-    if (inode->blocDonnees[indexBloc] == NULL) {
-      return -1; // echec de la creation du bloc
+  // inode compressé : on réécrit le début de la première trame
+  if (inode->compresse) {
+    long octetsEcris = ecrireDonneesCompressees(inode, contenu, taille, 0);
+    // écriture incomplète : le fichier garde sa taille
+    if (octetsEcris < taille) {
+      return octetsEcris;
     }
+    inode->taille = octetsEcris;
+    mettreAJourDateModifContenu(inode);
+    return octetsEcris;
   }
 
-  // on utilise la fonction EcrireContenuBloc pour faire la copie depuis contenu vers bloc
-  long octetsEcris = EcrireContenuBloc(inode->blocDonnees[indexBloc], contenu, taille);
+  // le bloc 0 du fichier, s'il existe déjà (sinon c'est un trou)
+  long indexBloc = 0;
+  tNumeroBloc numero = blocFichier(inode, indexBloc, NULL);
+
+  if (numero == BLOC_NUL) {
+    // alloue un nouveau bloc sur le disque
+    numero = AllouerBlocDisque(inode->disque, BLOC_NUL);
+  } else {
+    // le bloc existant peut être partagé : copie sur écriture
+    numero = PreparerEcritureBlocDisque(inode->disque, numero);
+  }
+  if (numero == BLOC_NUL) {
+    return -1; // echec de la creation du bloc
+  }
+  if (changerBlocFichier(inode, indexBloc, numero) != 0) {
+    return -1;
+  }
+
+  // on écrit dans le bloc sur le disque depuis contenu
+  long octetsEcris = EcrireBlocDisque(inode->disque, numero, 0, contenu, taille);
 
   // mettre a jour la taille de l'inode avec le nombre d'octets effectivement écrits
   inode->taille = octetsEcris;
 
   // mettre à jour les dates de modification
   mettreAJourDateModifContenu(inode);
-  mettreAJourDateModifInode(inode);
 
   return octetsEcris;
 }
 
-/* V3
- * Lit les données d'un inode avec décalage, et les stocke à une adresse donnée
- * Entrées : l'inode d'où les données sont lues, la zone où recopier ces données, la taille en octets
- * des données à lire et le décalage à appliquer (voir énoncé)
- * Sortie : le nombre d'octets effectivement lus, 0 si le décalage est au-delà de la taille
- */
-long LireDonneesInode(tInode inode, unsigned char *contenu, long taille, long decalage) {
-  // erreur inode
-  if (inode == NULL) {
-    fprintf(stderr, "LireDonneesInode : l'inode n'existe pas\n");
-    return -1;
-  }
-
-  // erreur contenu
-  if (contenu == NULL) {
-    fprintf(stderr, "LireDonneesInode : pas de zone où recopier les données\n");
-    return -1;
-  }
-
+// fonction auxiliaire qui lit les données d'un inode avec décalage, sans mettre à jour sa date d'accès
+// (voir LireDonneesInode), connaissant la taille de ses blocs et leur nombre maximal dans un fichier :
+// retourne le nombre d'octets effectivement lus
+static long lireDonnees(tInode inode, unsigned char *contenu, long taille, long decalage, long tailleBloc, long nbBlocsMax) {
   // verif si le décalage dépasse la taille du fichier
   if (decalage >= inode->taille) {
     return 0;
@@ -428,67 +1265,105 @@ long LireDonneesInode(tInode inode, unsigned char *contenu, long taille, long de
     return 0;
   }
 
+  // fichier en ligne : une seule copie depuis l'inode
+  if (inode->enLigne) {
+    memcpy(contenu, inode->donneesInode + decalage, tailleALire);
+    return tailleALire;
+  }
+
+  // inode compressé : lecture trame par trame
+  if (inode->compresse) {
+    return lireDonneesCompressees(inode, contenu, tailleALire, decalage);
+  }
+
   long totalOctetsLus = 0; // nombre total d'octets lus jusqu'à présent
   long positionActuelle = decalage; // position courante dans le fichier
 
-  // lecture bloc par bloc
+  // lecture étendue par étendue : chaque suite de blocs consécutifs sur le disque (ou chaque trou) d'un seul tenant
   while (totalOctetsLus < tailleALire) {
     // calcul du bloc courant et décalage dans ce bloc
-    int numeroBloc = positionActuelle / TAILLE_BLOC; // numéro du bloc actuel (de 0 à 9)
-    int decalageDansBloc = positionActuelle % TAILLE_BLOC; // position dans le bloc actuel (de 0 à 63)
+    long numeroBloc = positionActuelle / tailleBloc; // rang du bloc actuel dans le fichier
+    long decalageDansBloc = positionActuelle % tailleBloc; // position dans le bloc actuel
 
-    // verif que le bloc existe
-    if (numeroBloc >= NB_BLOCS_DIRECTS || inode->blocDonnees[numeroBloc] == NULL) {
+    // verif que le numéro de bloc est valide
+    if (numeroBloc >= nbBlocsMax) {
       break; // on arrete si bloc inexistant
     }
 
+    // le bloc sur le disque et le nombre de blocs qui le suivent dans la même étendue (ou le même trou)
+    long suite;
+    tNumeroBloc numero = blocFichier(inode, numeroBloc, &suite);
+
     long octetsRestants = tailleALire - totalOctetsLus; // ce qu'il reste à lire
-    long espaceDansBloc = TAILLE_BLOC - decalageDansBloc; // espace disponible dans le bloc actuel
-    long octetsALireDansBloc = (octetsRestants < espaceDansBloc) ? octetsRestants : espaceDansBloc; // le minimum entre les deux
-
-    // lecture avec LireContenuBloc
-    long octetsLusDansBloc = LireContenuBloc(
-      inode->blocDonnees[numeroBloc], // bloc source où lire les données
-      contenu + totalOctetsLus, // destination
-      octetsALireDansBloc // nb d'octets à lire
-    );
-
-    // si aucun octet lus dans le bloc
-    if (octetsLusDansBloc <= 0) {
+    long espaceDansSuite = (suite > (LONG_MAX - decalageDansBloc) / tailleBloc) ? LONG_MAX : suite * tailleBloc - decalageDansBloc;
+    long octetsALireDansSuite = (octetsRestants < espaceDansSuite) ? octetsRestants : espaceDansSuite; // le minimum entre les deux
+
+    long octetsLusDansSuite;
+    if (numero == BLOC_NUL) {
+      // trou dans le fichier : se lit à zéro, sans allouer de bloc
+      memset(contenu + totalOctetsLus, 0, octetsALireDansSuite);
+      octetsLusDansSuite = octetsALireDansSuite;
+    } else {
+      // lecture des blocs sur le disque, d'un seul tenant
+      octetsLusDansSuite = LireSuiteBlocsDisque(
+        inode->disque, numero, // premier bloc source où lire les données
+        decalageDansBloc, // position dans ce bloc
+        contenu + totalOctetsLus, // destination
+        octetsALireDansSuite // nb d'octets à lire
+      );
+    }
+
+    // si aucun octet lus dans la suite
+    if (octetsLusDansSuite <= 0) {
       break;
     }
 
-    totalOctetsLus += octetsLusDansBloc; // ajoute les octets lus au total
-    positionActuelle += octetsLusDansBloc; // avance la position dans le fichier
+    totalOctetsLus += octetsLusDansSuite; // ajoute les octets lus au total
+    positionActuelle += octetsLusDansSuite; // avance la position dans le fichier
   }
 
-  // met à jour date d'accès
-  mettreAJourDateAccess(inode);
-
   return totalOctetsLus;
 }
 
-/* V3
- * Ecrit dans un inode, avec décalage, ls données stockées à une adresse donnée
- * Entrées : l'inode où écrire le contenu, l'adesse de la zone depuis laquelle lire les données, la taille en octets
- * de ces données et le décalage à appliquer (voir énoncé)
- * Sortie : le nombre d'octets effectivement écrits, ou -1 en cas d'erreur
+/* V3 & V5
+ * Lit les données d'un inode avec décalage, et les stocke à une adresse donnée
+ * Les trous du fichier (blocs jamais écrits) se lisent à zéro, sans allouer de bloc.
+ * Entrées : l'inode d'où les données sont lues, la zone où recopier ces données, la taille en octets
+ * des données à lire et le décalage à appliquer (voir énoncé)
+ * Sortie : le nombre d'octets effectivement lus, 0 si le décalage est au-delà de la taille
  */
-long EcrireDonneesInode(tInode inode, unsigned char *contenu, long taille, long decalage) {
+long LireDonneesInode(tInode inode, unsigned char *contenu, long taille, long decalage) {
   // erreur inode
   if (inode == NULL) {
-    fprintf(stderr, "EcrireDonneesInode : l'inode n'existe pas\n");
+    fprintf(stderr, "LireDonneesInode : l'inode n'existe pas\n");
     return -1;
   }
 
   // erreur contenu
   if (contenu == NULL) {
-    fprintf(stderr, "EcrireDonneesInode : pas de données à écrire\n");
+    fprintf(stderr, "LireDonneesInode : pas de zone où recopier les données\n");
     return -1;
   }
+  // les ajouts en attente sont d'abord écrits (voir AjouterDonneesInode)
+  publierAjouts(inode, true);
+
+  long tailleBloc = tailleBlocInode(inode); // taille des blocs de l'inode
+  long octetsLus = lireDonnees(inode, contenu, taille, decalage, tailleBloc, nbBlocsMaxFichier(tailleBloc));
 
+  // met à jour date d'accès
+  if (octetsLus > 0) {
+    mettreAJourDateAccess(inode);
+  }
+
+  return octetsLus;
+}
+
+// fonction auxiliaire qui écrit dans un inode avec décalage, sans mettre à jour ses dates (voir EcrireDonneesInode),
+// connaissant la taille de ses blocs et celle du plus grand fichier :
+// retourne le nombre d'octets effectivement écrits, ou -1 en cas d'erreur
+static long ecrireDonnees(tInode inode, unsigned char *contenu, long taille, long decalage, long tailleBloc, long tailleMax) {
   // verif si le décalage dépasse la taille maximale du fichier
-  if (decalage >= NB_BLOCS_DIRECTS * TAILLE_BLOC) {
+  if (decalage >= tailleMax) {
     fprintf(stderr, "EcrireDonneesInode : décalage supérieur à la taille maximale\n");
     return -1;
   }
@@ -497,8 +1372,8 @@ long EcrireDonneesInode(tInode inode, unsigned char *contenu, long taille, long
   long tailleAEcrire = tailleDemandee; // ce qu'on va réellement écrire
 
   // si decalage + taille demandée est supérieur à la taille maximale du fichier
-  if (decalage + tailleDemandee > NB_BLOCS_DIRECTS * TAILLE_BLOC) {
-    tailleAEcrire = NB_BLOCS_DIRECTS * TAILLE_BLOC - decalage;
+  if (decalage + tailleDemandee > tailleMax) {
+    tailleAEcrire = tailleMax - decalage;
   }
 
   // si rien à écrire
@@ -506,48 +1381,133 @@ long EcrireDonneesInode(tInode inode, unsigned char *contenu, long taille, long
     return 0;
   }
 
+  // fichier en ligne : il y reste tant qu'il tient dans l'inode, sinon ses données passent dans des blocs
+  if (inode->enLigne) {
+    if (decalage + tailleAEcrire <= TAILLE_DONNEES_INODE) {
+      return ecrireEnLigne(inode, contenu, tailleAEcrire, decalage);
+    }
+    if (sortirDonneesEnLigne(inode) != 0) {
+      fprintf(stderr, "EcrireDonneesInode : impossible de ranger le fichier dans des blocs\n");
+      return -1;
+    }
+  }
+
+  // inode compressé : écriture trame par trame
+  if (inode->compresse) {
+    return ecrireDonneesCompressees(inode, contenu, tailleAEcrire, decalage);
+  }
+
   long totalOctetsEcrits = 0; // nombre total d'octets écris jusqu'à présent
   long positionActuelle = decalage; // position courante dans le fichier
+  long nbBlocsMax = tailleMax / tailleBloc; // nombre maximal de blocs du fichier
 
-  // écriture bloc par bloc
+  // écriture bloc par bloc pour les blocs à créer, par suites de blocs consécutifs sur le disque pour les blocs existants
   while (totalOctetsEcrits < tailleAEcrire) {
     // calcul du bloc courant et décalage dans ce bloc
-    int numeroBloc = positionActuelle / TAILLE_BLOC; // numéro du bloc actuel (de 0 à 9)
-    int decalageDansBloc = positionActuelle % TAILLE_BLOC; // position dans le bloc actuel (de 0 à 63)
+    long numeroBloc = positionActuelle / tailleBloc; // rang du bloc actuel dans le fichier
+    long decalageDansBloc = positionActuelle % tailleBloc; // position dans le bloc actuel
 
     // verif que le numéro de bloc est valide
-    if (numeroBloc >= NB_BLOCS_DIRECTS) {
+    if (numeroBloc >= nbBlocsMax) {
       break; // on arrete si bloc inexistant
     }
 
+    long octetsRestants = tailleAEcrire - totalOctetsEcrits; // ce qu'il reste à écrire
+    long espaceDansBloc = tailleBloc - decalageDansBloc; // espace disponible dans le bloc actuel
+    long octetsAEcrireDansBloc = (octetsRestants < espaceDansBloc) ? octetsRestants : espaceDansBloc; // le minimum entre les deux
+
+    // le bloc sur le disque et le nombre de blocs qui le suivent dans la même étendue
+    long suite;
+    tNumeroBloc numero = blocFichier(inode, numeroBloc, &suite);
+    long octetsEcritsDansSuite;
+
     // si le bloc existe pas encore, on le crée
-    if (inode->blocDonnees[numeroBloc] == NULL) {
-      inode->blocDonnees[numeroBloc] = CreerBloc();
+    if (numero == BLOC_NUL) {
+      // de préférence juste après le bloc précédent du fichier (blocs contigus sur le disque, même étendue)
+      tNumeroBloc blocPrecedent = (numeroBloc > 0) ? blocFichier(inode, numeroBloc - 1, NULL) : BLOC_NUL;
+      tNumeroBloc aPartirDe = (blocPrecedent != BLOC_NUL) ? blocPrecedent + 1 : BLOC_NUL;
+
+      if (octetsAEcrireDansBloc == tailleBloc) {
+        // bloc entièrement écrit : alloué directement avec son contenu
+        // (avec la déduplication, un bloc identique déjà présent est partagé)
+        numero = AllouerBlocContenuDisque(inode->disque, aPartirDe, contenu + totalOctetsEcrits);
+        octetsEcritsDansSuite = tailleBloc;
+      } else {
+        numero = AllouerBlocDisque(inode->disque, aPartirDe);
+        octetsEcritsDansSuite = 0;
+      }
+
+      // le bloc prend sa place dans la carte
+      if (numero != BLOC_NUL && changerBlocFichier(inode, numeroBloc, numero) != 0) {
+        LibererBlocDisque(inode->disque, numero);
+        numero = BLOC_NUL;
+      }
+
       // si erreur creation bloc
-      if (inode->blocDonnees[numeroBloc] == NULL) {
-        fprintf(stderr, "EcrireDonneesInode : impossible de créer le bloc %d\n", numeroBloc);
+      if (numero == BLOC_NUL) {
+        fprintf(stderr, "EcrireDonneesInode : impossible de créer le bloc %ld\n", numeroBloc);
         break;
       }
-    }
 
-    long octetsRestants = tailleAEcrire - totalOctetsEcrits; // ce qu'il reste à écrire
-    long espaceDansBloc = TAILLE_BLOC - decalageDansBloc; // espace disponible dans le bloc actuel
-    long octetsAEcrireDansBloc = (octetsRestants < espaceDansBloc) ? octetsRestants : espaceDansBloc; // le minimum entre les deux
+      // si le bloc n'est pas entièrement écrit, la partie non écrite doit se relire à zéro
+      if (octetsAEcrireDansBloc < tailleBloc) {
+        EffacerBlocDisque(inode->disque, numero);
+        octetsEcritsDansSuite = EcrireBlocDisque(inode->disque, numero, decalageDansBloc,
+                                                 contenu + totalOctetsEcrits, octetsAEcrireDansBloc);
+      }
+    } else {
+      // blocs existants de l'étendue : ceux qui sont partagés sont recopiés (copie sur écriture),
+      // les blocs qui restent en place à la suite sont écrits d'un seul tenant
+      long nbBlocsAEcrire = (decalageDansBloc + octetsRestants + tailleBloc - 1) / tailleBloc;
+      if (nbBlocsAEcrire > suite) {
+        nbBlocsAEcrire = suite;
+      }
+      long nbEnPlace = 0;
+      bool erreur = false;
+      while (nbEnPlace < nbBlocsAEcrire) {
+        tNumeroBloc prepare = PreparerEcritureBlocDisque(inode->disque, numero + nbEnPlace);
+        if (prepare == numero + nbEnPlace) {
+          nbEnPlace++;
+          continue;
+        }
 
-    // écriture avec EcrireContenuBloc
-    long octetsEcritsDansBloc = EcrireContenuBloc(
-      inode->blocDonnees[numeroBloc], // destination
-      contenu + totalOctetsEcrits, // source
-      octetsAEcrireDansBloc // nb d'octets à écrire
-    );
+        // bloc partagé recopié : la copie prend sa place dans le fichier (elle est écrite au tour suivant)
+        if (prepare != BLOC_NUL && changerBlocFichier(inode, numeroBloc + nbEnPlace, prepare) != 0) {
+          PartagerBlocDisque(inode->disque, numero + nbEnPlace); // le bloc d'origine reste dans le fichier
+          LibererBlocDisque(inode->disque, prepare);
+          prepare = BLOC_NUL;
+        }
+        erreur = (prepare == BLOC_NUL);
+        break;
+      }
 
-    // si aucun octet écrit dans le bloc
-    if (octetsEcritsDansBloc <= 0) {
+      if (erreur && nbEnPlace == 0) {
+        fprintf(stderr, "EcrireDonneesInode : impossible de modifier le bloc %ld\n", numeroBloc);
+        break;
+      }
+      if (nbEnPlace == 0) {
+        continue; // la copie du bloc partagé est maintenant en place
+      }
+
+      long octetsAEcrireDansSuite = nbEnPlace * tailleBloc - decalageDansBloc;
+      if (octetsAEcrireDansSuite > octetsRestants) {
+        octetsAEcrireDansSuite = octetsRestants;
+      }
+      octetsEcritsDansSuite = EcrireSuiteBlocsDisque(
+        inode->disque, numero, // premier bloc destination
+        decalageDansBloc, // position dans ce bloc
+        contenu + totalOctetsEcrits, // source
+        octetsAEcrireDansSuite // nb d'octets à écrire
+      );
+    }
+
+    // si aucun octet écrit
+    if (octetsEcritsDansSuite <= 0) {
       break;
     }
 
-    totalOctetsEcrits += octetsEcritsDansBloc; // ajoute les octets écrits au total
-    positionActuelle += octetsEcritsDansBloc; // avance la position dans le fichier
+    totalOctetsEcrits += octetsEcritsDansSuite; // ajoute les octets écrits au total
+    positionActuelle += octetsEcritsDansSuite; // avance la position dans le fichier
   }
 
   // met à juor taille du fichier
@@ -555,16 +1515,453 @@ long EcrireDonneesInode(tInode inode, unsigned char *contenu, long taille, long
     inode->taille = decalage + totalOctetsEcrits;
   }
 
-  // met à jour les dates
-  mettreAJourDateModifContenu(inode);
-  mettreAJourDateModifInode(inode);
-
   return totalOctetsEcrits;
 }
 
+// fonction auxiliaire qui écrit sur le disque le bloc de la fin du fichier gardé en mémoire par les ajouts,
+// s'il a été modifié (0 si ok, -1 si tous ses octets n'ont pas pu être écrits)
+static int ecrireQueue(tInode inode) {
+  if (inode->queue == NULL || !inode->queueModifiee) {
+    return 0;
+  }
+
+  long octetsEcrits = ecrireDonnees(inode, inode->queue, inode->remplissageQueue, inode->debutQueue,
+                                    tailleBlocInode(inode), TailleMaxFichierInode(inode));
+  if (octetsEcrits < inode->remplissageQueue) {
+    fprintf(stderr, "AjouterDonneesInode : impossible d'écrire la fin du fichier\n");
+    return -1;
+  }
+  inode->queueModifiee = false;
+  return 0;
+}
+
+// fonction auxiliaire qui publie les ajouts en attente d'un inode (voir sa déclaration avec la structure sInode)
+static int publierAjouts(tInode inode, bool garderQueue) {
+  int resultat = ecrireQueue(inode);
+
+  // des ajouts ont eu lieu : les dates sont mises à jour une seule fois
+  if (inode->datesAPublier) {
+    mettreAJourDateModifContenu(inode);
+    inode->datesAPublier = false;
+  }
+
+  // en cas d'erreur, les octets qui n'ont pas pu être écrits sont perdus
+  if (!garderQueue || resultat != 0) {
+    free(inode->queue);
+    inode->queue = NULL;
+    inode->remplissageQueue = 0;
+    inode->queueModifiee = false;
+  }
+  return resultat;
+}
+
+// fonction auxiliaire qui garde en mémoire le bloc de la fin du fichier, rempli des octets du fichier qu'il contient déjà
+// (0 si ok, -1 en cas d'erreur)
+static int ouvrirQueue(tInode inode, long tailleBloc) {
+  if (publierAjouts(inode, false) != 0) {
+    return -1;
+  }
+
+  inode->queue = malloc(tailleBloc);
+  if (inode->queue == NULL) {
+    fprintf(stderr, "AjouterDonneesInode : erreur allocation\n");
+    return -1;
+  }
+  inode->debutQueue = inode->taille - inode->taille % tailleBloc;
+  inode->remplissageQueue = inode->taille % tailleBloc;
+  if (lireDonnees(inode, inode->queue, inode->remplissageQueue, inode->debutQueue, tailleBloc,
+                  nbBlocsMaxFichier(tailleBloc)) != inode->remplissageQueue) {
+    fprintf(stderr, "AjouterDonneesInode : impossible de lire la fin du fichier\n");
+    publierAjouts(inode, false);
+    return -1;
+  }
+  return 0;
+}
+
 /* V3
+ * Ecrit dans un inode, avec décalage, ls données stockées à une adresse donnée
+ * Entrées : l'inode où écrire le contenu, l'adesse de la zone depuis laquelle lire les données, la taille en octets
+ * de ces données et le décalage à appliquer (voir énoncé)
+ * Sortie : le nombre d'octets effectivement écrits, ou -1 en cas d'erreur
+ */
+long EcrireDonneesInode(tInode inode, unsigned char *contenu, long taille, long decalage) {
+  // erreur inode
+  if (inode == NULL) {
+    fprintf(stderr, "EcrireDonneesInode : l'inode n'existe pas\n");
+    return -1;
+  }
+
+  // erreur contenu
+  if (contenu == NULL) {
+    fprintf(stderr, "EcrireDonneesInode : pas de données à écrire\n");
+    return -1;
+  }
+  // les ajouts en attente sont d'abord écrits, le bloc de la fin du fichier ne reste pas en mémoire
+  if (publierAjouts(inode, false) != 0) {
+    return -1;
+  }
+
+  long octetsEcrits = ecrireDonnees(inode, contenu, taille, decalage, tailleBlocInode(inode), TailleMaxFichierInode(inode));
+
+  // met à jour les dates
+  if (octetsEcrits > 0) {
+    mettreAJourDateModifContenu(inode);
+  }
+
+  return octetsEcrits;
+}
+
+// fonction auxiliaire qui vérifie les segments d'une lecture ou d'une écriture vectorisée (0 si ok, -1 sinon)
+static int verifierSegments(const char *fonction, tInode inode, struct sSegment segments[], long nbSegments) {
+  if (inode == NULL || (segments == NULL && nbSegments > 0) || nbSegments < 0) {
+    fprintf(stderr, "%s : parametre invalide\n", fonction);
+    return -1;
+  }
+  for (long i = 0; i < nbSegments; i++) {
+    if (segments[i].contenu == NULL || segments[i].taille < 0 || segments[i].decalage < 0) {
+      fprintf(stderr, "%s : segment %ld invalide\n", fonction, i);
+      return -1;
+    }
+    segments[i].traites = 0;
+  }
+  return 0;
+}
+
+// fonction auxiliaire qui retourne la fin (exclue) du groupe de segments commençant au segment debut :
+// segments qui se suivent dans le fichier et tiennent ensemble dans la zone de regroupement
+// (debut + 1 si le segment reste seul)
+static long finRegroupement(struct sSegment segments[], long debut, long nbSegments, long *pTaille) {
+  long taille = segments[debut].taille;
+  long fin = debut + 1;
+  while (fin < nbSegments && segments[fin].decalage == segments[debut].decalage + taille
+         && taille + segments[fin].taille <= TAILLE_REGROUPEMENT) {
+    taille += segments[fin].taille;
+    fin++;
+  }
+  *pTaille = taille;
+  return fin;
+}
+
+// fonction auxiliaire qui répartit les octets traités d'un groupe de segments entre eux, dans l'ordre
+static void repartirRegroupement(struct sSegment segments[], long debut, long fin, long traites) {
+  for (long i = debut; i < fin; i++) {
+    segments[i].traites = (traites < segments[i].taille) ? traites : segments[i].taille;
+    traites -= segments[i].traites;
+  }
+}
+
+/* V5
+ * Lit les données d'un inode dans plusieurs zones, chacune avec son propre décalage (à la manière de preadv) :
+ * les segments sont lus dans l'ordre en une seule passe, et la date d'accès n'est mise à jour qu'une fois.
+ * Les petits segments qui se suivent dans le fichier sont lus ensemble, puis répartis dans leurs zones.
+ * Entrées : l'inode, le tableau des segments (le champ traites de chacun reçoit le nombre d'octets lus), leur nombre
+ * Sortie : le nombre total d'octets effectivement lus, ou -1 en cas d'erreur
+ */
+long LireDonneesInodeV(tInode inode, struct sSegment segments[], long nbSegments) {
+  if (verifierSegments("LireDonneesInodeV", inode, segments, nbSegments) != 0) {
+    return -1;
+  }
+  // les ajouts en attente sont d'abord écrits (voir AjouterDonneesInode)
+  publierAjouts(inode, true);
+
+  long tailleBloc = tailleBlocInode(inode);
+  long nbBlocsMax = nbBlocsMaxFichier(tailleBloc);
+  unsigned char tampon[TAILLE_REGROUPEMENT];
+  long totalOctetsLus = 0;
+  for (long i = 0; i < nbSegments;) {
+    long taille;
+    long fin = finRegroupement(segments, i, nbSegments, &taille);
+    if (fin == i + 1) {
+      segments[i].traites = lireDonnees(inode, segments[i].contenu, taille, segments[i].decalage, tailleBloc, nbBlocsMax);
+    } else {
+      // groupe : une seule lecture, puis une copie par segment
+      long octetsLus = lireDonnees(inode, tampon, taille, segments[i].decalage, tailleBloc, nbBlocsMax);
+      repartirRegroupement(segments, i, fin, octetsLus);
+      for (long j = i, position = 0; j < fin; position += segments[j].traites, j++) {
+        memcpy(segments[j].contenu, tampon + position, segments[j].traites);
+      }
+    }
+    for (; i < fin; i++) {
+      totalOctetsLus += segments[i].traites;
+    }
+  }
+
+  if (totalOctetsLus > 0) {
+    mettreAJourDateAccess(inode);
+  }
+  return totalOctetsLus;
+}
+
+/* V5
+ * Ecrit dans un inode les données de plusieurs zones, chacune à son propre décalage (à la manière de pwritev) :
+ * les segments sont écrits dans l'ordre en une seule passe (un segment écrit après un autre l'emporte là où
+ * ils se recouvrent), et les dates ne sont mises à jour qu'une fois ; l'écriture s'arrête au premier segment
+ * en erreur ou écrit en partie (disque plein, taille maximale atteinte).
+ * Les petits segments qui se suivent dans le fichier sont rassemblés, puis écrits ensemble.
+ * Entrées : l'inode, le tableau des segments (le champ traites de chacun reçoit le nombre d'octets écrits), leur nombre
+ * Sortie : le nombre total d'octets effectivement écrits, ou -1 en cas d'erreur avant toute écriture
+ */
+long EcrireDonneesInodeV(tInode inode, struct sSegment segments[], long nbSegments) {
+  if (verifierSegments("EcrireDonneesInodeV", inode, segments, nbSegments) != 0) {
+    return -1;
+  }
+  // les ajouts en attente sont d'abord écrits, le bloc de la fin du fichier ne reste pas en mémoire
+  if (publierAjouts(inode, false) != 0) {
+    return -1;
+  }
+
+  long tailleBloc = tailleBlocInode(inode);
+  long tailleMax = TailleMaxFichierInode(inode);
+  unsigned char tampon[TAILLE_REGROUPEMENT];
+  long totalOctetsEcrits = 0;
+  bool erreur = false;
+  for (long i = 0; i < nbSegments && !erreur;) {
+    long taille;
+    long fin = finRegroupement(segments, i, nbSegments, &taille);
+    unsigned char *contenu = segments[i].contenu;
+    if (fin > i + 1) {
+      // groupe : les segments sont rassemblés pour une seule écriture
+      for (long j = i, position = 0; j < fin; position += segments[j].taille, j++) {
+        memcpy(tampon + position, segments[j].contenu, segments[j].taille);
+      }
+      contenu = tampon;
+    }
+
+    long octetsEcrits = ecrireDonnees(inode, contenu, taille, segments[i].decalage, tailleBloc, tailleMax);
+    erreur = (octetsEcrits < taille);
+    if (octetsEcrits > 0) {
+      repartirRegroupement(segments, i, fin, octetsEcrits);
+      totalOctetsEcrits += octetsEcrits;
+    }
+    i = fin;
+  }
+
+  if (totalOctetsEcrits > 0) {
+    mettreAJourDateModifContenu(inode);
+  }
+  return (erreur && totalOctetsEcrits == 0) ? -1 : totalOctetsEcrits;
+}
+
+/* V5
+ * Ajoute des données à la fin d'un inode, pour les écritures répétées de petits enregistrements (journaux).
+ * Le bloc de la fin du fichier est gardé en mémoire avec son remplissage : les petits ajouts y sont rassemblés,
+ * et il n'est écrit sur le disque qu'une fois plein ; les blocs entiers sont écrits directement.
+ * Taille tient compte des ajouts, mais les dates de modification ne sont mises à jour qu'à la publication
+ * des ajouts : ViderAjoutsInode, ou tout autre accès aux données de l'inode, ou sa sauvegarde.
+ * Entrées : l'inode, l'adresse des données à ajouter, leur taille en octets
+ * Sortie : le nombre d'octets effectivement ajoutés (moins que taille si la taille maximale est atteinte),
+ * ou -1 en cas d'erreur
+ */
+long AjouterDonneesInode(tInode inode, unsigned char *contenu, long taille) {
+  if (inode == NULL || contenu == NULL || taille < 0) {
+    fprintf(stderr, "AjouterDonneesInode : parametre invalide\n");
+    return -1;
+  }
+
+  // cas le plus fréquent : un petit ajout qui tient dans le bloc en mémoire, déjà commencé
+  // (il est donc dans la taille maximale du fichier)
+  long tailleBloc = tailleBlocInode(inode);
+  if (inode->queue != NULL && inode->remplissageQueue > 0 && inode->remplissageQueue + taille < tailleBloc
+      && inode->debutQueue + inode->remplissageQueue == Taille(inode)) {
+    memcpy(inode->queue + inode->remplissageQueue, contenu, taille);
+    inode->remplissageQueue += taille;
+    inode->queueModifiee = true;
+    inode->datesAPublier = true;
+    return taille;
+  }
+
+  // pas au-delà de la taille maximale du fichier
+  long fin = Taille(inode);
+  long tailleMax = TailleMaxFichierInode(inode);
+  if (taille > tailleMax - fin) {
+    taille = tailleMax - fin;
+  }
+  if (taille <= 0) {
+    return 0;
+  }
+
+  // le bloc gardé en mémoire doit être celui de la fin du fichier (sinon il est repris depuis le disque)
+  if ((inode->queue == NULL || inode->debutQueue + inode->remplissageQueue != fin) && ouvrirQueue(inode, tailleBloc) != 0) {
+    return -1;
+  }
+
+  long totalOctetsAjoutes = 0;
+  bool erreur = false;
+  while (totalOctetsAjoutes < taille && !erreur) {
+    long octetsRestants = taille - totalOctetsAjoutes;
+
+    // bloc vide et au moins un bloc entier à ajouter : les blocs entiers sont écrits sans passer par la mémoire
+    if (inode->remplissageQueue == 0 && octetsRestants >= tailleBloc) {
+      long octetsEcrits = ecrireDonnees(inode, contenu + totalOctetsAjoutes, octetsRestants - octetsRestants % tailleBloc,
+                                        inode->debutQueue, tailleBloc, tailleMax);
+      erreur = (octetsEcrits < octetsRestants - octetsRestants % tailleBloc);
+      if (octetsEcrits > 0) {
+        totalOctetsAjoutes += octetsEcrits;
+        inode->debutQueue += octetsEcrits;
+        inode->datesAPublier = true;
+      }
+      continue;
+    }
+
+    // sinon les octets complètent le bloc en mémoire, écrit sur le disque quand il est plein
+    long espaceDansBloc = tailleBloc - inode->remplissageQueue;
+    long octetsACopier = (octetsRestants < espaceDansBloc) ? octetsRestants : espaceDansBloc;
+    memcpy(inode->queue + inode->remplissageQueue, contenu + totalOctetsAjoutes, octetsACopier);
+    inode->remplissageQueue += octetsACopier;
+    inode->queueModifiee = true;
+    inode->datesAPublier = true;
+    totalOctetsAjoutes += octetsACopier;
+    if (inode->remplissageQueue == tailleBloc) {
+      erreur = (ecrireQueue(inode) != 0);
+      if (!erreur) {
+        inode->debutQueue += tailleBloc;
+        inode->remplissageQueue = 0;
+      }
+    }
+  }
+
+  // erreur (disque plein) : le bloc en mémoire est abandonné, seuls comptent les octets arrivés sur le disque
+  if (erreur) {
+    publierAjouts(inode, false);
+    totalOctetsAjoutes = Taille(inode) - fin;
+  }
+  return (totalOctetsAjoutes <= 0) ? -1 : totalOctetsAjoutes;
+}
+
+/* V5
+ * Publie les ajouts en attente d'un inode (voir AjouterDonneesInode) : la fin du fichier est écrite sur le disque
+ * et les dates de modification sont mises à jour. Le bloc de la fin du fichier reste en mémoire pour les ajouts suivants.
+ * Entrée : l'inode concerné
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur (les octets qui n'ont pas pu être écrits sont perdus)
+ */
+int ViderAjoutsInode(tInode inode) {
+  if (inode == NULL) {
+    fprintf(stderr, "ViderAjoutsInode : l'inode n'existe pas\n");
+    return -1;
+  }
+
+  return publierAjouts(inode, true);
+}
+
+// Taille des métadonnées sauvegardées d'un inode (champs à la suite, sans remplissage)
+#define TAILLE_METADONNEES (sizeof(unsigned int) + sizeof(natureFichier) + sizeof(long) + 3 * sizeof(time_t))
+
+// Taille de la partie fixe d'un enregistrement de SauvegarderMetaInode (métadonnées, mode de stockage,
+// nombre de trames et nombre d'étendues), suivie des tailles des trames puis des étendues (ou des données en ligne)
+#define TAILLE_META_INODE (TAILLE_METADONNEES + sizeof(int) + 2 * sizeof(uint32_t))
+
+// Le mode de stockage sauvegardé : un bit par mode
+#define MODE_COMPRESSE 1
+#define MODE_EN_LIGNE 2
+
+// fonction auxiliaire qui recopie un champ à la suite dans un enregistrement et retourne la position suivante
+static unsigned char *empiler(unsigned char *position, const void *champ, size_t taille) {
+  memcpy(position, champ, taille);
+  return position + taille;
+}
+
+// fonction auxiliaire qui recopie un champ depuis un enregistrement et retourne la position suivante
+static const unsigned char *depiler(const unsigned char *position, void *champ, size_t taille) {
+  memcpy(champ, position, taille);
+  return position + taille;
+}
+
+// fonction auxiliaire qui range les métadonnées d'un inode champ par champ dans un enregistrement
+// (TAILLE_METADONNEES octets) et retourne la position suivante
+static unsigned char *empilerMetadonnees(tInode inode, unsigned char *position) {
+  position = empiler(position, &inode->numero, sizeof(unsigned int));
+  position = empiler(position, &inode->type, sizeof(natureFichier));
+  position = empiler(position, &inode->taille, sizeof(long));
+  position = empiler(position, &inode->dateDerAcces, sizeof(time_t));
+  position = empiler(position, &inode->dateDerModif, sizeof(time_t));
+  return empiler(position, &inode->dateDerModifInode, sizeof(time_t));
+}
+
+// fonction auxiliaire qui crée un inode sans bloc et y lit les métadonnées (une seule lecture)
+// retourne l'inode, ou NULL en cas d'erreur
+static tInode chargerMetadonnees(FILE *fichier, tDisque disque) {
+  tInode inode = (tInode)malloc(sizeof(struct sInode));
+  if (inode == NULL) {
+    return NULL;
+  }
+
+  unsigned char enregistrement[TAILLE_METADONNEES];
+  size_t nbLus = fread(enregistrement, TAILLE_METADONNEES, 1, fichier);
+  const unsigned char *position = enregistrement;
+  position = depiler(position, &inode->numero, sizeof(unsigned int));
+  position = depiler(position, &inode->type, sizeof(natureFichier));
+  position = depiler(position, &inode->taille, sizeof(long));
+  position = depiler(position, &inode->dateDerAcces, sizeof(time_t));
+  position = depiler(position, &inode->dateDerModif, sizeof(time_t));
+  depiler(position, &inode->dateDerModifInode, sizeof(time_t));
+
+  // aucun bloc pour l'instant, pas de compression, pas en ligne
+  viderCarte(inode);
+  inode->enLigne = false;
+  inode->disque = disque;
+  inode->compresse = false;
+  inode->tailleTrame = NULL;
+  inode->nbTrames = 0;
+  inode->politiqueDates = DATES_STRICTES;
+  inode->queue = NULL;
+  inode->remplissageQueue = 0;
+  inode->queueModifiee = false;
+  inode->datesAPublier = false;
+
+  // fichier tronqué ou taille incohérente
+  if (nbLus != 1 || inode->taille < 0 || inode->taille > TailleMaxFichierBlocs(TailleBlocDisque(disque))) {
+    free(inode);
+    return NULL;
+  }
+
+  return inode;
+}
+
+// fonction auxiliaire qui sauvegarde un petit fichier (au plus TAILLE_DONNEES_INODE octets) en ligne :
+// métadonnées, données puis leur somme de contrôle, en un seul enregistrement ; retourne 0 si ok, -1 sinon
+static int sauvegarderEnLigne(tInode inode, FILE *fichier) {
+  unsigned char enregistrement[TAILLE_METADONNEES + TAILLE_DONNEES_INODE + sizeof(uint32_t)];
+  unsigned char *donnees = empilerMetadonnees(inode, enregistrement);
+
+  if (inode->enLigne) {
+    memcpy(donnees, inode->donneesInode, inode->taille);
+  } else {
+    // petit fichier encore rangé dans des blocs : recopié bloc par bloc (décompressé si besoin)
+    long tailleBloc = tailleBlocInode(inode);
+    unsigned char *bloc = malloc(tailleBloc);
+    if (bloc == NULL) {
+      fprintf(stderr, "SauvegarderInode : erreur allocation\n");
+      return -1;
+    }
+    for (long i = 0; i * tailleBloc < inode->taille; i++) {
+      if (!lireBlocFichier(inode, i, bloc) && blocFichierAlloue(inode, i)) {
+        fprintf(stderr, "SauvegarderInode : bloc %ld illisible\n", i);
+        free(bloc);
+        return -1;
+      }
+      long morceau = (inode->taille - i * tailleBloc < tailleBloc) ? inode->taille - i * tailleBloc : tailleBloc;
+      memcpy(donnees + i * tailleBloc, bloc, morceau);
+    }
+    free(bloc);
+  }
+
+  uint32_t somme = SommeControle(donnees, inode->taille);
+  size_t tailleEnregistrement = empiler(donnees + inode->taille, &somme, sizeof(uint32_t)) - enregistrement;
+  if (fwrite(enregistrement, 1, tailleEnregistrement, fichier) != tailleEnregistrement) {
+    fprintf(stderr, "SauvegarderInode : erreur d'ecriture\n");
+    return -1;
+  }
+  return 0;
+}
+
+/* V3 & V5
  * Sauvegarde toutes les informations contenues dans un inode dans un fichier (sur disque,
- * et préalablement ouvert en écriture et en mode binaire)
+ * et préalablement ouvert en écriture et en mode binaire) : les métadonnées, la carte
+ * des blocs alloués (un bit par bloc) puis les blocs alloués seulement, chacun suivi de sa somme de contrôle.
+ * Un fichier d'au plus 96 octets est sauvegardé en ligne : ses données suivent les métadonnées,
+ * avec une seule somme de contrôle, sans carte ni bloc.
+ * L'inode est rangé dans un seul enregistrement écrit en une fois ; le fichier n'est pas vidé
+ * (fflush ou fclose de l'appelant, une fois pour tous les inodes sauvegardés).
  * Entrées : l'inode concerné, l'identificateur du fichier
  * Sortie : 0 en cas de succès, -1 en cas d'erreur
  */
@@ -581,67 +1978,75 @@ int SauvegarderInode(tInode inode, FILE *fichier) {
     return -1;
   }
 
-  // sauvegarde des métadonnées de l'inode champ par champ
-  fwrite(&inode->numero, sizeof(unsigned int), 1, fichier);
-  fwrite(&inode->type, sizeof(natureFichier), 1, fichier);
-  fwrite(&inode->taille, sizeof(long), 1, fichier);
-  fwrite(&inode->dateDerAcces, sizeof(time_t), 1, fichier);
-  fwrite(&inode->dateDerModif, sizeof(time_t), 1, fichier);
-  fwrite(&inode->dateDerModifInode, sizeof(time_t), 1, fichier);  
-
-  // sauvegarde du contenu de chaque bloc utilisé
-  int nombreBlocsUtilises = (inode->taille + TAILLE_BLOC - 1) / TAILLE_BLOC; // calcul le nombre de blocs utilisés
-  if (nombreBlocsUtilises > NB_BLOCS_DIRECTS) {
-    nombreBlocsUtilises = NB_BLOCS_DIRECTS; // petite vérification
+  // les ajouts en attente font partie du fichier sauvegardé
+  if (publierAjouts(inode, true) != 0) {
+    return -1;
   }
 
-  // parcours tous les blocs utilisés
-  for (int i = 0; i < nombreBlocsUtilises; i++) {
-    // le bloc existe et contient des données
-    if (inode->blocDonnees[i] != NULL) {
-      // sauvegarde du bloc
-      int resultatSauvegarde = SauvegarderBloc(inode->blocDonnees[i], TAILLE_BLOC, fichier);
-
-      // erreur de sauvegarde
-      if (resultatSauvegarde != 0) {
-        fprintf(stderr, "SauvegarderInode : erreur sauvegarde bloc %d\n", i);
-        return -1;
-      }
-    } else { // le bloc n'existe pas
-      // cn crée un bloc temporaire vide
-      tBloc blocVide = CreerBloc();
-
-      // erreur création bloc
-      if (blocVide == NULL) {
-        fprintf(stderr, "SauvegarderInode : erreur création bloc vide %d", i);
-        return -1;
-      }
+  // petit fichier : enregistré en ligne
+  if (inode->taille <= TAILLE_DONNEES_INODE) {
+    return sauvegarderEnLigne(inode, fichier);
+  }
 
-      // sauvegarde du bloc vide
-      int resultatSauvegarde = SauvegarderBloc(blocVide, TAILLE_BLOC, fichier);
+  // sauvegarde du contenu de chaque bloc utilisé
+  long tailleBloc = tailleBlocInode(inode); // taille des blocs de l'inode
+  long nombreBlocsUtilises = (inode->taille + tailleBloc - 1) / tailleBloc; // calcul le nombre de blocs utilisés
+
+  // les trous du fichier ne sont pas sauvegardés
+  long tailleCarte = (nombreBlocsUtilises + 7) / 8;
+  long nombreBlocsAlloues = 0;
+  for (long i = 0; i < nombreBlocsUtilises; i++) {
+    if (blocFichierAlloue(inode, i)) {
+      nombreBlocsAlloues++;
+    }
+  }
 
-      // on détruit le bloc temporaire
-      DetruireBloc(&blocVide);
+  // l'enregistrement : métadonnées, carte des blocs alloués (un bit par bloc), puis chaque bloc alloué
+  // suivi de sa somme de contrôle
+  size_t tailleEnregistrement = TAILLE_METADONNEES + tailleCarte + nombreBlocsAlloues * (tailleBloc + sizeof(uint32_t));
+  unsigned char *enregistrement = (unsigned char *)malloc(tailleEnregistrement);
+  if (enregistrement == NULL) {
+    fprintf(stderr, "SauvegarderInode : erreur allocation\n");
+    return -1;
+  }
+  unsigned char *carte = empilerMetadonnees(inode, enregistrement);
+  memset(carte, 0, tailleCarte);
+  unsigned char *position = carte + tailleCarte;
+
+  // parcours tous les blocs alloués
+  for (long i = 0; i < nombreBlocsUtilises; i++) {
+    if (!blocFichierAlloue(inode, i)) {
+      continue; // trou
+    }
+    carte[i / 8] |= 1 << (i % 8);
 
-      // erreur sauvegarde du bloc vide
-      if (resultatSauvegarde != 0) {
-        fprintf(stderr, "SauvegarderInode : erreur savegarde bloc vide %d", i);
-        return -1;
-      }
+    // on recopie les données du bloc (décompressées si besoin) : un bloc corrompu n'est pas resauvegardé
+    if (!lireBlocFichier(inode, i, position)) {
+      fprintf(stderr, "SauvegarderInode : bloc %ld illisible\n", i);
+      free(enregistrement);
+      return -1;
     }
+    uint32_t somme = SommeControle(position, tailleBloc);
+    position = empiler(position + tailleBloc, &somme, sizeof(uint32_t));
   }
-  // forcer écriture des données
-  if (fflush(fichier) != 0) {
-    fprintf(stderr, "SauvergarderInode : erreur lors du fflush\n");
+
+  // une seule écriture pour tout l'inode
+  if (fwrite(enregistrement, 1, tailleEnregistrement, fichier) != tailleEnregistrement) {
+    fprintf(stderr, "SauvegarderInode : erreur d'ecriture\n");
+    free(enregistrement);
     return -1;
   }
+  free(enregistrement);
 
   return 0;
 }
 
-/* V3
+/* V3 & V5
  * Charge toutes les informations d'un inode à partir d'un fichier (sur disque,
  * et préalablement ouvert en lecture et en mode binaire)
+ * Les blocs de l'inode sont pris sur le disque par défaut, seulement pour les blocs alloués.
+ * Leur somme de contrôle est vérifiée au chargement ou à la première lecture (voir VerificationParesseuseDisque).
+ * Un petit fichier sauvegardé en ligne est chargé en ligne, sans bloc.
  * Entrées : l'inode concerné, l'identificateur du fichier
  * Sortie : 0 en cas de succès, -1 en cas d'erreur
  */
@@ -658,68 +2063,699 @@ int ChargerInode(tInode *pInode, FILE *fichier) {
     return -1;
   }
 
-  // on crée un inode temporaire
-  tInode inodeTemporaire = (tInode)malloc(sizeof(struct sInode));
-
-  // erreur allouer inode temporaire
-  if (inodeTemporaire == NULL) {
+  tDisque disque = DisqueParDefaut();
+  if (disque == NULL) {
     fprintf(stderr, "ChargerInode : impossible d'allouer l'inode");
     return -1;
   }
 
-  // chargement des métadonnées de l'inode depuis le fichier champ par champ
-  fread(&inodeTemporaire->numero, sizeof(unsigned int), 1, fichier);
-  fread(&inodeTemporaire->type, sizeof(natureFichier), 1, fichier);
-  fread(&inodeTemporaire->taille, sizeof(long), 1, fichier);
-  fread(&inodeTemporaire->dateDerAcces, sizeof(time_t), 1, fichier);
-  fread(&inodeTemporaire->dateDerModif, sizeof(time_t), 1, fichier);
-  fread(&inodeTemporaire->dateDerModifInode, sizeof(time_t), 1, fichier);  
+  // on crée un inode temporaire à partir des métadonnées
+  tInode inodeTemporaire = chargerMetadonnees(fichier, disque);
+  if (inodeTemporaire == NULL) {
+    fprintf(stderr, "ChargerInode : impossible de lire l'inode\n");
+    return -1;
+  }
 
-  // initialisation des pointeurs de blocs
-  for (int i = 0; i < NB_BLOCS_DIRECTS; i++) {
-    inodeTemporaire->blocDonnees[i] = NULL;
+  // petit fichier sauvegardé en ligne : ses données puis leur somme de contrôle
+  if (inodeTemporaire->taille <= TAILLE_DONNEES_INODE) {
+    uint32_t somme;
+    if (fread(inodeTemporaire->donneesInode, 1, inodeTemporaire->taille, fichier) != (size_t)inodeTemporaire->taille
+        || fread(&somme, sizeof(uint32_t), 1, fichier) != 1) {
+      fprintf(stderr, "ChargerInode : erreur chargement des données\n");
+      DetruireInode(&inodeTemporaire);
+      return -1;
+    }
+    if (somme != SommeControle(inodeTemporaire->donneesInode, inodeTemporaire->taille)) {
+      fprintf(stderr, "ChargerInode : données corrompues (somme de contrôle invalide)\n");
+      DetruireInode(&inodeTemporaire);
+      return -1;
+    }
+    inodeTemporaire->enLigne = true;
+    *pInode = inodeTemporaire;
+    return 0;
   }
 
-  // chargement du contenu de chaque bloc utilisé
-  int nombreBlocsACharger = (inodeTemporaire->taille + TAILLE_BLOC - 1) / TAILLE_BLOC; // calcul le nombre de blocs à charger
-  if (nombreBlocsACharger > NB_BLOCS_DIRECTS) {
-    nombreBlocsACharger = NB_BLOCS_DIRECTS; // petite vérification
+  // carte des blocs alloués (les trous n'ont pas de bloc)
+  long tailleBloc = tailleBlocInode(inodeTemporaire); // taille des blocs du disque
+  long nombreBlocsACharger = (inodeTemporaire->taille + tailleBloc - 1) / tailleBloc; // calcul le nombre de blocs à charger
+  long tailleCarte = (nombreBlocsACharger + 7) / 8;
+  unsigned char *carte = malloc(tailleCarte);
+  if (carte == NULL || fread(carte, 1, tailleCarte, fichier) != (size_t)tailleCarte) {
+    fprintf(stderr, "ChargerInode : erreur chargement carte des blocs\n");
+    free(carte);
+    DetruireInode(&inodeTemporaire);
+    return -1;
   }
 
-  // parcours tous les blocs
-  for (int i = 0; i < nombreBlocsACharger; i++) {
-    // création d'un nouveau bloc
-    inodeTemporaire->blocDonnees[i] = CreerBloc();
+  // parcours tous les blocs alloués
+  tNumeroBloc aPartirDe = BLOC_NUL;
+  for (long i = 0; i < nombreBlocsACharger; i++) {
+    if ((carte[i / 8] & (1 << (i % 8))) == 0) {
+      continue; // trou
+    }
+
+    // allocation d'un nouveau bloc, à la suite du précédent (il prolonge alors la même étendue)
+    tNumeroBloc numero = AllouerBlocDisque(disque, aPartirDe);
 
     // erreur création bloc
-    if (inodeTemporaire->blocDonnees[i] == NULL) {
-      fprintf(stderr, "ChargerInode : erreur création bloc %d\n", i);
+    if (numero == BLOC_NUL) {
+      fprintf(stderr, "ChargerInode : erreur création bloc %ld\n", i);
+      free(carte);
       DetruireInode(&inodeTemporaire); // on détruit l'inode
       return -1;
     }
+    if (changerBlocFichier(inodeTemporaire, i, numero) != 0) {
+      fprintf(stderr, "ChargerInode : erreur allocation\n");
+      LibererBlocDisque(disque, numero);
+      free(carte);
+      DetruireInode(&inodeTemporaire);
+      return -1;
+    }
 
-    // charger données bloc vers fichier
-    int resultatChargement = ChargerBloc(inodeTemporaire->blocDonnees[i], TAILLE_BLOC, fichier);
+    // charger les données du fichier directement dans le bloc, puis sa somme de contrôle
+    tBloc bloc = AdresseBlocDisque(disque, numero);
+    uint32_t somme;
+    if (fread(bloc, 1, tailleBloc, fichier) != (size_t)tailleBloc
+        || fread(&somme, sizeof(uint32_t), 1, fichier) != 1) {
+      fprintf(stderr, "ChargerInode : erreur chargement bloc %ld\n", i);
+      free(carte);
+      DetruireInode(&inodeTemporaire); // on détruit l'inode
+      return -1;
+    }
 
-    // erreur chargement bloc
-    if (resultatChargement != 0) {
-      fprintf(stderr, "ChargerInode : erreur chargement bloc %d\n", i);
+    // verif de la somme (tout de suite, ou à la première lecture en vérification paresseuse)
+    if (VerifierBlocChargeDisque(disque, numero, somme) != 0) {
+      fprintf(stderr, "ChargerInode : bloc %ld corrompu (somme de contrôle invalide)\n", i);
+      free(carte);
       DetruireInode(&inodeTemporaire); // on détruit l'inode
       return -1;
     }
+    aPartirDe = numero + 1;
   }
-  
+  free(carte);
+
   // attribue l'inode au pointeur
   *pInode = inodeTemporaire;
 
   return 0;
 }
 
+/* V5
+ * Sauvegarde les métadonnées d'un inode, son mode de stockage et la carte de ses blocs (ses étendues),
+ * mais pas ses données, qui sont sauvegardées avec le disque (sauf celles d'un fichier en ligne,
+ * rangées à la place des étendues).
+ * Entrées : l'inode concerné, l'identificateur du fichier
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+int SauvegarderMetaInode(tInode inode, FILE *fichier) {
+  if (inode == NULL || fichier == NULL) {
+    fprintf(stderr, "SauvegarderMetaInode : parametre invalide\n");
+    return -1;
+  }
+
+  // les ajouts en attente font partie du fichier sauvegardé
+  if (publierAjouts(inode, true) != 0) {
+    return -1;
+  }
+
+  // seules les trames jusqu'à la dernière compressée sont sauvegardées
+  long nbTrames = inode->nbTrames;
+  while (nbTrames > 0 && inode->tailleTrame[nbTrames - 1] == 0) {
+    nbTrames--;
+  }
+
+  // métadonnées, mode de stockage, trames puis étendues (ou données en ligne) : un seul enregistrement écrit
+  // en une fois (sur la pile tant que les étendues tiennent dans l'inode et qu'aucune trame n'est compressée)
+  unsigned char tampon[TAILLE_META_INODE + sizeof(inode->etenduesInode)];
+  long tailleEnLigne = inode->enLigne ? inode->taille : 0;
+  size_t tailleEnregistrement = TAILLE_META_INODE + nbTrames * sizeof(long)
+                                + inode->nbEtendues * sizeof(struct sEtendue) + tailleEnLigne;
+  unsigned char *enregistrement = tampon;
+  if (tailleEnregistrement > sizeof(tampon)) {
+    enregistrement = malloc(tailleEnregistrement);
+    if (enregistrement == NULL) {
+      fprintf(stderr, "SauvegarderMetaInode : erreur allocation\n");
+      return -1;
+    }
+  }
+
+  int mode = (inode->compresse ? MODE_COMPRESSE : 0) | (inode->enLigne ? MODE_EN_LIGNE : 0);
+  uint32_t nbTramesSauvees = (uint32_t)nbTrames;
+  uint32_t nbEtendues = (uint32_t)inode->nbEtendues;
+  unsigned char *position = empilerMetadonnees(inode, enregistrement);
+  position = empiler(position, &mode, sizeof(int));
+  position = empiler(position, &nbTramesSauvees, sizeof(uint32_t));
+  position = empiler(position, &nbEtendues, sizeof(uint32_t));
+  if (nbTrames > 0) {
+    position = empiler(position, inode->tailleTrame, nbTrames * sizeof(long));
+  }
+  position = empiler(position, inode->etendues, inode->nbEtendues * sizeof(struct sEtendue));
+  empiler(position, inode->donneesInode, tailleEnLigne);
+  int resultat = 0;
+  if (fwrite(enregistrement, tailleEnregistrement, 1, fichier) != 1) {
+    fprintf(stderr, "SauvegarderMetaInode : erreur d'ecriture\n");
+    resultat = -1;
+  }
+
+  if (enregistrement != tampon) {
+    free(enregistrement);
+  }
+  return resultat;
+}
+
+// fonction auxiliaire qui vérifie la carte d'un inode chargé : étendues non vides, triées et sans chevauchement,
+// dans les limites du fichier et désignant des blocs du disque (true si elle est cohérente)
+static bool carteValide(tInode inode, tDisque disque) {
+  long nbBlocsMax = nbBlocsMaxFichier(TailleBlocDisque(disque));
+  long finPrecedente = 0;
+  for (long k = 0; k < inode->nbEtendues; k++) {
+    struct sEtendue *etendue = &inode->etendues[k];
+    if (etendue->nbBlocs == 0 || etendue->premierBloc < finPrecedente || finEtendue(etendue) > nbBlocsMax
+        || etendue->numero == BLOC_NUL || (long)etendue->numero + etendue->nbBlocs > (long)NbBlocsDisque(disque)) {
+      return false;
+    }
+    finPrecedente = finEtendue(etendue);
+  }
+  return true;
+}
+
+// fonction auxiliaire qui libère un inode dont le chargement a échoué (ses blocs restent à leur disque)
+static void libererInodeCharge(tInode inode) {
+  libererCarte(inode);
+  free(inode->tailleTrame);
+  free(inode);
+}
+
+/* V5
+ * Charge un inode sauvegardé par SauvegarderMetaInode, dont les blocs sont sur un disque déjà chargé.
+ * Entrées : l'inode concerné, l'identificateur du fichier, le disque de l'inode
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+int ChargerMetaInode(tInode *pInode, FILE *fichier, tDisque disque) {
+  if (pInode == NULL || fichier == NULL || disque == NULL) {
+    fprintf(stderr, "ChargerMetaInode : parametre invalide\n");
+    return -1;
+  }
+
+  tInode inode = chargerMetadonnees(fichier, disque);
+  if (inode == NULL) {
+    fprintf(stderr, "ChargerMetaInode : impossible de lire l'inode\n");
+    return -1;
+  }
+
+  // mode de stockage, nombres de trames et d'étendues : la partie fixe de l'enregistrement en une seule lecture
+  int mode;
+  uint32_t nbTrames, nbEtendues;
+  unsigned char enregistrement[TAILLE_META_INODE - TAILLE_METADONNEES];
+  if (fread(enregistrement, sizeof(enregistrement), 1, fichier) != 1) {
+    fprintf(stderr, "ChargerMetaInode : erreur de lecture\n");
+    libererInodeCharge(inode);
+    return -1;
+  }
+  const unsigned char *position = depiler(enregistrement, &mode, sizeof(int));
+  position = depiler(position, &nbTrames, sizeof(uint32_t));
+  depiler(position, &nbEtendues, sizeof(uint32_t));
+
+  inode->compresse = (mode & MODE_COMPRESSE) != 0;
+  inode->enLigne = (mode & MODE_EN_LIGNE) != 0;
+
+  // un fichier ne peut pas avoir plus de trames ni d'étendues que de blocs, ni d'étendues s'il est en ligne
+  long nbBlocsMax = nbBlocsMaxFichier(TailleBlocDisque(disque));
+  if (nbTrames > nbBlocsMax / NB_BLOCS_TRAME + 1 || nbEtendues > nbBlocsMax
+      || (inode->enLigne && (nbEtendues != 0 || inode->taille > TAILLE_DONNEES_INODE))) {
+    fprintf(stderr, "ChargerMetaInode : nombre de trames ou d'etendues invalide\n");
+    libererInodeCharge(inode);
+    return -1;
+  }
+
+  // les tailles des trames
+  if (reserverTrames(inode, nbTrames) != 0
+      || fread(inode->tailleTrame, sizeof(long), nbTrames, fichier) != nbTrames) {
+    fprintf(stderr, "ChargerMetaInode : erreur de lecture\n");
+    libererInodeCharge(inode);
+    return -1;
+  }
+
+  // les étendues, lues directement dans la carte (un tableau alloué si elles ne tiennent pas dans l'inode)
+  if (nbEtendues > NB_ETENDUES_INODE) {
+    inode->etendues = malloc(nbEtendues * sizeof(struct sEtendue));
+    if (inode->etendues == NULL) {
+      fprintf(stderr, "ChargerMetaInode : erreur allocation\n");
+      libererInodeCharge(inode);
+      return -1;
+    }
+    inode->capaciteEtendues = nbEtendues;
+  }
+  inode->nbEtendues = nbEtendues;
+  if (fread(inode->etendues, sizeof(struct sEtendue), nbEtendues, fichier) != nbEtendues) {
+    fprintf(stderr, "ChargerMetaInode : erreur de lecture\n");
+    libererInodeCharge(inode);
+    return -1;
+  }
+
+  // les données d'un fichier en ligne
+  if (inode->enLigne && fread(inode->donneesInode, 1, inode->taille, fichier) != (size_t)inode->taille) {
+    fprintf(stderr, "ChargerMetaInode : erreur de lecture\n");
+    libererInodeCharge(inode);
+    return -1;
+  }
+
+  // verif que les tailles de trames tiennent dans leurs blocs
+  for (long t = 0; t < inode->nbTrames; t++) {
+    if (inode->tailleTrame[t] < 0 || inode->tailleTrame[t] > NB_BLOCS_TRAME * TailleBlocDisque(disque)) {
+      fprintf(stderr, "ChargerMetaInode : taille de trame invalide\n");
+      libererInodeCharge(inode);
+      return -1;
+    }
+  }
+
+  // verif que les étendues désignent des blocs du disque, sans se chevaucher
+  if (!carteValide(inode, disque)) {
+    fprintf(stderr, "ChargerMetaInode : numero de bloc invalide\n");
+    libererInodeCharge(inode);
+    return -1;
+  }
+
+  *pInode = inode;
+
+  return 0;
+}
+
+/* V5
+ * Associe un disque à un inode : les blocs créés ensuite pour cet inode y seront pris.
+ * Entrées : l'inode concerné, le disque (NULL pour le disque par défaut)
+ * Sortie : aucune
+ */
+void AssocierDisqueInode(tInode inode, tDisque disque) {
+  if (inode != NULL) {
+    inode->disque = (disque != NULL) ? disque : DisqueParDefaut();
+  }
+}
+
+/* V5
+ * Oublie les blocs d'un inode sans les rendre à leur disque.
+ * Entrée : l'inode concerné
+ * Sortie : aucune
+ */
+void DetacherBlocsInode(tInode inode) {
+  if (inode == NULL) {
+    return;
+  }
+
+  // les blocs seront libérés avec leur disque (les ajouts en attente sont abandonnés avec eux)
+  libererCarte(inode);
+  oublierTramesCache(inode);
+  free(inode->queue);
+  inode->queue = NULL;
+  inode->remplissageQueue = 0;
+  inode->queueModifiee = false;
+}
+
+/* V5
+ * Passe un inode en mode compressé : ses blocs sont regroupés en trames de NB_BLOCS_TRAME blocs
+ * compressées à l'écriture et décompressées à la lecture. Les données déjà présentes sont compressées.
+ * Entrée : l'inode concerné
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+int ActiverCompressionInode(tInode inode) {
+  if (inode == NULL) {
+    fprintf(stderr, "ActiverCompressionInode : l'inode n'existe pas\n");
+    return -1;
+  }
+
+  // déjà compressé
+  if (inode->compresse) {
+    return 0;
+  }
+
+  // les ajouts en attente sont écrits avant de changer de mode de stockage
+  if (publierAjouts(inode, false) != 0) {
+    return -1;
+  }
+
+  // fichier en ligne : rien à recompresser, il le sera en passant dans des blocs
+  if (inode->enLigne) {
+    inode->compresse = true;
+    return 0;
+  }
+
+  // les blocs actuels forment des trames stockées telles quelles : on les recompresse une par une
+  inode->compresse = true;
+  long tailleTrameMax = NB_BLOCS_TRAME * tailleBlocInode(inode);
+  unsigned char *tampon = malloc(tailleTrameMax);
+  if (tampon == NULL) {
+    fprintf(stderr, "ActiverCompressionInode : erreur allocation\n");
+    return -1;
+  }
+  for (long t = 0; tailleUtileTrame(inode, t) > 0; t++) {
+    unsigned char *donnees = trameDecompressee(inode, t);
+    if (donnees == NULL) {
+      free(tampon);
+      return -1;
+    }
+    memcpy(tampon, donnees, tailleTrameMax);
+    if (stockerTrame(inode, t, tampon) != 0) {
+      free(tampon);
+      return -1;
+    }
+  }
+  free(tampon);
+
+  return 0;
+}
+
+/* V5
+ * Indique si un inode est en mode compressé.
+ * Entrée : l'inode concerné
+ * Sortie : true s'il est compressé, false sinon
+ */
+bool CompressionInode(tInode inode) {
+  return inode != NULL && inode->compresse;
+}
+
+/* V5
+ * Choisit quand les lectures d'un inode mettent à jour sa date de dernier accès
+ * (DATES_STRICTES par défaut, voir politiqueDates). Les dates de modification suivent toujours les écritures.
+ * Entrées : l'inode concerné, la politique
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+int PolitiqueDatesInode(tInode inode, politiqueDates politique) {
+  if (inode == NULL || politique < DATES_STRICTES || politique > SANS_DATE_ACCES) {
+    fprintf(stderr, "PolitiqueDatesInode : parametre invalide\n");
+    return -1;
+  }
+  inode->politiqueDates = politique;
+  return 0;
+}
+
+/* V5
+ * Crée un clone d'un inode (copie instantanée) : le clone partage les blocs de la source,
+ * chaque bloc recevant une référence de plus. Le coût est celui de la recopie des numéros de blocs,
+ * quelle que soit la taille du fichier. Le partage d'un bloc n'est rompu qu'à la première écriture
+ * dans ce bloc, par l'un ou l'autre des inodes (copie sur écriture).
+ * Entrées : l'inode source, le numéro du clone
+ * Retour : le clone, ou NULL en cas de problème
+ */
+tInode CloneInode(tInode source, unsigned int numero) {
+  if (source == NULL) {
+    fprintf(stderr, "CloneInode : l'inode source n'existe pas\n");
+    return NULL;
+  }
+
+  // le clone reçoit aussi les ajouts en attente de la source
+  if (publierAjouts(source, true) != 0) {
+    return NULL;
+  }
+
+  tInode clone = CreerInode(numero, source->type);
+  if (clone == NULL) {
+    return NULL;
+  }
+
+  // même disque, même taille et même mode de stockage (les trames compressées sont partagées telles quelles)
+  clone->disque = source->disque;
+  clone->taille = source->taille;
+  clone->compresse = source->compresse;
+  clone->politiqueDates = source->politiqueDates;
+  if (reserverTrames(clone, source->nbTrames) != 0) {
+    fprintf(stderr, "CloneInode : erreur allocation\n");
+    DetruireInode(&clone);
+    return NULL;
+  }
+  if (source->nbTrames > 0) {
+    memcpy(clone->tailleTrame, source->tailleTrame, source->nbTrames * sizeof(long));
+  }
+
+  // fichier en ligne : ses données sont recopiées dans le clone
+  if (source->enLigne) {
+    memcpy(clone->donneesInode, source->donneesInode, source->taille);
+    return clone;
+  }
+  clone->enLigne = false;
+
+  // les blocs de chaque étendue de la source, ajoutés un par un à la carte du clone (qui ne contient
+  // ainsi que des blocs dont il détient une référence, même en cas d'erreur)
+  for (long k = 0; k < source->nbEtendues; k++) {
+    struct sEtendue etendue = source->etendues[k];
+    for (uint32_t j = 0; j < etendue.nbBlocs; j++) {
+      long i = (long)etendue.premierBloc + j;
+      tNumeroBloc numeroBloc = etendue.numero + j;
+
+      // une référence de plus sur le bloc de la source, ou une copie si son nombre de références est saturé
+      tNumeroBloc numeroClone = numeroBloc;
+      if (PartagerBlocDisque(clone->disque, numeroBloc) != 0) {
+        numeroClone = AllouerBlocDisque(clone->disque, numeroBloc);
+        if (numeroClone == BLOC_NUL) {
+          fprintf(stderr, "CloneInode : erreur allocation\n");
+          DetruireInode(&clone);
+          return NULL;
+        }
+      }
+      if (changerBlocFichier(clone, i, numeroClone) != 0) {
+        fprintf(stderr, "CloneInode : erreur allocation\n");
+        LibererBlocDisque(clone->disque, numeroClone);
+        DetruireInode(&clone);
+        return NULL;
+      }
+      if (numeroClone != numeroBloc && CopierBlocDisque(clone->disque, numeroClone, numeroBloc) != 0) {
+        fprintf(stderr, "CloneInode : erreur lecture bloc %ld\n", i);
+        DetruireInode(&clone);
+        return NULL;
+      }
+    }
+  }
+
+  return clone;
+}
+
 /* V4
  * Retourne la taille maximale d'un fichier contenu dans un inode.
  * Entrée : l'inode concerné,
  * Sortie : la taille du plus grand fichier de cet inode
  */
 long TailleMaxFichier(void) {
-  return NB_BLOCS_DIRECTS * TAILLE_BLOC;
-}
\ No newline at end of file
+  return TailleMaxFichierBlocs(TAILLE_BLOC);
+}
+
+/* V5
+ * Retourne la taille maximale d'un fichier dont les blocs ont une taille donnée : celle d'un inode
+ * à 10 blocs directs et trois niveaux de blocs d'indirection (simple, double, triple) remplis de numéros
+ * de 32 bits, dans la limite de 2^32 - 1 blocs (280 192 octets pour des blocs de 64 octets).
+ * Entrée : la taille des blocs
+ * Sortie : la taille du plus grand fichier
+ */
+long TailleMaxFichierBlocs(long tailleBloc) {
+  return nbBlocsMaxFichier(tailleBloc) * tailleBloc;
+}
+
+/* V5
+ * Retourne la taille maximale du fichier contenu dans un inode donné,
+ * qui dépend de la taille des blocs de son disque.
+ * Entrée : l'inode concerné
+ * Sortie : la taille du plus grand fichier de cet inode
+ */
+long TailleMaxFichierInode(tInode inode) {
+  if (inode == NULL) {
+    return TailleMaxFichier();
+  }
+
+  return TailleMaxFichierBlocs(tailleBlocInode(inode));
+}
+
+/* ---------------------------------------------------------------------------
+ * Lecture sans copie : les vues pointent dans les blocs du disque, épinglés jusqu'à LibererVuesInode.
+ * Deux blocs voisins en mémoire (blocs consécutifs d'une étendue, sur un disque en mémoire) ne font qu'une vue.
+ * ------------------------------------------------------------------------- */
+
+// fonction auxiliaire qui ajoute une vue, ou prolonge la dernière si les octets la suivent en mémoire
+// (0 si ok, -1 en cas de problème d'allocation)
+static int ajouterVue(tVuesInode vues, const unsigned char *adresse, long taille) {
+  if (vues->nbVues > 0) {
+    struct sVue *derniere = &vues->vues[vues->nbVues - 1];
+    if (derniere->adresse + derniere->taille == adresse) {
+      derniere->taille += taille;
+      return 0;
+    }
+  }
+  if (vues->nbVues == vues->capaciteVues) {
+    long capacite = (vues->capaciteVues > 0) ? vues->capaciteVues * 2 : NB_VUES_INITIAL;
+    struct sVue *tableau = realloc(vues->vues, capacite * sizeof(struct sVue));
+    if (tableau == NULL) {
+      return -1;
+    }
+    vues->vues = tableau;
+    vues->capaciteVues = capacite;
+  }
+  vues->vues[vues->nbVues].adresse = adresse;
+  vues->vues[vues->nbVues].taille = taille;
+  vues->nbVues++;
+  return 0;
+}
+
+// fonction auxiliaire qui épingle des blocs consécutifs du disque pour les vues (retourne l'adresse du premier,
+// NULL s'il ne peut pas l'être ; *pNbBlocs : nombre de blocs voulus, remplacé par le nombre épinglés)
+static const unsigned char *epinglerBlocsVues(tVuesInode vues, tNumeroBloc premier, long *pNbBlocs) {
+  if (vues->nbEpingles == vues->capaciteEpingles) {
+    long capacite = (vues->capaciteEpingles > 0) ? vues->capaciteEpingles * 2 : NB_VUES_INITIAL;
+    struct sEpingle *tableau = realloc(vues->epingles, capacite * sizeof(struct sEpingle));
+    if (tableau == NULL) {
+      return NULL;
+    }
+    vues->epingles = tableau;
+    vues->capaciteEpingles = capacite;
+  }
+  const unsigned char *bloc = EpinglerBlocsDisque(vues->disque, premier, pNbBlocs);
+  if (bloc != NULL) {
+    vues->epingles[vues->nbEpingles++] = (struct sEpingle){bloc, premier, *pNbBlocs};
+  }
+  return bloc;
+}
+
+/* V5
+ * Lit sans copie taille octets d'un inode à partir d'un décalage (sans dépasser la fin du fichier) :
+ * les vues pointent dans les blocs du disque, épinglés jusqu'à LibererVuesInode, ou dans l'inode pour un fichier
+ * en ligne ; les trous, les fichiers compressés et les blocs non épinglables sont recopiés dans une zone des vues.
+ * Entrées : l'inode, la taille en octets, le décalage dans le fichier
+ * Retour : les vues (aucune si le décalage est au-delà de la fin du fichier), NULL en cas d'erreur
+ */
+tVuesInode LireVuesInode(tInode inode, long taille, long decalage) {
+  if (inode == NULL || taille < 0 || decalage < 0) {
+    fprintf(stderr, "LireVuesInode : parametre invalide\n");
+    return NULL;
+  }
+  // les ajouts en attente sont d'abord écrits (voir AjouterDonneesInode)
+  publierAjouts(inode, true);
+
+  tVuesInode vues = malloc(sizeof(struct sVuesInode));
+  if (vues == NULL) {
+    fprintf(stderr, "LireVuesInode : erreur allocation\n");
+    return NULL;
+  }
+  vues->disque = inode->disque;
+  vues->vues = NULL;
+  vues->nbVues = 0;
+  vues->capaciteVues = 0;
+  vues->epingles = NULL;
+  vues->nbEpingles = 0;
+  vues->capaciteEpingles = 0;
+  vues->copie = NULL;
+
+  // on ne lit pas au-delà de la fin du fichier
+  long tailleALire = (decalage < inode->taille) ? inode->taille - decalage : 0;
+  if (taille < tailleALire) {
+    tailleALire = taille;
+  }
+  if (tailleALire == 0) {
+    return vues;
+  }
+
+  // fichier en ligne : une seule vue, dans l'inode
+  if (inode->enLigne) {
+    if (ajouterVue(vues, inode->donneesInode + decalage, tailleALire) != 0) {
+      fprintf(stderr, "LireVuesInode : erreur allocation\n");
+      LibererVuesInode(&vues);
+      return NULL;
+    }
+    mettreAJourDateAccess(inode);
+    return vues;
+  }
+
+  // fichier compressé : les trames décompressées ne restent pas dans leur cache, on les recopie
+  if (inode->compresse) {
+    vues->copie = malloc(tailleALire);
+    long octetsLus = (vues->copie != NULL) ? lireDonneesCompressees(inode, vues->copie, tailleALire, decalage) : -1;
+    if (octetsLus < 0 || (octetsLus > 0 && ajouterVue(vues, vues->copie, octetsLus) != 0)) {
+      fprintf(stderr, "LireVuesInode : erreur allocation\n");
+      LibererVuesInode(&vues);
+      return NULL;
+    }
+    mettreAJourDateAccess(inode);
+    return vues;
+  }
+
+  long tailleBloc = tailleBlocInode(inode);
+  long position = decalage;
+  long fin = decalage + tailleALire;
+
+  // suite de blocs par suite de blocs : chaque suite est épinglée (d'un coup en mémoire), ou recopiée
+  // bloc par bloc dans la zone des vues si elle ne peut pas l'être ; un trou est mis à zéro d'un coup
+  while (position < fin) {
+    long decalageDansBloc = position % tailleBloc;
+    long suite;
+    tNumeroBloc numero = blocFichier(inode, position / tailleBloc, &suite);
+    long nbBlocs = (decalageDansBloc + (fin - position) + tailleBloc - 1) / tailleBloc;
+    if (nbBlocs > suite) {
+      nbBlocs = suite;
+    }
+
+    const unsigned char *bloc = (numero != BLOC_NUL) ? epinglerBlocsVues(vues, numero, &nbBlocs) : NULL;
+    const unsigned char *adresse;
+    if (bloc == NULL && numero != BLOC_NUL) {
+      nbBlocs = 1;
+    }
+    long morceau = nbBlocs * tailleBloc - decalageDansBloc;
+    if (morceau > fin - position) {
+      morceau = fin - position;
+    }
+    if (bloc != NULL) {
+      adresse = bloc + decalageDansBloc;
+    } else {
+      if (vues->copie == NULL && (vues->copie = malloc(tailleALire)) == NULL) {
+        fprintf(stderr, "LireVuesInode : erreur allocation\n");
+        LibererVuesInode(&vues);
+        return NULL;
+      }
+      unsigned char *place = vues->copie + (position - decalage);
+      if (numero == BLOC_NUL) {
+        // trou dans le fichier : se lit à zéro
+        memset(place, 0, morceau);
+      } else if (LireBlocDisque(inode->disque, numero, decalageDansBloc, place, morceau) != morceau) {
+        break; // bloc illisible : la lecture s'arrête là
+      }
+      adresse = place;
+    }
+
+    if (ajouterVue(vues, adresse, morceau) != 0) {
+      fprintf(stderr, "LireVuesInode : erreur allocation\n");
+      LibererVuesInode(&vues);
+      return NULL;
+    }
+    position += morceau;
+  }
+
+  mettreAJourDateAccess(inode);
+  return vues;
+}
+
+/* V5
+ * Retourne le tableau des vues d'une lecture sans copie.
+ * Entrées : les vues, l'adresse où ranger leur nombre
+ * Retour : le tableau des vues (valable jusqu'à LibererVuesInode)
+ */
+const struct sVue *VuesInode(tVuesInode vues, long *pNbVues) {
+  if (pNbVues != NULL) {
+    *pNbVues = (vues != NULL) ? vues->nbVues : 0;
+  }
+  return (vues != NULL) ? vues->vues : NULL;
+}
+
+/* V5
+ * Relâche les blocs épinglés par une lecture sans copie et détruit ses vues.
+ * Entrée : les vues à libérer
+ * Retour : aucun
+ */
+void LibererVuesInode(tVuesInode *pVues) {
+  if (pVues == NULL || *pVues == NULL) {
+    return;
+  }
+
+  for (long i = 0; i < (*pVues)->nbEpingles; i++) {
+    struct sEpingle *epingle = &(*pVues)->epingles[i];
+    DesepinglerBlocsDisque((*pVues)->disque, epingle->adresse, epingle->premier, epingle->nbBlocs);
+  }
+  free((*pVues)->epingles);
+  free((*pVues)->vues);
+  free((*pVues)->copie);
+  free(*pVues);
+  *pVues = NULL;
+}
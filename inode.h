@@ -10,6 +10,7 @@
 
 #include <time.h>
 #include <stdio.h>
+#include "disque.h"
 
 // Taille maximale du nom d'un fichier dans un système de fichiers
 #define TAILLE_NOM_FICHIER 24
@@ -17,6 +18,31 @@
 // Type représentant un inode
 typedef struct sInode *tInode;
 
+// Une vue sur une suite d'octets d'un fichier, lue en place sans copie (à la manière d'un iovec)
+struct sVue
+{
+  // L'adresse des octets (à ne pas modifier)
+  const unsigned char *adresse;
+  // Le nombre d'octets
+  long taille;
+};
+
+// Type public représentant les vues d'une lecture sans copie (voir LireVuesInode)
+typedef struct sVuesInode *tVuesInode;
+
+// Un segment d'une lecture ou d'une écriture vectorisée (voir LireDonneesInodeV et EcrireDonneesInodeV)
+struct sSegment
+{
+  // La zone en mémoire où lire, ou d'où écrire
+  unsigned char *contenu;
+  // Le nombre d'octets demandés
+  long taille;
+  // La position dans le fichier
+  long decalage;
+  // Le nombre d'octets effectivement lus ou écrits (rempli par l'appel)
+  long traites;
+};
+
 // Type représentant la nature d'un fichier dans un système de fichiers
 // ORDINAIRE : Fichier ordinaire
 // REPERTOIRE : Répertoire
@@ -28,6 +54,17 @@ typedef enum
     AUTRE
 } natureFichier;
 
+// Politique de mise à jour de la date de dernier accès par les lectures (à la manière des options de montage)
+// DATES_STRICTES : chaque lecture la met à jour (strictatime)
+// DATES_RELATIVES : seulement si elle précède la dernière modification ou date de plus d'un jour (relatime)
+// SANS_DATE_ACCES : jamais (noatime)
+typedef enum
+{
+    DATES_STRICTES,
+    DATES_RELATIVES,
+    SANS_DATE_ACCES
+} politiqueDates;
+
 /* V1
  * Crée et retourne un inode.
  * Entrées : numéro de l'inode et le type de fichier qui y est associé
@@ -93,7 +130,7 @@ extern void AfficherInode(tInode inode);
 
 /* V1
  * Copie à l'adresse contenu les taille octets stockés dans un inode.
- * Si taille est supérieure à la taille d’un bloc, seuls les TAILLE_BLOC premiers octets doivent être copiés.
+ * Si taille est supérieure à la taille d’un bloc, seuls les premiers octets tenant dans un bloc doivent être copiés.
  * Entrées : l'inode, l'adresse de la zone où recopier et la taille en octets de l'inode
  * Retour : le nombre d'octets effectivement lus dans l'inode ou -1 en cas d'erreur
  */
@@ -101,14 +138,15 @@ extern long LireDonneesInode1bloc(tInode inode, unsigned char *contenu, long tai
 
 /* V1
  * Copie dans un inode les taille octets situés à l’adresse contenu.
- * Si taille est supérieure à la taille d’un bloc, seuls les TAILLE_BLOC premiers octets doivent être copiés.
+ * Si taille est supérieure à la taille d’un bloc, seuls les premiers octets tenant dans un bloc doivent être copiés.
  * Entrées : l'inode, l'adresse de la zone à recopier et sa taille en octets
  * Retour : le nombre d'octets effectivement écrits dans l'inode ou -1 en cas d'erreur
  */
 extern long EcrireDonneesInode1bloc(tInode inode, unsigned char *contenu, long taille);
 
-/* V3
+/* V3 & V5
  * Lit les données d'un inode avec décalage, et les stocke à une adresse donnée
+ * Les trous du fichier (blocs jamais écrits) se lisent à zéro, sans allouer de bloc.
  * Entrées : l'inode d'où les données sont lues, la zone où recopier ces données, la taille en octets
  * des données à lire et le décalage à appliquer (voir énoncé)
  * Sortie : le nombre d'octets effectivement lus, 0 si le décalage est au-delà de la taille
@@ -123,22 +161,128 @@ extern long LireDonneesInode(tInode inode, unsigned char *contenu, long taille,
  */
 extern long EcrireDonneesInode(tInode inode, unsigned char *contenu, long taille, long decalage);
 
-/* V3
+/* V5
+ * Lit les données d'un inode dans plusieurs zones, chacune avec son propre décalage (à la manière de preadv) :
+ * une seule passe sur les segments, dans l'ordre, et une seule mise à jour de la date d'accès.
+ * Entrées : l'inode, le tableau des segments (le champ traites de chacun reçoit le nombre d'octets lus), leur nombre
+ * Sortie : le nombre total d'octets effectivement lus, ou -1 en cas d'erreur
+ */
+extern long LireDonneesInodeV(tInode inode, struct sSegment segments[], long nbSegments);
+
+/* V5
+ * Ecrit dans un inode les données de plusieurs zones, chacune à son propre décalage (à la manière de pwritev) :
+ * une seule passe sur les segments, dans l'ordre (le dernier l'emporte là où ils se recouvrent), et une seule
+ * mise à jour des dates ; l'écriture s'arrête au premier segment en erreur ou écrit en partie.
+ * Entrées : l'inode, le tableau des segments (le champ traites de chacun reçoit le nombre d'octets écrits), leur nombre
+ * Sortie : le nombre total d'octets effectivement écrits, ou -1 en cas d'erreur avant toute écriture
+ */
+extern long EcrireDonneesInodeV(tInode inode, struct sSegment segments[], long nbSegments);
+
+/* V5
+ * Ajoute des données à la fin d'un inode (journaux, petits enregistrements répétés) : le bloc de la fin du fichier
+ * reste en mémoire et rassemble les petits ajouts, il n'est écrit qu'une fois plein. Taille en tient compte, mais
+ * les dates ne sont mises à jour qu'à la publication des ajouts (ViderAjoutsInode, ou tout autre accès aux données
+ * de l'inode, ou sa sauvegarde).
+ * Entrées : l'inode, l'adresse des données à ajouter, leur taille en octets
+ * Sortie : le nombre d'octets effectivement ajoutés (limité par la taille maximale du fichier), ou -1 en cas d'erreur
+ */
+extern long AjouterDonneesInode(tInode inode, unsigned char *contenu, long taille);
+
+/* V5
+ * Publie les ajouts en attente d'un inode : la fin du fichier est écrite sur le disque et les dates
+ * de modification sont mises à jour.
+ * Entrée : l'inode concerné
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int ViderAjoutsInode(tInode inode);
+
+/* V3 & V5
  * Sauvegarde toutes les informations contenues dans un inode dans un fichier (sur disque,
- * et préalablement ouvert en écriture et en mode binaire)
+ * et préalablement ouvert en écriture et en mode binaire) : les métadonnées, la carte
+ * des blocs alloués (un bit par bloc) puis les blocs alloués seulement (les trous ne sont pas écrits),
+ * chacun suivi de sa somme de contrôle CRC32C. L'inode est écrit en une seule fois (un enregistrement),
+ * sans vider le fichier (fflush ou fclose de l'appelant, une fois pour tous les inodes).
+ * Un fichier d'au plus 96 octets est écrit en ligne : ses données à la suite des métadonnées, avec une seule somme.
  * Entrées : l'inode concerné, l'identificateur du fichier
  * Sortie : 0 en cas de succès, -1 en cas d'erreur
  */
 extern int SauvegarderInode(tInode inode, FILE *fichier);
 
-/* V3
+/* V3 & V5
  * Charge toutes les informations d'un inode à partir d'un fichier (sur disque,
  * et préalablement ouvert en lecture et en mode binaire)
+ * Les blocs de l'inode sont pris sur le disque par défaut, et seulement pour les blocs alloués (les trous restent des trous).
+ * Leur somme de contrôle est vérifiée au chargement, ou à la première lecture (voir VerificationParesseuseDisque) :
+ * un bloc corrompu est une erreur. Un fichier sauvegardé en ligne est chargé en ligne, sans bloc.
  * Entrées : l'inode concerné, l'identificateur du fichier
  * Sortie : 0 en cas de succès, -1 en cas d'erreur
  */
 extern int ChargerInode(tInode *pInode, FILE *fichier);
 
+/* V5
+ * Sauvegarde les métadonnées d'un inode, son mode de stockage et la carte de ses blocs (ses étendues : suites
+ * de blocs consécutifs sur le disque), mais pas ses données, qui sont sauvegardées avec le disque (voir SauvegarderDisque),
+ * sauf celles d'un fichier en ligne, écrites à la place des étendues.
+ * Entrées : l'inode concerné, l'identificateur du fichier
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int SauvegarderMetaInode(tInode inode, FILE *fichier);
+
+/* V5
+ * Charge un inode sauvegardé par SauvegarderMetaInode, dont les blocs sont sur un disque déjà chargé.
+ * Entrées : l'inode concerné, l'identificateur du fichier, le disque de l'inode
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int ChargerMetaInode(tInode *pInode, FILE *fichier, tDisque disque);
+
+/* V5
+ * Associe un disque à un inode : les blocs créés ensuite pour cet inode y seront pris.
+ * A faire avant toute écriture dans l'inode.
+ * Entrées : l'inode concerné, le disque (NULL pour le disque par défaut)
+ * Sortie : aucune
+ */
+extern void AssocierDisqueInode(tInode inode, tDisque disque);
+
+/* V5
+ * Oublie les blocs d'un inode sans les rendre à leur disque.
+ * Sert à détruire rapidement des inodes dont le disque va être détruit d'un coup (DetruireDisque).
+ * Entrée : l'inode concerné
+ * Sortie : aucune
+ */
+extern void DetacherBlocsInode(tInode inode);
+
+/* V5
+ * Passe un inode en mode compressé : ses blocs sont regroupés en trames compressées
+ * à l'écriture et décompressées à la lecture (les dernières trames lues restent en cache).
+ * Les données déjà présentes sont compressées.
+ * Entrée : l'inode concerné
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int ActiverCompressionInode(tInode inode);
+
+/* V5
+ * Indique si un inode est en mode compressé.
+ * Entrée : l'inode concerné
+ * Sortie : true s'il est compressé, false sinon
+ */
+extern bool CompressionInode(tInode inode);
+
+/* V5
+ * Choisit quand les lectures d'un inode mettent à jour sa date de dernier accès
+ * (DATES_STRICTES par défaut, voir politiqueDates). Les dates de modification suivent toujours les écritures.
+ * Entrées : l'inode concerné, la politique
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int PolitiqueDatesInode(tInode inode, politiqueDates politique);
+
+/* V5
+ * Crée un clone d'un inode (copie instantanée) : le clone partage les blocs de la source,
+ * qui ne sont recopiés qu'à la première écriture dans un bloc partagé (copie sur écriture).
+ * Entrées : l'inode source, le numéro du clone
+ * Retour : le clone, ou NULL en cas de problème
+ */
+extern tInode CloneInode(tInode source, unsigned int numero);
+
 /* V4
  * Retourne la taille maximale d'un fichier contenu dans un inode.
  * Entrée : l'inode concerné,
@@ -146,4 +290,50 @@ extern int ChargerInode(tInode *pInode, FILE *fichier);
  */
 extern long TailleMaxFichier(void);
 
+/* V5
+ * Retourne la taille maximale d'un fichier dont les blocs ont une taille donnée. Les blocs d'un fichier sont décrits
+ * par des étendues (sans bloc d'indirection) ; la limite est reprise d'un inode classique à 10 blocs directs
+ * et trois niveaux d'indirection (simple, double, triple) remplis de numéros de 32 bits, dans la limite
+ * de 2^32 - 1 blocs (280 192 octets pour des blocs de 64 octets).
+ * Entrée : la taille des blocs
+ * Sortie : la taille du plus grand fichier
+ */
+extern long TailleMaxFichierBlocs(long tailleBloc);
+
+/* V5
+ * Retourne la taille maximale du fichier contenu dans un inode donné,
+ * qui dépend de la taille des blocs de son disque.
+ * Entrée : l'inode concerné
+ * Sortie : la taille du plus grand fichier de cet inode
+ */
+extern long TailleMaxFichierInode(tInode inode);
+
+/* V5
+ * Lit sans copie taille octets d'un inode à partir d'un décalage (sans dépasser la fin du fichier) :
+ * retourne la liste des vues (adresse, taille) qui couvrent ces octets dans l'ordre du fichier, directement
+ * dans les blocs du disque (ou dans l'inode pour un fichier en ligne). Les blocs vus sont épinglés jusqu'à
+ * LibererVuesInode : les vues restent valables et gardent le contenu lu même si des fichiers (celui-ci compris)
+ * sont écrits, tronqués ou supprimés, ou si le disque s'agrandit (un bloc épinglé est recopié avant d'être modifié,
+ * et n'est rendu au disque qu'au dernier désépinglage). La vue d'un fichier en ligne est dans l'inode, qui ne doit
+ * alors être ni modifié ni détruit. Les trous, les fichiers compressés et les blocs que le cache d'un fichier image
+ * refuse d'épingler sont recopiés dans une zone des vues.
+ * Entrées : l'inode, la taille en octets, le décalage dans le fichier
+ * Retour : les vues (aucune si le décalage est au-delà de la fin du fichier), NULL en cas d'erreur
+ */
+extern tVuesInode LireVuesInode(tInode inode, long taille, long decalage);
+
+/* V5
+ * Retourne le tableau des vues d'une lecture sans copie.
+ * Entrées : les vues, l'adresse où ranger leur nombre
+ * Retour : le tableau des vues (valable jusqu'à LibererVuesInode)
+ */
+extern const struct sVue *VuesInode(tVuesInode vues, long *pNbVues);
+
+/* V5
+ * Relâche les blocs épinglés par une lecture sans copie et détruit ses vues.
+ * Entrée : les vues à libérer
+ * Retour : aucun
+ */
+extern void LibererVuesInode(tVuesInode *pVues);
+
 #endif
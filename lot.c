@@ -0,0 +1,468 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : lot.c
+ * Module d'entrées/sorties par lots.
+ **/
+
+// syscall, preadv, pwritev
+#define _DEFAULT_SOURCE
+
+#include "lot.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+// io_uring (Linux) : appels système directs, sans bibliothèque
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define ES_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+// Nombre maximal de requêtes en cours en même temps dans l'anneau d'un lot
+#define NB_ENTREES_ANNEAU_MAX 256
+
+// Nombre maximal de zones d'une requête (limite des preadv/pwritev)
+#define NB_ZONES_REQUETE_MAX 1024
+
+// Une requête d'un lot
+struct sRequeteES
+{
+  // Écriture (true) ou lecture (false)
+  bool ecriture;
+  // Le fichier, les zones en mémoire (dans le tableau des zones du lot), la taille totale, la position dans le fichier
+  int fd;
+  long premiereZone;
+  int nbZones;
+  long taille;
+  off_t position;
+  // La requête est-elle terminée ?
+  bool terminee;
+};
+
+#ifdef ES_URING
+// Les anneaux io_uring d'un lot, partagés avec le noyau
+struct sAnneaux
+{
+  int fd;
+  // Anneau de soumission : indices de tête (noyau) et de queue (lot), tableau d'indices et requêtes
+  unsigned *sqTete, *sqQueue, *sqMasque, *sqTableau;
+  struct io_uring_sqe *sqes;
+  // Anneau de complétion : indices de tête (lot) et de queue (noyau), résultats
+  unsigned *cqTete, *cqQueue, *cqMasque;
+  struct io_uring_cqe *cqes;
+  // Nombre d'entrées de l'anneau de soumission
+  unsigned nbEntrees;
+  // Les projections des anneaux et leurs tailles (pour les libérer)
+  void *projectionSq, *projectionCq;
+  size_t tailleSq, tailleCq, tailleSqes;
+};
+#endif
+
+// Définition d'un lot
+struct sLotES
+{
+  // Les requêtes en attente et leurs zones en mémoire
+  long capacite;
+  long nbRequetes;
+  struct sRequeteES *requetes;
+  long nbZones;
+  struct iovec *zones;
+  // Les requêtes sont-elles soumises par io_uring ?
+  bool asynchrone;
+#ifdef ES_URING
+  // Les anneaux, et sont-ils ouverts (à fermer à la destruction du lot) ?
+  struct sAnneaux anneaux;
+  bool anneauxOuverts;
+#endif
+};
+
+// Les lots créés ensuite utilisent-ils io_uring (s'il est disponible) ?
+static bool asynchroneParDefaut = true;
+
+// fonction auxiliaire qui termine une requête par des preadv/pwritev, à partir de l'octet deja (les zones de la requête
+// sont raccourcies au fur et à mesure) : la partie d'une lecture au-delà de la fin du fichier se lit à zéro ;
+// retourne 0 si ok, -1 sinon
+static int terminerRequete(tLotES lot, struct sRequeteES *requete, long deja) {
+  struct iovec *zones = &lot->zones[requete->premiereZone];
+  int nbZones = requete->nbZones;
+  long retires = 0;
+  for (;;) {
+    // zones (ou début de zone) déjà transférées
+    while (nbZones > 0 && retires + (long)zones->iov_len <= deja) {
+      retires += zones->iov_len;
+      zones++;
+      nbZones--;
+    }
+    if (nbZones == 0) {
+      break;
+    }
+    zones->iov_base = (unsigned char *)zones->iov_base + (deja - retires);
+    zones->iov_len -= deja - retires;
+    retires = deja;
+
+    ssize_t n = requete->ecriture ? pwritev(requete->fd, zones, nbZones, requete->position + deja)
+                                  : preadv(requete->fd, zones, nbZones, requete->position + deja);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0 || (n == 0 && requete->ecriture)) {
+      return -1;
+    }
+    if (n == 0) {
+      for (int z = 0; z < nbZones; z++) {
+        memset(zones[z].iov_base, 0, zones[z].iov_len);
+      }
+      break;
+    }
+    deja += n;
+  }
+
+  requete->terminee = true;
+  return 0;
+}
+
+// fonction auxiliaire qui exécute les requêtes pas encore terminées d'un lot par des preadv/pwritev (0 si ok, -1 sinon)
+static int executerSynchrone(tLotES lot) {
+  int resultat = 0;
+  for (long i = 0; i < lot->nbRequetes; i++) {
+    if (!lot->requetes[i].terminee && terminerRequete(lot, &lot->requetes[i], 0) != 0) {
+      resultat = -1;
+    }
+  }
+  return resultat;
+}
+
+#ifdef ES_URING
+// fonction auxiliaire qui libère les anneaux d'un lot
+static void fermerAnneaux(struct sAnneaux *anneaux) {
+  if (anneaux->projectionSq != MAP_FAILED) {
+    munmap(anneaux->projectionSq, anneaux->tailleSq);
+  }
+  if (anneaux->projectionCq != MAP_FAILED) {
+    munmap(anneaux->projectionCq, anneaux->tailleCq);
+  }
+  if (anneaux->sqes != MAP_FAILED) {
+    munmap(anneaux->sqes, anneaux->tailleSqes);
+  }
+  close(anneaux->fd);
+}
+
+// fonction auxiliaire qui crée les anneaux io_uring d'un lot (0 si ok, -1 si io_uring n'est pas disponible)
+static int ouvrirAnneaux(struct sAnneaux *anneaux, unsigned nbEntrees) {
+  struct io_uring_params parametres;
+  memset(&parametres, 0, sizeof(parametres));
+  int fd = (int)syscall(__NR_io_uring_setup, nbEntrees, &parametres);
+  if (fd < 0) {
+    return -1;
+  }
+
+  anneaux->fd = fd;
+  anneaux->nbEntrees = parametres.sq_entries;
+  anneaux->tailleSq = parametres.sq_off.array + parametres.sq_entries * sizeof(unsigned);
+  anneaux->tailleCq = parametres.cq_off.cqes + parametres.cq_entries * sizeof(struct io_uring_cqe);
+  anneaux->tailleSqes = parametres.sq_entries * sizeof(struct io_uring_sqe);
+  anneaux->projectionSq = mmap(NULL, anneaux->tailleSq, PROT_READ | PROT_WRITE, MAP_SHARED, fd, IORING_OFF_SQ_RING);
+  anneaux->projectionCq = mmap(NULL, anneaux->tailleCq, PROT_READ | PROT_WRITE, MAP_SHARED, fd, IORING_OFF_CQ_RING);
+  anneaux->sqes = mmap(NULL, anneaux->tailleSqes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, IORING_OFF_SQES);
+  if (anneaux->projectionSq == MAP_FAILED || anneaux->projectionCq == MAP_FAILED || anneaux->sqes == MAP_FAILED) {
+    fermerAnneaux(anneaux);
+    return -1;
+  }
+
+  unsigned char *sq = (unsigned char *)anneaux->projectionSq;
+  anneaux->sqTete = (unsigned *)(sq + parametres.sq_off.head);
+  anneaux->sqQueue = (unsigned *)(sq + parametres.sq_off.tail);
+  anneaux->sqMasque = (unsigned *)(sq + parametres.sq_off.ring_mask);
+  anneaux->sqTableau = (unsigned *)(sq + parametres.sq_off.array);
+  unsigned char *cq = (unsigned char *)anneaux->projectionCq;
+  anneaux->cqTete = (unsigned *)(cq + parametres.cq_off.head);
+  anneaux->cqQueue = (unsigned *)(cq + parametres.cq_off.tail);
+  anneaux->cqMasque = (unsigned *)(cq + parametres.cq_off.ring_mask);
+  anneaux->cqes = (struct io_uring_cqe *)(cq + parametres.cq_off.cqes);
+
+  return 0;
+}
+
+// fonction auxiliaire qui traite les complétions disponibles : une requête incomplète ou refusée par le noyau
+// est terminée par preadv/pwritev ; retourne le nombre de complétions traitées
+static long recolterCompletions(tLotES lot, int *pResultat) {
+  struct sAnneaux *anneaux = &lot->anneaux;
+  long nbCompletions = 0;
+  unsigned tete = *anneaux->cqTete;
+  while (tete != __atomic_load_n(anneaux->cqQueue, __ATOMIC_ACQUIRE)) {
+    struct io_uring_cqe *cqe = &anneaux->cqes[tete & *anneaux->cqMasque];
+    struct sRequeteES *requete = &lot->requetes[cqe->user_data];
+    if (terminerRequete(lot, requete, (cqe->res > 0) ? cqe->res : 0) != 0) {
+      *pResultat = -1;
+    }
+    tete++;
+    nbCompletions++;
+  }
+  __atomic_store_n(anneaux->cqTete, tete, __ATOMIC_RELEASE);
+  return nbCompletions;
+}
+
+// fonction auxiliaire qui abandonne l'anneau d'un lot après un échec de io_uring_enter : les requêtes que le noyau
+// n'a pas prises sont retirées de l'anneau de soumission, celles qu'il a prises (enCours moins les retirées) sont
+// attendues, car elles écrivent encore dans les zones du lot ; l'anneau est alors fermé et les requêtes pas encore
+// terminées sont exécutées par preadv/pwritev ; retourne 0 si ok, -1 sinon
+static int abandonnerAnneaux(tLotES lot, long enCours, int resultat) {
+  struct sAnneaux *anneaux = &lot->anneaux;
+  unsigned tete = __atomic_load_n(anneaux->sqTete, __ATOMIC_ACQUIRE);
+  enCours -= (long)(*anneaux->sqQueue - tete);
+  __atomic_store_n(anneaux->sqQueue, tete, __ATOMIC_RELEASE);
+
+  // le reste du lot (et les lots suivants) en preadv/pwritev
+  lot->asynchrone = false;
+  while (enCours > 0) {
+    long nbCompletions = recolterCompletions(lot, &resultat);
+    enCours -= nbCompletions;
+    if (enCours > 0 && nbCompletions == 0
+        && syscall(__NR_io_uring_enter, anneaux->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR) {
+      // requêtes impossibles à attendre : les zones ne sont pas réécrites, l'anneau sera fermé avec le lot
+      fprintf(stderr, "ExecuterLotES : %ld requete(s) io_uring impossibles a attendre\n", enCours);
+      return -1;
+    }
+  }
+  fermerAnneaux(anneaux);
+  lot->anneauxOuverts = false;
+  return (executerSynchrone(lot) == 0) ? resultat : -1;
+}
+
+// fonction auxiliaire qui exécute les requêtes d'un lot par io_uring : l'anneau de soumission est rempli
+// (au plus nbEntrees requêtes en cours), puis chaque complétion libère une place pour la suivante ;
+// retourne 0 si ok, -1 sinon
+static int executerAnneaux(tLotES lot) {
+  struct sAnneaux *anneaux = &lot->anneaux;
+  int resultat = 0;
+  long suivante = 0;
+  long enCours = 0;
+  long terminees = 0;
+  unsigned queue = *anneaux->sqQueue;
+
+  while (terminees < lot->nbRequetes) {
+    // requêtes suivantes dans l'anneau de soumission, tant qu'il y a de la place
+    while (suivante < lot->nbRequetes && enCours < (long)anneaux->nbEntrees) {
+      struct sRequeteES *requete = &lot->requetes[suivante];
+      unsigned indice = queue & *anneaux->sqMasque;
+      struct io_uring_sqe *sqe = &anneaux->sqes[indice];
+      memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode = requete->ecriture ? IORING_OP_WRITEV : IORING_OP_READV;
+      sqe->fd = requete->fd;
+      sqe->addr = (uint64_t)(uintptr_t)&lot->zones[requete->premiereZone];
+      sqe->len = (uint32_t)requete->nbZones;
+      sqe->off = (uint64_t)requete->position;
+      sqe->user_data = (uint64_t)suivante;
+      anneaux->sqTableau[indice] = indice;
+      queue++;
+      suivante++;
+      enCours++;
+    }
+    __atomic_store_n(anneaux->sqQueue, queue, __ATOMIC_RELEASE);
+
+    // soumission de ce que le noyau n'a pas encore pris, et attente d'au moins une complétion
+    unsigned nonSoumises = queue - __atomic_load_n(anneaux->sqTete, __ATOMIC_ACQUIRE);
+    if (syscall(__NR_io_uring_enter, anneaux->fd, nonSoumises, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0
+        && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      return abandonnerAnneaux(lot, enCours, resultat);
+    }
+
+    // résultats disponibles
+    long nbCompletions = recolterCompletions(lot, &resultat);
+    enCours -= nbCompletions;
+    terminees += nbCompletions;
+  }
+
+  return resultat;
+}
+#endif
+
+/* V5
+ * Crée un lot vide.
+ * Entrée : le nombre maximal de zones en mémoire du lot
+ * Retour : le lot créé, ou NULL en cas de problème
+ */
+tLotES CreerLotES(long capacite) {
+  if (capacite <= 0) {
+    fprintf(stderr, "CreerLotES : capacite invalide (%ld)\n", capacite);
+    return NULL;
+  }
+
+  tLotES lot = (tLotES)malloc(sizeof(struct sLotES));
+  if (lot == NULL) {
+    fprintf(stderr, "CreerLotES : probleme creation\n");
+    return NULL;
+  }
+  lot->requetes = malloc(capacite * sizeof(struct sRequeteES));
+  lot->zones = malloc(capacite * sizeof(struct iovec));
+  if (lot->requetes == NULL || lot->zones == NULL) {
+    fprintf(stderr, "CreerLotES : probleme creation\n");
+    free(lot->requetes);
+    free(lot->zones);
+    free(lot);
+    return NULL;
+  }
+  lot->capacite = capacite;
+  lot->nbRequetes = 0;
+  lot->nbZones = 0;
+  lot->asynchrone = false;
+
+#ifdef ES_URING
+  // io_uring refusé (noyau ancien, filtrage des appels système) : preadv/pwritev
+  lot->anneauxOuverts = false;
+  if (asynchroneParDefaut) {
+    unsigned nbEntrees = (capacite < NB_ENTREES_ANNEAU_MAX) ? (unsigned)capacite : NB_ENTREES_ANNEAU_MAX;
+    lot->anneauxOuverts = (ouvrirAnneaux(&lot->anneaux, nbEntrees) == 0);
+    lot->asynchrone = lot->anneauxOuverts;
+  }
+#endif
+
+  return lot;
+}
+
+/* V5
+ * Détruit un lot (les requêtes pas encore exécutées sont abandonnées).
+ * Entrée : le lot à détruire
+ * Retour : aucun
+ */
+void DetruireLotES(tLotES *pLot) {
+  if (pLot == NULL || *pLot == NULL) {
+    return;
+  }
+
+#ifdef ES_URING
+  if ((*pLot)->anneauxOuverts) {
+    fermerAnneaux(&(*pLot)->anneaux);
+  }
+#endif
+  free((*pLot)->requetes);
+  free((*pLot)->zones);
+  free(*pLot);
+  *pLot = NULL;
+}
+
+// fonction auxiliaire qui ajoute une requête à un lot (0 si ok, -1 si le lot est plein)
+static int ajouterRequete(tLotES lot, bool ecriture, int fd, unsigned char *adresse, long taille, off_t position) {
+  if (lot == NULL || lot->nbZones == lot->capacite) {
+    return -1;
+  }
+
+  struct sRequeteES *requete = &lot->requetes[lot->nbRequetes++];
+  requete->ecriture = ecriture;
+  requete->fd = fd;
+  requete->premiereZone = lot->nbZones;
+  requete->nbZones = 1;
+  requete->taille = taille;
+  requete->position = position;
+  requete->terminee = false;
+  lot->zones[lot->nbZones].iov_base = adresse;
+  lot->zones[lot->nbZones].iov_len = taille;
+  lot->nbZones++;
+
+  return 0;
+}
+
+/* V5
+ * Ajoute au lot la lecture de taille octets d'un fichier, à partir d'une position, vers une adresse.
+ * Entrées : le lot, le descripteur du fichier, l'adresse où lire, la taille en octets, la position dans le fichier
+ * Sortie : 0 en cas de succès, -1 si le lot est plein
+ */
+int AjouterLectureLotES(tLotES lot, int fd, unsigned char *adresse, long taille, off_t position) {
+  return ajouterRequete(lot, false, fd, adresse, taille, position);
+}
+
+/* V5
+ * Ajoute au lot l'écriture de taille octets dans un fichier, à partir d'une position, depuis une adresse.
+ * Entrées : le lot, le descripteur du fichier, l'adresse des octets, la taille en octets, la position dans le fichier
+ * Sortie : 0 en cas de succès, -1 si le lot est plein
+ */
+int AjouterEcritureLotES(tLotES lot, int fd, const unsigned char *adresse, long taille, off_t position) {
+  // la zone n'est que lue par une écriture
+  return ajouterRequete(lot, true, fd, (unsigned char *)adresse, taille, position);
+}
+
+/* V5
+ * Prolonge la dernière requête du lot : les taille octets suivants du fichier sont lus vers
+ * (ou écrits depuis) une autre zone en mémoire.
+ * Entrées : le lot, l'adresse de la zone, sa taille en octets
+ * Sortie : 0 en cas de succès, -1 si le lot est vide ou plein
+ */
+int ProlongerLotES(tLotES lot, unsigned char *adresse, long taille) {
+  if (lot == NULL || lot->nbRequetes == 0 || lot->nbZones == lot->capacite) {
+    return -1;
+  }
+
+  struct sRequeteES *requete = &lot->requetes[lot->nbRequetes - 1];
+  if (requete->nbZones == NB_ZONES_REQUETE_MAX) {
+    return -1;
+  }
+  lot->zones[lot->nbZones].iov_base = adresse;
+  lot->zones[lot->nbZones].iov_len = taille;
+  lot->nbZones++;
+  requete->nbZones++;
+  requete->taille += taille;
+
+  return 0;
+}
+
+/* V5
+ * Retourne le nombre de requêtes en attente dans un lot.
+ * Entrée : le lot
+ * Retour : le nombre de requêtes
+ */
+long NbRequetesLotES(tLotES lot) {
+  if (lot == NULL) {
+    return 0;
+  }
+
+  return lot->nbRequetes;
+}
+
+/* V5
+ * Exécute toutes les requêtes d'un lot et attend qu'elles soient terminées ; le lot est ensuite vide.
+ * Entrée : le lot
+ * Sortie : 0 en cas de succès, -1 si une requête a échoué
+ */
+int ExecuterLotES(tLotES lot) {
+  if (lot == NULL) {
+    return -1;
+  }
+
+  int resultat;
+#ifdef ES_URING
+  resultat = lot->asynchrone ? executerAnneaux(lot) : executerSynchrone(lot);
+#else
+  resultat = executerSynchrone(lot);
+#endif
+
+  lot->nbRequetes = 0;
+  lot->nbZones = 0;
+  return resultat;
+}
+
+/* V5
+ * Choisit si les lots créés ensuite utilisent io_uring quand il est disponible.
+ * Entrée : true pour utiliser io_uring
+ * Sortie : aucune
+ */
+void AsynchroneLotES(bool asynchrone) {
+  asynchroneParDefaut = asynchrone;
+}
+
+/* V5
+ * Indique si un lot utilise io_uring.
+ * Entrée : le lot
+ * Retour : true si ses requêtes sont soumises par io_uring, false sinon
+ */
+bool EstAsynchroneLotES(tLotES lot) {
+  return lot != NULL && lot->asynchrone;
+}
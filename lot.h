@@ -0,0 +1,87 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : lot.h
+ * Module d'entrées/sorties par lots.
+ * Un lot regroupe des lectures et des écritures de blocs dans des fichiers, soumises ensemble :
+ * sous Linux avec io_uring (toutes les requêtes sont en cours en même temps), sinon (ou si le noyau
+ * refuse io_uring) par des preadv/pwritev successifs.
+ * Une requête porte sur une suite d'octets consécutifs du fichier, qui peut être répartie
+ * sur plusieurs zones en mémoire (une seule requête pour plusieurs blocs voisins).
+ **/
+#ifndef __LOT_H__
+#define __LOT_H__
+
+#include <stdbool.h>
+#include <sys/types.h>
+
+// Type public représentant un lot d'entrées/sorties
+typedef struct sLotES *tLotES;
+
+/* V5
+ * Crée un lot vide.
+ * Entrée : le nombre maximal de zones en mémoire du lot (toutes requêtes confondues)
+ * Retour : le lot créé, ou NULL en cas de problème
+ */
+extern tLotES CreerLotES(long capacite);
+
+/* V5
+ * Détruit un lot (les requêtes pas encore exécutées sont abandonnées).
+ * Entrée : le lot à détruire
+ * Retour : aucun
+ */
+extern void DetruireLotES(tLotES *pLot);
+
+/* V5
+ * Ajoute au lot la lecture de taille octets d'un fichier, à partir d'une position, vers une adresse.
+ * La partie au-delà de la fin du fichier se lit à zéro.
+ * Entrées : le lot, le descripteur du fichier, l'adresse où lire, la taille en octets, la position dans le fichier
+ * Sortie : 0 en cas de succès, -1 si le lot est plein
+ */
+extern int AjouterLectureLotES(tLotES lot, int fd, unsigned char *adresse, long taille, off_t position);
+
+/* V5
+ * Ajoute au lot l'écriture de taille octets dans un fichier, à partir d'une position, depuis une adresse.
+ * Entrées : le lot, le descripteur du fichier, l'adresse des octets, la taille en octets, la position dans le fichier
+ * Sortie : 0 en cas de succès, -1 si le lot est plein
+ */
+extern int AjouterEcritureLotES(tLotES lot, int fd, const unsigned char *adresse, long taille, off_t position);
+
+/* V5
+ * Prolonge la dernière requête du lot : les taille octets suivants du fichier sont lus vers
+ * (ou écrits depuis) une autre zone en mémoire.
+ * Entrées : le lot, l'adresse de la zone, sa taille en octets
+ * Sortie : 0 en cas de succès, -1 si le lot est vide ou plein
+ */
+extern int ProlongerLotES(tLotES lot, unsigned char *adresse, long taille);
+
+/* V5
+ * Retourne le nombre de requêtes en attente dans un lot.
+ * Entrée : le lot
+ * Retour : le nombre de requêtes
+ */
+extern long NbRequetesLotES(tLotES lot);
+
+/* V5
+ * Exécute toutes les requêtes d'un lot (soumises ensemble) et attend qu'elles soient terminées ; le lot est ensuite vide.
+ * Entrée : le lot
+ * Sortie : 0 en cas de succès, -1 si une requête a échoué
+ */
+extern int ExecuterLotES(tLotES lot);
+
+/* V5
+ * Choisit si les lots créés ensuite utilisent io_uring quand il est disponible (par défaut),
+ * ou des pread/pwrite successifs.
+ * Entrée : true pour utiliser io_uring
+ * Sortie : aucune
+ */
+extern void AsynchroneLotES(bool asynchrone);
+
+/* V5
+ * Indique si un lot utilise io_uring.
+ * Entrée : le lot
+ * Retour : true si ses requêtes sont soumises par io_uring, false sinon
+ */
+extern bool EstAsynchroneLotES(tLotES lot);
+
+#endif
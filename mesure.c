@@ -0,0 +1,72 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : mesure.c
+ * Module de mesure pour les programmes de banc d'essai.
+ **/
+
+// clock_gettime, sysconf (POSIX)
+#define _POSIX_C_SOURCE 200809L
+
+#include "mesure.h"
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+/* V5
+ * Retourne le temps écoulé depuis une origine fixe (horloge monotone).
+ * Entrée : aucune
+ * Retour : le temps en secondes
+ */
+double Chronometre(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+/* V5
+ * Retourne la mémoire résidente actuelle du processus (sous Linux, d'après /proc/self/statm).
+ * Entrée : aucune
+ * Retour : la mémoire résidente en Kio, -1 si elle n'est pas connue
+ */
+long MemoireResidente(void) {
+  FILE *statm = fopen("/proc/self/statm", "r");
+  if (statm == NULL) {
+    return -1;
+  }
+
+  // deuxième champ : le nombre de pages résidentes
+  long pages, residentes;
+  int lus = fscanf(statm, "%ld %ld", &pages, &residentes);
+  fclose(statm);
+  if (lus != 2) {
+    return -1;
+  }
+  return residentes * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/* V5
+ * Retourne le pic de mémoire résidente du processus depuis son lancement.
+ * Entrée : aucune
+ * Retour : le pic de mémoire résidente en Kio, -1 s'il n'est pas connu
+ */
+long PicMemoireResidente(void) {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return -1;
+  }
+  return usage.ru_maxrss;
+}
+
+/* V5
+ * Retourne un débit en Mo/s (10^6 octets par seconde).
+ * Entrées : le nombre d'octets traités, la durée en secondes
+ * Retour : le débit, 0 si la durée est nulle
+ */
+double DebitMo(double octets, double duree) {
+  if (duree <= 0) {
+    return 0;
+  }
+  return octets / duree / 1e6;
+}
@@ -0,0 +1,39 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : mesure.h
+ * Module de mesure pour les programmes de banc d'essai (bench_*.c) :
+ * temps écoulé et mémoire résidente du processus.
+ **/
+#ifndef __MESURE_H__
+#define __MESURE_H__
+
+/* V5
+ * Retourne le temps écoulé depuis une origine fixe (horloge monotone).
+ * Entrée : aucune
+ * Retour : le temps en secondes
+ */
+extern double Chronometre(void);
+
+/* V5
+ * Retourne la mémoire résidente actuelle du processus (sous Linux, d'après /proc/self/statm).
+ * Entrée : aucune
+ * Retour : la mémoire résidente en Kio, -1 si elle n'est pas connue
+ */
+extern long MemoireResidente(void);
+
+/* V5
+ * Retourne le pic de mémoire résidente du processus depuis son lancement.
+ * Entrée : aucune
+ * Retour : le pic de mémoire résidente en Kio, -1 s'il n'est pas connu
+ */
+extern long PicMemoireResidente(void);
+
+/* V5
+ * Retourne un débit en Mo/s (10^6 octets par seconde).
+ * Entrées : le nombre d'octets traités, la durée en secondes
+ * Retour : le débit, 0 si la durée est nulle
+ */
+extern double DebitMo(double octets, double duree);
+
+#endif
@@ -8,16 +8,52 @@
 #include "repertoire.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 // Définition d'un répertoire
 struct sRepertoire
 {
   tEntreesRepertoire *table;
+  // Nombre d'entrées (utilisées ou non) de la table, elle s'agrandit si besoin
+  int capacite;
 };
 
-// fonction auxiliaire pour calculer le nombre maximum de fichiers qu'on peut mettre dans un répertoire
+// Taille des entrées que peut contenir la table d'un répertoire à sa création : 10 blocs de taille par défaut
+#define TAILLE_TABLE_INITIALE (10 * TAILLE_BLOC)
+
+// fonction auxiliaire pour calculer la capacité initiale de la table d'un répertoire
+// (elle s'agrandit ensuite si besoin, le nombre maximum de fichiers dépend de la taille max d'un fichier)
 static int CalculerCapaciteMax(void) {
-  return TailleMaxFichier() / sizeof(struct sEntreesRepertoire);
+  return TAILLE_TABLE_INITIALE / sizeof(struct sEntreesRepertoire);
+}
+
+// fonction auxiliaire qui double la capacité de la table d'un répertoire (0 si ok, -1 sinon)
+// le nombre d'entrées réellement stockables dépend de l'inode (voir EcrireRepertoireDansInode)
+static int AgrandirTable(tRepertoire rep) {
+  int nouvelleCapacite = rep->capacite * 2;
+
+  // on agrandit le tableau de pointeurs
+  tEntreesRepertoire *nouvelleTable = realloc(rep->table, nouvelleCapacite * sizeof(struct sEntreesRepertoire*));
+  if (nouvelleTable == NULL) {
+    return -1;
+  }
+  rep->table = nouvelleTable;
+
+  // on alloue les nouvelles entrées
+  for (int i = rep->capacite; i < nouvelleCapacite; i++) {
+    rep->table[i] = malloc(sizeof(struct sEntreesRepertoire));
+
+    // erreur allocation : on garde les entrées déjà allouées
+    if (rep->table[i] == NULL) {
+      rep->capacite = i;
+      return -1;
+    }
+    rep->table[i]->nomEntree[0] = '\0';
+    rep->table[i]->numeroInode = 0;
+  }
+  rep->capacite = nouvelleCapacite;
+
+  return 0;
 }
 
 /* V4
@@ -71,6 +107,7 @@ tRepertoire CreerRepertoire(void)
     rep->table[i]->nomEntree[0] = '\0';
     rep->table[i]->numeroInode = 0;
   }
+  rep->capacite = capaciteMax;
 
   return rep;
 }
@@ -89,6 +126,10 @@ void DetruireRepertoire(tRepertoire *pRep)
 
   // on libère en premier le tableau d'entrées du répertoire
   if ((*pRep)->table != NULL) {
+    // libère chaque entrée
+    for (int i = 0; i < (*pRep)->capacite; i++) {
+      free((*pRep)->table[i]);
+    }
     free((*pRep)->table); // libère la mémoire allouée pour le tableau d'entrées
     (*pRep)->table = NULL; // on met le pointeur à NULL
   }
@@ -128,7 +169,7 @@ int EcrireEntreeRepertoire(tRepertoire rep, char nomEntree[], unsigned int numer
     return -1;
   }
   
-  int capaciteMax = CalculerCapaciteMax(); // capacité max d'entrées de répertoire
+  int capaciteMax = rep->capacite; // capacité actuelle d'entrées de répertoire
   int indexExistant = -1; // mémorise l'index de l'entrée trouvée
 
   // chaque entrée du répertoire un par un
@@ -167,10 +208,13 @@ int EcrireEntreeRepertoire(tRepertoire rep, char nomEntree[], unsigned int numer
         break; // on prend la première position libre trouvée
       }
     }
-    // erreur pas de position libre trouvée
+    // pas de position libre trouvée : on agrandit la table
     if (indexLibre == -1) {
-      fprintf(stderr, "EcrireEntreeRepertoire : repertoire plein\n");
-      return -1;
+      indexLibre = capaciteMax;
+      if (AgrandirTable(rep) != 0) {
+        fprintf(stderr, "EcrireEntreeRepertoire : repertoire plein\n");
+        return -1;
+      }
     }
 
     int k = 0; // index pour parcourir les caractères du nom
@@ -191,6 +235,70 @@ int EcrireEntreeRepertoire(tRepertoire rep, char nomEntree[], unsigned int numer
   return 0;
 }
 
+// fonction auxiliaire qui range une entrée lue à la suite dans la table d'un répertoire (agrandie si besoin),
+// si elle est utilisée ; retourne 0 si ok, -1 en cas de problème d'allocation
+static int ajouterEntreeLue(tRepertoire rep, int *pIndexCourant, const struct sEntreesRepertoire *entree) {
+  // entrée vide : rien à ranger
+  if (entree->nomEntree[0] == '\0') {
+    return 0;
+  }
+
+  // table pleine : on l'agrandit
+  if (*pIndexCourant == rep->capacite && AgrandirTable(rep) != 0) {
+    return -1;
+  }
+
+  // on copie le nom de l'entrée carac par carac, puis son numéro d'inode
+  tEntreesRepertoire destination = rep->table[*pIndexCourant];
+  int k = 0;
+  while (entree->nomEntree[k] != '\0' && k < TAILLE_NOM_FICHIER) {
+    destination->nomEntree[k] = entree->nomEntree[k];
+    k++;
+  }
+  destination->nomEntree[k] = '\0';
+  destination->numeroInode = entree->numeroInode;
+  (*pIndexCourant)++;
+
+  return 0;
+}
+
+/* V5
+ * Retire une entrée d'un répertoire (sa case redevient libre).
+ * Comme dans le répertoire, le nom est comparé sur ses TAILLE_NOM_FICHIER premiers caractères.
+ * Entrées : le répertoire, le nom de l'entrée à retirer
+ * Retour : 0 si l'entrée est retirée, -1 si elle n'existe pas ou en cas d'erreur
+ */
+int SupprimerEntreeRepertoire(tRepertoire rep, char nomEntree[])
+{
+  // verif si le repertoire et le nom existent
+  if (rep == NULL || rep->table == NULL || nomEntree == NULL || nomEntree[0] == '\0') {
+    fprintf(stderr, "SupprimerEntreeRepertoire : parametre invalide\n");
+    return -1;
+  }
+
+  // chaque entrée utilisée du répertoire un par un
+  for (int i = 0; i < rep->capacite; i++) {
+    char *nom = rep->table[i]->nomEntree;
+    if (nom[0] == '\0') {
+      continue;
+    }
+
+    // compare caract par caract (au plus TAILLE_NOM_FICHIER)
+    int j = 0;
+    while (j < TAILLE_NOM_FICHIER && nomEntree[j] != '\0' && nomEntree[j] == nom[j]) {
+      j++;
+    }
+    if (j == TAILLE_NOM_FICHIER || (nomEntree[j] == '\0' && nom[j] == '\0')) {
+      // la case redevient libre
+      nom[0] = '\0';
+      rep->table[i]->numeroInode = 0;
+      return 0;
+    }
+  }
+
+  return -1;
+}
+
 /* V4
  * Lit le contenu d'un répertoire depuis un inode.
  * Entrées : le répertoire mis à jour avec le contenu lu,
@@ -238,48 +346,64 @@ int LireRepertoireDepuisInode(tRepertoire *pRep, tInode inode)
     return 0;
   }
 
-  unsigned char *donneesBrutes = (unsigned char *)malloc(tailleReelle); // alloue de la mémoire pour recevoir les données du répertoire contenue dans l'inode
-  
-  // erreur allocation mémoire
-  if (donneesBrutes == NULL) {
-    fprintf(stderr, "LireRepertoireDepuisInode : erreur allocation memoire\n");
+  // lecture sans copie : les entrées sont lues en place dans les blocs du répertoire
+  tVuesInode vues = LireVuesInode(inode, tailleReelle, 0);
+
+  // erreur lecture
+  if (vues == NULL) {
+    fprintf(stderr, "LireRepertoireDepuisInode : erreur lecture de l'inode\n");
     DetruireRepertoire(pRep); // détruit le rep crée
     return -1;
   }
-  
-  // lire les données du répertoire depuis l'inode
-  long octetsLus = LireDonneesInode(inode, donneesBrutes, tailleReelle, 0);
-  
-  // si aucune donnée lue
-  if (octetsLus <= 0) {
-    free(donneesBrutes); // on libère la mémoire temporaire des données brutes
-    return 0;
-  }
-
-  int tailleEntree = sizeof(struct sEntreesRepertoire); // taille en mémoire d'une entrée de répertoire
-  int nbEntreesPossibles = octetsLus / tailleEntree; // nombre d'entrees completes qu'on peut extraire des octets lus
 
-  // parcourir toutes les entrees possibles dans les données lus
-  for (int i = 0; i < nbEntreesPossibles; i++) {
-    // on prend l'entrée i
-    struct sEntreesRepertoire *entree = (struct sEntreesRepertoire *)(donneesBrutes + (i * tailleEntree));
+  long nbVues;
+  const struct sVue *tableauVues = VuesInode(vues, &nbVues);
+  long tailleEntree = sizeof(struct sEntreesRepertoire); // taille en mémoire d'une entrée de répertoire
+  struct sEntreesRepertoire aCheval; // entrée à cheval sur deux vues, reconstituée ici
+  long octetsACheval = 0; // octets de cette entrée déjà recopiés
+  int indexCourant = 0; // prochaine case libre de la table
+  int resultat = 0;
+
+  // parcourir toutes les entrées complètes des vues
+  // (les noms d'un répertoire écrit par EcrireRepertoireDansInode sont uniques : chaque entrée est rangée
+  // à la suite dans la table, sans chercher si elle existe déjà)
+  for (long v = 0; v < nbVues && resultat == 0; v++) {
+    const unsigned char *octets = tableauVues[v].adresse;
+    long tailleVue = tableauVues[v].taille;
+    long k = 0; // position dans la vue
+
+    // fin d'une entrée commencée dans la vue précédente
+    if (octetsACheval > 0) {
+      k = (tailleEntree - octetsACheval < tailleVue) ? tailleEntree - octetsACheval : tailleVue;
+      memcpy((unsigned char *)&aCheval + octetsACheval, octets, k);
+      octetsACheval += k;
+      if (octetsACheval < tailleEntree) {
+        continue;
+      }
+      octetsACheval = 0;
+      resultat = ajouterEntreeLue(*pRep, &indexCourant, &aCheval);
+    }
 
-    // verif si l'entree est utilisé
-    if (entree->nomEntree[0] != '\0') {
-      // on ajoute cette entrée dans le répertoire
-      int resultat = EcrireEntreeRepertoire(*pRep, entree->nomEntree, entree->numeroInode);
+    // les entrées entières de la vue, lues en place
+    for (; k + tailleEntree <= tailleVue && resultat == 0; k += tailleEntree) {
+      resultat = ajouterEntreeLue(*pRep, &indexCourant, (const struct sEntreesRepertoire *)(octets + k));
+    }
 
-      // erreur ajout entrée
-      if (resultat == -1) {
-        fprintf(stderr, "LireRepertoireDepuisInode : erreur ajout entree\n");
-        free(donneesBrutes); // on libère la mémoire temporaire des données brutes
-        DetruireRepertoire(pRep); // on détruit le répertoire
-        return -1;
-      }
+    // début d'une entrée à cheval sur la vue suivante
+    if (k < tailleVue && resultat == 0) {
+      octetsACheval = tailleVue - k;
+      memcpy(&aCheval, octets + k, octetsACheval);
     }
   }
-  // on libère la mémoire temporaire des données brutes
-  free(donneesBrutes);
+
+  // on relâche les blocs du répertoire
+  LibererVuesInode(&vues);
+
+  if (resultat != 0) {
+    fprintf(stderr, "LireRepertoireDepuisInode : erreur ajout entree\n");
+    DetruireRepertoire(pRep); // on détruit le répertoire
+    return -1;
+  }
 
   return 0;
 }
@@ -309,8 +433,25 @@ int EcrireRepertoireDansInode(tRepertoire rep, tInode inode)
     return -1;
   }
 
-  long tailleMax = TailleMaxFichier(); // taille maximale d'un fichier
-  unsigned char *donneesAEcrire = (unsigned char *)malloc(tailleMax); // alloue de la mémoire pour écrire les données du répertoire contenue dans l'inode
+  long tailleMax = TailleMaxFichierInode(inode); // taille maximale du fichier de cet inode
+  long tailleDonnees = NbEntreesRepertoire(rep) * sizeof(struct sEntreesRepertoire); // taille des entrées à écrire
+
+  // verif si on dépasse pas la taille max
+  if (tailleDonnees > tailleMax) {
+    fprintf(stderr, "EcrireRepertoireDansInode : repertoire plein\n");
+    return -1;
+  }
+
+  // l'inode ne raccourcit pas quand le répertoire a perdu des entrées (voir SupprimerEntreeRepertoire) :
+  // la fin de son ancien contenu est recouverte d'entrées vides, ignorées à la lecture
+  long tailleEcrite = (Taille(inode) > tailleDonnees) ? Taille(inode) : tailleDonnees;
+
+  // répertoire vide : rien à écrire
+  if (tailleEcrite == 0) {
+    return 0;
+  }
+
+  unsigned char *donneesAEcrire = (unsigned char *)malloc(tailleEcrite); // alloue de la mémoire pour écrire les données du répertoire contenue dans l'inode
 
   // erreur allocation mémoire
   if (donneesAEcrire == NULL) {
@@ -319,12 +460,12 @@ int EcrireRepertoireDansInode(tRepertoire rep, tInode inode)
   }
 
   // initialise tout à 0
-  for (int i = 0; i < tailleMax; i++) {
+  for (long i = 0; i < tailleEcrite; i++) {
     donneesAEcrire[i] = 0;
   }
 
   int indexCourant = 0; // position actuelle dans le tableau des données
-  int capaciteMax = CalculerCapaciteMax(); // nb max d'entrées dans le répertoire
+  int capaciteMax = rep->capacite; // nb d'entrées dans la table du répertoire
 
   // on parcourt toutes les entrées du répertoire
   for (int i = 0; i < capaciteMax; i++) {
@@ -351,22 +492,22 @@ int EcrireRepertoireDansInode(tRepertoire rep, tInode inode)
       // on avance à la prochaine entrée
       indexCourant += sizeof(struct sEntreesRepertoire);
 
-      // verif si on dépasse pas la taille max
-      if (indexCourant > tailleMax) {
+      // verif si on dépasse pas la taille prévue
+      if (indexCourant > tailleDonnees) {
         fprintf(stderr, "EcrireRepertoireDansInode : erreur dépassement taille max\n");
         free(donneesAEcrire); // on libère la mémoire temporaire
         return -1;
       }
     }
   }
-  // on écrit toutes les données dans l'inode
-  long octetsEcrits = EcrireDonneesInode(inode, donneesAEcrire, indexCourant, 0);
+  // on écrit toutes les données dans l'inode (entrées vides comprises)
+  long octetsEcrits = EcrireDonneesInode(inode, donneesAEcrire, tailleEcrite, 0);
 
   // on libère la mémoire temporaire
   free(donneesAEcrire);
 
   // verif si l'écriture à marché
-  if (octetsEcrits != indexCourant) {
+  if (octetsEcrits != tailleEcrite) {
     fprintf(stderr, "EcrireRepertoireDansInode : erreur ecriture dans l'inode\n");
     return -1;
   }
@@ -392,7 +533,7 @@ int EntreesContenuesDansRepertoire(tRepertoire rep, struct sEntreesRepertoire ta
   }
 
   int compteur = 0; // compte le nb d'entrées valides
-  int capaciteMax = CalculerCapaciteMax(); // capacité max du répertoire
+  int capaciteMax = rep->capacite; // capacité de la table du répertoire
 
   // on parcourt toutes les entrées possibles du répertoire
   for (int i = 0; i < capaciteMax; i++) {
@@ -439,7 +580,7 @@ int NbEntreesRepertoire(tRepertoire rep)
   }
 
   int compteur = 0; // on compte les entrées utilisées
-  int capaciteMax = CalculerCapaciteMax(); // capacite max du repertoire
+  int capaciteMax = rep->capacite; // capacite de la table du repertoire
 
   // on parcourt toutes les entrées du répertoire
   for (int i = 0; i < capaciteMax; i++) {
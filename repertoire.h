@@ -51,6 +51,14 @@ extern void DetruireRepertoire(tRepertoire *pRep);
  */
 extern int EcrireEntreeRepertoire(tRepertoire rep, char nomEntree[], unsigned int numeroInode);
 
+/* V5
+ * Retire une entrée d'un répertoire (sa case redevient libre).
+ * Comme dans le répertoire, le nom est comparé sur ses TAILLE_NOM_FICHIER premiers caractères.
+ * Entrées : le répertoire, le nom de l'entrée à retirer
+ * Retour : 0 si l'entrée est retirée, -1 si elle n'existe pas ou en cas d'erreur
+ */
+extern int SupprimerEntreeRepertoire(tRepertoire rep, char nomEntree[]);
+
 /* V4
  * Lit le contenu d'un répertoire depuis un inode.
  * Entrées : le répertoire mis à jour avec le contenu lu,
@@ -5,11 +5,20 @@
  * Module de gestion d'un systèmes de fichiers (simulé)
  **/
 
+// read (POSIX)
+#define _POSIX_C_SOURCE 200809L
+
 #include "sf.h"
 #include "bloc.h"
+#include "disque.h"
 #include "repertoire.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
 
 // Taille maximale du nom du SF (ou nom du disque)
 #define TAILLE_NOM_DISQUE 24
@@ -21,27 +30,76 @@ struct sSuperBloc
   char nomDisque[TAILLE_NOM_DISQUE+1];
   // La date de dernière modification du système de fichiers
   time_t dateDerModif;
+  // La taille des blocs du système de fichiers en octets
+  long tailleBloc;
+  // Le disque du SF : ses blocs et la carte des blocs libres
+  tDisque disque;
+  // Les nouveaux fichiers ordinaires sont-ils compressés ?
+  int compression;
+  // Quand les lectures des fichiers mettent-elles à jour leur date de dernier accès ? (voir politiqueDates)
+  politiqueDates politiqueDates;
+  // La carte des numéros d'inode : un bit par numéro, à 1 si le numéro est pris (NULL tant qu'aucun n'est pris)
+  uint64_t *carteInodes;
+  // Le nombre de mots de 64 bits de la carte des numéros d'inode
+  long nbMotsInodes;
+  // Indice du premier mot de la carte des numéros d'inode qui peut contenir un numéro libre
+  long premierMotInodesLibre;
+};
+
+// Nombre de numéros d'inode par mot de la carte des numéros
+#define NUMEROS_PAR_MOT 64
+
+// Taille minimale (en octets) et nombre minimal de blocs des tronçons lus d'une source importée (voir importerSF)
+#define TAILLE_TRONCON_IMPORT (64 * 1024)
+#define NB_BLOCS_TRONCON_IMPORT 16
+
+// Une source importée dans le SF : un flux, ou à défaut un descripteur de fichier du système
+struct sSourceImport
+{
+  FILE *flux;
+  int fd;
 };
 
 // Type représentant le super-bloc
 typedef struct sSuperBloc *tSuperBloc;
 
-// Définition de la liste chaînée des inodes
-struct sListeInodes
+// Capacité initiale de la table des inodes (doublée quand un numéro d'inode la dépasse)
+#define CAPACITE_TABLE_INODES 16
+
+// Définition de la table des inodes : un tableau indexé par numéro d'inode, agrandi si besoin
+struct sTableInodes
 {
-  // Références vers le premier et le dernier élément de la liste chaînée
-  struct sListeInodesElement *premier, *dernier;
-  // Nombre d'inodes dans la liste
+  // Les inodes, chacun à l'indice de son numéro (NULL pour un numéro sans inode)
+  tInode *inodes;
+  // Le nombre de cases du tableau
+  unsigned int capacite;
+  // Nombre d'inodes dans la table
   int nbInodes;
 };
 
-// Définition d'un élement de la liste chaînée des inodes dans le SF
-struct sListeInodesElement
+// Un fichier ouvert du SF (voir OuvrirSF) : son inode, trouvé une seule fois par son nom, et le curseur
+struct sFichierOuvert
 {
-  // L'inode proprement dit
+  // L'inode du fichier (NULL pour un descripteur libre)
   tInode inode;
-  // L'élément suivant dans la liste chaînée
-  struct sListeInodesElement *suivant;
+  // La position courante dans le fichier
+  long position;
+  // Le mode d'ouverture (combinaison de OUVERTURE_LECTURE, OUVERTURE_ECRITURE...)
+  int mode;
+};
+
+// Capacité initiale de la table des fichiers ouverts (doublée quand elle est pleine)
+#define CAPACITE_FICHIERS_OUVERTS 8
+
+// Définition de la table des fichiers ouverts : un tableau indexé par descripteur
+struct sTableFichiersOuverts
+{
+  // Les fichiers ouverts, chacun à l'indice de son descripteur
+  struct sFichierOuvert *fichiers;
+  // Le nombre de cases du tableau
+  int capacite;
+  // Le nombre de fichiers ouverts
+  int nbOuverts;
 };
 
 // Définition d'un système de fichiers (simplifié)
@@ -49,17 +107,19 @@ struct sSF
 {
   // Le super-bloc
   tSuperBloc superBloc;
-  // La liste chaînée des inodes
-  struct sListeInodes listeInodes;
+  // La table des inodes
+  struct sTableInodes tableInodes;
+  // La table des fichiers ouverts
+  struct sTableFichiersOuverts fichiersOuverts;
 };
 
-/* V2
-*  Crée et retourne un super-bloc.
+/* V2 & V5
+*  Crée et retourne un super-bloc (sans disque, voir CreerSFAvecTailleBloc et ChargerSF).
 * Fonction non publique (static)
-* Entrée : le nom du disque (ou du SF)
+* Entrée : le nom du disque (ou du SF), la taille des blocs
 * Sortie : le super-bloc, ou NULL en cas de problème
 */
-static tSuperBloc CreerSuperBloc(char nomDisque[]) {
+static tSuperBloc CreerSuperBloc(char nomDisque[], long tailleBloc) {
   // alloue de la mémoire au nouveau super bloc
   tSuperBloc nouveauSuperBloc = (tSuperBloc)malloc(sizeof(struct sSuperBloc));
 
@@ -86,12 +146,29 @@ static tSuperBloc CreerSuperBloc(char nomDisque[]) {
   // initialiser la date de dernière modif
   nouveauSuperBloc->dateDerModif = time(NULL);
 
+  // taille des blocs du SF
+  nouveauSuperBloc->tailleBloc = tailleBloc;
+
+  // le disque est créé ou chargé par l'appelant
+  nouveauSuperBloc->disque = NULL;
+
+  // pas de compression par défaut
+  nouveauSuperBloc->compression = 0;
+
+  // dates d'accès strictes par défaut
+  nouveauSuperBloc->politiqueDates = DATES_STRICTES;
+
+  // aucun numéro d'inode pris
+  nouveauSuperBloc->carteInodes = NULL;
+  nouveauSuperBloc->nbMotsInodes = 0;
+  nouveauSuperBloc->premierMotInodesLibre = 0;
+
   // retourne le nouveau super bloc
   return nouveauSuperBloc;
 }
 
-/* V2
-*  Détruit un super-bloc.
+/* V2 & V5
+*  Détruit un super-bloc et son disque.
 * Fonction non publique (static)
 * Entrée : le super-bloc à détruire
 * Sortie : aucune
@@ -107,6 +184,12 @@ static void DetruireSuperBloc(tSuperBloc *pSuperBloc) {
     return;
   }
 
+  // libère d'un coup tous les blocs du SF
+  DetruireDisque(&(*pSuperBloc)->disque);
+
+  // on libère la carte des numéros d'inode
+  free((*pSuperBloc)->carteInodes);
+
   // on libère la mémoire associée
   free(*pSuperBloc);
 
@@ -131,18 +214,202 @@ static void AfficherSuperBloc(tSuperBloc superBloc) {
   printf("SF de nom %s, super bloc :\n", superBloc->nomDisque);
 
   // affiche la taille du bloc
-  printf("taille bloc = %d", TAILLE_BLOC);
+  printf("taille bloc = %ld", superBloc->tailleBloc);
 
   // affiche la date de deernière modification
   printf(", date der modif = %s", ctime(&superBloc->dateDerModif));
 }
 
+// fonction auxiliaire qui retourne la taille maximale d'un fichier du SF (elle dépend de la taille de ses blocs)
+static long tailleMaxFichierSF(tSF sf) {
+  return TailleMaxFichierBlocs(sf->superBloc->tailleBloc);
+}
+
+// fonction auxiliaire qui prend le plus petit numéro d'inode libre dans la carte du super-bloc
+// (la carte est agrandie par doublement quand tous ses numéros sont pris)
+// retourne 0 et le numéro si ok, -1 en cas de problème d'allocation ou si les numéros sont épuisés
+static int allouerNumeroInode(tSuperBloc superBloc, unsigned int *pNumero) {
+  // les mots avant premierMotInodesLibre sont pleins
+  long mot = superBloc->premierMotInodesLibre;
+  while (mot < superBloc->nbMotsInodes && superBloc->carteInodes[mot] == UINT64_MAX) {
+    mot++;
+  }
+
+  // carte pleine : on double sa taille (les numéros restent sous la borne de la table des inodes)
+  if (mot == superBloc->nbMotsInodes) {
+    long nbMots = (superBloc->nbMotsInodes > 0) ? superBloc->nbMotsInodes * 2 : 1;
+    if ((unsigned long)nbMots * NUMEROS_PAR_MOT > UINT_MAX / 2) {
+      return -1;
+    }
+    uint64_t *carte = realloc(superBloc->carteInodes, nbMots * sizeof(uint64_t));
+    if (carte == NULL) {
+      return -1;
+    }
+    memset(carte + superBloc->nbMotsInodes, 0, (nbMots - superBloc->nbMotsInodes) * sizeof(uint64_t));
+    superBloc->carteInodes = carte;
+    superBloc->nbMotsInodes = nbMots;
+  }
+
+  // premier bit à 0 du mot
+  int bit = __builtin_ctzll(~superBloc->carteInodes[mot]);
+  superBloc->carteInodes[mot] |= UINT64_C(1) << bit;
+  superBloc->premierMotInodesLibre = mot;
+
+  *pNumero = (unsigned int)(mot * NUMEROS_PAR_MOT + bit);
+  return 0;
+}
+
+// fonction auxiliaire qui rend un numéro d'inode à la carte du super-bloc
+static void libererNumeroInode(tSuperBloc superBloc, unsigned int numero) {
+  long mot = numero / NUMEROS_PAR_MOT;
+  if (mot >= superBloc->nbMotsInodes) {
+    return;
+  }
+  superBloc->carteInodes[mot] &= ~(UINT64_C(1) << (numero % NUMEROS_PAR_MOT));
+  if (mot < superBloc->premierMotInodesLibre) {
+    superBloc->premierMotInodesLibre = mot;
+  }
+}
+
+// fonction auxiliaire qui indique si un numéro d'inode est pris dans la carte du super-bloc
+static bool numeroInodePris(tSuperBloc superBloc, unsigned int numero) {
+  long mot = numero / NUMEROS_PAR_MOT;
+  return mot < superBloc->nbMotsInodes && ((superBloc->carteInodes[mot] >> (numero % NUMEROS_PAR_MOT)) & 1);
+}
+
+// fonction auxiliaire qui initialise une table des inodes vide
+static void initialiserTableInodes(struct sTableInodes *table) {
+  table->inodes = NULL;
+  table->capacite = 0;
+  table->nbInodes = 0;
+}
+
+// fonction auxiliaire qui retourne l'inode du SF ayant un numéro donné (NULL s'il n'y en a pas)
+static tInode inodeSF(tSF sf, unsigned int numero) {
+  return (numero < sf->tableInodes.capacite) ? sf->tableInodes.inodes[numero] : NULL;
+}
+
+// fonction auxiliaire qui range un inode dans la table du SF, à l'indice de son numéro (la table est agrandie si besoin)
+// retourne 0 si ok, -1 en cas de problème d'allocation ou si le numéro est déjà pris
+static int ajouterInodeSF(tSF sf, tInode inode) {
+  struct sTableInodes *table = &sf->tableInodes;
+  unsigned int numero = Numero(inode);
+
+  if (numero >= table->capacite) {
+    if (numero >= UINT_MAX / 2) {
+      return -1;
+    }
+    unsigned int capacite = (table->capacite > 0) ? table->capacite : CAPACITE_TABLE_INODES;
+    while (capacite <= numero) {
+      capacite *= 2;
+    }
+    tInode *inodes = realloc(table->inodes, capacite * sizeof(tInode));
+    if (inodes == NULL) {
+      return -1;
+    }
+    memset(inodes + table->capacite, 0, (capacite - table->capacite) * sizeof(tInode));
+    table->inodes = inodes;
+    table->capacite = capacite;
+  }
+
+  if (table->inodes[numero] != NULL) {
+    return -1;
+  }
+  table->inodes[numero] = inode;
+  table->nbInodes++;
+  return 0;
+}
+
+// fonction auxiliaire qui retire un inode de la table du SF (sans le détruire) et rend son numéro
+static void retirerInodeSF(tSF sf, unsigned int numero) {
+  if (inodeSF(sf, numero) != NULL) {
+    sf->tableInodes.inodes[numero] = NULL;
+    sf->tableInodes.nbInodes--;
+    libererNumeroInode(sf->superBloc, numero);
+  }
+}
+
+// fonction auxiliaire qui détruit un nouvel inode qui n'a pas pu être rangé dans la table du SF
+// et rend son numéro
+static void abandonnerInodeSF(tSF sf, tInode *pInode) {
+  libererNumeroInode(sf->superBloc, Numero(*pInode));
+  DetruireInode(pInode);
+}
+
+// fonction auxiliaire qui initialise une table des fichiers ouverts vide
+static void initialiserFichiersOuverts(struct sTableFichiersOuverts *table) {
+  table->fichiers = NULL;
+  table->capacite = 0;
+  table->nbOuverts = 0;
+}
+
+// fonction auxiliaire qui indique si un inode du SF est ouvert par au moins un descripteur
+static bool inodeOuvertSF(tSF sf, tInode inode) {
+  struct sTableFichiersOuverts *table = &sf->fichiersOuverts;
+  for (int i = 0; i < table->capacite && table->nbOuverts > 0; i++) {
+    if (table->fichiers[i].inode == inode) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// fonction auxiliaire qui publie les ajouts en attente des fichiers ouverts (voir EcrireSF),
+// pour que le disque contienne toutes leurs données (0 si ok, -1 sinon)
+static int publierAjoutsSF(tSF sf) {
+  struct sTableFichiersOuverts *table = &sf->fichiersOuverts;
+  int resultat = 0;
+  for (int i = 0; i < table->capacite && table->nbOuverts > 0; i++) {
+    if (table->fichiers[i].inode != NULL && ViderAjoutsInode(table->fichiers[i].inode) != 0) {
+      resultat = -1;
+    }
+  }
+  return resultat;
+}
+
+// fonction auxiliaire qui cherche une entrée dans un répertoire par son nom
+// (retourne 0 et le numéro de son inode si elle existe, -1 sinon)
+static int chercherEntreeSF(tRepertoire rep, char nom[], unsigned int *pNumero) {
+  int nbEntrees = NbEntreesRepertoire(rep);
+  if (nbEntrees == 0) {
+    return -1;
+  }
+  struct sEntreesRepertoire *entrees = malloc(nbEntrees * sizeof(struct sEntreesRepertoire));
+  if (entrees == NULL) {
+    return -1;
+  }
+  EntreesContenuesDansRepertoire(rep, entrees);
+
+  int trouve = -1;
+  for (int i = 0; i < nbEntrees && trouve != 0; i++) {
+    // les noms sont tronqués à TAILLE_NOM_FICHIER caractères dans le répertoire
+    if (strncmp(entrees[i].nomEntree, nom, TAILLE_NOM_FICHIER) == 0) {
+      *pNumero = entrees[i].numeroInode;
+      trouve = 0;
+    }
+  }
+  free(entrees);
+  return trouve;
+}
+
 /* V2 & V4
  * Crée un nouveau système de fichiers.
  * Entrée : nom du disque à associer au système de fichiers créé
  * Retour : le système de fichiers créé, ou NULL en cas d'erreur
  */
 tSF CreerSF (char nomDisque[]){
+  // blocs de taille par défaut
+  return CreerSFAvecTailleBloc(nomDisque, TAILLE_BLOC);
+}
+
+// fonction auxiliaire qui crée un SF dont le disque est en mémoire (nomImage NULL) ou dans un fichier image
+static tSF creerSF(char nomDisque[], long tailleBloc, char nomImage[]) {
+  // erreur taille de bloc
+  if (!TailleBlocValide(tailleBloc)) {
+    fprintf(stderr, "CreerSF : taille de bloc invalide (%ld)\n", tailleBloc);
+    return NULL;
+  }
+
   // on alloue de la mémoire pour le système de fichiers
   tSF nouveauSF = (tSF)malloc(sizeof(struct sSF));
 
@@ -153,7 +420,7 @@ tSF CreerSF (char nomDisque[]){
   }
 
   // création du super bloc avec le nom donné
-  nouveauSF->superBloc = CreerSuperBloc(nomDisque);
+  nouveauSF->superBloc = CreerSuperBloc(nomDisque, tailleBloc);
 
   // on vérifie que le super bloc est bien crée
   if (nouveauSF->superBloc == NULL) {
@@ -161,13 +428,23 @@ tSF CreerSF (char nomDisque[]){
     return NULL;
   }
 
-  // on initialise la liste des inodes
-  nouveauSF->listeInodes.premier = NULL;
-  nouveauSF->listeInodes.dernier = NULL;
-  nouveauSF->listeInodes.nbInodes = 0;
+  // on initialise la table des inodes et celle des fichiers ouverts
+  initialiserTableInodes(&nouveauSF->tableInodes);
+  initialiserFichiersOuverts(&nouveauSF->fichiersOuverts);
+
+  // création du disque du SF
+  nouveauSF->superBloc->disque = (nomImage != NULL) ? CreerDisqueFichier(tailleBloc, nomImage) : CreerDisque(tailleBloc);
 
-  // création du répertoire racine (inode 0)
-  tInode racine = CreerInode(0, REPERTOIRE);
+  // erreur création disque
+  if (nouveauSF->superBloc->disque == NULL) {
+    DetruireSuperBloc(&nouveauSF->superBloc); // on détruit le super bloc
+    free(nouveauSF); // on libère le nouveau sf
+    return NULL;
+  }
+
+  // création du répertoire racine (inode 0, le premier numéro libre de la carte)
+  unsigned int numeroRacine;
+  tInode racine = (allouerNumeroInode(nouveauSF->superBloc, &numeroRacine) == 0) ? CreerInode(numeroRacine, REPERTOIRE) : NULL;
 
   // erreur création répertoire racine
   if (racine == NULL) {
@@ -176,29 +453,42 @@ tSF CreerSF (char nomDisque[]){
     free(nouveauSF); // on libère le nouveau sf
     return NULL;
   }
+  AssocierDisqueInode(racine, nouveauSF->superBloc->disque);
+  PolitiqueDatesInode(racine, nouveauSF->superBloc->politiqueDates);
 
-  // on ajoute à la liste
-  struct sListeInodesElement *nouvelElement = (struct sListeInodesElement*)malloc(sizeof(struct sListeInodesElement));
-
-  // erreur création élément liste
-  if (nouvelElement == NULL) {
-    fprintf(stderr, "CreerSF : probleme creation element liste\n");
+  // on range l'inode racine dans la table
+  if (ajouterInodeSF(nouveauSF, racine) != 0) {
+    fprintf(stderr, "CreerSF : probleme creation table des inodes\n");
     DetruireInode(&racine); // on détruit l'inode racine
     DetruireSuperBloc(&nouveauSF->superBloc); // on détruit le super bloc
     free(nouveauSF); // on libère le nv sf
     return NULL;
   }
 
-  // associe l'inode racine au nouvel élément de liste
-  nouvelElement->inode = racine;
-  nouvelElement->suivant = NULL;
+  return nouveauSF; // retourne le nouveau sf
+}
+
+/* V5
+ * Crée un nouveau système de fichiers dont les blocs ont une taille donnée.
+ * Entrées : nom du disque à associer au SF, taille des blocs en octets
+ * Retour : le système de fichiers créé, ou NULL en cas d'erreur
+ */
+tSF CreerSFAvecTailleBloc(char nomDisque[], long tailleBloc) {
+  return creerSF(nomDisque, tailleBloc, NULL);
+}
 
-  // initialise la liste avec l'élément racine
-  nouveauSF->listeInodes.premier = nouvelElement;
-  nouveauSF->listeInodes.dernier = nouvelElement;
-  nouveauSF->listeInodes.nbInodes = 1;
+/* V5
+ * Crée un nouveau système de fichiers dont les blocs sont stockés dans un fichier image.
+ * Entrées : nom du disque à associer au SF, taille des blocs en octets, nom du fichier image
+ * Retour : le système de fichiers créé, ou NULL en cas d'erreur
+ */
+tSF CreerSFSurFichier(char nomDisque[], long tailleBloc, char nomImage[]) {
+  if (nomImage == NULL) {
+    fprintf(stderr, "CreerSFSurFichier : pas de fichier image\n");
+    return NULL;
+  }
 
-  return nouveauSF; // retourne le nouveau sf
+  return creerSF(nomDisque, tailleBloc, nomImage);
 }
 
 /* V2
@@ -217,26 +507,22 @@ void DetruireSF(tSF *pSF) {
     return;
   }
 
-  // on détruit le super bloc du sf
-  DetruireSuperBloc(&(*pSF)->superBloc);
-
-  // on détruit tous les inodes de la liste
-  struct sListeInodesElement *elementActuel = (*pSF)->listeInodes.premier; // element de la liste qu'on est en train de détruire
-  struct sListeInodesElement *elementProchain; // prochain element de la liste qu'on va détruire
-  
-  while (elementActuel != NULL) {
-    // sauvegarde de l'élement suivant
-    elementProchain = elementActuel->suivant;
-
-    // détruit l'inode
-    DetruireInode(&elementActuel->inode);
+  // on détruit tous les inodes de la table
+  struct sTableInodes *table = &(*pSF)->tableInodes;
+  for (unsigned int i = 0; i < table->capacite; i++) {
+    if (table->inodes[i] != NULL) {
+      // détruit l'inode (ses blocs partent avec le disque, on ne les rend pas un par un)
+      DetacherBlocsInode(table->inodes[i]);
+      DetruireInode(&table->inodes[i]);
+    }
+  }
 
-    // on libère l'élément de la liste
-    free(elementActuel);
+  // on libère le tableau de la table, et celui des fichiers ouverts
+  free(table->inodes);
+  free((*pSF)->fichiersOuverts.fichiers);
 
-    // on passe à l'élément suivant
-    elementActuel = elementProchain;
-  }
+  // on détruit le super bloc du sf, et avec lui le disque
+  DetruireSuperBloc(&(*pSF)->superBloc);
 
   // on libère la mémoire du sf
   free(*pSF);
@@ -261,23 +547,23 @@ void AfficherSF(tSF sf){
   // affiche super bloc
   AfficherSuperBloc(sf->superBloc);
 
-  // affiche tous les inodes de la liste
+  // affiche tous les inodes de la table, par numéro
   printf("Inodes :\n");
-  struct sListeInodesElement *elementAffiche = sf->listeInodes.premier; // élément de la liste qu'on affiche
   int compteurInodes = 0;
 
-  while (elementAffiche != NULL) {
-    // affiche l'inode
-    AfficherInode(elementAffiche->inode);
-
-    // element suivant
-    elementAffiche = elementAffiche->suivant;
-    compteurInodes++;
+  for (unsigned int i = 0; i < sf->tableInodes.capacite; i++) {
+    if (sf->tableInodes.inodes[i] == NULL) {
+      continue;
+    }
 
     // separation entre les inodes
-    if (elementAffiche != NULL) {
+    if (compteurInodes > 0) {
       printf("\n");
     }
+
+    // affiche l'inode
+    AfficherInode(sf->tableInodes.inodes[i]);
+    compteurInodes++;
   }
 
   // si aucun inode
@@ -307,183 +593,178 @@ long Ecrire1BlocFichierSF(tSF sf, char nomFichier[], natureFichier type) {
     return -1;
   }
 
-  // contenu d'un fichier dans un buffer
-  unsigned char buffer[TAILLE_BLOC];
-  long octetsLus = fread(buffer, 1, TAILLE_BLOC, fichier);
+  // contenu d'un fichier dans un buffer (d'un bloc du SF)
+  long tailleBloc = sf->superBloc->tailleBloc;
+  unsigned char *buffer = malloc(tailleBloc);
+
+  // erreur allocation buffer
+  if (buffer == NULL) {
+    fprintf(stderr, "Ecrire1BlocFichierSF : échec allocation mémoire pour le buffer\n");
+    fclose(fichier);
+    return -1;
+  }
+  long octetsLus = fread(buffer, 1, tailleBloc, fichier);
 
   // on ferme le fichier
   fclose(fichier);
 
+  // on prend un numéro d'inode libre
+  unsigned int nouveauNumero;
+  if (allouerNumeroInode(sf->superBloc, &nouveauNumero) != 0) {
+    fprintf(stderr, "Ecrire1BlocFichierSF : plus de numéro d'inode libre\n");
+    free(buffer);
+    return -1;
+  }
+
   // on crée un nouvel inode
-  unsigned int nouveauNumero = sf->listeInodes.nbInodes; // numéro unique
   tInode nouvelInode = CreerInode(nouveauNumero, type);
 
   // echec création inode
   if (nouvelInode == NULL) {
     fprintf(stderr, "Ecrire1BlocFichierSF : Impossible de creer l'inode\n");
+    libererNumeroInode(sf->superBloc, nouveauNumero);
+    free(buffer);
     return -1;
   }
+  AssocierDisqueInode(nouvelInode, sf->superBloc->disque);
+  PolitiqueDatesInode(nouvelInode, sf->superBloc->politiqueDates);
+  if (sf->superBloc->compression && type == ORDINAIRE) {
+    ActiverCompressionInode(nouvelInode);
+  }
 
   // on écrit le contenu du fichier dans l'inode
   long octetsEcris = EcrireDonneesInode1bloc(nouvelInode, buffer, octetsLus);
+  free(buffer);
 
   // echec ecriture dans l'inode -> destruction de l'inode
   if (octetsEcris <= 0) {
     fprintf(stderr, "Ecrire1BlocFichierSF : impossible d'écrire dans l'inode\n");
-    DetruireInode(&nouvelInode);
+    abandonnerInodeSF(sf, &nouvelInode);
     return -1;
   }
 
-  // on crée un nouvel élément pour la liste des inodes
-  struct sListeInodesElement *nouvelElement = (struct sListeInodesElement*)malloc(sizeof(struct sListeInodesElement));
-
-  // echec allocation mémoire de l'élément
-  if (nouvelElement == NULL) {
-    fprintf(stderr, "Ecrire1BlocFichierSF : impossible d'ajouter l'inode à la liste");
-    DetruireInode(&nouvelInode);
+  // on range l'inode dans la table des inodes
+  if (ajouterInodeSF(sf, nouvelInode) != 0) {
+    fprintf(stderr, "Ecrire1BlocFichierSF : impossible d'ajouter l'inode à la table\n");
+    abandonnerInodeSF(sf, &nouvelInode);
     return -1;
   }
 
-  // initialise le nouvel élément avec l'inode créé
-  nouvelElement->inode = nouvelInode; // élément pointe vers le nouvel inode
-  nouvelElement->suivant = NULL; // dernier élément de la liste
-
-  // on ajoute l'élement au sf
-  if (sf->listeInodes.premier == NULL) { // si la liste est vide
-    sf->listeInodes.premier = nouvelElement;
-    sf->listeInodes.dernier = nouvelElement;
-  } else { // si la liste a déjà des éléments
-    sf->listeInodes.dernier->suivant = nouvelElement;
-    sf->listeInodes.dernier = nouvelElement;
-  }
-
-  // on augmente le nb total d'inodes dans le compteur
-  sf->listeInodes.nbInodes++;
-
   // met à jour la date de modification du super bloc
   sf->superBloc->dateDerModif = time(NULL);
 
   return octetsEcris;
 }
 
-/* V3 & V4
- * Ecrit un fichier (d'un nombre de blocs quelconque) dans le système de fichiers.
- * Si la taille du fichier à écrire dépasse la taille maximale d'un fichier dans le SF(10 x 64 octets),
- * seuls les 640 premiers octets seront écrits dans le système de fichiers.
- * Entrées : le système de fichiers, le nom du fichier (sur disque) et son type dans le SF (simulé)
- * Sortie : le nombre d'octets effectivement écrits, -1 en cas d'erreur.
- */
-long EcrireFichierSF(tSF sf, char nomFichier[], natureFichier type) {
-  // erreur sf
-  if (sf == NULL) {
-    fprintf(stderr, "EcrireFichierSF : le sf n'existe pas\n");
-    return -1;
-  }
-
-  // erreur nomFichier
-  if (nomFichier == NULL) {
-    fprintf(stderr, "EcrireFichierSF : le fichier n'existe pas\n");
-    return -1;
-  }
-  
-  // ouvrir le fichier source en lecture binaire
-  FILE *fichierSource;
-  fichierSource = fopen(nomFichier, "rb");
-
-  // erreur ouverture fichier source
-  if (fichierSource == NULL) {
-    fprintf(stderr, "EcrireFichierSF : erreur ouverture fichier source\n");
-    return -1;
-  }
-
-  // obtenir la taille du fichier source
-  fseek(fichierSource, 0, SEEK_END); // on se place à la fin du fichier
-  long tailleFichier = ftell(fichierSource);// récupérer la taille
-  fseek(fichierSource, 0, SEEK_SET);// retourne au début du fichier
-
-  // erreur taille de fichier
-  if (tailleFichier < 0) {
-    fprintf(stderr, "EcrireFichierSF : impossible de déterminer la taille du fichier\n");
-    fclose(fichierSource); // on ferme le fichier
-    return -1;
-  }
-
-  long tailleMax = 10 * TAILLE_BLOC; // 10 = NB_BLOCS_DIRECTS
-  long octetsALire = tailleFichier;
-
-  // verif si le fichier dépasse la capacité maximale
-  if (tailleFichier > tailleMax) {
-    printf("Fichier '%s' trop volumineux, tronqué à %ld octets\n", nomFichier, tailleMax);
-    octetsALire = tailleMax; // on lit que la capacité max
+// fonction auxiliaire qui remplit une zone depuis une source, jusqu'à la fin de la source
+// (un tube ou un terminal peut rendre moins d'octets que demandé à chaque lecture) :
+// retourne le nombre d'octets lus (moins que taille à la fin de la source), -1 en cas d'erreur de lecture
+static long lireSourceImport(struct sSourceImport *source, unsigned char *zone, long taille) {
+  long lus = 0;
+  while (lus < taille) {
+    long morceau;
+    if (source->flux != NULL) {
+      morceau = (long)fread(zone + lus, 1, taille - lus, source->flux);
+      if (morceau == 0 && ferror(source->flux)) {
+        return -1;
+      }
+    } else {
+      morceau = (long)read(source->fd, zone + lus, taille - lus);
+      if (morceau < 0 && errno == EINTR) {
+        continue;
+      }
+      if (morceau < 0) {
+        return -1;
+      }
+    }
+    if (morceau == 0) {
+      break; // fin de la source
+    }
+    lus += morceau;
   }
+  return lus;
+}
 
-  // buffer temporaire pour stocker le contenu du fichier
-  unsigned char *buffer = malloc(octetsALire);
-
-  // erreur allocation mémoire du buffer
-  if (buffer == NULL) {
-    fprintf(stderr, "EcrireFichierSF : échec allocation mémoire pour le buffer\n");
-    fclose(fichierSource); // on ferme le fichier source
+// fonction auxiliaire qui importe une source dans un nouveau fichier du SF, tronçon par tronçon :
+// chaque tronçon est écrit dans l'inode dès qu'il est lu, si bien que la mémoire utilisée ne dépend pas
+// de la taille de la source, qui peut être un tube (sa taille n'est pas demandée)
+// retourne le nombre d'octets écrits, -1 en cas d'erreur (le fichier n'est alors pas créé)
+static long importerSF(tSF sf, struct sSourceImport *source, char nomFichier[], natureFichier type, const char *fonction) {
+  // tronçons de blocs entiers, pour que chaque écriture couvre des blocs (et des trames compressées) entiers
+  long tailleBloc = sf->superBloc->tailleBloc;
+  long tailleTroncon = (NB_BLOCS_TRONCON_IMPORT * tailleBloc > TAILLE_TRONCON_IMPORT)
+                     ? NB_BLOCS_TRONCON_IMPORT * tailleBloc : TAILLE_TRONCON_IMPORT;
+  unsigned char *troncon = malloc(tailleTroncon);
+  if (troncon == NULL) {
+    fprintf(stderr, "%s : échec allocation mémoire pour le tampon\n", fonction);
     return -1;
   }
 
-  // lecture du contenu du fichier vers le buffer
-  long octetsLus = fread(buffer, 1, octetsALire, fichierSource);
-
-  // si lecture incomplète du fichier
-  if (octetsLus != octetsALire) {
-    fprintf(stderr, "EcrireFichierSF : lecture incomplète (%ld/%ld octets lus)\n", octetsLus, octetsALire);
-    free(buffer); // on libère le buffer
-    fclose(fichierSource); // on ferme le fichier source
+  // on prend un numéro d'inode libre
+  unsigned int nouveauNumero;
+  if (allouerNumeroInode(sf->superBloc, &nouveauNumero) != 0) {
+    fprintf(stderr, "%s : plus de numéro d'inode libre\n", fonction);
+    free(troncon);
     return -1;
   }
 
-  // on ferme le fichier source
-  fclose(fichierSource);
-
   // on crée un nouvel inode dans le SF
-  unsigned int nouveauNumero = sf->listeInodes.nbInodes; // numéro unique
   tInode nouvelInode = CreerInode(nouveauNumero, type);
-
-  // erreur création inode
   if (nouvelInode == NULL) {
-    fprintf(stderr, "EcrireFichierSF : échec création inode numéro %u\n", nouveauNumero);
-    free(buffer); // on libère le buffer
+    fprintf(stderr, "%s : échec création inode numéro %u\n", fonction, nouveauNumero);
+    libererNumeroInode(sf->superBloc, nouveauNumero);
+    free(troncon);
     return -1;
   }
-
-  // on écrit les données du buffer vers l'inode
-  long octetsEcrits = EcrireDonneesInode(nouvelInode, buffer, octetsLus, 0);
-
-  // echec ecriture dans l'inode -> destruction de l'inode
-  if (octetsEcrits < 0) {
-    printf("EcrireFichierSF : impossible d'écrire dans l'inode\n");
-    DetruireInode(&nouvelInode);
-    free(buffer); // on libère le buffer
-    return -1;
+  AssocierDisqueInode(nouvelInode, sf->superBloc->disque);
+  PolitiqueDatesInode(nouvelInode, sf->superBloc->politiqueDates);
+  if (sf->superBloc->compression && type == ORDINAIRE) {
+    ActiverCompressionInode(nouvelInode);
   }
 
-  // on libère le buffer
-  free(buffer);
+  // tronçon par tronçon, jusqu'à la fin de la source ou la taille maximale d'un fichier
+  long tailleMax = tailleMaxFichierSF(sf); // dépend de la taille des blocs du SF
+  long octetsEcrits = 0;
+  while (true) {
+    long octetsLus = lireSourceImport(source, troncon, tailleTroncon);
+    if (octetsLus < 0) {
+      fprintf(stderr, "%s : erreur de lecture de la source\n", fonction);
+      abandonnerInodeSF(sf, &nouvelInode);
+      free(troncon);
+      return -1;
+    }
+    if (octetsLus == 0) {
+      break;
+    }
 
-  // trouver l'inode racine
-  tInode racine = NULL; // pointeur vers l'inode racine
-  struct sListeInodesElement *current = sf->listeInodes.premier; // on commence au premier élément de la liste
+    // au-delà de la taille maximale, la source est tronquée
+    long octetsAEcrire = octetsLus;
+    if (octetsAEcrire > tailleMax - octetsEcrits) {
+      printf("Fichier '%s' trop volumineux, tronqué à %ld octets\n", nomFichier, tailleMax);
+      octetsAEcrire = tailleMax - octetsEcrits;
+    }
 
-  // parcourt toute la liste
-  while (current != NULL) {
-    // verif si cet élément contient un inode valide et si c'est l'inode numéro 0
-    if (current->inode != NULL && Numero(current->inode) == 0) {
-      racine = current->inode; // on a trouvé le répertoire racine
-      break; // on arrête la recherche
+    long ecrits = (octetsAEcrire > 0) ? EcrireDonneesInode(nouvelInode, troncon, octetsAEcrire, octetsEcrits) : 0;
+    if (ecrits < 0) {
+      fprintf(stderr, "%s : impossible d'écrire dans l'inode\n", fonction);
+      abandonnerInodeSF(sf, &nouvelInode);
+      free(troncon);
+      return -1;
+    }
+    octetsEcrits += ecrits;
+    if (ecrits < octetsAEcrire || octetsLus < tailleTroncon || octetsAEcrire < octetsLus) {
+      break; // disque plein, fin de la source ou taille maximale atteinte
     }
-    current = current->suivant; // passe à l'élément suivant
   }
-  
+  free(troncon);
+
+  // l'inode racine (numéro 0)
+  tInode racine = inodeSF(sf, 0);
+
   // verif si on a bien trouvé l'inode racine
   if (racine == NULL) {
-    fprintf(stderr, "EcrireFichierSF : répertoire racine introuvable\n");
-    DetruireInode(&nouvelInode); // on détruit l'inode
+    fprintf(stderr, "%s : répertoire racine introuvable\n", fonction);
+    abandonnerInodeSF(sf, &nouvelInode); // on détruit l'inode et rend son numéro
     return -1;
   }
 
@@ -492,96 +773,139 @@ long EcrireFichierSF(tSF sf, char nomFichier[], natureFichier type) {
 
   // on lit le contenu du répertoire depuis inode vers struct temp
   if (LireRepertoireDepuisInode(&repertoireRacine, racine) != 0) {
-    fprintf(stderr, "EcrireFichierSF : erreur lecture répertoire racine\n");
-    DetruireInode(&nouvelInode); // on détruit l'inode
+    fprintf(stderr, "%s : erreur lecture répertoire racine\n", fonction);
+    abandonnerInodeSF(sf, &nouvelInode); // on détruit l'inode et rend son numéro
     return -1;
   }
-  
+
   // on ajoute l'entrée au répertoire
   if (EcrireEntreeRepertoire(repertoireRacine, nomFichier, nouveauNumero) != 0) {
-    fprintf(stderr, "EcrireFichierSF : erreur ajout entrée dans répertoire\n");
+    fprintf(stderr, "%s : erreur ajout entrée dans répertoire\n", fonction);
     DetruireRepertoire(&repertoireRacine); // on détruit le répertoire temporaire
-    DetruireInode(&nouvelInode); // on détruit l'inode
+    abandonnerInodeSF(sf, &nouvelInode); // on détruit l'inode et rend son numéro
     return -1;
   }
-  
+
   // répertoire -> inode racine
   if (EcrireRepertoireDansInode(repertoireRacine, racine) != 0) {
-    fprintf(stderr, "EcrireFichierSF : erreur écriture répertoire dans inode\n");
+    fprintf(stderr, "%s : erreur écriture répertoire dans inode\n", fonction);
     DetruireRepertoire(&repertoireRacine); // on détruit le répertoire temporaire
-    DetruireInode(&nouvelInode); // on détruit l'inode
+    abandonnerInodeSF(sf, &nouvelInode); // on détruit l'inode et rend son numéro
     return -1;
   }
-  
+
   // on détruit le répertoire temporaire
   DetruireRepertoire(&repertoireRacine);
-  
-  // on crée un nouvel élément pour la liste des inodes
-  struct sListeInodesElement *nouvelElement = malloc(sizeof(struct sListeInodesElement));
 
-  // echec allocation mémoire de l'élément -> destruction de l'inode
-  if (nouvelElement == NULL) {
-    fprintf(stderr, "EcrireFichierSF : échec allocation mémoire pour l'élément de la liste\n");
-    DetruireInode(&nouvelInode);
+  // on range l'inode dans la table des inodes -> destruction de l'inode en cas d'échec
+  if (ajouterInodeSF(sf, nouvelInode) != 0) {
+    fprintf(stderr, "%s : échec ajout de l'inode à la table des inodes\n", fonction);
+    abandonnerInodeSF(sf, &nouvelInode);
     return -1;
   }
 
-  // initialise le nouvel élément avec l'inode créé
-  nouvelElement->inode = nouvelInode; // élément pointe vers le nouvel inode
-  nouvelElement->suivant = NULL; // dernier élément de la liste
-
-  // on ajoute l'élement au sf
-  if (sf->listeInodes.premier == NULL) { // si la liste est vide
-    sf->listeInodes.premier = nouvelElement;
-    sf->listeInodes.dernier = nouvelElement;
-  } else { // si la liste a déjà des éléments
-    sf->listeInodes.dernier->suivant = nouvelElement;
-    sf->listeInodes.dernier = nouvelElement;
-  }
-
-  // on augmente le nb total d'inodes dans le compteur
-  sf->listeInodes.nbInodes++;
-
   // met à jour la date de modification du super bloc
   sf->superBloc->dateDerModif = time(NULL);
 
   return octetsEcrits;
 }
 
-/* V3
- * Sauvegarde un système de fichiers dans un fichier (sur disque).
- * Entrées : le système de fichiers, le nom du fichier sauvegarde (sur disque)
- * Sortie : 0 en cas de succèe, -1 en cas d'erreur
+/* V3 & V5
+ * Ecrit un fichier (d'un nombre de blocs quelconque) dans le système de fichiers.
+ * Si la taille du fichier à écrire dépasse la taille maximale d'un fichier dans le SF (voir TailleMaxFichierBlocs,
+ * 280 192 octets avec les blocs par défaut), seuls les premiers octets jusqu'à cette taille seront écrits.
+ * Le fichier est lu et écrit par tronçons (voir EcrireFluxSF).
+ * Entrées : le système de fichiers, le nom du fichier (sur disque) et son type dans le SF (simulé)
+ * Sortie : le nombre d'octets effectivement écrits, -1 en cas d'erreur.
  */
-int SauvegarderSF(tSF sf, char nomFichier[]) {
+long EcrireFichierSF(tSF sf, char nomFichier[], natureFichier type) {
   // erreur sf
   if (sf == NULL) {
-    fprintf(stderr, "SauvegarderSF : le SF n'existe pas\n");
+    fprintf(stderr, "EcrireFichierSF : le sf n'existe pas\n");
     return -1;
   }
 
   // erreur nomFichier
   if (nomFichier == NULL) {
-    fprintf(stderr, "SauvegarderSF : le nom de fichier est invalide\n");
+    fprintf(stderr, "EcrireFichierSF : le fichier n'existe pas\n");
     return -1;
   }
 
-  // on ouvre le fichier de sauvegarde en écriture binaire
-  FILE *fichierSauvegarde;
-  fichierSauvegarde = fopen(nomFichier, "wb");
+  // ouvrir le fichier source en lecture binaire
+  FILE *fichierSource;
+  fichierSource = fopen(nomFichier, "rb");
 
-  // erreur ouverture fichier sauvegarde
-  if (fichierSauvegarde == NULL) {
-    fprintf(stderr, "SauvegarderSF : erreur ouverture fichier sauvegarde");
+  // erreur ouverture fichier source
+  if (fichierSource == NULL) {
+    fprintf(stderr, "EcrireFichierSF : erreur ouverture fichier source\n");
+    return -1;
+  }
+
+  // import tronçon par tronçon, puis on ferme le fichier source
+  struct sSourceImport source = {fichierSource, -1};
+  long octetsEcrits = importerSF(sf, &source, nomFichier, type, "EcrireFichierSF");
+  fclose(fichierSource);
+
+  return octetsEcrits;
+}
+
+/* V5
+ * Ecrit dans le système de fichiers le contenu d'un flux ouvert en lecture, jusqu'à sa fin.
+ * Entrées : le système de fichiers, le flux (non fermé), le nom du fichier dans le SF et son type
+ * Sortie : le nombre d'octets effectivement écrits, -1 en cas d'erreur.
+ */
+long EcrireFluxSF(tSF sf, FILE *flux, char nomFichier[], natureFichier type) {
+  if (sf == NULL || flux == NULL || nomFichier == NULL) {
+    fprintf(stderr, "EcrireFluxSF : parametre invalide\n");
+    return -1;
+  }
+
+  struct sSourceImport source = {flux, -1};
+  return importerSF(sf, &source, nomFichier, type, "EcrireFluxSF");
+}
+
+/* V5
+ * Ecrit dans le système de fichiers le contenu lu sur un descripteur de fichier du système, jusqu'à sa fin.
+ * Entrées : le système de fichiers, le descripteur (non fermé), le nom du fichier dans le SF et son type
+ * Sortie : le nombre d'octets effectivement écrits, -1 en cas d'erreur.
+ */
+long EcrireDescripteurSystemeSF(tSF sf, int fd, char nomFichier[], natureFichier type) {
+  if (sf == NULL || fd < 0 || nomFichier == NULL) {
+    fprintf(stderr, "EcrireDescripteurSystemeSF : parametre invalide\n");
     return -1;
   }
 
+  struct sSourceImport source = {NULL, fd};
+  return importerSF(sf, &source, nomFichier, type, "EcrireDescripteurSystemeSF");
+}
+
+// fonction auxiliaire qui écrit la sauvegarde d'un SF dans un fichier ouvert (0 si ok, -1 sinon)
+static int ecrireSauvegardeSF(tSF sf, FILE *fichierSauvegarde) {
   // sauvegarde métadonnées du super-bloc dans le fichier
   fwrite(sf->superBloc->nomDisque, sizeof(char), TAILLE_NOM_DISQUE+1, fichierSauvegarde);
   fwrite(&sf->superBloc->dateDerModif, sizeof(time_t), 1, fichierSauvegarde);
+  fwrite(&sf->superBloc->tailleBloc, sizeof(long), 1, fichierSauvegarde);
+  fwrite(&sf->superBloc->compression, sizeof(int), 1, fichierSauvegarde);
+  int politique = sf->superBloc->politiqueDates;
+  fwrite(&politique, sizeof(int), 1, fichierSauvegarde);
+
+  // sauvegarde de la carte des numéros d'inode : nombre de mots puis les mots
+  if (fwrite(&sf->superBloc->nbMotsInodes, sizeof(long), 1, fichierSauvegarde) != 1
+      || fwrite(sf->superBloc->carteInodes, sizeof(uint64_t), sf->superBloc->nbMotsInodes, fichierSauvegarde)
+         != (size_t)sf->superBloc->nbMotsInodes) {
+    fprintf(stderr, "SauvegarderSF : erreur sauvegarde de la carte des numéros d'inode\n");
+    return -1;
+  }
+
+  // sauvegarde du disque : carte des blocs libres et blocs, chacun d'un seul tenant
+  // (avec les ajouts en attente des fichiers ouverts)
+  if (publierAjoutsSF(sf) != 0 || SauvegarderDisque(sf->superBloc->disque, fichierSauvegarde) != 0) {
+    fprintf(stderr, "SauvegarderSF : erreur sauvegarde du disque\n");
+    return -1;
+  }
 
   // écriture nombre total d'inodes
-  int nbInodes = sf->listeInodes.nbInodes;
+  int nbInodes = sf->tableInodes.nbInodes;
 
   // sauvegarde le nb d'inodes
   size_t elementsNbInodes = fwrite(&nbInodes, sizeof(int), 1, fichierSauvegarde);
@@ -589,59 +913,113 @@ int SauvegarderSF(tSF sf, char nomFichier[]) {
   // erreur sauvegarde nombre d'inodes 
   if (elementsNbInodes != 1) {
     fprintf(stderr, "SauvegarderSF : erreur sauvegarde nombre d'inodes\n");
-    fclose(fichierSauvegarde); // on ferme le fichier sauvegarde
     return -1;
   }
 
-  // parcours tous les inodes de la liste pour les sauvegarder
-  struct sListeInodesElement *elementCourant = sf->listeInodes.premier; // on commence au premier élément
+  // parcours tous les inodes de la table, par numéro, pour les sauvegarder
   int compteurInodes = 0; // verif qu'on sauvegarde bien tous les inodes
 
   // chaque inode un par un
-  while (elementCourant != NULL) {
-    // sauvegarde l'inode actuel dans le fichier
-    int resultatSauvegarde = SauvegarderInode(elementCourant->inode, fichierSauvegarde);
+  for (unsigned int i = 0; i < sf->tableInodes.capacite; i++) {
+    if (sf->tableInodes.inodes[i] == NULL) {
+      continue;
+    }
+
+    // sauvegarde l'inode actuel dans le fichier (ses données sont déjà sauvegardées avec le disque)
+    int resultatSauvegarde = SauvegarderMetaInode(sf->tableInodes.inodes[i], fichierSauvegarde);
 
     // verif sauvegarde de l'inode
     if (resultatSauvegarde != 0) {
-      fprintf(stderr, "SauvegarderSF : échec sauvegarde de l'inode numéro %d\n", compteurInodes);
-      fclose(fichierSauvegarde); // on ferme le fichier sauvegarde
+      fprintf(stderr, "SauvegarderSF : échec sauvegarde de l'inode numéro %u\n", i);
       return -1;
     }
 
-    // on passe à l'inode suivant
-    elementCourant = elementCourant->suivant;
-
     compteurInodes++;
   }
   // verif nb d'inodes sauvegardés
   if (compteurInodes != nbInodes) {
     fprintf(stderr, "SauvegarderSF : erreur sauvegarde d'inodes (%d inodes sauvegardés au lieu de %d)\n", compteurInodes, nbInodes);
-    fclose(fichierSauvegarde); // on ferme le fichier sauvegarde
     return -1;
   }
 
   // forcer écriture des données
   if (fflush(fichierSauvegarde) != 0) {
     fprintf(stderr, "SauvegarderSF : erreur lors du fflush\n");
-    fclose(fichierSauvegarde); // on ferme le fichier
     return -1;
   }
 
-  // on ferme le fichier
-  fclose(fichierSauvegarde);
-
   return 0;
 }
 
-/* V3
- * Restaure le contenu d'un système de fichiers depuis un fichier sauvegarde (sur disque).
- * Entrées : le système de fichiers où restaurer, le nom du fichier sauvegarde (sur disque)
+/* V3 & V5
+ * Sauvegarde un système de fichiers dans un fichier (sur disque) :
+ * super-bloc (avec la carte des numéros d'inode), disque (en une seule écriture pour les blocs)
+ * puis les inodes (métadonnées et numéros de blocs).
+ * La sauvegarde est écrite dans un fichier temporaire qui remplace l'ancienne à la fin.
+ * Entrées : le système de fichiers, le nom du fichier sauvegarde (sur disque)
  * Sortie : 0 en cas de succèe, -1 en cas d'erreur
  */
-int ChargerSF(tSF *pSF, char nomFichier[]) {
-  // erreur pSF
-  if (pSF == NULL) {
+int SauvegarderSF(tSF sf, char nomFichier[]) {
+  // erreur sf
+  if (sf == NULL) {
+    fprintf(stderr, "SauvegarderSF : le SF n'existe pas\n");
+    return -1;
+  }
+
+  // erreur nomFichier
+  if (nomFichier == NULL) {
+    fprintf(stderr, "SauvegarderSF : le nom de fichier est invalide\n");
+    return -1;
+  }
+
+  // fichier temporaire renommé à la fin : l'ancienne sauvegarde reste intacte en cas d'erreur,
+  // et n'est jamais tronquée sous un SF chargé qui en projette les blocs (voir ChargerSF)
+  char *nomTemporaire = malloc(strlen(nomFichier) + sizeof(".tmp"));
+  if (nomTemporaire == NULL) {
+    fprintf(stderr, "SauvegarderSF : probleme allocation\n");
+    return -1;
+  }
+  strcpy(nomTemporaire, nomFichier);
+  strcat(nomTemporaire, ".tmp");
+
+  // on ouvre le fichier de sauvegarde en écriture binaire
+  FILE *fichierSauvegarde = fopen(nomTemporaire, "wb");
+
+  // erreur ouverture fichier sauvegarde
+  if (fichierSauvegarde == NULL) {
+    fprintf(stderr, "SauvegarderSF : erreur ouverture fichier sauvegarde\n");
+    free(nomTemporaire);
+    return -1;
+  }
+
+  int resultat = ecrireSauvegardeSF(sf, fichierSauvegarde);
+
+  // on ferme le fichier, puis il remplace l'ancienne sauvegarde
+  if (fclose(fichierSauvegarde) != 0) {
+    fprintf(stderr, "SauvegarderSF : erreur fermeture fichier sauvegarde\n");
+    resultat = -1;
+  }
+  if (resultat == 0 && rename(nomTemporaire, nomFichier) != 0) {
+    fprintf(stderr, "SauvegarderSF : impossible de remplacer %s\n", nomFichier);
+    resultat = -1;
+  }
+  if (resultat != 0) {
+    remove(nomTemporaire);
+  }
+  free(nomTemporaire);
+
+  return resultat;
+}
+
+/* V3 & V5
+ * Restaure le contenu d'un système de fichiers depuis un fichier sauvegarde (sur disque).
+ * Le fichier doit avoir été produit par SauvegarderSF (format V5).
+ * Entrées : le système de fichiers où restaurer, le nom du fichier sauvegarde (sur disque)
+ * Sortie : 0 en cas de succèe, -1 en cas d'erreur
+ */
+int ChargerSF(tSF *pSF, char nomFichier[]) {
+  // erreur pSF
+  if (pSF == NULL) {
     fprintf(stderr, "ChargerSF : le pointeur vers le SF est invalide\n");
     return -1;
   }
@@ -672,13 +1050,12 @@ int ChargerSF(tSF *pSF, char nomFichier[]) {
     return -1;
   }
 
-  // on initialise la liste vide
-  nouveauSF->listeInodes.premier = NULL;
-  nouveauSF->listeInodes.dernier = NULL;
-  nouveauSF->listeInodes.nbInodes = 0;
+  // on initialise la table des inodes vide, et celle des fichiers ouverts
+  initialiserTableInodes(&nouveauSF->tableInodes);
+  initialiserFichiersOuverts(&nouveauSF->fichiersOuverts);
 
   // on cree le super bloc temporaire
-  nouveauSF->superBloc = CreerSuperBloc("temp");
+  nouveauSF->superBloc = CreerSuperBloc("temp", TAILLE_BLOC);
 
   // erreur création super bloc
   if (nouveauSF->superBloc == NULL) {
@@ -690,6 +1067,58 @@ int ChargerSF(tSF *pSF, char nomFichier[]) {
   // chargement du super-bloc
   fread(nouveauSF->superBloc->nomDisque, sizeof(char), TAILLE_NOM_DISQUE+1, fichierSauvegarde);
   fread(&nouveauSF->superBloc->dateDerModif, sizeof(time_t), 1, fichierSauvegarde);
+  size_t elementsTailleBloc = fread(&nouveauSF->superBloc->tailleBloc, sizeof(long), 1, fichierSauvegarde);
+  size_t elementsCompression = fread(&nouveauSF->superBloc->compression, sizeof(int), 1, fichierSauvegarde);
+
+  // erreur taille de bloc (sauvegarde tronquée ou corrompue)
+  if (elementsTailleBloc != 1 || elementsCompression != 1 || !TailleBlocValide(nouveauSF->superBloc->tailleBloc)) {
+    fprintf(stderr, "ChargerSF : taille de bloc invalide\n");
+    DetruireSF(&nouveauSF); // on détruit le SF
+    fclose(fichierSauvegarde); // on ferme le fichier
+    return -1;
+  }
+
+  // chargement de la politique des dates d'accès
+  tSuperBloc superBloc = nouveauSF->superBloc;
+  int politique;
+  if (fread(&politique, sizeof(int), 1, fichierSauvegarde) != 1 || politique < DATES_STRICTES || politique > SANS_DATE_ACCES) {
+    fprintf(stderr, "ChargerSF : politique des dates invalide\n");
+    DetruireSF(&nouveauSF); // on détruit le SF
+    fclose(fichierSauvegarde); // on ferme le fichier
+    return -1;
+  }
+  superBloc->politiqueDates = politique;
+
+  // chargement de la carte des numéros d'inode (même borne que allouerNumeroInode)
+  size_t elementsNbMots = fread(&superBloc->nbMotsInodes, sizeof(long), 1, fichierSauvegarde);
+  if (elementsNbMots != 1 || superBloc->nbMotsInodes < 0
+      || (unsigned long)superBloc->nbMotsInodes * NUMEROS_PAR_MOT > UINT_MAX / 2) {
+    fprintf(stderr, "ChargerSF : carte des numéros d'inode invalide\n");
+    superBloc->nbMotsInodes = 0;
+    DetruireSF(&nouveauSF); // on détruit le SF
+    fclose(fichierSauvegarde); // on ferme le fichier
+    return -1;
+  }
+  if (superBloc->nbMotsInodes > 0) {
+    superBloc->carteInodes = malloc(superBloc->nbMotsInodes * sizeof(uint64_t));
+    if (superBloc->carteInodes == NULL
+        || fread(superBloc->carteInodes, sizeof(uint64_t), superBloc->nbMotsInodes, fichierSauvegarde)
+           != (size_t)superBloc->nbMotsInodes) {
+      fprintf(stderr, "ChargerSF : erreur lecture de la carte des numéros d'inode\n");
+      DetruireSF(&nouveauSF); // on détruit le SF
+      fclose(fichierSauvegarde); // on ferme le fichier
+      return -1;
+    }
+  }
+
+  // chargement du disque, qui doit avoir la taille de bloc du super-bloc
+  if (ChargerDisque(&nouveauSF->superBloc->disque, fichierSauvegarde) != 0
+      || TailleBlocDisque(nouveauSF->superBloc->disque) != nouveauSF->superBloc->tailleBloc) {
+    fprintf(stderr, "ChargerSF : erreur chargement du disque\n");
+    DetruireSF(&nouveauSF); // on détruit le SF
+    fclose(fichierSauvegarde); // on ferme le fichier
+    return -1;
+  }
 
   // lecture du nb total d'inodes sauvegardés
   int nbInodes;
@@ -717,7 +1146,7 @@ int ChargerSF(tSF *pSF, char nomFichier[]) {
     tInode inodeCharge;
 
     // chargement de l'inode depuis le fichier
-    int resultatChargement = ChargerInode(&inodeCharge, fichierSauvegarde);
+    int resultatChargement = ChargerMetaInode(&inodeCharge, fichierSauvegarde, nouveauSF->superBloc->disque);
 
     // erreur chargement inode
     if (resultatChargement != 0) {
@@ -727,38 +1156,33 @@ int ChargerSF(tSF *pSF, char nomFichier[]) {
       return -1;
     }
 
-    // création d'un nouvel élément de liste pour cet inode
-    struct sListeInodesElement *nouvelElement = malloc(sizeof(struct sListeInodesElement));
+    PolitiqueDatesInode(inodeCharge, superBloc->politiqueDates);
 
-    // erreur allocation mémoire élément
-    if (nouvelElement == NULL) {
-      fprintf(stderr, "ChargerSF : erreur allocation mémoire pour nouvel élément de liste pour inode %d\n", i);
+    // on range l'inode dans la table : son numéro doit être unique et pris dans la carte des numéros
+    if (!numeroInodePris(superBloc, Numero(inodeCharge)) || ajouterInodeSF(nouveauSF, inodeCharge) != 0) {
+      fprintf(stderr, "ChargerSF : numero d'inode invalide ou en double pour l'inode %d\n", i);
+      DetacherBlocsInode(inodeCharge); // ses blocs restent au disque
       DetruireInode(&inodeCharge); // on détruit l'inode
       DetruireSF(&nouveauSF); // on détruit le SF
       fclose(fichierSauvegarde); // on ferme le fichier
       return -1;
     }
-
-    // initialisation du nouvel élément
-    nouvelElement->inode = inodeCharge; // élément pointe vers le nouvel inode
-    nouvelElement->suivant = NULL; // dernier élément de la liste
-
-    // on ajoute l'élement au sf
-    if (nouveauSF->listeInodes.premier == NULL) { // si la liste est vide
-      nouveauSF->listeInodes.premier = nouvelElement;
-      nouveauSF->listeInodes.dernier = nouvelElement;
-    } else { // si la liste a déjà des éléments
-      nouveauSF->listeInodes.dernier->suivant = nouvelElement;
-      nouveauSF->listeInodes.dernier = nouvelElement;
-    }
-
-    // on augmente le nb total d'inodes dans le compteur
-    nouveauSF->listeInodes.nbInodes++;
   }
 
   // on ferme le fichier de sauvegarde
   fclose(fichierSauvegarde);
 
+  // la carte ne doit pas prendre de numéro sans inode (il ne serait jamais rendu)
+  int nbNumerosPris = 0;
+  for (long mot = 0; mot < superBloc->nbMotsInodes; mot++) {
+    nbNumerosPris += __builtin_popcountll(superBloc->carteInodes[mot]);
+  }
+  if (nbNumerosPris != nbInodes) {
+    fprintf(stderr, "ChargerSF : carte des numéros d'inode incohérente (%d numéros pris pour %d inodes)\n", nbNumerosPris, nbInodes);
+    DetruireSF(&nouveauSF); // on détruit le SF
+    return -1;
+  }
+
   // on met à jour la date de modif
   nouveauSF->superBloc->dateDerModif = time(NULL);
 
@@ -796,19 +1220,8 @@ int Ls(tSF sf, bool detail)  {
     return -1;
   }
 
-  // on cherche l'inode racine
-  tInode inodeRacine = NULL;
-  struct sListeInodesElement *current = sf->listeInodes.premier; // on commence au début
-
-  // on parcourt chaque élément pour trouver l'inode 0
-  while (current != NULL) {
-    // // verif si numéro d'inode est 0
-    if (Numero(current->inode) == 0) {
-      inodeRacine = current->inode; // on l'a trouvé
-      break; // on sort de la boucle
-    }
-    current = current->suivant; // élément suivant
-  }
+  // l'inode racine (numéro 0)
+  tInode inodeRacine = inodeSF(sf, 0);
 
   // verif inode racine
   if (inodeRacine == NULL) {
@@ -852,19 +1265,8 @@ int Ls(tSF sf, bool detail)  {
         unsigned int numInode = tabEntrees[i].numeroInode; // numéro d'inode du fichier
         char *nomFichier = tabEntrees[i].nomEntree; // nom du fichier
 
-        // on cherche l'inode correspondant
-        tInode inodeFichier = NULL;
-        current = sf->listeInodes.premier; // on commence du début
-
-        // parcours de la liste pour trouver l'inode avec le bon num
-        while (current != NULL) {
-          // si même num
-          if (Numero(current->inode) == numInode) {
-            inodeFichier = current->inode; // on a trouvé
-            break; // on sort de la boucle
-          }
-          current = current->suivant; // on passe au prochain
-        }
+        // l'inode correspondant, trouvé directement par son numéro
+        tInode inodeFichier = inodeSF(sf, numInode);
 
         // si inode trouvé, on affiche les infos détaillés
         if (inodeFichier != NULL) {
@@ -939,4 +1341,525 @@ int Ls(tSF sf, bool detail)  {
   DetruireRepertoire(&rep);
 
   return 0;
-}
\ No newline at end of file
+}
+
+/* V5
+ * Affiche l'occupation du disque d'un système de fichiers (nombre de blocs et d'octets,
+ * au total, utilisés et libres), à la manière de la commande df,
+ * et, si elle est activée, le bilan de la déduplication.
+ * Entrée : le système de fichiers
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+int Df(tSF sf) {
+  // verif si le sf existe
+  if (sf == NULL) {
+    fprintf(stderr, "Df : erreur sf inexistant\n");
+    return -1;
+  }
+
+  // les blocs des ajouts en attente sont comptés
+  publierAjoutsSF(sf);
+
+  tDisque disque = sf->superBloc->disque;
+  long tailleBloc = TailleBlocDisque(disque);
+  long nbBlocs = NbBlocsDisque(disque) - 1; // le bloc 0 réservé ne compte pas
+  long nbLibres = NbBlocsLibresDisque(disque);
+  long nbUtilises = nbBlocs - nbLibres;
+
+  printf("%-25s %10s %10s %10s %12s %12s\n", "SF", "blocs", "utilises", "libres", "octets util.", "octets libres");
+  printf("%-25s %10ld %10ld %10ld %12ld %12ld\n", sf->superBloc->nomDisque,
+         nbBlocs, nbUtilises, nbLibres, nbUtilises * tailleBloc, nbLibres * tailleBloc);
+
+  // déduplication : blocs référencés par les fichiers (logiques) et blocs réellement stockés
+  if (DeduplicationActiveDisque(disque)) {
+    long nbPartages = NbReferencesPartageesDisque(disque);
+    long nbLogiques = nbUtilises + nbPartages;
+    printf("deduplication : %ld blocs logiques pour %ld stockes (ratio %.2f), %ld octets economises, index %ld octets\n",
+           nbLogiques, nbUtilises, nbUtilises > 0 ? (double)nbLogiques / nbUtilises : 1.0,
+           nbPartages * tailleBloc, TailleMemoireDedupDisque(disque));
+  } else if (NbReferencesPartageesDisque(disque) > 0) {
+    // blocs partagés par des fichiers clonés (voir CloneFichierSF)
+    long nbPartages = NbReferencesPartageesDisque(disque);
+    printf("partage : %ld references partagees, %ld octets economises\n", nbPartages, nbPartages * tailleBloc);
+  }
+
+  // disque dans un fichier image : activité du cache de blocs
+  tStatsCache stats;
+  if (StatistiquesCacheDisque(disque, &stats) == 0) {
+    long nbAcces = stats.succes + stats.defauts;
+    printf("cache : %ld octets, %ld succes, %ld defauts (%.1f %% de succes), %ld evictions, %ld blocs reecrits, %ld lus par anticipation\n",
+           TailleMemoireCacheDisque(disque), stats.succes, stats.defauts,
+           nbAcces > 0 ? 100.0 * stats.succes / nbAcces : 0.0, stats.evictions, stats.ecritures, stats.anticipes);
+  }
+
+  return 0;
+}
+
+/* V5
+ * Active la déduplication des blocs d'un système de fichiers : les blocs entiers identiques
+ * des fichiers écrits ensuite ne sont stockés qu'une fois.
+ * Entrée : le système de fichiers
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+int ActiverDeduplicationSF(tSF sf) {
+  if (sf == NULL) {
+    fprintf(stderr, "ActiverDeduplicationSF : erreur sf inexistant\n");
+    return -1;
+  }
+
+  return ActiverDeduplicationDisque(sf->superBloc->disque);
+}
+
+/* V5
+ * Active ou désactive la compression des nouveaux fichiers ordinaires d'un système de fichiers
+ * (les fichiers déjà écrits gardent leur mode de stockage).
+ * Entrées : le système de fichiers, true pour compresser les nouveaux fichiers
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+int ActiverCompressionSF(tSF sf, bool compression) {
+  if (sf == NULL) {
+    fprintf(stderr, "ActiverCompressionSF : erreur sf inexistant\n");
+    return -1;
+  }
+
+  sf->superBloc->compression = compression;
+
+  return 0;
+}
+
+/* V5
+ * Choisit quand les lectures des fichiers d'un système de fichiers mettent à jour leur date de dernier accès,
+ * à la manière des options de montage strictatime, relatime et noatime (voir politiqueDates) :
+ * la politique s'applique aux fichiers existants et aux nouveaux.
+ * Entrées : le système de fichiers, la politique
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+int PolitiqueDatesSF(tSF sf, politiqueDates politique) {
+  if (sf == NULL || politique < DATES_STRICTES || politique > SANS_DATE_ACCES) {
+    fprintf(stderr, "PolitiqueDatesSF : parametre invalide\n");
+    return -1;
+  }
+
+  sf->superBloc->politiqueDates = politique;
+  for (unsigned int i = 0; i < sf->tableInodes.capacite; i++) {
+    if (sf->tableInodes.inodes[i] != NULL) {
+      PolitiqueDatesInode(sf->tableInodes.inodes[i], politique);
+    }
+  }
+
+  return 0;
+}
+
+/* V5
+ * Clone un fichier du SF (copie instantanée, à la manière de cp --reflink) : le nouveau fichier
+ * partage les blocs de la source (voir CloneInode), le coût ne dépend que du nombre de numéros de blocs.
+ * Le partage d'un bloc est rompu à la première écriture dans ce bloc, par l'un ou l'autre des fichiers.
+ * Entrées : le système de fichiers, le nom du fichier source et celui du clone (qui ne doit pas exister)
+ * Sortie : la taille du fichier cloné, -1 en cas d'erreur
+ */
+long CloneFichierSF(tSF sf, char nomSource[], char nomDestination[]) {
+  if (sf == NULL) {
+    fprintf(stderr, "CloneFichierSF : le sf n'existe pas\n");
+    return -1;
+  }
+  if (nomSource == NULL || nomDestination == NULL) {
+    fprintf(stderr, "CloneFichierSF : nom de fichier manquant\n");
+    return -1;
+  }
+
+  // le répertoire racine donne le numéro d'inode de la source
+  tInode racine = inodeSF(sf, 0);
+  if (racine == NULL) {
+    fprintf(stderr, "CloneFichierSF : répertoire racine introuvable\n");
+    return -1;
+  }
+  tRepertoire repertoireRacine = NULL;
+  if (LireRepertoireDepuisInode(&repertoireRacine, racine) != 0) {
+    fprintf(stderr, "CloneFichierSF : erreur lecture répertoire racine\n");
+    return -1;
+  }
+
+  unsigned int numeroSource;
+  if (chercherEntreeSF(repertoireRacine, nomSource, &numeroSource) != 0) {
+    fprintf(stderr, "CloneFichierSF : fichier '%s' introuvable\n", nomSource);
+    DetruireRepertoire(&repertoireRacine);
+    return -1;
+  }
+  unsigned int numeroExistant;
+  if (chercherEntreeSF(repertoireRacine, nomDestination, &numeroExistant) == 0) {
+    fprintf(stderr, "CloneFichierSF : le fichier '%s' existe déjà\n", nomDestination);
+    DetruireRepertoire(&repertoireRacine);
+    return -1;
+  }
+
+  tInode source = inodeSF(sf, numeroSource);
+  if (source == NULL || Type(source) == REPERTOIRE) {
+    fprintf(stderr, "CloneFichierSF : '%s' n'est pas un fichier clonable\n", nomSource);
+    DetruireRepertoire(&repertoireRacine);
+    return -1;
+  }
+
+  // le clone partage les blocs de la source
+  unsigned int nouveauNumero;
+  if (allouerNumeroInode(sf->superBloc, &nouveauNumero) != 0) {
+    fprintf(stderr, "CloneFichierSF : plus de numéro d'inode libre\n");
+    DetruireRepertoire(&repertoireRacine);
+    return -1;
+  }
+  tInode clone = CloneInode(source, nouveauNumero);
+  if (clone == NULL) {
+    libererNumeroInode(sf->superBloc, nouveauNumero);
+    DetruireRepertoire(&repertoireRacine);
+    return -1;
+  }
+
+  // on ajoute l'entrée du clone au répertoire racine
+  if (EcrireEntreeRepertoire(repertoireRacine, nomDestination, nouveauNumero) != 0
+      || EcrireRepertoireDansInode(repertoireRacine, racine) != 0) {
+    fprintf(stderr, "CloneFichierSF : erreur ajout entrée dans répertoire\n");
+    DetruireRepertoire(&repertoireRacine);
+    abandonnerInodeSF(sf, &clone); // rend les références prises sur les blocs
+    return -1;
+  }
+  DetruireRepertoire(&repertoireRacine);
+
+  // on range le clone dans la table des inodes
+  if (ajouterInodeSF(sf, clone) != 0) {
+    fprintf(stderr, "CloneFichierSF : échec ajout du clone à la table des inodes\n");
+    abandonnerInodeSF(sf, &clone);
+    return -1;
+  }
+
+  // met à jour la date de modification du super bloc
+  sf->superBloc->dateDerModif = time(NULL);
+
+  return Taille(clone);
+}
+
+/* V5
+ * Supprime un fichier du SF : son entrée est retirée du répertoire racine, son inode est détruit
+ * (ses blocs sont rendus au disque, ou leur nombre de références baisse s'ils sont partagés)
+ * et son numéro d'inode est rendu à la carte des numéros, pour le prochain fichier créé.
+ * Entrées : le système de fichiers, le nom du fichier à supprimer
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+int SupprimerFichierSF(tSF sf, char nomFichier[]) {
+  if (sf == NULL) {
+    fprintf(stderr, "SupprimerFichierSF : le sf n'existe pas\n");
+    return -1;
+  }
+  if (nomFichier == NULL) {
+    fprintf(stderr, "SupprimerFichierSF : nom de fichier manquant\n");
+    return -1;
+  }
+
+  // le répertoire racine donne le numéro d'inode du fichier
+  tInode racine = inodeSF(sf, 0);
+  if (racine == NULL) {
+    fprintf(stderr, "SupprimerFichierSF : répertoire racine introuvable\n");
+    return -1;
+  }
+  tRepertoire repertoireRacine = NULL;
+  if (LireRepertoireDepuisInode(&repertoireRacine, racine) != 0) {
+    fprintf(stderr, "SupprimerFichierSF : erreur lecture répertoire racine\n");
+    return -1;
+  }
+
+  unsigned int numero;
+  if (chercherEntreeSF(repertoireRacine, nomFichier, &numero) != 0) {
+    fprintf(stderr, "SupprimerFichierSF : fichier '%s' introuvable\n", nomFichier);
+    DetruireRepertoire(&repertoireRacine);
+    return -1;
+  }
+
+  // la racine ne se supprime pas
+  tInode inode = inodeSF(sf, numero);
+  if (inode == racine) {
+    fprintf(stderr, "SupprimerFichierSF : '%s' est le répertoire racine\n", nomFichier);
+    DetruireRepertoire(&repertoireRacine);
+    return -1;
+  }
+
+  // un fichier ouvert ne se supprime pas (ses descripteurs pointent sur son inode)
+  if (inode != NULL && inodeOuvertSF(sf, inode)) {
+    fprintf(stderr, "SupprimerFichierSF : '%s' est ouvert\n", nomFichier);
+    DetruireRepertoire(&repertoireRacine);
+    return -1;
+  }
+
+  // on retire l'entrée du répertoire racine
+  if (SupprimerEntreeRepertoire(repertoireRacine, nomFichier) != 0
+      || EcrireRepertoireDansInode(repertoireRacine, racine) != 0) {
+    fprintf(stderr, "SupprimerFichierSF : erreur retrait de l'entrée du répertoire\n");
+    DetruireRepertoire(&repertoireRacine);
+    return -1;
+  }
+  DetruireRepertoire(&repertoireRacine);
+
+  // on retire l'inode de la table (son numéro redevient libre) puis on le détruit avec ses blocs
+  if (inode != NULL) {
+    retirerInodeSF(sf, numero);
+    DetruireInode(&inode);
+  }
+
+  // met à jour la date de modification du super bloc
+  sf->superBloc->dateDerModif = time(NULL);
+
+  return 0;
+}
+
+/* ---------------------------------------------------------------------------
+ * Fichiers ouverts : un descripteur garde l'inode du fichier (le nom n'est cherché qu'à l'ouverture)
+ * et la position courante ; les blocs sont retrouvés à partir de l'étendue courante de l'inode,
+ * si bien qu'une lecture ou une écriture séquentielle ne refait ni recherche de nom ni recherche de bloc.
+ * ------------------------------------------------------------------------- */
+
+// fonction auxiliaire qui retourne le fichier ouvert d'un descripteur (NULL, avec un message, s'il n'est pas ouvert)
+static struct sFichierOuvert *fichierOuvertSF(tSF sf, int descripteur, const char *fonction) {
+  if (sf == NULL || descripteur < 0 || descripteur >= sf->fichiersOuverts.capacite
+      || sf->fichiersOuverts.fichiers[descripteur].inode == NULL) {
+    fprintf(stderr, "%s : descripteur %d invalide\n", fonction, descripteur);
+    return NULL;
+  }
+  return &sf->fichiersOuverts.fichiers[descripteur];
+}
+
+// fonction auxiliaire qui prend le plus petit descripteur libre (la table est agrandie si besoin)
+// retourne le descripteur, -1 en cas de problème d'allocation
+static int allouerDescripteurSF(tSF sf) {
+  struct sTableFichiersOuverts *table = &sf->fichiersOuverts;
+  if (table->nbOuverts < table->capacite) {
+    for (int i = 0; i < table->capacite; i++) {
+      if (table->fichiers[i].inode == NULL) {
+        return i;
+      }
+    }
+  }
+
+  if (table->capacite > INT_MAX / 2) {
+    return -1;
+  }
+  int capacite = (table->capacite > 0) ? table->capacite * 2 : CAPACITE_FICHIERS_OUVERTS;
+  struct sFichierOuvert *fichiers = realloc(table->fichiers, capacite * sizeof(struct sFichierOuvert));
+  if (fichiers == NULL) {
+    return -1;
+  }
+  memset(fichiers + table->capacite, 0, (capacite - table->capacite) * sizeof(struct sFichierOuvert));
+  table->fichiers = fichiers;
+  int descripteur = table->capacite;
+  table->capacite = capacite;
+  return descripteur;
+}
+
+// fonction auxiliaire qui crée un fichier ordinaire vide dans le SF et l'ajoute au répertoire racine
+// (retourne son inode, NULL en cas de problème)
+static tInode creerFichierVideSF(tSF sf, tRepertoire repertoireRacine, tInode racine, char nomFichier[]) {
+  unsigned int numero;
+  if (allouerNumeroInode(sf->superBloc, &numero) != 0) {
+    fprintf(stderr, "OuvrirSF : plus de numéro d'inode libre\n");
+    return NULL;
+  }
+  tInode inode = CreerInode(numero, ORDINAIRE);
+  if (inode == NULL) {
+    libererNumeroInode(sf->superBloc, numero);
+    return NULL;
+  }
+  AssocierDisqueInode(inode, sf->superBloc->disque);
+  PolitiqueDatesInode(inode, sf->superBloc->politiqueDates);
+  if (sf->superBloc->compression) {
+    ActiverCompressionInode(inode);
+  }
+
+  // l'inode est rangé dans la table, puis son entrée ajoutée au répertoire racine
+  if (ajouterInodeSF(sf, inode) != 0) {
+    fprintf(stderr, "OuvrirSF : échec ajout de l'inode à la table des inodes\n");
+    abandonnerInodeSF(sf, &inode);
+    return NULL;
+  }
+  if (EcrireEntreeRepertoire(repertoireRacine, nomFichier, numero) != 0
+      || EcrireRepertoireDansInode(repertoireRacine, racine) != 0) {
+    fprintf(stderr, "OuvrirSF : erreur ajout entrée dans répertoire\n");
+    retirerInodeSF(sf, numero);
+    DetruireInode(&inode);
+    return NULL;
+  }
+
+  sf->superBloc->dateDerModif = time(NULL);
+  return inode;
+}
+
+/* V5
+ * Ouvre un fichier du SF (du répertoire racine) et retourne un descripteur, positionné au début du fichier.
+ * Entrées : le système de fichiers, le nom du fichier, le mode d'ouverture (combinaison de OUVERTURE_...)
+ * Sortie : le descripteur (le plus petit libre, à partir de 0), -1 en cas d'erreur
+ */
+int OuvrirSF(tSF sf, char nomFichier[], int mode) {
+  if (sf == NULL || nomFichier == NULL) {
+    fprintf(stderr, "OuvrirSF : parametre invalide\n");
+    return -1;
+  }
+  if ((mode & (OUVERTURE_LECTURE | OUVERTURE_ECRITURE)) == 0
+      || (mode & ~(OUVERTURE_LECTURE | OUVERTURE_ECRITURE | OUVERTURE_AJOUT | OUVERTURE_CREATION)) != 0) {
+    fprintf(stderr, "OuvrirSF : mode d'ouverture invalide\n");
+    return -1;
+  }
+
+  // le répertoire racine donne le numéro d'inode du fichier
+  tInode racine = inodeSF(sf, 0);
+  if (racine == NULL) {
+    fprintf(stderr, "OuvrirSF : répertoire racine introuvable\n");
+    return -1;
+  }
+  tRepertoire repertoireRacine = NULL;
+  if (LireRepertoireDepuisInode(&repertoireRacine, racine) != 0) {
+    fprintf(stderr, "OuvrirSF : erreur lecture répertoire racine\n");
+    return -1;
+  }
+
+  tInode inode;
+  unsigned int numero;
+  if (chercherEntreeSF(repertoireRacine, nomFichier, &numero) == 0) {
+    inode = inodeSF(sf, numero);
+    if (inode == NULL) {
+      fprintf(stderr, "OuvrirSF : inode %u du fichier '%s' introuvable\n", numero, nomFichier);
+    }
+  } else if (mode & OUVERTURE_CREATION) {
+    inode = creerFichierVideSF(sf, repertoireRacine, racine, nomFichier);
+  } else {
+    fprintf(stderr, "OuvrirSF : fichier '%s' introuvable\n", nomFichier);
+    inode = NULL;
+  }
+  DetruireRepertoire(&repertoireRacine);
+  if (inode == NULL) {
+    return -1;
+  }
+
+  // un répertoire ne s'écrit que par le module répertoire
+  if (Type(inode) == REPERTOIRE && (mode & OUVERTURE_ECRITURE)) {
+    fprintf(stderr, "OuvrirSF : '%s' est un répertoire\n", nomFichier);
+    return -1;
+  }
+
+  int descripteur = allouerDescripteurSF(sf);
+  if (descripteur < 0) {
+    fprintf(stderr, "OuvrirSF : erreur allocation du descripteur\n");
+    return -1;
+  }
+  struct sFichierOuvert *fichier = &sf->fichiersOuverts.fichiers[descripteur];
+  fichier->inode = inode;
+  fichier->position = 0;
+  fichier->mode = mode;
+  sf->fichiersOuverts.nbOuverts++;
+
+  return descripteur;
+}
+
+/* V5
+ * Lit taille octets d'un fichier ouvert à partir de sa position courante, qui avance d'autant.
+ * Entrées : le système de fichiers, le descripteur (ouvert avec OUVERTURE_LECTURE), la zone où recopier les données
+ * et sa taille en octets
+ * Sortie : le nombre d'octets effectivement lus (0 à la fin du fichier), -1 en cas d'erreur
+ */
+long LireSF(tSF sf, int descripteur, unsigned char *contenu, long taille) {
+  struct sFichierOuvert *fichier = fichierOuvertSF(sf, descripteur, "LireSF");
+  if (fichier == NULL) {
+    return -1;
+  }
+  if (!(fichier->mode & OUVERTURE_LECTURE)) {
+    fprintf(stderr, "LireSF : descripteur %d non ouvert en lecture\n", descripteur);
+    return -1;
+  }
+
+  long octetsLus = LireDonneesInode(fichier->inode, contenu, taille, fichier->position);
+  if (octetsLus > 0) {
+    fichier->position += octetsLus;
+  }
+  return octetsLus;
+}
+
+/* V5
+ * Ecrit taille octets dans un fichier ouvert à sa position courante (à la fin du fichier avec OUVERTURE_AJOUT),
+ * qui avance d'autant. Écrire au-delà de la fin du fichier y laisse un trou, qui se lit à zéro.
+ * Entrées : le système de fichiers, le descripteur (ouvert avec OUVERTURE_ECRITURE), l'adresse des données
+ * et leur taille en octets
+ * Sortie : le nombre d'octets effectivement écrits, -1 en cas d'erreur
+ */
+long EcrireSF(tSF sf, int descripteur, unsigned char *contenu, long taille) {
+  struct sFichierOuvert *fichier = fichierOuvertSF(sf, descripteur, "EcrireSF");
+  if (fichier == NULL) {
+    return -1;
+  }
+  if (!(fichier->mode & OUVERTURE_ECRITURE)) {
+    fprintf(stderr, "EcrireSF : descripteur %d non ouvert en écriture\n", descripteur);
+    return -1;
+  }
+
+  // ajout : à la fin du fichier, dont le dernier bloc reste en mémoire jusqu'à FermerSF (voir AjouterDonneesInode)
+  long octetsEcrits;
+  if (fichier->mode & OUVERTURE_AJOUT) {
+    fichier->position = Taille(fichier->inode);
+    octetsEcrits = AjouterDonneesInode(fichier->inode, contenu, taille);
+  } else {
+    octetsEcrits = EcrireDonneesInode(fichier->inode, contenu, taille, fichier->position);
+  }
+  if (octetsEcrits > 0) {
+    fichier->position += octetsEcrits;
+    sf->superBloc->dateDerModif = time(NULL);
+  }
+  return octetsEcrits;
+}
+
+/* V5
+ * Déplace la position courante d'un fichier ouvert, à la manière de lseek.
+ * Entrées : le système de fichiers, le descripteur, le déplacement en octets et son origine :
+ * SEEK_SET (début du fichier), SEEK_CUR (position courante) ou SEEK_END (fin du fichier)
+ * Sortie : la nouvelle position, -1 en cas d'erreur (position négative ou origine invalide)
+ */
+long PositionnerSF(tSF sf, int descripteur, long decalage, int origine) {
+  struct sFichierOuvert *fichier = fichierOuvertSF(sf, descripteur, "PositionnerSF");
+  if (fichier == NULL) {
+    return -1;
+  }
+
+  long base;
+  switch (origine) {
+    case SEEK_SET:
+      base = 0;
+      break;
+    case SEEK_CUR:
+      base = fichier->position;
+      break;
+    case SEEK_END:
+      base = Taille(fichier->inode);
+      break;
+    default:
+      fprintf(stderr, "PositionnerSF : origine invalide\n");
+      return -1;
+  }
+
+  if ((decalage < 0) ? base + decalage < 0 : base > LONG_MAX - decalage) {
+    fprintf(stderr, "PositionnerSF : position invalide\n");
+    return -1;
+  }
+  fichier->position = base + decalage;
+  return fichier->position;
+}
+
+/* V5
+ * Ferme un fichier ouvert : son descripteur redevient libre.
+ * Entrées : le système de fichiers, le descripteur
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+int FermerSF(tSF sf, int descripteur) {
+  struct sFichierOuvert *fichier = fichierOuvertSF(sf, descripteur, "FermerSF");
+  if (fichier == NULL) {
+    return -1;
+  }
+
+  // les ajouts en attente sont écrits sur le disque
+  int resultat = ViderAjoutsInode(fichier->inode);
+
+  fichier->inode = NULL;
+  sf->fichiersOuverts.nbOuverts--;
+  return resultat;
+}
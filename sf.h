@@ -18,6 +18,17 @@ typedef struct sSF *tSF;
 // Type (public) représentant un super-bloc.
 typedef struct sSuperBloc *tSuperBloc;
 
+// Modes d'ouverture d'un fichier du SF (voir OuvrirSF), à combiner avec |
+// OUVERTURE_LECTURE : lecture (seule, sans OUVERTURE_ECRITURE)
+// OUVERTURE_ECRITURE : écriture
+// OUVERTURE_AJOUT : chaque écriture se fait à la fin du fichier (les petits ajouts sont rassemblés en mémoire
+//                   jusqu'à FermerSF, voir AjouterDonneesInode)
+// OUVERTURE_CREATION : le fichier (ordinaire, vide) est créé s'il n'existe pas
+#define OUVERTURE_LECTURE 1
+#define OUVERTURE_ECRITURE 2
+#define OUVERTURE_AJOUT 4
+#define OUVERTURE_CREATION 8
+
 /* V2 & V4
  * Crée un nouveau système de fichiers.
  * Entrée : nom du disque à associer au système de fichiers créé
@@ -25,6 +36,26 @@ typedef struct sSuperBloc *tSuperBloc;
  */
 extern tSF CreerSF (char nomDisque[]);
 
+/* V5
+ * Crée un nouveau système de fichiers dont les blocs ont une taille donnée.
+ * La taille est enregistrée dans le super-bloc (et dans la sauvegarde du SF).
+ * Entrées : nom du disque à associer au SF, taille des blocs en octets
+ *           (puissance de 2 entre TAILLE_BLOC_MIN et TAILLE_BLOC_MAX)
+ * Retour : le système de fichiers créé, ou NULL en cas d'erreur
+ */
+extern tSF CreerSFAvecTailleBloc(char nomDisque[], long tailleBloc);
+
+/* V5
+ * Crée un nouveau système de fichiers dont les blocs sont stockés dans un fichier image
+ * (lus et écrits à la demande, voir CreerDisqueFichier) au lieu d'être tous en mémoire.
+ * SauvegarderSF n'enregistre alors que les métadonnées et le nom de l'image, et ChargerSF
+ * rouvre l'image sans lire ses blocs.
+ * Entrées : nom du disque à associer au SF, taille des blocs en octets
+ *           (puissance de 2 entre TAILLE_BLOC_MIN et TAILLE_BLOC_MAX), nom du fichier image (créé ou vidé)
+ * Retour : le système de fichiers créé, ou NULL en cas d'erreur
+ */
+extern tSF CreerSFSurFichier(char nomDisque[], long tailleBloc, char nomImage[]);
+
 /* V2
  * Détruit un système de fichiers et libère la mémoire associée.
  * Entrée : le SF à détruire
@@ -47,24 +78,54 @@ extern void AfficherSF(tSF sf);
  */
 extern long Ecrire1BlocFichierSF(tSF sf, char nomFichier[], natureFichier type);
 
-/* V3 & V4
+/* V3 & V5
  * Ecrit un fichier (d'un nombre de blocs quelconque) dans le système de fichiers.
- * Si la taille du fichier à écrire dépasse la taille maximale d'un fichier dans le SF(10 x 64 octets),
- * seuls les 640 premiers octets seront écrits dans le système de fichiers.
+ * Si la taille du fichier à écrire dépasse la taille maximale d'un fichier dans le SF
+ * (voir TailleMaxFichierBlocs, soit 280 192 octets avec les blocs par défaut),
+ * seuls les premiers octets jusqu'à cette taille seront écrits dans le système de fichiers.
+ * Le fichier est lu par tronçons de taille fixe, écrits dans le SF au fur et à mesure (voir EcrireFluxSF).
  * Entrées : le système de fichiers, le nom du fichier (sur disque) et son type dans le SF (simulé)
  * Sortie : le nombre d'octets effectivement écrits, -1 en cas d'erreur.
  */
 extern long EcrireFichierSF(tSF sf, char nomFichier[], natureFichier type);
 
-/* V3
- * Sauvegarde un système de fichiers dans un fichier (sur disque).
+/* V5
+ * Ecrit dans le système de fichiers le contenu d'un flux ouvert en lecture (fichier, tube, stdin...),
+ * jusqu'à sa fin : la source est lue par tronçons de taille fixe (64 Kio, ou 16 blocs si c'est plus),
+ * chacun écrit dans le nouveau fichier dès qu'il est lu, si bien que la mémoire utilisée ne dépend pas
+ * de la taille de la source, dont la taille n'a pas à être connue à l'avance.
+ * Au-delà de la taille maximale d'un fichier dans le SF, la source est tronquée (comme avec EcrireFichierSF).
+ * Entrées : le système de fichiers, le flux (qui n'est pas fermé), le nom du fichier dans le SF et son type
+ * Sortie : le nombre d'octets effectivement écrits, -1 en cas d'erreur.
+ */
+extern long EcrireFluxSF(tSF sf, FILE *flux, char nomFichier[], natureFichier type);
+
+/* V5
+ * Comme EcrireFluxSF, pour un descripteur de fichier du système (voir open, pipe) lu avec read.
+ * Entrées : le système de fichiers, le descripteur (qui n'est pas fermé), le nom du fichier dans le SF et son type
+ * Sortie : le nombre d'octets effectivement écrits, -1 en cas d'erreur.
+ */
+extern long EcrireDescripteurSystemeSF(tSF sf, int fd, char nomFichier[], natureFichier type);
+
+/* V3 & V5
+ * Sauvegarde un système de fichiers dans un fichier (sur disque) :
+ * super-bloc (avec la carte des numéros d'inode), disque (en une seule écriture pour les blocs)
+ * puis les inodes (métadonnées et numéros de blocs).
+ * La sauvegarde est écrite dans un fichier temporaire qui remplace l'ancienne à la fin
+ * (un SF chargé depuis l'ancienne, dont les blocs sont projetés, reste donc valide).
  * Entrées : le système de fichiers, le nom du fichier sauvegarde (sur disque)
  * Sortie : 0 en cas de succèe, -1 en cas d'erreur
  */
 int SauvegarderSF(tSF sf, char nomFichier[]);
 
-/* V3
+/* V3 & V5
  * Restaure le contenu d'un système de fichiers depuis un fichier sauvegarde (sur disque).
+ * Le fichier doit avoir été produit par SauvegarderSF (format V5).
+ * Les blocs ne sont pas lus : l'image des blocs de la sauvegarde est projetée en mémoire (mmap privé,
+ * les modifications restent en mémoire jusqu'à la prochaine sauvegarde) et chaque page est lue au premier accès ;
+ * le chargement ne coûte que les métadonnées. Les sommes de contrôle des blocs sont alors vérifiées
+ * à la première lecture de chaque bloc (au chargement si la projection est impossible, sauf après
+ * VerificationParesseuseDisque(true)). Le fichier ne doit pas être modifié en place tant que le SF est chargé.
  * Entrées : le système de fichiers où restaurer, le nom du fichier sauvegarde (sur disque)
  * Sortie : 0 en cas de succèe, -1 en cas d'erreur
  */
@@ -79,4 +140,106 @@ int ChargerSF(tSF *pSF, char nomFichier[]);
  */
 extern int Ls (tSF sf, bool detail);
 
+/* V5
+ * Affiche l'occupation du disque d'un système de fichiers (nombre de blocs et d'octets,
+ * au total, utilisés et libres), à la manière de la commande df,
+ * et, si elle est activée, le bilan de la déduplication (ratio et octets économisés)
+ * ou, sinon, celui des blocs partagés par des fichiers clonés (voir CloneFichierSF),
+ * et pour un disque dans un fichier image l'activité de son cache de blocs (succès, défauts, évictions).
+ * Entrée : le système de fichiers
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int Df(tSF sf);
+
+/* V5
+ * Active la déduplication des blocs d'un système de fichiers : les blocs entiers identiques
+ * des fichiers écrits ensuite ne sont stockés qu'une fois (blocs partagés avec un nombre de références).
+ * Le réglage est conservé par SauvegarderSF/ChargerSF.
+ * Entrée : le système de fichiers
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int ActiverDeduplicationSF(tSF sf);
+
+/* V5
+ * Active ou désactive la compression des nouveaux fichiers ordinaires d'un système de fichiers
+ * (voir ActiverCompressionInode ; les fichiers déjà écrits gardent leur mode de stockage).
+ * Le réglage est conservé par SauvegarderSF/ChargerSF.
+ * Entrées : le système de fichiers, true pour compresser les nouveaux fichiers
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int ActiverCompressionSF(tSF sf, bool compression);
+
+/* V5
+ * Choisit quand les lectures des fichiers d'un système de fichiers mettent à jour leur date de dernier accès,
+ * à la manière des options de montage strictatime, relatime et noatime (voir politiqueDates) :
+ * la politique s'applique aux fichiers existants et aux nouveaux. Elle est conservée par SauvegarderSF/ChargerSF.
+ * Entrées : le système de fichiers, la politique
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int PolitiqueDatesSF(tSF sf, politiqueDates politique);
+
+/* V5
+ * Clone un fichier du SF (copie instantanée, à la manière de cp --reflink) : le nouveau fichier
+ * partage les blocs de la source avec un nombre de références, et un bloc partagé n'est recopié
+ * qu'à la première écriture dans ce bloc (copie sur écriture). Le coût du clonage ne dépend que
+ * du nombre de numéros de blocs, pas de la taille du fichier.
+ * Entrées : le système de fichiers, le nom du fichier source et celui du clone (qui ne doit pas exister)
+ * Sortie : la taille du fichier cloné, -1 en cas d'erreur
+ */
+extern long CloneFichierSF(tSF sf, char nomSource[], char nomDestination[]);
+
+/* V5
+ * Supprime un fichier du SF : son entrée est retirée du répertoire racine, son inode est détruit
+ * (ses blocs sont rendus au disque, ou leur nombre de références baisse s'ils sont partagés)
+ * et son numéro d'inode pourra être donné au prochain fichier créé (le plus petit numéro libre d'abord).
+ * Entrées : le système de fichiers, le nom du fichier à supprimer
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur
+ */
+extern int SupprimerFichierSF(tSF sf, char nomFichier[]);
+
+/* V5
+ * Ouvre un fichier du SF (du répertoire racine) et retourne un descripteur, à la manière de open :
+ * le descripteur garde l'inode du fichier et une position courante (au début du fichier à l'ouverture),
+ * si bien que les lectures et écritures suivantes ne cherchent plus le nom dans le répertoire.
+ * Un fichier ouvert ne peut pas être supprimé (voir SupprimerFichierSF), un répertoire ne s'ouvre qu'en lecture,
+ * et les descripteurs ne sont pas conservés par SauvegarderSF/ChargerSF.
+ * Entrées : le système de fichiers, le nom du fichier,
+ *           le mode d'ouverture (OUVERTURE_LECTURE et/ou OUVERTURE_ECRITURE, avec OUVERTURE_AJOUT, OUVERTURE_CREATION)
+ * Sortie : le descripteur (le plus petit libre, à partir de 0), -1 en cas d'erreur
+ */
+extern int OuvrirSF(tSF sf, char nomFichier[], int mode);
+
+/* V5
+ * Lit taille octets d'un fichier ouvert à partir de sa position courante, qui avance d'autant (voir read).
+ * Entrées : le système de fichiers, le descripteur (ouvert avec OUVERTURE_LECTURE), la zone où recopier les données
+ * et sa taille en octets
+ * Sortie : le nombre d'octets effectivement lus (0 à la fin du fichier), -1 en cas d'erreur
+ */
+extern long LireSF(tSF sf, int descripteur, unsigned char *contenu, long taille);
+
+/* V5
+ * Ecrit taille octets dans un fichier ouvert à sa position courante (à la fin du fichier avec OUVERTURE_AJOUT),
+ * qui avance d'autant (voir write). Écrire au-delà de la fin du fichier y laisse un trou, qui se lit à zéro.
+ * Entrées : le système de fichiers, le descripteur (ouvert avec OUVERTURE_ECRITURE), l'adresse des données
+ * et leur taille en octets
+ * Sortie : le nombre d'octets effectivement écrits, -1 en cas d'erreur
+ */
+extern long EcrireSF(tSF sf, int descripteur, unsigned char *contenu, long taille);
+
+/* V5
+ * Déplace la position courante d'un fichier ouvert, à la manière de lseek (la position peut dépasser la fin du fichier).
+ * Entrées : le système de fichiers, le descripteur, le déplacement en octets et son origine :
+ * SEEK_SET (début du fichier), SEEK_CUR (position courante) ou SEEK_END (fin du fichier)
+ * Sortie : la nouvelle position, -1 en cas d'erreur (position négative ou origine invalide)
+ */
+extern long PositionnerSF(tSF sf, int descripteur, long decalage, int origine);
+
+/* V5
+ * Ferme un fichier ouvert : ses ajouts en attente sont écrits sur le disque et son descripteur redevient libre
+ * (il pourra être redonné par OuvrirSF).
+ * Entrées : le système de fichiers, le descripteur
+ * Sortie : 0 en cas de succès, -1 en cas d'erreur (le descripteur est tout de même libéré)
+ */
+extern int FermerSF(tSF sf, int descripteur);
+
 #endif
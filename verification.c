@@ -0,0 +1,122 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : verification.c
+ * Module de vérification pour les programmes de démonstration.
+ **/
+
+#include "verification.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Nom du programme de démonstration et nombre d'erreurs constatées
+static const char *nomDemo = "demo";
+static int nbErreurs = 0;
+
+/* V5
+ * Commence les vérifications d'un programme de démonstration : remet le nombre d'erreurs à 0.
+ * Entrée : le nom du programme, rappelé dans les messages d'échec
+ * Retour : aucun
+ */
+void DebuterVerifications(const char *nomProgramme) {
+  nomDemo = nomProgramme;
+  nbErreurs = 0;
+}
+
+/* V5
+ * Affiche le résultat d'une vérification (OK ou ECHEC) ; un échec est aussi signalé sur la sortie d'erreur
+ * et compté, sans interrompre la démonstration.
+ * Entrées : la condition vérifiée, sa description
+ * Retour : aucun
+ */
+void Verifier(bool condition, const char *description) {
+  printf("  %-64s %s\n", description, condition ? "OK" : "ECHEC");
+  if (!condition) {
+    fprintf(stderr, "%s : ECHEC : %s\n", nomDemo, description);
+    nbErreurs++;
+  }
+}
+
+/* V5
+ * Termine les vérifications : affiche le nombre d'erreurs constatées.
+ * Entrée : le titre de la démonstration
+ * Retour : le code de sortie du programme, 1 si au moins une vérification a échoué, 0 sinon
+ */
+int TerminerVerifications(const char *titre) {
+  printf("\n=== FIN DEMONSTRATION %s : %d erreur(s) ===\n", titre, nbErreurs);
+  return nbErreurs != 0;
+}
+
+/* V5
+ * Retourne le nombre de blocs utilisés d'un disque (le disque grandit au besoin).
+ * Entrée : le disque
+ * Retour : le nombre de blocs ni libres ni en attente de libération
+ */
+long NbBlocsUtilises(tDisque disque) {
+  return NbBlocsDisque(disque) - NbBlocsLibresDisque(disque);
+}
+
+/* V5
+ * Indique si un inode contient exactement les taille octets attendus.
+ * Entrées : l'inode, le contenu attendu, sa taille
+ * Retour : true si la taille et le contenu de l'inode sont ceux attendus, false sinon
+ */
+bool ContenuInodeEgal(tInode inode, const unsigned char *attendu, long taille) {
+  // un octet de plus est demandé : la lecture doit s'arrêter à la fin du fichier
+  unsigned char *lu = malloc(taille + 1);
+  bool egal = lu != NULL && Taille(inode) == taille
+              && LireDonneesInode(inode, lu, taille + 1, 0) == taille && memcmp(lu, attendu, taille) == 0;
+  free(lu);
+  return egal;
+}
+
+/* V5
+ * Indique si un fichier du SF contient exactement les taille octets attendus.
+ * Entrées : le SF, le nom du fichier, le contenu attendu, sa taille
+ * Retour : true si le fichier s'ouvre et contient exactement ce qui est attendu, false sinon
+ */
+bool ContenuFichierEgal(tSF sf, char nom[], const unsigned char *attendu, long taille) {
+  int descripteur = OuvrirSF(sf, nom, OUVERTURE_LECTURE);
+  if (descripteur < 0) {
+    return false;
+  }
+  unsigned char *lu = malloc(taille + 1);
+  bool egal = lu != NULL && LireSF(sf, descripteur, lu, taille + 1) == taille && memcmp(lu, attendu, taille) == 0;
+  free(lu);
+  FermerSF(sf, descripteur);
+  return egal;
+}
+
+/* V5
+ * Crée (ou remplace) un fichier du SF avec un contenu donné.
+ * Entrées : le SF, le nom du fichier, le contenu, sa taille
+ * Retour : true si tout le contenu est écrit et le fichier fermé, false sinon
+ */
+bool CreerFichierContenu(tSF sf, char nom[], const unsigned char *contenu, long taille) {
+  int descripteur = OuvrirSF(sf, nom, OUVERTURE_ECRITURE | OUVERTURE_CREATION);
+  if (descripteur < 0) {
+    return false;
+  }
+  bool ecrit = EcrireSF(sf, descripteur, (unsigned char *)contenu, taille) == taille;
+  return FermerSF(sf, descripteur) == 0 && ecrit;
+}
+
+/* V5
+ * Indique si les vues d'une lecture sans copie couvrent exactement les taille octets attendus, dans l'ordre.
+ * Entrées : les vues (voir LireVuesInode), le contenu attendu, sa taille
+ * Retour : true si les vues, mises bout à bout, donnent le contenu attendu, false sinon
+ */
+bool VuesEgales(tVuesInode vues, const unsigned char *attendu, long taille) {
+  long nbVues;
+  const struct sVue *tableau = VuesInode(vues, &nbVues);
+  long position = 0;
+  for (long i = 0; tableau != NULL && i < nbVues; i++) {
+    if (tableau[i].taille <= 0 || position + tableau[i].taille > taille
+        || memcmp(tableau[i].adresse, attendu + position, tableau[i].taille) != 0) {
+      return false;
+    }
+    position += tableau[i].taille;
+  }
+  return position == taille;
+}
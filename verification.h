@@ -0,0 +1,75 @@
+/**
+ * ProgC - Projet Automne 25-26 : Gestion de systèmes de fichiers
+ * VERSION 5
+ * Fichier : verification.h
+ * Module de vérification pour les programmes de démonstration (demo_*.c) :
+ * affichage et décompte des vérifications, comparaison de contenus.
+ * Une vérification en échec est signalée sur la sortie d'erreur et comptée, et la démonstration continue ;
+ * le programme retourne 1 à la fin si au moins une vérification a échoué (voir TerminerVerifications).
+ **/
+#ifndef __VERIFICATION_H__
+#define __VERIFICATION_H__
+
+#include <stdbool.h>
+#include "disque.h"
+#include "inode.h"
+#include "sf.h"
+
+/* V5
+ * Commence les vérifications d'un programme de démonstration : remet le nombre d'erreurs à 0.
+ * Entrée : le nom du programme, rappelé dans les messages d'échec
+ * Retour : aucun
+ */
+extern void DebuterVerifications(const char *nomProgramme);
+
+/* V5
+ * Affiche le résultat d'une vérification (OK ou ECHEC) ; un échec est aussi signalé sur la sortie d'erreur
+ * et compté, sans interrompre la démonstration.
+ * Entrées : la condition vérifiée, sa description
+ * Retour : aucun
+ */
+extern void Verifier(bool condition, const char *description);
+
+/* V5
+ * Termine les vérifications : affiche le nombre d'erreurs constatées.
+ * Entrée : le titre de la démonstration
+ * Retour : le code de sortie du programme, 1 si au moins une vérification a échoué, 0 sinon
+ */
+extern int TerminerVerifications(const char *titre);
+
+/* V5
+ * Retourne le nombre de blocs utilisés d'un disque (le disque grandit au besoin).
+ * Entrée : le disque
+ * Retour : le nombre de blocs ni libres ni en attente de libération
+ */
+extern long NbBlocsUtilises(tDisque disque);
+
+/* V5
+ * Indique si un inode contient exactement les taille octets attendus.
+ * Entrées : l'inode, le contenu attendu, sa taille
+ * Retour : true si la taille et le contenu de l'inode sont ceux attendus, false sinon
+ */
+extern bool ContenuInodeEgal(tInode inode, const unsigned char *attendu, long taille);
+
+/* V5
+ * Indique si un fichier du SF contient exactement les taille octets attendus.
+ * Entrées : le SF, le nom du fichier, le contenu attendu, sa taille
+ * Retour : true si le fichier s'ouvre et contient exactement ce qui est attendu, false sinon
+ */
+extern bool ContenuFichierEgal(tSF sf, char nom[], const unsigned char *attendu, long taille);
+
+/* V5
+ * Crée (ou remplace) un fichier du SF avec un contenu donné.
+ * Entrées : le SF, le nom du fichier, le contenu, sa taille
+ * Retour : true si tout le contenu est écrit et le fichier fermé, false sinon
+ */
+extern bool CreerFichierContenu(tSF sf, char nom[], const unsigned char *contenu, long taille);
+
+/* V5
+ * Indique si les vues d'une lecture sans copie couvrent exactement les taille octets attendus, dans l'ordre.
+ * Entrées : les vues (voir LireVuesInode), le contenu attendu, sa taille
+ * Retour : true si les vues, mises bout à bout, donnent le contenu attendu, false sinon
+ */
+extern bool VuesEgales(tVuesInode vues, const unsigned char *attendu, long taille);
+
+#endif